@@ -0,0 +1,134 @@
+#include <CtrlLib/CtrlLib.h>
+
+using namespace Upp;
+
+struct Timers : Ctrl {
+	static void Process() { TimerProc(msecs()); }
+};
+
+void WaitSource(ArrayCtrl& list)
+{ // filtering and sorting is applied by time callback
+	while(list.IsSourceWorking()) {
+		Sleep(1);
+		Timers::Process();
+	}
+}
+
+const int N = 100000;
+
+Vector<int> model; // source rows in expected order
+int         edited = -1; // source row changed by Set
+
+void Check(ArrayCtrl& list, ArrayColumns& data)
+{
+	ASSERT(list.GetCount() == model.GetCount());
+	for(int i = 0; i < model.GetCount(); i++) { // sequentially, over all pages
+		ASSERT(list.GetSourceRow(i) == model[i]);
+		ASSERT(list.Get(i, 0) == model[i]);
+	}
+	for(int pass = 0; pass < 2000; pass++) { // random access evicts cached pages
+		int i = Random(model.GetCount());
+		int r = model[i];
+		ASSERT(list.Get(i, 0) == data.Get<int>(0)[r]);
+		ASSERT(list.Get(i, 1) == data.Get<int>(1)[r]);
+		ASSERT(list.Get(i, 2) == (r == edited ? String("edited") : data.Get<String>(2)[r]));
+		ASSERT(list.FindSourceRow(r) == i);
+	}
+	Index<int> shown(clone(model));
+	for(int pass = 0; pass < 100; pass++) {
+		int r = Random(N);
+		if(shown.Find(r) < 0)
+			ASSERT(list.FindSourceRow(r) < 0);
+	}
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	SeedRandom(0);
+
+	ArrayColumns data;
+	Vector<int>& id = data.Add<int>();
+	Vector<int>& key = data.Add<int>();
+	Vector<String>& name = data.Add<String>();
+	for(int i = 0; i < N; i++) {
+		id.Add(i);
+		key.Add(i * 7919 % 1000);
+		name.Add(FormatIntBase(i, 36));
+	}
+
+	ArrayCtrl list;
+	list.AddColumn("id");
+	list.AddColumn("key");
+	list.AddColumn("name");
+	list.SetSource(data);
+	ASSERT(!list.IsSourceWorking());
+	for(int i = 0; i < N; i++)
+		model.Add(i);
+	Check(list, data);
+
+	auto Filter = [&](int limit) {
+		list.FilterSource([=](const Vector<Value>& row) { return (int)row[1] < limit; });
+		ASSERT(list.IsSourceWorking());
+		WaitSource(list);
+		model.Clear();
+		for(int i = 0; i < N; i++)
+			if(key[i] < limit)
+				model.Add(i);
+	};
+	Filter(500);
+	Check(list, data);
+
+	list.SortSource(1, [](const Value& a, const Value& b) { return (int)a > (int)b; });
+	WaitSource(list);
+	StableSort(model, [&](int a, int b) { return key[a] > key[b]; });
+	Check(list, data);
+
+	{ // values changed by Set and cursor stay with the source row
+		int r = model[1234];
+		list.SetCursor(1234);
+		list.Set(1000, 2, "edited");
+		int er = model[1000];
+		edited = er;
+		ASSERT(list.Get(1000, 0) == er); // Set does not hide other source values
+		ASSERT(list.Get(1000, 2) == "edited");
+
+		list.NoSortSource();
+		WaitSource(list);
+		model.Clear();
+		for(int i = 0; i < N; i++)
+			if(key[i] < 500)
+				model.Add(i);
+		ASSERT(list.GetSourceRow(list.GetCursor()) == r);
+		ASSERT(list.Get(list.FindSourceRow(er), 2) == "edited");
+
+		Filter(key[er]); // edited row is filtered out
+		ASSERT(list.FindSourceRow(er) < 0);
+		ASSERT(list.GetCursor() < 0 || list.GetSourceRow(list.GetCursor()) == r);
+
+		list.FilterSource(Null);
+		WaitSource(list);
+		model.Clear();
+		for(int i = 0; i < N; i++)
+			model.Add(i);
+		ASSERT(list.Get(er, 2) == "edited");
+		ASSERT(list.Get(er, 0) == er);
+		ASSERT(list.Get(er + 1, 2) == name[er + 1]);
+		Check(list, data);
+	}
+
+	{ // source is refreshed after it changes
+		id.Add(N);
+		key.Add(0);
+		name.Add("last");
+		list.RefreshSource();
+		ASSERT(list.GetCount() == N + 1);
+		ASSERT(list.Get(N, 2) == "last");
+	}
+
+	list.Clear();
+	ASSERT(list.GetCount() == 0 && !list.GetSource());
+
+	LOG("=========== OK");
+}
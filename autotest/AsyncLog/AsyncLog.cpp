@@ -0,0 +1,77 @@
+#include <Core/Core.h>
+
+#ifdef PLATFORM_POSIX
+#include <sys/wait.h>
+#endif
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	LOG("Testing LOG_ASYNC");
+	String stdpath = GetStdLogPath();
+	String path = GetHomeDirFile("AsyncLog.test.log");
+	StdLogSetup(LOG_FILE|LOG_ASYNC, path, 0);
+
+	const int THREADS = 8;
+	const int N = 20000;
+	Array<Thread> thread;
+	for(int t = 0; t < THREADS; t++)
+		thread.Add().Run([=] {
+			for(int i = 0; i < N; i++)
+				RLOG("T" << t << " " << i);
+		});
+	for(Thread& t : thread)
+		t.Wait();
+	RLOG("END");
+	FlushLog();
+
+	Vector<String> line = Split(LoadFile(path), '\n');
+	Vector<int> next;
+	next.SetCount(THREADS, 0);
+	bool end = false;
+	for(String l : line) {
+		l = TrimRight(l);
+		if(IsNull(l) || *l == '*') // header
+			continue;
+		if(l == "END") {
+			end = true;
+			continue;
+		}
+		ASSERT(!end); // lines from finished threads have to precede
+		CParser p(l);
+		p.PassChar('T');
+		int t = p.ReadInt();
+		int i = p.ReadInt();
+		ASSERT(next[t] == i); // order of each thread is preserved
+		next[t]++;
+	}
+	ASSERT(end);
+	for(int n : next)
+		ASSERT(n == N);
+
+	StdLogSetup(LOG_FILE|LOG_ASYNC, path, 4096); // rotation still works
+	for(int i = 0; i < 1000; i++)
+		RLOG("Line " << i);
+	FlushLog();
+	ASSERT(GetFileLength(path) < 4096 + 100);
+
+#ifdef PLATFORM_POSIX
+	pid_t pid = fork();
+	if(pid == 0) { // queued lines are written when the application crashes
+		StdLogSetup(LOG_FILE|LOG_ASYNC, path, 0);
+		for(int i = 0; i < 1000; i++)
+			RLOG("Crash " << i);
+		abort();
+	}
+	int status;
+	ASSERT(waitpid(pid, &status, 0) == pid && WIFSIGNALED(status));
+	ASSERT(LoadFile(path).Find("Crash 999") >= 0);
+#endif
+
+	StdLogSetup(LOG_COUT|LOG_FILE, stdpath);
+	DeleteFile(path);
+
+	LOG("=========== OK");
+}
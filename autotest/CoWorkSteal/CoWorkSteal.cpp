@@ -0,0 +1,78 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+int64 Fib(int n)
+{
+	if(n < 16)
+		return n < 2 ? n : Fib(n - 1) + Fib(n - 2);
+	int64 a, b;
+	CoWork co;
+	co & [&] { a = Fib(n - 1); };
+	b = Fib(n - 2);
+	co.Finish();
+	return a + b;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	DUMP(Fib(30));
+	ASSERT(Fib(30) == 832040);
+	
+	{ // jobs spawned by workers go to their local deques
+		std::atomic<int> count(0);
+		CoWork co;
+		for(int i = 0; i < 100; i++)
+			co & [&] {
+				CoWork co2;
+				for(int j = 0; j < 5000; j++) // more than local deque capacity
+					co2 & [&] { count++; };
+			};
+		co.Finish();
+		DUMP((int)count);
+		ASSERT(count == 100 * 5000);
+	}
+	
+	{ // cancel skips jobs waiting in local deques
+		std::atomic<int> count(0);
+		CoWork co;
+		co & [&] {
+			CoWork co2;
+			for(int j = 0; j < 500; j++)
+				co2 & [&] { Sleep(1); count++; };
+			co2.Cancel();
+			ASSERT(co2.IsFinished());
+		};
+		co.Finish();
+		DUMP((int)count);
+		ASSERT(count < 500);
+	}
+	
+	{ // exception in local job is rethrown by Finish
+		bool caught = false;
+		CoWork co;
+		co & [&] {
+			CoWork co2;
+			for(int j = 0; j < 100; j++)
+				co2 & [=] { if(j == 50) throw Exc("failed"); };
+			try {
+				co2.Finish();
+			}
+			catch(Exc e) {
+				CoWork::FinLock();
+				caught = true;
+			}
+		};
+		co.Finish();
+		ASSERT(caught);
+	}
+	
+	for(int n = 1; n <= CPU_Cores() + 2; n++) {
+		CoWork::SetPoolSize(n);
+		ASSERT(Fib(25) == 75025);
+	}
+	
+	LOG("================ OK");
+}
@@ -0,0 +1,86 @@
+#include <CodeEditor/CodeEditor.h>
+
+using namespace Upp;
+
+struct TestEditor : CodeEditor {
+	using CodeEditor::syntax_dirty;
+
+	String SyntaxState(int line)  { return GetSyntax(line)->Get(); }
+
+	void Scan() {
+		for(;;) {
+			ScanSyntaxState();
+			if(syntax_dirty == INT_MAX &&
+			   (syntax_state.IsEmpty() ? 0 : syntax_state.Top().line) + SYNTAX_STEP > GetLineCount())
+				break;
+		}
+	}
+
+	void Check() { // snapshots have to be the same as when scanning from the start
+		TestEditor fresh;
+		fresh.Highlight("cpp");
+		fresh.Set(Get());
+		for(const SyntaxPos& p : syntax_state)
+			ASSERT(fresh.SyntaxState(p.line) == p.data);
+		for(int i = 0; i < 50; i++) {
+			int line = Random(GetLineCount());
+			ASSERT(SyntaxState(line) == fresh.SyntaxState(line));
+		}
+	}
+
+	TestEditor() { Highlight("cpp"); }
+};
+
+String RandomText()
+{
+	static const char *part[] = {
+		"/*", "*/", "//", "\"", "{", "}", "(", ")", "#if 0\n", "#endif\n", "\n", "\n", "\n",
+		"int x = 1;", "  ", "'\\''", "R\"(", ")\"", "\\\n",
+	};
+	String r;
+	int n = Random(20);
+	for(int i = 0; i < n; i++)
+		r << part[Random(__countof(part))];
+	return r;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	SeedRandom(0);
+
+	String text;
+	for(int i = 0; i < 3000; i++)
+		text << decode(i % 7, 0, "/* comment", 3, "end */ int a;", 5, "if(x) { \"string\"; }", "void Fn(int x);") << "\n";
+
+	TestEditor edit;
+	edit.Set(text);
+	edit.Scan();
+	edit.Check();
+
+	edit.Insert(edit.GetPos(1000, 2), "x"); // change inside the line converges at the next snapshot
+	ASSERT(edit.syntax_dirty < INT_MAX);
+	edit.SyntaxState(1100);
+	ASSERT(edit.syntax_dirty == INT_MAX);
+	edit.Check();
+
+	for(int pass = 0; pass < 400; pass++) {
+		int n = Random(5) + 1;
+		for(int i = 0; i < n; i++) {
+			int len = edit.GetLength();
+			int pos = Random(len + 1);
+			if(Random(3))
+				edit.Insert(pos, RandomText());
+			else
+				edit.Remove(pos, min(len - pos, (int)Random(Random(20) ? 30 : 1000)));
+			if(Random(2)) // highlighting of some lines before the scan is done
+				edit.SyntaxState(Random(edit.GetLineCount()));
+		}
+		edit.Scan();
+		edit.Check();
+	}
+	DUMP(edit.GetLineCount());
+
+	LOG("=========== OK");
+}
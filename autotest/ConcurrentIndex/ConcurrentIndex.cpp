@@ -0,0 +1,57 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	for(int n : { 10, 1000, 100000, 1000000 }) {
+		ConcurrentIndex<int> ndx;
+		CoFor(4 * n, [&](int i) {
+			int k = (int)(i * 7919LL % n);
+			int q = ndx.FindAdd(k);
+			ASSERT(ndx[q] == k);
+			ASSERT(ndx.Find(k) == q);
+		});
+		DUMP(ndx.GetCount());
+		ASSERT(ndx.GetCount() == n);
+		Vector<int> h;
+		h.SetCount(n, -1);
+		for(int i = 0; i < n; i++) {
+			ASSERT(h[ndx[i]] < 0);
+			h[ndx[i]] = i;
+			ASSERT(ndx.Find(ndx[i]) == i);
+		}
+		ASSERT(ndx.Find(-1) < 0);
+		ASSERT(ndx.Find(n) < 0);
+	}
+
+	{
+		ConcurrentVectorMap<String, int> map;
+		CoFor(200000, [&](int i) {
+			int k = i % 50000;
+			String key = AsString(k);
+			int q = map.FindAdd(key, k);
+			ASSERT(map.GetKey(q) == key);
+			ASSERT(map[q] == k);
+		});
+		ASSERT(map.GetCount() == 50000);
+		for(int i = 0; i < 50000; i++) {
+			ASSERT(map.Get(AsString(i), -1) == i);
+			ASSERT(*map.FindPtr(AsString(i)) == i);
+		}
+		ASSERT(map.FindPtr("x") == nullptr);
+		Vector<String> keys = map.GetKeys();
+		Vector<int> values = map.GetValues();
+		for(int i = 0; i < keys.GetCount(); i++)
+			ASSERT(AsString(values[i]) == keys[i]);
+		map.Clear();
+		ASSERT(map.IsEmpty());
+		ASSERT(map.GetAdd("a", 1) == 1);
+		ASSERT(map.GetAdd("a", 2) == 1);
+		ASSERT(map.GetCount() == 1);
+	}
+
+	LOG("=========== OK");
+}
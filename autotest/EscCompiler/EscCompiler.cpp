@@ -0,0 +1,55 @@
+#include <Esc/Esc.h>
+
+using namespace Upp;
+
+String Run(const String& script, int64 oplimit)
+{
+	ArrayMap<String, EscValue> global;
+	StdLib(global);
+	String r;
+	try {
+		Scan(global, script);
+		r = Execute(global, "f", oplimit).ToString();
+	}
+	catch(CParser::Error e) {
+		r = "ERROR " + e;
+	}
+	for(int i = 0; i < global.GetCount(); i++)
+		if(!global[i].IsLambda())
+			r << " | " << global.GetKey(i) << " = " << global[i].ToString();
+	return r;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	// each line is a script with function 'f', run with various operation limits
+	// to check that both results and operation counting match the interpreter
+	int compiled = 0;
+	for(String script : Split(LoadFile(GetDataFile("scripts.txt")), '\n')) {
+		for(int64 oplimit : { 100000, 1, 2, 3, 5, 8, 13, 21, 34, 55 }) {
+			UseEscCompiler(false);
+			String a = Run(script, oplimit);
+			UseEscCompiler(true);
+			String b = Run(script, oplimit);
+			if(oplimit == 100000)
+				LOG(script << "\n   -> " << a);
+			if(a != b)
+				LOG("*** vm: " << b);
+			ASSERT(a == b);
+		}
+		try {
+			ArrayMap<String, EscValue> global;
+			Scan(global, script);
+			int q = global.Find("f");
+			if(q >= 0 && GetEscCode(global[q].GetLambda()))
+				compiled++;
+		}
+		catch(CParser::Error) {}
+	}
+	DUMP(compiled);
+	ASSERT(compiled > 250);
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,118 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+template <class T>
+void Check(const FlatIndex<T>& a, const Index<T>& b)
+{
+	ASSERT(a.GetCount() == b.GetCount());
+	for(int i = 0; i < a.GetCount(); i++) {
+		ASSERT(a[i] == b[i]);
+		ASSERT(a.IsUnlinked(i) == b.IsUnlinked(i));
+		if(!a.IsUnlinked(i)) {
+			Vector<int> x, y;
+			for(int q = a.Find(a[i]); q >= 0; q = a.FindNext(q))
+				x.Add(q);
+			for(int q = b.Find(b[i]); q >= 0; q = b.FindNext(q))
+				y.Add(q);
+			Sort(x); // order of same keys is not the same after Set or Unlink
+			Sort(y);
+			ASSERT(x == y);
+		}
+	}
+}
+
+template <class T, class F>
+void Test(F key)
+{
+	for(int pass = 0; pass < 10; pass++) {
+		FlatIndex<T> a;
+		Index<T> b;
+		int n = (int)Random(1 << (2 * pass + 1)) + 1;
+		for(int i = 0; i < 5000; i++) {
+			T k = key((int)Random(n));
+			switch(Random(10)) {
+			case 0:
+				a.Add(k);
+				b.Add(k);
+				break;
+			case 1:
+				ASSERT(a.UnlinkKey(k) == b.UnlinkKey(k));
+				break;
+			case 2:
+				if(a.GetCount()) {
+					int q = (int)Random(a.GetCount());
+					a.Set(q, k);
+					b.Set(q, k);
+				}
+				break;
+			case 3:
+				if(Random(50) == 0) {
+					a.Sweep();
+					b.Sweep();
+				}
+				break;
+			case 4:
+				if(Random(20) == 0) {
+					int q = (int)Random(a.GetCount() + 1);
+					a.Trim(q);
+					b.Trim(q);
+				}
+				break;
+			default:
+				int q = a.Find(k);
+				ASSERT((q < 0) == (b.Find(k) < 0));
+				ASSERT(q < 0 || a[q] == k);
+				q = a.FindAdd(k);
+				ASSERT(b[b.FindAdd(k)] == a[q]);
+			}
+		}
+		Check(a, b);
+		FlatIndex<T> c(a, 1);
+		Check(c, b);
+		FlatIndex<T> d = pick(c);
+		Check(d, b);
+		ASSERT(c.GetCount() == 0);
+		ASSERT(c.Find(key(0)) < 0);
+		b.Sweep();
+		StringStream ss;
+		a.Serialize(ss);
+		ss.Seek(0);
+		ss.SetLoading();
+		FlatIndex<T> e;
+		e.Serialize(ss);
+		Check(e, b);
+	}
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Test<int>([](int i) { return i; });
+	Test<String>([](int i) { return "key" + AsString(i); });
+
+	FlatVectorMap<String, int> map;
+	for(int i = 0; i < 100000; i++)
+		map.GetAdd(AsString(i % 1000), 0)++;
+	ASSERT(map.GetCount() == 1000);
+	for(int i = 0; i < 1000; i++) {
+		ASSERT(map.GetKey(i) == AsString(i));
+		ASSERT(map.Get(AsString(i)) == 100);
+	}
+	ASSERT(map.Get("x", -1) == -1);
+	ASSERT(!map.FindPtr("x"));
+	map.UnlinkKey("10");
+	map.Sweep();
+	ASSERT(map.GetCount() == 999);
+	ASSERT(map.Find("11") == 10);
+	
+	FlatIndex<int> h;
+	for(int i = 0; i < 1000000; i++)
+		h.Add(i);
+	for(int i = 0; i < 1000000; i++)
+		ASSERT(h.Find(i) == i);
+	ASSERT(h.Find(-1) < 0);
+
+	LOG("=========== OK");
+}
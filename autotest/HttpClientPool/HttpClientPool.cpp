@@ -0,0 +1,142 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#define PORT 27320
+#define N    600
+
+std::atomic<int> connections;
+std::atomic<int> requests;
+
+static void Serve(TcpSocket *s)
+{ // keep-alive server, sometimes closes the connection to test reconnects
+	for(;;) {
+		HttpHeader h;
+		if(!h.Read(*s))
+			break;
+		String uri = h.GetURI();
+		if(uri == "/nocontent") {
+			s->Put("HTTP/1.1 204 No Content\r\nSet-Cookie: sid=42\r\n\r\n");
+			continue;
+		}
+		if(uri == "/redirect") {
+			s->Put("HTTP/1.1 302 Found\r\nLocation: http://localhost:" + AsString(PORT)
+			       + "/redirected\r\nContent-Length: 0\r\n\r\n");
+			continue;
+		}
+		if(uri == "/cookie") {
+			String body = h["cookie"];
+			s->Put("HTTP/1.1 200 OK\r\nContent-Length: " + AsString(body.GetCount()) + "\r\n\r\n" + body);
+			continue;
+		}
+		int n = ++requests;
+		String body = uri;
+		bool close = n % 11 == 0;
+		s->Put("HTTP/1.1 200 OK\r\nContent-Length: " + AsString(body.GetCount()) + "\r\n"
+		       + (close ? "Connection: close\r\n" : "") + "\r\n" + body);
+		if(close || n % 13 == 0) // closing without notice, client has to detect it
+			break;
+	}
+	delete s;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	TcpSocket server;
+	ASSERT(server.Listen(PORT, 100));
+	Thread::Start([&] {
+		while(!Thread::IsShutdownThreads()) {
+			TcpSocket *s = new TcpSocket;
+			s->Timeout(200);
+			if(s->Accept(server)) {
+				connections++;
+				s->Timeout(Null);
+				Thread::Start([=] { Serve(s); });
+			}
+			else
+				delete s;
+		}
+	});
+
+	{
+		HttpClientPool pool;
+		pool.MaxHostConnections(4);
+		pool.WhenRequest = [](HttpRequest& r) { r.Header("X-Test", "1"); };
+		int done = 0;
+		for(int i = 0; i < N; i++) {
+			String path = "/" + AsString(i);
+			String url = String(i & 1 ? "localhost" : "127.0.0.1") + ":" + AsString(PORT) + path;
+			pool.Add(url, [&, path](HttpRequest& r) {
+				ASSERT(r.IsSuccess());
+				ASSERT(r.GetContent() == path);
+				done++;
+			});
+		}
+		int canceled = pool.Add("127.0.0.1:" + AsString(PORT) + "/canceled", [](HttpRequest&) { NEVER(); });
+		ASSERT(pool.Cancel(canceled));
+		ASSERT(!pool.Cancel(canceled));
+		ASSERT(pool.GetQueueCount() == N);
+		while(pool.Do())
+			ASSERT(pool.GetConnectionCount() <= 8); // 4 for each target
+		DUMP(done);
+		DUMP((int)requests);
+		DUMP((int)connections);
+		DUMP(pool.GetConnectCount());
+		DUMP(pool.GetReuseCount());
+		ASSERT(done == N);
+		ASSERT(pool.GetConnectCount() + pool.GetReuseCount() == N);
+		ASSERT(pool.GetReuseCount() > N / 2);
+		ASSERT(pool.GetConnectCount() > N / 11); // closed by server
+		ASSERT(connections < N / 2);
+
+		int c = pool.GetConnectCount();
+		pool.Add("127.0.0.1:" + AsString(PORT) + "/again", [&](HttpRequest& r) {
+			ASSERT(r.GetContent() == "/again");
+			done++;
+		});
+		pool.Finish();
+		ASSERT(done == N + 1);
+		DUMP(pool.GetIdleCount());
+		pool.CloseIdle();
+		ASSERT(pool.GetConnectionCount() == 0);
+		ASSERT(pool.GetConnectCount() <= c + 1);
+	}
+
+	{ // outside of the pool, HttpRequest does not reuse the connection
+		int c = connections;
+		HttpRequest r("127.0.0.1:" + AsString(PORT) + "/single");
+		r.KeepAlive();
+		ASSERT(r.Execute() == "/single");
+		ASSERT(r.Execute() == "/single");
+		ASSERT(connections == c + 2);
+	}
+
+	{ // response without body sets cookies too
+		HttpRequest r("127.0.0.1:" + AsString(PORT) + "/nocontent");
+		r.Execute();
+		ASSERT(r.GetStatusCode() == 204);
+		r.Url("127.0.0.1:" + AsString(PORT) + "/cookie");
+		ASSERT(r.Execute() == "sid=42");
+	}
+
+	{ // redirected connection is reused for the host it is connected to
+		HttpClientPool pool;
+		pool.MaxHostConnections(1);
+		pool.Add("127.0.0.1:" + AsString(PORT) + "/redirect", [](HttpRequest& r) {
+			ASSERT(r.GetContent() == "/redirected");
+		});
+		pool.Finish();
+		ASSERT(pool.GetConnectCount() == 1);
+		pool.Add("localhost:" + AsString(PORT) + "/next", [](HttpRequest& r) {
+			ASSERT(r.GetContent() == "/next");
+		});
+		pool.Finish();
+		ASSERT(pool.GetReuseCount() == 1);
+	}
+
+	Thread::ShutdownThreads();
+	
+	LOG("=========== OK");
+}
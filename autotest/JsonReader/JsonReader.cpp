@@ -0,0 +1,174 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+struct Item : Moveable<Item> {
+	int    id = 0;
+	String name;
+	double value = 0;
+	
+	void Jsonize(JsonIO& io) { io("id", id)("name", name)("value", value); }
+};
+
+struct Doc {
+	String                 title;
+	Vector<Item>           items;
+	Vector<Vector<String>> tags;
+	int                    id = 0;
+	int                    count = 0;
+	String                 note = "n";
+
+	void Jsonize(JsonIO& io) { io("id", id)("title", title)("items", items)("tags", tags)("count", count, 10)("note", note); }
+};
+
+String ViaReader(const String& json)
+{
+	StringStream ss(json);
+	JsonReader r(ss);
+	return AsJSON(r.ReadValue());
+}
+
+String ViaDom(const String& json)
+{
+	JsonDom dom(json);
+	ASSERT(dom.GetError().IsEmpty());
+	return AsJSON(dom.GetRoot().ToValue());
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	const char *test[] = {
+		"null", "true", "false", "0", "-12.5e3", "\"text\"",
+		"[]", "{}", "[1, 2, 3,]", "{\"a\": 1, \"b\": [true, null, {\"c\": \"x\"}],}",
+		"\"esc \\\" \\\\ \\/ \\b\\f\\n\\r\\t\"",
+		"\"\\u010Cesk\\u00FD \\uD83D\\uDE0D\"",
+		"\"\\/Date(1234567890000)\\/\"", "\"/Date(1234567890000)/\"",
+		"// comment\n[1, /* comment */ 2]",
+	};
+	for(const char *s : test) {
+		String a = AsJSON(ParseJSON(s));
+		LOG(s << " -> " << a);
+		ASSERT(ViaReader(s) == a);
+		ASSERT(ViaDom(s) == a);
+	}
+
+	for(const char *s : { "[1, 2", "{\"a\" 1}", "[1 2]", "\"abc", "nul", "{1: 2}" }) {
+		try {
+			ViaReader(s);
+			NEVER();
+		}
+		catch(JsonError e) {
+			LOG(s << " -> " << e);
+		}
+		JsonDom dom(s);
+		ASSERT(dom.GetError().GetCount() && dom.GetRoot().IsVoid());
+	}
+
+	String json = "[";
+	for(int i = 0; i < 20000; i++) {
+		if(i)
+			json << ",\n";
+		json << Json("id", i)("name", String('x', i % 100) + "\"\n" + AsString(i))("value", i * 0.25);
+	}
+	json << "]";
+	String a = AsJSON(ParseJSON(json));
+	ASSERT(ViaReader(json) == a);
+	ASSERT(ViaDom(json) == a);
+	
+	{
+		JsonDom dom(json);
+		JsonDom::Node root = dom.GetRoot();
+		ASSERT(root.GetCount() == 20000);
+		ASSERT(root[123]["id"].GetNumber() == 123);
+		ASSERT(root[123]["value"].GetNumber() == 123 * 0.25);
+		ASSERT(root[123]["name"].GetString() == String('x', 23) + "\"\n123");
+		ASSERT(root[123].GetKey(1).IsEqual("name"));
+		ASSERT(root[123]["nothing"].IsVoid());
+		DUMP(dom.GetMemoryUsed());
+	}
+
+	{
+		StringStream ss(json);
+		JsonReader r(ss);
+		int count = 0;
+		int depth = 0;
+		while(r.Next() != JSON_EOF) {
+			depth = max(depth, r.GetDepth());
+			count++;
+		}
+		ASSERT(depth == 2);
+		ASSERT(count == 2 + 20000 * 8);
+		ASSERT(r.GetLine() == 20000);
+	}
+
+	{
+		StringStream ss(json);
+		JsonReader r(ss);
+		ASSERT(r.Next() == JSON_ARRAY);
+		int i = 0;
+		while(r.Next() != JSON_END_ARRAY) {
+			Item m;
+			if(i % 2) {
+				LoadFromJson(m, r);
+				ASSERT(m.id == i && m.value == i * 0.25);
+			}
+			else
+				r.Skip();
+			i++;
+		}
+		ASSERT(i == 20000);
+		ASSERT(r.Next() == JSON_EOF);
+	}
+
+	{
+		StringStream ss("{\"id\": 1, \"name\": \"a\", \"value\": 1.5}\n{\"id\": 2, \"name\": \"b\", \"value\": 2.5}\n");
+		JsonReader r(ss);
+		int n = 0;
+		while(r.Next() != JSON_EOF) {
+			Item m;
+			LoadFromJson(m, r);
+			ASSERT(m.id == ++n && m.value == n + 0.5);
+		}
+		ASSERT(n == 2);
+	}
+	
+	{
+		Item m;
+		StringStream ss("{\"id\": 3, \"name\": \"c\", \"value\": 4}");
+		ASSERT(LoadFromJson(m, ss) && m.id == 3 && m.name == "c" && m.value == 4);
+		StringStream ss2("{\"id\": \"x\"}");
+		ASSERT(!LoadFromJson(m, ss2));
+		StringStream ss3("{\"id\": ");
+		ASSERT(!LoadFromJson(m, ss3));
+	}
+
+	{ // Jsonize is driven by the reader, members in different order or unknown are handled too
+		String json = "{\"title\": \"x\", \"extra\": {\"a\": [1, 2, {}]},"
+		       "\"items\": [{\"value\": 1.5, \"id\": 1, \"name\": \"a\"}, {\"id\": 2, \"foo\": [3], \"name\": \"b\"}, {}],"
+		       "\"tags\": [[\"p\", \"q\"], []], \"id\": 7, \"note\": null}";
+		Doc d1, d2;
+		ASSERT(LoadFromJson(d1, json));
+		StringStream ss(json);
+		ASSERT(LoadFromJson(d2, ss));
+		ASSERT(StoreAsJson(d1) == StoreAsJson(d2));
+		ASSERT(d2.items.GetCount() == 3 && d2.items[0].id == 1 && d2.items[1].name == "b");
+		ASSERT(d2.tags.GetCount() == 2 && d2.tags[0][1] == "q" && d2.tags[1].GetCount() == 0);
+		ASSERT(d2.id == 7 && d2.count == 10 && d2.title == "x");
+		ASSERT(IsNull(d2.note));
+		LOG(StoreAsJson(d2));
+
+		Vector<Item> v;
+		StringStream ss2(a);
+		ASSERT(LoadFromJson(v, ss2) && v.GetCount() == 20000 && v[777].id == 777);
+	}
+
+	{
+		JsonDom dom("[1, 2] x");
+		ASSERT(dom.GetError().GetCount());
+		ASSERT(JsonDom("[1, 2] // comment\n").GetError().IsEmpty());
+	}
+
+	LOG("=========== OK");
+}
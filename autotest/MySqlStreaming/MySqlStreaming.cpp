@@ -0,0 +1,92 @@
+#include <MySql/MySql.h>
+
+using namespace Upp;
+
+// Needs running MySQL server, e.g.
+// MySqlStreaming test test test localhost
+// Without it, test is skipped.
+
+const int N = 20000;
+
+Vector<Vector<Value>> FetchAll(SqlSession& session, bool streaming)
+{
+	Sql sql(session);
+	if(streaming)
+		sql.StreamingFetch();
+	ASSERT(sql.Execute("select ID, NAME, AMOUNT, DAY, NOTE from STREAMTEST order by ID"));
+	ASSERT(sql.GetColumns() == 5);
+	Vector<Vector<Value>> r;
+	while(sql.Fetch()) {
+		Vector<Value>& row = r.Add();
+		for(int i = 0; i < sql.GetColumns(); i++)
+			row.Add(sql[i]);
+	}
+	ASSERT(sql.GetRowsProcessed() == r.GetCount());
+	return r;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	const Vector<String>& arg = CommandLine();
+	
+	MySqlSession session;
+	if(!session.Connect(arg.GetCount() > 0 ? ~arg[0] : "test", arg.GetCount() > 1 ? ~arg[1] : "test",
+	                    arg.GetCount() > 2 ? ~arg[2] : "test", arg.GetCount() > 3 ? ~arg[3] : "localhost")) {
+		LOG("No database, test skipped: " << session.GetLastError());
+		LOG("=========== OK");
+		return;
+	}
+
+	Sql sql(session);
+	sql.Execute("drop table STREAMTEST");
+	ASSERT(sql.Execute("create table STREAMTEST (ID integer primary key, NAME varchar(200), "
+	                   "AMOUNT double precision, DAY date, NOTE text)"));
+	int bulk = session.GetBulkInsertRows(5);
+	for(int i = 0; i < N; i += bulk) {
+		Vector< Vector<Value> > data;
+		data.SetCount(5);
+		for(int j = i; j < min(i + bulk, N); j++) {
+			data[0].Add(j);
+			data[1].Add("name of row number " + AsString(j));
+			data[2].Add(j * 1.5);
+			data[3].Add(j % 3 ? Value(Date(2020, 1, 1) + j) : Value());
+			data[4].Add(j % 5 ? Value(String('x', j % 1000)) : Value());
+		}
+		ASSERT(session.BulkInsert("STREAMTEST", { "ID", "NAME", "AMOUNT", "DAY", "NOTE" }, data));
+	}
+
+	Vector<Vector<Value>> stored = FetchAll(session, false);
+	Vector<Vector<Value>> streamed = FetchAll(session, true);
+	ASSERT(stored.GetCount() == N);
+	ASSERT(streamed == stored);
+
+	sql.StreamingFetch();
+	for(int pass = 0; pass < 3; pass++) { // rest of partially read result is discarded
+		ASSERT(sql.Execute("select ID from STREAMTEST order by ID"));
+		for(int i = 0; i < 10; i++)
+			ASSERT(sql.Fetch() && (int)sql[0] == i);
+		ASSERT(sql.GetRowsProcessed() == 10);
+		if(pass == 1)
+			sql.Cancel();
+		if(pass == 2) {
+			sql.Cancel();
+			Sql sql2(session); // other cursor can use the session after Cancel
+			ASSERT(sql2.Execute("select count(*) from STREAMTEST where ID < 100") && sql2.Fetch());
+			ASSERT((int)sql2[0] == 100);
+		}
+		ASSERT(sql.Execute("select count(*) from STREAMTEST") && sql.Fetch());
+		ASSERT((int)sql[0] == N);
+		ASSERT(!sql.Fetch());
+	}
+	
+	session.StreamingFetch(); // as set for session
+	ASSERT(FetchAll(session, false) == stored);
+	session.NoStreamingFetch();
+
+	sql.NoStreamingFetch();
+	sql.Execute("drop table STREAMTEST");
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,125 @@
+#include <PdfDraw/PdfDraw.h>
+
+using namespace Upp;
+
+Image MakeImage()
+{
+	ImageBuffer ib(50, 50);
+	for(int y = 0; y < 50; y++)
+		for(int x = 0; x < 50; x++)
+			ib[y][x] = RGBA(Color(x * 5, y * 5, 100));
+	return Image(ib);
+}
+
+String MakeJPEG()
+{ // only header is checked by PdfDraw
+	String h = "\xff\xd8\xff\xe0";
+	for(int i = 0; i < 1000; i++)
+		h.Cat(i);
+	return h;
+}
+
+void DrawDoc(PdfDraw& w, int pages)
+{
+	Image img = MakeImage();
+	Image img2 = MakeImage(); // different serial, same data
+	for(int i = 0; i < pages; i++) {
+		if(i)
+			w.StartPage();
+		w.DrawRect(100, 100 + i, 1000, 1000, Color(i % 256, 0, 0));
+		w.DrawImage(200, 200, i & 1 ? img : MakeImage(), RectC(0, 0, 50, 50));
+		w.DrawImage(300, 300, img2);
+		DrawJPEG(w, 400, 400, 100, 100, MakeJPEG()); // new String each time
+		w.DrawEllipse(500, 500, 400, 300, Blue());
+		w.EndPage();
+	}
+}
+
+int Count(const String& pdf, const char *s)
+{
+	int n = 0;
+	for(int q = 0; (q = pdf.Find(s, q)) >= 0; q++)
+		n++;
+	return n;
+}
+
+void Check(const String& pdf, int pages)
+{
+	ASSERT(pdf.StartsWith("%PDF-1.7\n"));
+	ASSERT(Count(pdf, "%PDF-") == 1);
+	int q = pdf.ReverseFind("startxref");
+	ASSERT(q > 0);
+	int xref = ScanInt(pdf.Mid(q + 10));
+	ASSERT(pdf.Mid(xref, 4) == "xref");
+	Vector<String> ln = Split(pdf.Mid(xref), CharFilterCrLf);
+	int n = atoi(Split(ln[1], ' ')[1]);
+	ASSERT(n > 1);
+	for(int i = 1; i < n; i++) {
+		int pos = ScanInt(ln[i + 2]);
+		String h = AsString(i) + " 0 obj\n";
+		ASSERT(pdf.Mid(pos, h.GetCount()) == h);
+	}
+	ASSERT(Count(pdf, "/Subtype /Image") == 1); // equal images are stored once
+	ASSERT(Count(pdf, "/Subtype/Image") == 1); // and equal JPEGs too
+	ASSERT(Count(pdf, "/Type /Page\n") == pages);
+}
+
+String NoId(const String& pdf)
+{ // document ID is random
+	int q = pdf.Find("/ID [");
+	ASSERT(q >= 0);
+	return pdf.Mid(0, q) + pdf.Mid(pdf.Find(']', q));
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	for(int pages : { 1, 5, 32, 33, 100 }) {
+		PdfDraw mem;
+		DrawDoc(mem, pages);
+		String a = mem.Finish();
+		Check(a, pages);
+
+		StringStream ss;
+		PdfDraw w(ss);
+		DrawDoc(w, pages);
+		ASSERT(w.GetPageCount() == pages);
+		ASSERT(w.Finish().IsEmpty());
+		String b = ss.GetResult();
+		Check(b, pages);
+		ASSERT(NoId(a) == NoId(b));
+		LOG(pages << " pages: " << b.GetCount() << " bytes");
+	}
+
+	{ // Clear detaches the stream
+		StringStream ss;
+		PdfDraw w(ss);
+		DrawDoc(w, 40);
+		int64 len = ss.GetSize();
+		ASSERT(len > 0);
+		w.Clear();
+		w.StartPage();
+		DrawDoc(w, 3);
+		String pdf = w.Finish();
+		Check(pdf, 3);
+		ASSERT(ss.GetSize() == len);
+	}
+
+	{ // destroyed while pages are being compressed
+		StringStream ss;
+		PdfDraw w(ss);
+		DrawDoc(w, 70);
+	}
+
+	{ // streamed document cannot be signed
+		StringStream ss;
+		PdfDraw w(ss);
+		DrawDoc(w, 3);
+		PdfSignatureInfo sign;
+		ASSERT(w.Finish(&sign).IsEmpty());
+		ASSERT(ss.IsError());
+	}
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,102 @@
+#include <PostgreSQL/PostgreSQL.h>
+
+using namespace Upp;
+
+// Values as sent by server in binary format
+
+String BE(int64 x, int bytes)
+{
+	String r;
+	while(bytes--)
+		r.Cat((byte)(x >> (8 * bytes)));
+	return r;
+}
+
+String Numeric(int weight, int sign, std::initializer_list<int> digits)
+{
+	String r = BE(digits.size(), 2) + BE(weight, 2) + BE(sign, 2) + BE(0, 2);
+	for(int d : digits)
+		r.Cat(BE(d, 2));
+	return r;
+}
+
+Value Get(Oid oid, const String& data)
+{
+	ASSERT(PostgreSQLIsBinaryType(oid));
+	return PostgreSQLBinaryValue(oid, data, data.GetCount());
+}
+
+const int64 USEC = 1000000;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	enum { BOOL = 16, BYTEA = 17, INT8 = 20, INT2 = 21, INT4 = 23, TEXT = 25, OID = 26, JSON = 114,
+	       FLOAT4 = 700, FLOAT8 = 701, VARCHAR = 1043, DATE = 1082, TIME = 1083, TIMESTAMP = 1114,
+	       TIMESTAMPTZ = 1184, INTERVAL = 1186, NUMERIC = 1700, UUID = 2950, JSONB = 3802,
+	       INT4ARRAY = 1007 };
+
+	ASSERT(Get(BOOL, BE(1, 1)) == "1");
+	ASSERT(Get(BOOL, BE(0, 1)) == "0");
+	ASSERT(Get(INT2, BE(-2, 2)) == -2);
+	ASSERT(Get(INT4, BE(0x01020304, 4)) == 0x01020304);
+	ASSERT(Get(INT4, BE(-7, 4)) == -7);
+	ASSERT(Get(INT8, BE(-1234567890123, 8)) == (int64)-1234567890123);
+	ASSERT(Get(OID, BE(0xfffffffe, 4)) == (int64)0xfffffffe);
+
+	{
+		float f = 1.5f;
+		dword h;
+		memcpy(&h, &f, 4);
+		ASSERT(Get(FLOAT4, BE(h, 4)) == 1.5);
+		double d = -2.25;
+		uint64 h8;
+		memcpy(&h8, &d, 8);
+		ASSERT(Get(FLOAT8, BE(h8, 8)) == -2.25);
+	}
+
+	ASSERT(fabs((double)Get(NUMERIC, Numeric(1, 0, { 1, 2345, 6780 })) - 12345.678) < 1e-9);
+	ASSERT(fabs((double)Get(NUMERIC, Numeric(1, 0x4000, { 1, 2345, 6780 })) + 12345.678) < 1e-9);
+	ASSERT(fabs((double)Get(NUMERIC, Numeric(-1, 0, { 5 })) - 0.0005) < 1e-15);
+	ASSERT(Get(NUMERIC, Numeric(2, 0, { 7 })) == 700000000.0);
+	ASSERT(Get(NUMERIC, Numeric(0, 0, {})) == 0.0);
+	ASSERT(std::isnan((double)Get(NUMERIC, Numeric(0, 0xc000, {}))));
+
+	ASSERT(Get(DATE, BE(0, 4)) == Date(2000, 1, 1));
+	ASSERT(Get(DATE, BE(-1, 4)) == Date(1999, 12, 31));
+	ASSERT(Get(DATE, BE(7305, 4)) == Date(2020, 1, 1));
+	ASSERT(IsNull(Get(DATE, BE(INT_MAX, 4)))); // infinity
+
+	int64 t = (7305 * 86400 + 12 * 3600 + 30 * 60 + 15) * USEC;
+	ASSERT(Get(TIMESTAMP, BE(t + 500000, 8)) == Time(2020, 1, 1, 12, 30, 15));
+	ASSERT(Get(TIMESTAMP, BE(-1, 8)) == Time(1999, 12, 31, 23, 59, 59));
+	ASSERT(IsNull(Get(TIMESTAMP, BE(INT64_MAX, 8))));
+	ASSERT(Get(TIME, BE(45015 * USEC, 8)) == Time(1970, 1, 1, 12, 30, 15));
+
+#ifdef PLATFORM_POSIX
+	setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1); // timestamptz is received in UTC
+	tzset();
+	ASSERT(Get(TIMESTAMPTZ, BE(t, 8)) == Time(2020, 1, 1, 13, 30, 15));
+	int64 summer = (int64)(Date(2020, 7, 1) - Date(2000, 1, 1)) * 86400 * USEC + t - 7305 * 86400 * USEC;
+	ASSERT(Get(TIMESTAMPTZ, BE(summer, 8)) == Time(2020, 7, 1, 14, 30, 15));
+	ASSERT(Get(TIMESTAMPTZ, BE(-USEC, 8)) == Time(2000, 1, 1, 0, 59, 59));
+#endif
+	ASSERT(IsNull(Get(TIMESTAMPTZ, BE(INT64_MIN, 8))));
+
+	ASSERT(Get(UUID, ScanHexString("00112233445566778899aabbccddeeff")) == "00112233-4455-6677-8899-aabbccddeeff");
+	String bytes("\0\1\2\377", 4);
+	ASSERT(Get(BYTEA, bytes) == bytes);
+	ASSERT(Get(TEXT, "text") == "text");
+	ASSERT(Get(VARCHAR, "") == "");
+	ASSERT(Get(JSON, "{\"a\":1}") == "{\"a\":1}");
+	ASSERT(Get(JSONB, "\1{\"a\":1}") == "{\"a\":1}");
+	ASSERT(PostgreSQLBinaryValue(JSONB, "\2{}", 3).IsError());
+
+	for(Oid oid : { INTERVAL, INT4ARRAY }) { // these are refused by Execute
+		ASSERT(!PostgreSQLIsBinaryType(oid));
+		ASSERT(PostgreSQLBinaryValue(oid, "\0\0\0\0\0\0\0\0", 8).IsError());
+	}
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,96 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+void Inner()
+{
+	RZONE("inner");
+	int64 t0 = nsecs();
+	while(nsecs() - t0 < 2000); // about 2us
+}
+
+void Outer()
+{
+	RZONE_FUNCTION();
+	for(int i = 0; i < 3; i++)
+		Inner();
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Outer(); // not active, nothing recorded
+	
+	StartProfiler(1000);
+	CoFor(100, [](int) { Outer(); });
+	StopProfiler();
+
+	Outer();
+
+	int outer = 0, inner = 0, jobs = 0;
+	for(int i = 0; i < GetProfilerThreadCount(); i++)
+		for(const ProfileEvent& e : GetProfilerEvents(i)) {
+			ASSERT(e.end >= e.start);
+			String n = e.name;
+			if(n == "Outer")
+				outer++;
+			if(n == "inner") {
+				inner++;
+				ASSERT(e.end - e.start >= 2000);
+			}
+			if(n == "CoWork job")
+				jobs++;
+		}
+	DUMP(outer);
+	DUMP(inner);
+	DUMP(jobs);
+	ASSERT(outer == 100);
+	ASSERT(inner == 300);
+	ASSERT(jobs <= 100);
+	
+	String summary = GetProfilerSummary();
+	LOG(summary);
+	ASSERT(summary.Find("inner") >= 0);
+
+	Value trace = ParseJSON(GetProfilerTrace());
+	ASSERT(!trace.IsError());
+	int complete = 0;
+	for(Value e : trace["traceEvents"])
+		if(e["ph"] == "X") {
+			ASSERT((double)e["dur"] >= 0);
+			complete++;
+		}
+	ASSERT(complete == outer + inner + jobs);
+
+	ClearProfiler();
+	for(int i = 0; i < GetProfilerThreadCount(); i++)
+		ASSERT(GetProfilerEvents(i).GetCount() == 0);
+
+	StartProfiler(1000); // ring buffer keeps last 1024 events
+	for(int i = 0; i < 1000; i++)
+		Outer();
+	StopProfiler();
+	int n = 0;
+	for(int i = 0; i < GetProfilerThreadCount(); i++)
+		n += GetProfilerEvents(i).GetCount();
+	ASSERT(n == 1024);
+
+	int threads = GetProfilerThreadCount();
+	StartProfiler(1000); // buffers of finished threads are reused
+	for(int i = 0; i < 20; i++) {
+		Thread t;
+		t.Run([] { Outer(); });
+		t.Wait();
+	}
+	StopProfiler();
+	DUMP(GetProfilerThreadCount());
+	ASSERT(GetProfilerThreadCount() <= threads + 1);
+
+	{
+		RTIMING("RTIMING");
+		Inner();
+	}
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,126 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+template <class T, class Gen>
+void Check(const char *name, int n, Gen gen)
+{
+	Vector<T> data;
+	for(int i = 0; i < n; i++)
+		data.Add(gen());
+	Vector<T> expected = clone(data);
+	StableSort(expected);
+
+	Vector<T> v = clone(data);
+	RadixSort(v);
+	ASSERT(v == expected);
+
+	v = clone(data);
+	CoRadixSort(v);
+	ASSERT(v == expected);
+
+	ASSERT(GetRadixSortOrder(data) == GetStableSortOrder(data));
+	ASSERT(CoGetRadixSortOrder(data) == GetStableSortOrder(data));
+
+	Vector<int> index;
+	for(int i = 0; i < n; i++)
+		index.Add(i);
+	v = clone(data);
+	CoRadixIndexSort(v, index);
+	ASSERT(v == expected);
+	ASSERT(index == GetStableSortOrder(data));
+
+	LOG(name << " " << n << " OK");
+}
+
+enum Level { LOW = -1, MEDIUM, HIGH };
+
+struct Item : Moveable<Item> {
+	String name;
+	double value;
+	int    id;
+};
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	for(int n : { 0, 1, 2, 100, 10000, 300000 }) {
+		Check<int>("int", n, [] { return (int)Random() - INT_MAX / 2; });
+		Check<int>("small int", n, [] { return (int)Random(10) - 5; });
+		Check<dword>("dword", n, [] { return Random(); });
+		Check<int64>("int64", n, [] { return (int64)Random64() - INT64_MAX / 2; });
+		Check<int16>("int16", n, [] { return (int16)Random(); });
+		Check<byte>("byte", n, [] { return (byte)Random(); });
+		Check<double>("double", n, [] { return (Randomf() - 0.5) * pow(10.0, (int)Random(40) - 20); });
+		Check<float>("float", n, [] { return float(Randomf() - 0.5); });
+		Check<String>("String", n, [] { return AsString(Random()); });
+		Check<String>("String prefix", n, [] {
+			return String('x', Random(200)) + String('a' + Random(3), Random(3)) + AsString(Random(1000));
+		});
+		Check<String>("String binary", n, [] {
+			String s;
+			for(int i = Random(5); i--;)
+				s.Cat(Random(256));
+			return s;
+		});
+	}
+
+	double values[] = { -1e300, -1.5, -0.0, 0.0, 1e-300, 2.5, 1e300 };
+	Vector<double> dv;
+	for(int i = 0; i < 1000; i++)
+		dv.Add(values[Random(__countof(values))]);
+	RadixSort(dv);
+	for(int i = 1; i < dv.GetCount(); i++)
+		ASSERT(dv[i - 1] <= dv[i]);
+
+	Vector<Level> level;
+	for(int i = 0; i < 1000; i++)
+		level.Add(Level((int)Random(3) - 1));
+	RadixSort(level);
+	for(int i = 1; i < level.GetCount(); i++)
+		ASSERT(level[i - 1] <= level[i]);
+
+	Array<Item> item; // key extractors, stability
+	for(int i = 0; i < 200000; i++) {
+		Item& m = item.Add();
+		m.name = AsString(Random(1000));
+		m.value = Random(100) / 10.0;
+		m.id = i;
+	}
+	auto by_name = [](const Item& a, const Item& b) { return a.name < b.name; };
+	auto by_value = [](const Item& a, const Item& b) { return a.value < b.value; };
+
+	Array<Item> expected = clone(item);
+	StableSort(expected, by_name);
+	Array<Item> h = clone(item);
+	RadixSort(h, [](const Item& m) -> const String& { return m.name; });
+	for(int i = 0; i < h.GetCount(); i++)
+		ASSERT(h[i].id == expected[i].id);
+	h = clone(item);
+	CoRadixSort(h, [](const Item& m) { return m.name; });
+	for(int i = 0; i < h.GetCount(); i++)
+		ASSERT(h[i].id == expected[i].id);
+
+	expected = clone(item);
+	StableSort(expected, by_value);
+	h = clone(item);
+	CoRadixSort(h, [](const Item& m) { return m.value; });
+	for(int i = 0; i < h.GetCount(); i++)
+		ASSERT(h[i].id == expected[i].id);
+
+	Vector<String> key;
+	Vector<int> data;
+	for(int i = 0; i < 1000; i++) {
+		key.Add(AsString(Random(100)));
+		data.Add(i);
+	}
+	RadixIndexSort(key, data, [](const String& s) { return s.GetCount(); });
+	for(int i = 1; i < key.GetCount(); i++) {
+		ASSERT(key[i - 1].GetCount() <= key[i].GetCount());
+		if(key[i - 1].GetCount() == key[i].GetCount())
+			ASSERT(data[i - 1] < data[i]);
+	}
+
+	LOG("=========== OK");
+}
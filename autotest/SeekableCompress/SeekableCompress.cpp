@@ -0,0 +1,86 @@
+#include <plugin/lz4/lz4.h>
+#include <plugin/zstd/zstd.h>
+
+using namespace Upp;
+
+String Data(int len)
+{
+	String s;
+	int i = 0;
+	while(s.GetCount() < len)
+		s << "line " << i++ << (i % 3 ? " some text" : " and some other text") << '\n';
+	s.Trim(len);
+	return s;
+}
+
+template <class C, class D>
+void Check(int len, bool co)
+{
+	String data = Data(len);
+	StringStream ss;
+	{
+		C c;
+		c.Seekable();
+		c.Co(co);
+		c.Open(ss);
+		c.Put(data);
+	}
+	String z = ss.GetResult();
+	LOG(len << ' ' << co << " -> " << z.GetCount());
+	
+	{ // sequential read ignores the seek table
+		StringStream in(z);
+		D d(in);
+		d.Co(co);
+		ASSERT(d.IsSeekable());
+		ASSERT(d.GetSize() == len);
+		ASSERT(d.GetAll(len) == data);
+		ASSERT(d.IsEof());
+		ASSERT(!d.IsError());
+	}
+
+	StringStream in(z);
+	D d(in);
+	ASSERT(d.IsSeekable());
+	SeedRandom(len);
+	for(int i = 0; i < 200; i++) {
+		int pos = Random(len + 1);
+		int n = min((int)Random(3000000), len - pos);
+		d.Seek(pos);
+		ASSERT(d.GetPos() == pos);
+		ASSERT(d.Get(n) == data.Mid(pos, n));
+		ASSERT(d.GetPos() == pos + n);
+	}
+	d.Seek(len - min(len, 100));
+	ASSERT(d.Get(1000) == data.Mid(len - min(len, 100)));
+	ASSERT(d.IsEof());
+	ASSERT(!d.IsError());
+}
+
+template <class C, class D>
+void Check()
+{
+	for(int len : { 0, 1, 1000, 1024 * 1024, 1024 * 1024 + 1, 20 * 1024 * 1024 + 123 })
+		for(int co = 0; co < 2; co++)
+			Check<C, D>(len, co);
+	
+	StringStream ss;
+	{
+		C c(ss);
+		c.Put(Data(1000));
+	}
+	StringStream in(ss.GetResult());
+	D d(in);
+	ASSERT(!d.IsSeekable());
+	ASSERT(d.Get(2000) == Data(1000));
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	Check<LZ4CompressStream, LZ4DecompressStream>();
+	Check<ZstdCompressStream, ZstdDecompressStream>();
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,94 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#define PORT 27319
+#define N    200
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	SocketEventLoop loop;
+	
+	Vector<int> fired;
+	loop.SetTimer(30, [&] { fired.Add(30); });
+	loop.SetTimer(10, [&] { fired.Add(10); });
+	int id = loop.SetTimer(20, [&] { fired.Add(20); });
+	loop.KillTimer(id);
+	loop.Run();
+	DUMPC(fired);
+	ASSERT(fired.GetCount() == 2 && fired[0] == 10 && fired[1] == 30);
+
+	TcpSocket server;
+	ASSERT(server.Listen(PORT, 2 * N, false, true));
+	server.Timeout(0);
+
+	Array<TcpSocket> conn;
+	loop.Add(server, WAIT_READ, [&](dword) {
+		for(;;) { // edge-triggered: accept all pending connections
+			TcpSocket& s = conn.Add();
+			s.Timeout(0);
+			if(!s.Accept(server)) {
+				conn.Drop();
+				break;
+			}
+			loop.Add(s, WAIT_READ, [&](dword) {
+				for(;;) {
+					String line = s.GetLine();
+					if(line.IsVoid())
+						break;
+					if(line.StartsWith("GET ")) { // minimal http server for HttpRequest
+						while(s.GetLine().GetCount())
+							;
+						s.Timeout(Null);
+						s.Put("HTTP/1.1 200 OK\r\nContent-Length: 5\r\nConnection: close\r\n\r\nHello");
+						loop.Remove(s);
+						s.Close();
+						return;
+					}
+					s.Timeout(Null);
+					s.Put(line + "\n");
+					s.Timeout(0);
+				}
+				if(s.IsEof()) {
+					loop.Remove(s);
+					s.Close();
+				}
+			});
+		}
+	});
+	
+	Array<TcpSocket> client;
+	int echoed = 0;
+	for(int i = 0; i < N; i++) {
+		TcpSocket& c = client.Add();
+		ASSERT(c.Connect("127.0.0.1", PORT));
+		c.Timeout(0);
+		c.Put(AsString(i) + "\n");
+		loop.Add(c, WAIT_READ, [&, i](dword) {
+			String line = c.GetLine();
+			if(line.IsVoid())
+				return;
+			ASSERT(line == AsString(i));
+			loop.Remove(c);
+			c.Close();
+			echoed++;
+		});
+	}
+	
+	while(echoed < N && loop.Wait(5000) > 0)
+		;
+	DUMP(echoed);
+	ASSERT(echoed == N);
+	
+	HttpRequest r("http://127.0.0.1:" + AsString(PORT) + "/test");
+	bool finished = false;
+	r.AddTo(loop, [&] { finished = true; });
+	while(!finished && loop.Wait(5000) > 0)
+		;
+	DUMP(r.GetContent());
+	ASSERT(finished && r.IsSuccess() && r.GetContent() == "Hello");
+	
+	LOG("=========== OK");
+}
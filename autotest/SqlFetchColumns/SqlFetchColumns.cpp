@@ -0,0 +1,82 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+const int N = 2500;
+
+Value Expected(int row, int column)
+{
+	if(row % 7 == 3)
+		return Null;
+	switch(column) {
+	case 0: return row;
+	case 1: return (int64)row << 33;
+	case 2: return row * 0.25;
+	case 3: return "name " + AsString(row);
+	case 4: return Date(2020, 1, 1) + row;
+	case 5: return Time(2020, 1, 1, 12, 30, 15) + row * 3601;
+	}
+	return Null;
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session sqlite;
+	ASSERT(sqlite.Open(":memory:"));
+	Sql sql(sqlite);
+	ASSERT(sql.Execute("create table TEST (ID integer primary key, I integer, I64 integer, D double, "
+	                   "S text, DT date, TM datetime)"));
+	sqlite.Begin();
+	for(int i = 0; i < N; i++)
+		ASSERT(sql.Execute("insert into TEST(ID, I, I64, D, S, DT, TM) values (?, ?, ?, ?, ?, ?, ?)", i,
+		                   Expected(i, 0), Expected(i, 1), Expected(i, 2), Expected(i, 3),
+		                   Expected(i, 4), Expected(i, 5)));
+	sqlite.Commit();
+
+	Vector<int> id, ci;
+	Vector<int64> ci64;
+	Vector<double> cd;
+	Vector<String> cs;
+	Vector<Date> cdt;
+	Vector<Time> ctm;
+	ASSERT(sql.Execute("select ID, I, I64, D, S, DT, TM from TEST order by ID"));
+	int chunks = 0;
+	for(;;) { // appended in chunks
+		int n = sql.FetchColumns({ id, ci, ci64, cd, cs, cdt, ctm }, 1000);
+		ASSERT(n == min(N - 1000 * chunks, 1000));
+		if(n < 1000)
+			break;
+		chunks++;
+	}
+	ASSERT(chunks == 2);
+	ASSERT(!sql.Fetch());
+	ASSERT(id.GetCount() == N && ctm.GetCount() == N);
+	for(int i = 0; i < N; i++) {
+		ASSERT(id[i] == i);
+		ASSERT(ci[i] == Expected(i, 0));
+		ASSERT(ci64[i] == Expected(i, 1));
+		ASSERT(IsNull(cd[i]) ? IsNull(Expected(i, 2)) : cd[i] == Expected(i, 2));
+		ASSERT(cs[i] == Expected(i, 3));
+		ASSERT(cdt[i] == Expected(i, 4));
+		ASSERT(ctm[i] == Expected(i, 5));
+	}
+
+	{ // conversions, fewer vectors than columns, Value target
+		Vector<double> d;
+		Vector<String> s;
+		Vector<Value> v;
+		ASSERT(sql.Execute("select I, I, I64, D from TEST where ID < 10 order by ID"));
+		ASSERT(sql.FetchColumns({ d, s, v }) == 10);
+		for(int i = 0; i < 10; i++) {
+			ASSERT(IsNull(d[i]) ? i % 7 == 3 : d[i] == i);
+			ASSERT(s[i] == (i % 7 == 3 ? String() : AsString(i)));
+			ASSERT(v[i] == Expected(i, 1));
+		}
+		ASSERT(sql.FetchColumns({ d, s, v }) == 0);
+		ASSERT(d.GetCount() == 10);
+	}
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,140 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+std::atomic<int> connects;
+std::atomic<int> active;
+std::atomic<int> max_active;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	String path = GetHomeDirFile("SqlSessionPool.db");
+	DeleteFile(path);
+	{
+		Sqlite3Session sqlite;
+		sqlite.Open(path);
+		Sql sql(sqlite);
+		sql.Execute("create table TEST (ID integer primary key, NAME text)");
+		for(int i = 0; i < 100; i++)
+			sql.Execute("insert into TEST(ID, NAME) values (?, ?)", i, AsString(i));
+	}
+
+	SqlSessionPool pool;
+	pool.WhenConnect = [&]() -> SqlSession * {
+		connects++;
+		Sqlite3Session *s = new Sqlite3Session;
+		if(!s->Open(path)) {
+			delete s;
+			return NULL;
+		}
+		return s;
+	};
+	pool.MinSize(2).MaxSize(4);
+	
+	pool.Maintain();
+	ASSERT(pool.GetCount() == 2 && pool.GetIdleCount() == 2);
+
+	CoWork co;
+	std::atomic<int> rows(0);
+	for(int i = 0; i < 200; i++)
+		co & [&, i] {
+			SqlSessionPool::Lease s = pool.Get();
+			ASSERT(s);
+			int n = ++active;
+			int m = max_active;
+			while(n > m && !max_active.compare_exchange_weak(m, n))
+				;
+			Sql sql(*s);
+			sql.Execute("select NAME from TEST where ID = ?", i % 100);
+			if(sql.Fetch() && sql[0] == AsString(i % 100))
+				rows++;
+			Sleep(1);
+			active--;
+		};
+	co.Finish();
+	
+	DUMP(pool.GetStats());
+	ASSERT(rows == 200);
+	ASSERT(max_active <= 4);
+	ASSERT(pool.GetCount() <= 4);
+	ASSERT(connects == pool.GetCount());
+	ASSERT(pool.GetStats().leases == 200);
+	
+	{ // transaction is rolled back when lease ends
+		SqlSessionPool::Lease s = pool.Get();
+		s->Begin();
+		Sql sql(*s);
+		sql.Execute("delete from TEST");
+	}
+	for(int i = 0; i < 4; i++) {
+		SqlSessionPool::Lease s = pool.Get();
+		ASSERT(s->GetTransactionLevel() == 0);
+		Sql sql(*s);
+		ASSERT(sql.Execute("select count(*) from TEST") && sql.Fetch() && (int)sql[0] == 100);
+	}
+
+	{ // wait for lease and timeout
+		Vector<SqlSessionPool::Lease> lease;
+		for(int i = 0; i < 4; i++)
+			lease.Add(pool.Get());
+		ASSERT(pool.GetIdleCount() == 0);
+		int t0 = msecs();
+		ASSERT(!pool.Get(100));
+		ASSERT(msecs(t0) >= 90);
+		ASSERT(pool.GetStats().timeouts == 1);
+		
+		Thread t;
+		t.Run([&] { Sleep(100); lease.Remove(0); });
+		SqlSessionPool::Lease s = pool.Get(5000);
+		ASSERT(s);
+		t.Wait();
+		SqlSessionPool::Stats st = pool.GetStats();
+		DUMP(st);
+		ASSERT(st.max_wait_time >= 50 && st.leased == 4);
+		
+		SqlSessionPool::Lease s2 = pick(s);
+		ASSERT(!s && s2);
+	}
+
+	{ // closed session is discarded on release
+		pool.ValidateAfter(0);
+		SqlSessionPool::Lease s = pool.Get();
+		((Sqlite3Session&)*s).Close();
+		s.Release();
+		ASSERT(pool.GetCount() == 3);
+		s = pool.Get();
+		ASSERT(s && s->IsOpen());
+	}
+
+	pool.IdleTimeout(50);
+	Sleep(100);
+	pool.Maintain();
+	ASSERT(pool.GetCount() == 2);
+	
+	SqlSessionPool::Stats st = pool.GetStats();
+	DUMP(st);
+	ASSERT(st.evicted == 1 && st.discarded == 1);
+	ASSERT(st.utilization > 0 && st.utilization <= 1);
+	
+	{ // session leased during Clear is closed when released
+		SqlSessionPool::Lease s = pool.Get();
+		pool.Clear();
+		ASSERT(pool.GetCount() == 1 && pool.GetIdleCount() == 0);
+		Sql sql(*s);
+		ASSERT(sql.Execute("select count(*) from TEST") && sql.Fetch() && (int)sql[0] == 100);
+		s.Release();
+		ASSERT(pool.GetCount() == 0);
+		s = pool.Get();
+		ASSERT(s && s->IsOpen() && pool.GetCount() == 1);
+	}
+	ASSERT(pool.GetStats().discarded == 1);
+
+	pool.Clear();
+	ASSERT(pool.GetCount() == 0);
+
+	DeleteFile(path);
+
+	LOG("=========== OK");
+}
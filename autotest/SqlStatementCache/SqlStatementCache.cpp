@@ -0,0 +1,144 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	Sqlite3Session sqlite;
+	ASSERT(sqlite.Open(":memory:"));
+	Sql sql(sqlite);
+	ASSERT(sqlite.GetStatementCache() == 32);
+
+	sql.Execute("create table TEST (ID integer primary key, NAME text)");
+	for(int i = 0; i < 1000; i++) {
+		String name = String('x', 50) + FormatIntDec(i, 4, '0');
+		ASSERT(sql.Execute("insert into TEST(ID, NAME) values (?, ?)", i, name));
+	}
+	int64 hits = sqlite.GetStatementCacheHits();
+	int64 misses = sqlite.GetStatementCacheMisses();
+	DUMP(hits);
+	DUMP(misses);
+	ASSERT(hits >= 999);
+
+	auto Hits = [&] { int64 h = sqlite.GetStatementCacheHits() - hits; hits += h; return (int)h; };
+	auto Misses = [&] { int64 m = sqlite.GetStatementCacheMisses() - misses; misses += m; return (int)m; };
+
+	const char *select = "select ID from TEST where NAME >= ? order by ID";
+	for(int pass = 0; pass < 100; pass++) { // parameters are bound without copy, they have to outlive Value
+		int from = pass * 7;
+		{
+			String name = String('x', 50) + FormatIntDec(from, 4, '0');
+			ASSERT(sql.Execute(select, name));
+		}
+		Vector<String> clobber; // reuses memory of destroyed parameter
+		for(int i = 0; i < 100; i++)
+			clobber.Add(String('y', 54));
+		int n = 0;
+		while(sql.Fetch())
+			ASSERT(sql[0] == from + n++);
+		ASSERT(n == 1000 - from);
+	}
+	sql.Cancel();
+	ASSERT(Misses() == 1 && Hits() == 99);
+
+	{ // canceled statement is reset before it is used again
+		ASSERT(sql.Execute(select, "a"));
+		ASSERT(sql.Fetch() && sql[0] == 0);
+		ASSERT(sql.Fetch() && sql[0] == 1);
+		sql.Cancel();
+		ASSERT(Hits() == 1);
+		ASSERT(sql.Execute(select, "a"));
+		ASSERT(sql.Fetch() && sql[0] == 0);
+		ASSERT(Hits() == 1);
+		sql.Cancel();
+	}
+
+	{ // statement used by two cursors is prepared twice
+		Sql sql2(sqlite);
+		ASSERT(sql.Execute(select, "a"));
+		ASSERT(sql2.Execute(select, String('x', 50) + "0500"));
+		ASSERT(Hits() == 1 && Misses() == 1);
+		ASSERT(sql.Fetch() && sql[0] == 0);
+		ASSERT(sql2.Fetch() && sql2[0] == 500);
+		sql.Cancel();
+		sql2.Cancel();
+		ASSERT(sql.Execute(select, "a"));
+		ASSERT(sql2.Execute(select, "a"));
+		ASSERT(Hits() == 1 && Misses() == 1);
+		sql.Cancel();
+		sql2.Cancel();
+	}
+
+	{ // least recently used statement is evicted
+		sqlite.StatementCache(2);
+		auto Run = [&](int i) {
+			ASSERT(sql.Execute("select " + AsString(i)));
+			ASSERT(sql.Fetch() && sql[0] == i);
+			sql.Cancel();
+		};
+		Run(1);
+		Run(2);
+		Run(3); // evicts 1
+		ASSERT(Misses() == 3 && Hits() == 0);
+		Run(2); // 2 becomes most recently used
+		ASSERT(Hits() == 1);
+		Run(1); // evicts 3
+		ASSERT(Misses() == 1);
+		Run(2);
+		ASSERT(Hits() == 1);
+		Run(3);
+		ASSERT(Misses() == 1);
+		sqlite.StatementCache(32);
+	}
+
+	{ // failed statements are not cached
+		const char *insert = "insert into TEST(ID, NAME) values (?, ?)";
+		ASSERT(!sql.Execute(insert, 1, "duplicate"));
+		DUMP(sqlite.GetLastError());
+		sql.Cancel();
+		ASSERT(!sql.Execute(insert, 2, "duplicate"));
+		sql.Cancel();
+		ASSERT(Misses() == 2 && Hits() == 0);
+		ASSERT(sql.Execute(insert, 1000, String('x', 50) + "1000"));
+		sql.Cancel();
+		ASSERT(sql.Execute(insert, 1001, String('x', 50) + "1001"));
+		sql.Cancel();
+		ASSERT(Misses() == 1 && Hits() == 1);
+		ASSERT(!sql.Execute("select * from NONEXISTENT"));
+		ASSERT(!sql.Execute("select * from NONEXISTENT"));
+		ASSERT(Misses() == 2);
+		ASSERT(sql.Execute(select, String('x', 50) + "0999"));
+		ASSERT(sql.Fetch() && sql[0] == 999);
+		ASSERT(sql.Fetch() && sql[0] == 1000);
+		ASSERT(sql.Fetch() && sql[0] == 1001);
+		ASSERT(!sql.Fetch());
+		sql.Cancel();
+		ASSERT(Misses() == 1); // evicted by the previous block
+	}
+
+	{ // cached statement is prepared again after schema change
+		ASSERT(sql.Execute("select * from TEST where ID = 1"));
+		ASSERT(sql.GetColumns() == 2);
+		sql.Cancel();
+		ASSERT(sql.Execute("alter table TEST add column VALUE integer"));
+		ASSERT(sql.Execute("select * from TEST where ID = 1"));
+		ASSERT(sql.GetColumns() == 3);
+		ASSERT(Misses() == 2 && Hits() == 1);
+		ASSERT(sql.Fetch() && sql[0] == 1 && IsNull(sql[2]));
+		sql.Cancel();
+	}
+
+	sqlite.NoStatementCache();
+	ASSERT(sql.Execute(select, "a"));
+	ASSERT(sql.Execute(select, "a"));
+	ASSERT(Hits() == 0 && Misses() == 0);
+	sqlite.StatementCache(8);
+
+	ASSERT(sql.Execute(select, "a"));
+	sql.Cancel();
+	sqlite.Close(); // finalizes cached statements before closing the database
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,104 @@
+#include <CtrlLib/CtrlLib.h>
+
+using namespace Upp;
+
+Vector<String> model;
+
+int64 ModelPos(int line, int column)
+{
+	int64 pos = column;
+	for(int i = 0; i < line; i++)
+		pos += model[i].GetCount() + 1;
+	return pos;
+}
+
+int ModelLine(int64& pos)
+{
+	for(int i = 0; i < model.GetCount(); i++) {
+		if(pos <= model[i].GetCount())
+			return i;
+		pos -= model[i].GetCount() + 1;
+	}
+	NEVER();
+	return -1;
+}
+
+String RandomText()
+{
+	String r;
+	int n = decode(Random(20), 0, Random(5000), 1, Random(50), Random(3));
+	for(int i = 0; i < n; i++)
+		r << String('a' + Random(26), Random(10)) << '\n';
+	r << String('A' + Random(26), Random(10));
+	return r;
+}
+
+void Check(LineEdit& edit, bool full)
+{
+	ASSERT(edit.GetLineCount() == model.GetCount());
+	int64 len = ModelPos(model.GetCount() - 1, model.Top().GetCount());
+	ASSERT(edit.GetLength64() == len);
+	if(full)
+		for(int i = 0; i < model.GetCount(); i++)
+			ASSERT(edit.GetUtf8Line(i) == model[i]);
+	for(int i = 0; i < 100; i++) {
+		int line = Random(model.GetCount());
+		ASSERT(edit.GetUtf8Line(line) == model[line]);
+		int column = Random(model[line].GetCount() + 1);
+		int64 pos = ModelPos(line, column);
+		ASSERT(edit.GetPos64(line, column) == pos);
+		ASSERT(edit.GetLinePos64(pos) == line && pos == column);
+	}
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	SeedRandom(0);
+
+	LineEdit edit;
+
+	String text;
+	for(int i = 0; i < 3000; i++)
+		text << "Line " << i << "\n";
+	edit.Set(text);
+	model = Split(text, '\n', false);
+	Check(edit, true);
+
+	for(int pass = 0; pass < 20000; pass++) {
+		if(Random(2) || model.GetCount() < 100) {
+			String s = RandomText();
+			int line = Random(model.GetCount());
+			int column = Random(model[line].GetCount() + 1);
+			edit.Insert((int)ModelPos(line, column), s);
+			Vector<String> ins = Split(s, '\n', false);
+			String tail = model[line].Mid(column);
+			model[line].Trim(column);
+			model[line] << ins[0];
+			ins.Remove(0);
+			int n = ins.GetCount();
+			model.Insert(line + 1, pick(ins));
+			model[line + n] << tail;
+		}
+		else {
+			int64 pos = Random((int)edit.GetLength64());
+			int64 count = min(edit.GetLength64() - pos, (int64)decode(Random(10), 0, Random(100000), 1, Random(2000), Random(50)));
+			edit.Remove((int)pos, (int)count);
+			int64 endpos = pos + count;
+			int line = ModelLine(pos);
+			int endline = ModelLine(endpos);
+			model[line] = model[line].Left((int)pos) + model[endline].Mid((int)endpos);
+			model.Remove(line + 1, endline - line);
+		}
+		Check(edit, pass % 1000 == 0);
+	}
+	Check(edit, true);
+	DUMP(model.GetCount());
+
+	edit.Clear();
+	model = { "" };
+	Check(edit, true);
+
+	LOG("=========== OK");
+}
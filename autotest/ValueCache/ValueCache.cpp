@@ -0,0 +1,80 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+std::atomic<int> made;
+
+Value Make(int i)
+{
+	return MakeValue(
+		[&] { return AsString(i); },
+		[&](Value& v) { made++; v = i; return 100; }
+	);
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	
+	SetupValueCache(100000000, 100000);
+	ClearValueCacheStats();
+
+	for(int pass = 0; pass < 3; pass++)
+		for(int i = 0; i < 1000; i++)
+			ASSERT(Make(i) == i);
+	for(int i = 0; i < 100; i++)
+		ASSERT(Make(0) == 0);
+	ValueCacheStats st = GetValueCacheStats();
+	DUMP(st);
+	ASSERT(made == 1000);
+	ASSERT(st.misses == 1000);
+	ASSERT(st.hits == 2100);
+	ASSERT(st.front_hits >= 96); // every 32nd is refreshed in shard LRU
+	ASSERT(st.count == 1000);
+	
+	ASSERT(ValueCacheRemove([](const Value& v) { return (int)v < 500; }) == 500);
+	for(int i = 0; i < 1000; i++) // removed values have to be made again even if in front cache
+		ASSERT(Make(i) == i);
+	ASSERT(made == 1500);
+	
+	for(int i = 1000; i < 2000; i++)
+		ASSERT(Make(i) == i);
+	CoFor(100000, [&](int i) {
+		int q = i % 2000;
+		ASSERT(Make(q) == q);
+	});
+	st = GetValueCacheStats();
+	DUMP(st);
+	ASSERT(made == 2500);
+	ASSERT(st.count == 2000);
+	
+	SetupValueCache(100000000, 200);
+	ShrinkValueCache();
+	st = GetValueCacheStats();
+	DUMP(st);
+	ASSERT(st.count <= 200);
+	ASSERT(st.evictions >= 1800);
+	made = 0;
+	for(int i = 0; i < 2000; i++)
+		ASSERT(Make(i) == i);
+	ASSERT(made >= 1800);
+	
+	{ // evictions do not invalidate other front entries, item used from front cache is kept in LRU
+		SetupValueCache(100000000, 80);
+		ShrinkValueCache();
+		ASSERT(Make(20000) == 20000);
+		ClearValueCacheStats();
+		made = 0;
+		for(int i = 10000; i < 11000; i++) {
+			ASSERT(Make(i) == i);
+			ASSERT(Make(20000) == 20000);
+		}
+		st = GetValueCacheStats();
+		DUMP(st);
+		ASSERT(made == 1000);
+		ASSERT(st.evictions >= 1000);
+		ASSERT(st.front_hits >= 900);
+	}
+
+	LOG("=========== OK");
+}
@@ -0,0 +1,88 @@
+#include <Core/Core.h>
+#include <plugin/zip/zip.h>
+
+using namespace Upp;
+
+String Content(int i)
+{
+	String s;
+	int n = i * 37 % 5000;
+	for(int j = 0; j < n; j++)
+		s.Cat(i % 7 ? 'a' + (i + j) % 26 : j * i & 255);
+	return s;
+}
+
+String Path(int i)
+{
+	return Format("dir%d/file%d.txt", i % 10, i);
+}
+
+String MakeZip(bool co)
+{
+	StringZip zip;
+	Time tm(2024, 1, 1, 12, 0, 0);
+	zip.WriteFolder("empty", tm);
+	for(int i = 0; i < 2000; i++)
+		if(co)
+			zip.CoWriteFile(Content(i), Path(i), tm, i % 3);
+		else
+			zip.WriteFile(Content(i), Path(i), Null, tm, i % 3);
+	zip.WriteFile("last", "last", Null, tm);
+	return zip.Finish();
+}
+
+void Check(UnZip& unzip)
+{
+	ASSERT(!unzip.IsError());
+	ASSERT(unzip.GetCount() == 2002);
+	for(int i = 0; i < 2000; i++) {
+		int q = unzip.Find(Path(i));
+		ASSERT(q == i + 1);
+		ASSERT(unzip.Extract(q) == Content(i));
+		const byte *s = unzip.GetStored(q);
+		if(i % 3 == 0)
+			ASSERT(s && memcmp(s, ~Content(i), Content(i).GetCount()) == 0);
+		else
+			ASSERT(!s);
+	}
+	ASSERT(unzip.Find("nothing") < 0);
+	ASSERT(unzip.ReadFile("last") == "last");
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String serial = MakeZip(false);
+	String co = MakeZip(true);
+	ASSERT(serial == co); // CoWriteFile output is deterministic
+	
+	StringUnZip sunzip(co);
+	Check(sunzip);
+
+	MemUnZip munzip(~co, co.GetCount());
+	Check(munzip);
+	
+	String path = GetHomeDirFile("ZipParallel.zip");
+	SaveFile(path, co);
+	{
+		MappedUnZip unzip(path);
+		Check(unzip);
+		
+		String dir = GetHomeDirFile("ZipParallel.dir");
+		DeleteFolderDeep(dir);
+		ASSERT(unzip.ExtractAll(dir));
+		for(int i = 0; i < 2000; i++)
+			ASSERT(LoadFile(AppendFileName(dir, Path(i))) == Content(i));
+		ASSERT(DirectoryExists(AppendFileName(dir, "empty")));
+		DeleteFolderDeep(dir);
+	}
+	DeleteFile(path);
+	
+	StringZip bad;
+	bad.WriteFile("x", "../outside");
+	StringUnZip unzip(bad.Finish());
+	ASSERT(!unzip.ExtractAll(GetHomeDirFile("ZipParallel.dir")));
+	
+	LOG("=========== OK");
+}
@@ -20,6 +20,30 @@ void ThreadWork(int ii)
 		Work(ii);
 }
 
+void BigWork(int ii)
+{ // random access to big buffers is dominated by TLB misses and remote NUMA nodes
+	for(int i = 0; i < NCOUNT / 10; i++) {
+		Vector<int> h;
+		h.SetCount(4 * 1024 * 1024, ii);
+		dword q = ii;
+		for(int j = 0; j < 8 * 1024 * 1024; j++) {
+			q = 1664525 * q + 1013904223;
+			h[q & (4 * 1024 * 1024 - 1)]++;
+		}
+	}
+}
+
+void SetMemoryOptions()
+{ // -hugepages, -hugetlb, -numa
+	const Vector<String>& arg = CommandLine();
+	MemoryOptions o;
+	if(FindIndex(arg, "-hugepages") >= 0)
+		o.huge_pages = 1;
+	if(FindIndex(arg, "-hugetlb") >= 0)
+		o.huge_pages = 2;
+	o.numa = FindIndex(arg, "-numa") >= 0;
+}
+
 void ChrisTest();
 
 void sLarge(String& text, int *large, int count, const char *txt)
@@ -76,6 +100,7 @@ CONSOLE_APP_MAIN
 	ChrisTest();
 #else
 	StdLogSetup(LOG_FILE|LOG_COUT);
+	SetMemoryOptions();
 	String fn = GetDataFile("x.cpp");
 	fn = AppendFileName(GetFileFolder(GetFileFolder(GetFileFolder(fn))),
 	                    "uppsrc/CtrlLib/ArrayCtrl.cpp");
@@ -99,6 +124,15 @@ CONSOLE_APP_MAIN
 			co & callback1(Work, 0);
 	}
 	RLOG("CoWork (1000 runs): " << tm.Elapsed() << " ms");
+	for(int n = 1; n <= min(CPU_Cores(), MAX_THREADS); n = 2 * n) {
+		TimeStop tm;
+		for(int i = 0; i < n; i++)
+			x[i].Run(callback1(BigWork, i));
+		for(int i = 0; i < n; i++)
+			x[i].Wait();
+		RLOG(n << " thread(s) with big buffers " << tm.Elapsed() << " ms");
+	}
+	RLOG(MemoryProfile());
 #else
 	TimeStop tm;
 	for(int i = 0; i < 1000; i++)
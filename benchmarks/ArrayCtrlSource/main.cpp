@@ -0,0 +1,54 @@
+#include <CtrlLib/CtrlLib.h>
+
+using namespace Upp;
+
+GUI_APP_MAIN
+{
+	StdLogSetup(LOG_FILE|LOG_ELAPSED);
+
+#ifdef _DEBUG
+	int N = 100000;
+#else
+	int N = 10000000;
+#endif
+
+	int kb0 = MemoryUsedKb();
+	TimeStop tm;
+	ArrayCtrl plain;
+	plain.AddColumn("int");
+	plain.AddColumn("double");
+	plain.AddColumn("String");
+	for(int i = 0; i < N / 10; i++)
+		plain.Add((int)Random(), Randomf(), AsString(Random()));
+	RLOG("ArrayCtrl with " << N / 10 << " lines: " << tm << ", " << MemoryUsedKb() - kb0 << " KB");
+	plain.Clear();
+	plain.Shrink();
+
+	kb0 = MemoryUsedKb();
+	tm.Reset();
+	ArrayColumns data;
+	Vector<int>& ic = data.Add<int>();
+	Vector<double>& dc = data.Add<double>();
+	Vector<String>& sc = data.Add<String>();
+	for(int i = 0; i < N; i++) {
+		ic.Add((int)Random());
+		dc.Add(Randomf());
+		sc.Add(AsString(Random()));
+	}
+	RLOG("ArrayColumns with " << N << " lines: " << tm << ", " << MemoryUsedKb() - kb0 << " KB");
+
+	ArrayCtrl list;
+	list.AddColumn("int").Sorting();
+	list.AddColumn("double").Sorting();
+	list.AddColumn("String").Sorting();
+	list.SetSource(data);
+
+	TopWindow win;
+	win.Sizeable().Zoomable();
+	win.Add(list.SizePos());
+	list.WhenColumnSorted = [&] { tm.Reset(); win.Title("Sorting..."); };
+	list.WhenSourceReady = [&] {
+		win.Title(Format("%d lines, %d KB, sorted in %s", list.GetCount(), MemoryUsedKb(), tm.ToString()));
+	};
+	win.Run();
+}
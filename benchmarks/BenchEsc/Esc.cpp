@@ -2,44 +2,35 @@
 
 using namespace Upp;
 
-CONSOLE_APP_MAIN
+EscValue Run(ArrayMap<String, EscValue>& global, const char *fn, bool vm)
 {
-	RDUMP(sizeof(EscValue));
-
-	String code = LoadFile(GetDataFile("test.esc"));
-	ArrayMap<String, EscValue> global;
-
-	StdLib(global);
+	UseEscCompiler(vm);
+	return Execute(global, fn, INT_MAX);
+}
 
-	try {
-		Scan(global, code);
-		EscValue primes;
-		for(int i = 0; i < 100; i++)
-		{
-			RTIMING("run");
-			primes = Execute(global, "sieve", INT_MAX);
-		}
-		RDUMP(primes);
-	}
-	catch(CParser::Error e) {
-		RLOG(e);
-	}
+#define BENCH(file, fn) \
+try { \
+	ArrayMap<String, EscValue> global; \
+	StdLib(global); \
+	Scan(global, LoadFile(GetDataFile(file))); \
+	EscValue a, b; \
+	for(int i = 0; i < 100; i++) { \
+		{ RTIMING(fn " interpreter"); a = Run(global, fn, false); } \
+		{ RTIMING(fn " vm"); b = Run(global, fn, true); } \
+	} \
+	RLOG(fn << ": " << a.GetCount() << " items, " << (a == b ? "identical" : "DIFFERENT")); \
+} \
+catch(CParser::Error e) { \
+	RLOG(e); \
+}
 
-	code = LoadFile(GetDataFile("test2.esc"));
+CONSOLE_APP_MAIN
+{
+	RDUMP(sizeof(EscValue));
 
-	try {
-		Scan(global, code);
-		EscValue data_ptr;
-		for(int i = 0; i < 100; i++)
-		{
-			RTIMING("run test 2");
-			data_ptr = Execute(global, "test", INT_MAX);
-		}
-		RDUMP(data_ptr);
-	}
-	catch(CParser::Error e) {
-		RLOG(e);
-	}
+	BENCH("test.esc", "sieve");
+	BENCH("test2.esc", "test");
+	BENCH("test3.esc", "calls");
 
 	RLOG("");
 	RLOG("-----------------------");
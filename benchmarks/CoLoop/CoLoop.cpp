@@ -40,23 +40,42 @@ int64 SumLine(const char *s)
 
 int64 gsum;
 
+int64 Loop(const Vector<String>& data)
+{
+	CoWork co;
+	int64 sum = 0;
+	std::atomic<int> ii = 0;
+	co.Loop([&] {
+		int64 h = 0;
+		for(int i = ii++; i < data.GetCount(); i = ii++)
+			h += SumLine(data[i]);
+		CoWork::FinLock();
+		sum += h;
+	});
+	return sum;
+}
+
 CONSOLE_APP_MAIN
 {
 	Vector<String> data = TestData();
 	
+	if(CommandLine().GetCount() && CommandLine()[0] == "-scaling") {
+		StdLogSetup(LOG_FILE|LOG_COUT);
+		for(int n = 1;; n = min(2 * n, CPU_Cores())) {
+			CoWork::SetPoolSize(n);
+			TimeStop tm;
+			for(int i = 0; i < N / 10; i++)
+				gsum = Loop(data);
+			RLOG(n << " threads: " << tm.Elapsed() << " ms");
+			if(n >= CPU_Cores())
+				break;
+		}
+		return;
+	}
+
 	for(int i = 0; i < N; i++) {
 		RTIMING("ThreadLoop *");
-		CoWork co;
-		int64 sum = 0;
-		std::atomic<int> ii = 0;
-		co.Loop([&] {
-			int64 h = 0;
-			for(int i = ii++; i < data.GetCount(); i = ii++)
-				h += SumLine(data[i]);
-			CoWork::FinLock();
-			sum += h;
-		});
-		gsum = sum;
+		gsum = Loop(data);
 		DUMP(gsum);
 	}
 }
@@ -11,6 +11,59 @@ force_inline double Sum(const String& s)
 	return sum;
 }
 
+double SpawnSum(const Vector<String>& data, int l, int h)
+{ // recursive job spawning, exercises worker-local scheduling and stealing
+	if(h - l < 256) {
+		double m = 0;
+		for(int j = l; j < h; j++)
+			m += Sum(data[j]);
+		return m;
+	}
+	int mid = (l + h) / 2;
+	double a, b;
+	CoWork co;
+	co & [&] { a = SpawnSum(data, l, mid); };
+	b = SpawnSum(data, mid, h);
+	co.Finish();
+	return a + b;
+}
+
+void Scaling(const Vector<String>& data)
+{
+	StdLogSetup(LOG_FILE|LOG_COUT);
+	RLOG("threads, CoPartition ms, CoFor ms, spawn ms");
+	int n = 1;
+	for(;;) {
+		CoWork::SetPoolSize(n);
+		double sum1 = 0, sum2 = 0, sum3 = 0;
+		TimeStop tm1;
+		CoPartition(0, data.GetCount(), [&](int l, int h) {
+			double m = 0;
+			for(int j = l; j < h; j++)
+				m += Sum(data[j]);
+			CoWork::FinLock();
+			sum1 += m;
+		});
+		double t1 = tm1.Elapsed();
+		TimeStop tm2;
+		CoFor(data.GetCount(), [&](int i) {
+			double m = Sum(data[i]);
+			CoWork::FinLock();
+			sum2 += m;
+		});
+		double t2 = tm2.Elapsed();
+		TimeStop tm3;
+		sum3 = SpawnSum(data, 0, data.GetCount());
+		double t3 = tm3.Elapsed();
+		RLOG(n << ", " << t1 << ", " << t2 << ", " << t3);
+		ASSERT(sum1 == sum2 && sum2 == sum3);
+		if(n >= CPU_Cores())
+			break;
+		n = min(2 * n, CPU_Cores());
+	}
+	CoWork::SetPoolSize(CPU_Cores() + 2);
+}
+
 CONSOLE_APP_MAIN
 {
 	SeedRandom(0);
@@ -22,6 +75,12 @@ CONSOLE_APP_MAIN
 			data.Top() << Random() << ' ';
 	}
 	
+	if(CommandLine().GetCount() && CommandLine()[0] == "-scaling") {
+		Scaling(data);
+		return;
+	}
+
+	
 //	for(int i = 0; i < 10000; i++)
 	{
 		{
@@ -0,0 +1,70 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+const int N = 4000000; // operations in total
+const int KEYS = 500000;
+
+template <class F>
+int64 Run(int threads, F fn)
+{
+	int64 t0 = usecs();
+	Array<Thread> thread;
+	for(int t = 0; t < threads; t++)
+		thread.Add().Run([=] {
+			for(int i = t; i < N; i += threads)
+				fn(i);
+		});
+	for(Thread& t : thread)
+		t.Wait();
+	return usecs() - t0;
+}
+
+CONSOLE_APP_MAIN
+{
+	Vector<int> key;
+	for(int i = 0; i < N; i++)
+		key.Add((int)Random(KEYS));
+
+	RLOG("threads\tMutex + VectorMap\tConcurrentVectorMap (in ms)");
+	for(int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+		int64 tm, tc;
+		{
+			Mutex lock;
+			VectorMap<int, int> map;
+			tm = Run(threads, [&](int i) {
+				Mutex::Lock __(lock);
+				map.GetAdd(key[i], i);
+			});
+		}
+		{
+			ConcurrentVectorMap<int, int> map;
+			tc = Run(threads, [&](int i) {
+				map.GetAdd(key[i], i);
+			});
+		}
+		RLOG(threads << '\t' << tm / 1000 << '\t' << tc / 1000);
+	}
+	
+	RLOG("---- Find only");
+	RLOG("threads\tMutex + VectorMap\tConcurrentVectorMap (in ms)");
+	Mutex lock;
+	VectorMap<int, int> map;
+	ConcurrentVectorMap<int, int> cmap;
+	for(int i = 0; i < KEYS; i++) {
+		map.Add(i, i);
+		cmap.FindAdd(i, i);
+	}
+	for(int threads : { 1, 2, 4, 8, 16, 32, 64 }) {
+		int64 tm = Run(threads, [&](int i) {
+			Mutex::Lock __(lock);
+			if(map.Get(key[i]) != key[i])
+				Panic("Invalid result");
+		});
+		int64 tc = Run(threads, [&](int i) {
+			if(cmap.Get(key[i], -1) != key[i])
+				Panic("Invalid result");
+		});
+		RLOG(threads << '\t' << tm / 1000 << '\t' << tc / 1000);
+	}
+}
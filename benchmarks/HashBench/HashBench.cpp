@@ -4,8 +4,32 @@ using namespace Upp;
 
 #define LDUMP(x) x
 
+template <class I>
+void IndexBench(const char *name, const Vector<int>& data, int n)
+{
+	I ndx;
+	int64 t0 = usecs();
+	for(int i = 0; i < n; i++)
+		ndx.FindAdd(data[i]);
+	int64 t1 = usecs();
+	int found = 0;
+	for(int i = 0; i < n; i++)
+		found += ndx.Find(data[i] ^ (i & 1)) >= 0; // about half misses
+	int64 t2 = usecs();
+	RLOG(name << " " << n << " keys: insert " << 1000.0 * (t1 - t0) / n << " ns/key, lookup "
+	     << 1000.0 * (t2 - t1) / n << " ns/key, found " << found);
+}
+
 CONSOLE_APP_MAIN
 {
+	Vector<int> data;
+	for(int i = 0; i < 100000000; i++)
+		data.Add((int)Random() & ~1);
+	for(int n = 1000; n <= data.GetCount(); n *= 10) {
+		IndexBench<Index<int>>("Index", data, n);
+		IndexBench<FlatIndex<int>>("FlatIndex", data, n);
+	}
+
 	String s;
 	for(int i = 0; i < 1000000; i++)
 		s.Cat(Random());
@@ -11,9 +11,21 @@ struct Record {
 	size_t sz;
 };
 
+void SetMemoryOptions()
+{ // -hugepages, -hugetlb, -numa
+	const Vector<String>& arg = CommandLine();
+	MemoryOptions o;
+	if(FindIndex(arg, "-hugepages") >= 0)
+		o.huge_pages = 1;
+	if(FindIndex(arg, "-hugetlb") >= 0)
+		o.huge_pages = 2;
+	o.numa = FindIndex(arg, "-numa") >= 0;
+}
+
 CONSOLE_APP_MAIN
 {
 	StdLogSetup(LOG_COUT|LOG_FILE);
+	SetMemoryOptions();
 	RLOG("Decompressing");
 	Record *r;
 	int l;
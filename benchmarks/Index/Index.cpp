@@ -33,6 +33,22 @@ CONSOLE_APP_MAIN
 	//	for (int j = 0; j < jsize; ++j)
 	//		v[j].Sweep();
 	}
+	{
+		Vector<FlatIndex<int> > v;
+		v.SetCount(v_num);
+		{
+			RTIMING("inner FlatIndex FindAdd");
+			for (int i = 0; i < isize; ++i)
+				for (int j = 0; j < v_num; ++j)
+					v[j].FindAdd(i);
+		}
+		{
+			RTIMING("inner FlatIndex UnlinkKey");
+			for (int i = 0; i < isize; ++i)
+				for (int j = 0; j < v_num; ++j)
+					v[j].UnlinkKey(i);
+		}
+	}
 	return;
 	{
 		Vector<Index<int> > v;
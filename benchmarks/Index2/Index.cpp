@@ -41,6 +41,24 @@ CONSOLE_APP_MAIN
 		//	for (int j = 0; j < jsize; ++j)
 		//		v[j].Sweep();
 		}
+		{
+			Vector<FlatIndex<int> > v;
+			v.SetCount(v_num);
+			{
+				RTIMING("inner FlatIndex FindAdd");
+				int *s = data;
+				for (int i = 0; i < isize; ++i)
+					for (int j = 0; j < v_num; ++j)
+						v[j].FindAdd(*s++);
+			}
+			{
+				RTIMING("inner FlatIndex UnlinkKey");
+				int *s = data;
+				for (int i = 0; i < isize; ++i)
+					for (int j = 0; j < v_num; ++j)
+						v[j].UnlinkKey(*s++);
+			}
+		}
 		{
 			Vector<Index<int> > v;
 			v.SetCount(v_num);
@@ -29,6 +29,7 @@ CONSOLE_APP_MAIN
 	
 	for(int i = 0; i < 100; i++) {
 		Index<String> ndx;
+		FlatIndex<String> fndx;
 		SortedIndex<String> ndx2;
 		std::set<std::string> st;
 		std::set<String> sst;
@@ -39,6 +40,11 @@ CONSOLE_APP_MAIN
 			for(const String& s : w)
 				ndx.FindAdd(s);
 		}
+		{
+			RTIMING("FlatIndex");
+			for(const String& s : w)
+				fndx.FindAdd(s);
+		}
 		{
 			RTIMING("SortedIndex");
 			for(const String& s : w)
@@ -66,6 +72,7 @@ CONSOLE_APP_MAIN
 		}
 		ONCELOCK {
 			RDUMP(ndx.GetCount());
+			RDUMP(fndx.GetCount());
 			RDUMP(ndx2.GetCount());
 			RDUMP(st.size());
 			RDUMP(sst.size());
@@ -82,6 +89,7 @@ CONSOLE_APP_MAIN
 	
 	for(int i = 0; i < 100; i++) {
 		Index<String> ndx;
+		FlatIndex<String> fndx;
 		SortedIndex<String> ndx2;
 		std::set<std::string> st;
 		std::set<String> sst;
@@ -92,6 +100,11 @@ CONSOLE_APP_MAIN
 			for(const String& s : w)
 				ndx.FindAdd(s);
 		}
+		{
+			RTIMING("FlatIndex");
+			for(const String& s : w)
+				fndx.FindAdd(s);
+		}
 		{
 			RTIMING("SortedIndex");
 			for(const String& s : w)
@@ -119,6 +132,7 @@ CONSOLE_APP_MAIN
 		}
 		ONCELOCK {
 			RDUMP(ndx.GetCount());
+			RDUMP(fndx.GetCount());
 			RDUMP(ndx2.GetCount());
 			RDUMP(st.size());
 			RDUMP(sst.size());
@@ -44,4 +44,57 @@ CONSOLE_APP_MAIN
 	RDUMP(j1 == j0 && j2 == j0);
 	
 	RDUMP(AsJSON(ParseJSON(j1), true));
+	
+	String json = "[";
+	for(int i = 0; i < 50000; i++) {
+		if(i)
+			json << ",\n";
+		JsonArray tags;
+		for(int j = 0; j < i % 5; j++)
+			tags << "tag" + AsString(j);
+		json << Json("id", i)("name", "Item \"" + AsString(i) + "\"")("value", i * 1.5)
+		            ("active", i % 2 == 0)("tags", tags)("note", Value());
+	}
+	json << "]";
+	double mb = json.GetCount() / 1024.0 / 1024.0;
+	RDUMP(mb);
+
+	int reps = N / 1000 + 1;
+	int t0 = msecs();
+	for(int i = 0; i < reps; i++) {
+		RTIMING("ParseJSON");
+		ParseJSON(json);
+	}
+	RLOG("ParseJSON: " << mb * reps * 1000 / max(msecs(t0), 1) << " MB/s");
+
+	t0 = msecs();
+	for(int i = 0; i < reps; i++) {
+		RTIMING("JsonReader events");
+		StringStream ss(json);
+		JsonReader r(ss);
+		while(r.Next() != JSON_EOF);
+	}
+	RLOG("JsonReader events: " << mb * reps * 1000 / max(msecs(t0), 1) << " MB/s");
+
+	t0 = msecs();
+	for(int i = 0; i < reps; i++) {
+		RTIMING("JsonReader ReadValue");
+		StringStream ss(json);
+		JsonReader(ss).ReadValue();
+	}
+	RLOG("JsonReader ReadValue: " << mb * reps * 1000 / max(msecs(t0), 1) << " MB/s");
+
+	t0 = msecs();
+	for(int i = 0; i < reps; i++) {
+		RTIMING("JsonDom");
+		JsonDom dom(json);
+	}
+	RLOG("JsonDom: " << mb * reps * 1000 / max(msecs(t0), 1) << " MB/s, memory used "
+	     << JsonDom(json).GetMemoryUsed() / 1024 << " KB");
+
+	RDUMP(MemoryUsedKb());
+	{
+		Value v = ParseJSON(json);
+		RLOG("ParseJSON memory used: " << MemoryUsedKb() << " KB");
+	}
 }
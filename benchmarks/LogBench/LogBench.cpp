@@ -0,0 +1,35 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+const int N = 400000; // lines in total
+
+double Run(int threads, dword options, const String& path)
+{
+	StdLogSetup(options, path, 0);
+	int64 t0 = usecs();
+	Array<Thread> thread;
+	for(int t = 0; t < threads; t++)
+		thread.Add().Run([=] {
+			for(int i = t; i < N; i += threads)
+				RLOG("Thread " << t << ", line " << i << ", some additional text to log");
+		});
+	for(Thread& t : thread)
+		t.Wait();
+	int64 tm = usecs() - t0; // time seen by producers
+	FlushLog();
+	return N / (tm / 1e6);
+}
+
+CONSOLE_APP_MAIN
+{
+	String path = GetHomeDirFile("LogBench.bench.log");
+	Cout() << "threads\tsync lines/s\tasync lines/s\n";
+	for(int threads : { 1, 2, 4, 8, 16, 32 }) {
+		double s = Run(threads, LOG_FILE, path);
+		double a = Run(threads, LOG_FILE|LOG_ASYNC, path);
+		Cout() << threads << '\t' << Format("%.0f", s) << '\t' << Format("%.0f", a) << '\n';
+	}
+	StdLogSetup(LOG_FILE);
+	DeleteFile(path);
+}
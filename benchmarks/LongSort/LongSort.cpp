@@ -27,6 +27,27 @@ CONSOLE_APP_MAIN
 			Sort(b);
 		}
 	}
+	{
+		Vector<String> b = clone(a);
+		{
+			RTIMING("RadixSort");
+			RadixSort(b);
+		}
+	}
+	{
+		Vector<String> b = clone(a);
+		{
+			RTIMING("CoSort");
+			CoSort(b);
+		}
+	}
+	{
+		Vector<String> b = clone(a);
+		{
+			RTIMING("CoRadixSort");
+			CoRadixSort(b);
+		}
+	}
 	{
 		std::vector<std::string> d = c;
 		{
@@ -0,0 +1,56 @@
+#include <PdfDraw/PdfDraw.h>
+
+using namespace Upp;
+
+const int N = 2000;
+
+Image MakeImage()
+{
+	ImageBuffer ib(200, 200);
+	for(int y = 0; y < 200; y++)
+		for(int x = 0; x < 200; x++)
+			ib[y][x] = RGBA(Color(x, y, 100));
+	return ib;
+}
+
+void DrawPage(Draw& w, int i)
+{
+	for(int y = 0; y < 60; y++)
+		w.DrawRect(300, 300 + 100 * y, 200 + 30 * ((i + y) % 100), 50, Color((i * y) & 255, 0, 100));
+	w.DrawImage(3000, 300, MakeImage()); // new serial on each page, deduplicated by hash
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+
+	String path = GetHomeDirFile("PdfStream.pdf");
+	// streaming first, as peak memory can only grow
+	{
+		FileOut out(path);
+		PdfDraw w(out);
+		TimeStop tm;
+		for(int i = 0; i < N; i++) {
+			if(i)
+				w.StartPage();
+			DrawPage(w, i);
+			w.EndPage();
+		}
+		w.Finish();
+		RLOG("Streamed: " << tm << ", peak memory: " << MemoryUsedKbMax() << " KB");
+	}
+	{
+		PdfDraw w;
+		TimeStop tm;
+		for(int i = 0; i < N; i++) {
+			if(i)
+				w.StartPage();
+			DrawPage(w, i);
+			w.EndPage();
+		}
+		SaveFile(path, w.Finish());
+		RLOG("In memory: " << tm << ", peak memory: " << MemoryUsedKbMax() << " KB");
+	}
+	RLOG("File size: " << GetFileLength(path));
+	DeleteFile(path);
+}
@@ -0,0 +1,70 @@
+#include <PostgreSQL/PostgreSQL.h>
+
+using namespace Upp;
+
+// Needs running PostgreSQL server, e.g.
+// PgBinaryFetch "host=localhost dbname=test user=test password=test"
+
+const int N = 2000000;
+
+const char *query = "select ID, AMOUNT, CREATED from BINTEST";
+
+double Sum(Sql& sql)
+{
+	double sum = 0;
+	sql.Execute(query);
+	while(sql.Fetch())
+		sum += (int)sql[0] + (double)sql[1] + Time(sql[2]).second;
+	return sum;
+}
+
+double SumColumns(Sql& sql)
+{
+	double sum = 0;
+	sql.Execute(query);
+	Vector<int> id;
+	Vector<double> amount;
+	Vector<Time> created;
+	while(sql.FetchColumns({ id, amount, created }, 10000)) {
+		for(int i = 0; i < id.GetCount(); i++)
+			sum += id[i] + amount[i] + created[i].second;
+		id.Clear();
+		amount.Clear();
+		created.Clear();
+	}
+	return sum;
+}
+
+CONSOLE_APP_MAIN
+{
+	const Vector<String>& arg = CommandLine();
+	PostgreSQLSession pg;
+	if(arg.GetCount() < 1 || !pg.Open(arg[0])) {
+		RLOG("Cannot open database: " << pg.GetLastError());
+		return;
+	}
+	Sql sql(pg);
+	sql.Execute("drop table BINTEST");
+	sql.Execute("create table BINTEST (ID integer, AMOUNT numeric(12, 2), CREATED timestamp)");
+	sql.Execute("insert into BINTEST select i, i * 0.25, timestamp '2020-01-01' + i * interval '1 second' "
+	            "from generate_series(0, ?) i", N - 1);
+	
+	for(int pass = 0; pass < 3; pass++) {
+		double sum[4];
+		for(int binary = 0; binary < 2; binary++) {
+			pg.BinaryResults(binary);
+			{
+				RTIMING(binary ? "binary Fetch" : "text Fetch");
+				sum[2 * binary] = Sum(sql);
+			}
+			{
+				RTIMING(binary ? "binary FetchColumns" : "text FetchColumns");
+				sum[2 * binary + 1] = SumColumns(sql);
+			}
+		}
+		ASSERT(sum[0] == sum[1] && sum[0] == sum[2] && sum[0] == sum[3]);
+	}
+	
+	pg.BinaryResults(false);
+	sql.Execute("drop table BINTEST");
+}
@@ -0,0 +1,63 @@
+#include <Core/Core.h>
+
+using namespace Upp;
+
+#define N 10000000
+
+template <class T>
+void Bench(const char *name, const Vector<T>& data)
+{
+	RLOG("---- " << name);
+	Vector<T> expected;
+	{
+		Vector<T> v = clone(data);
+		TimeStop tm;
+		Sort(v);
+		RLOG("Sort        " << tm);
+		expected = pick(v);
+	}
+	{
+		Vector<T> v = clone(data);
+		TimeStop tm;
+		CoSort(v);
+		RLOG("CoSort      " << tm);
+	}
+	{
+		Vector<T> v = clone(data);
+		TimeStop tm;
+		RadixSort(v);
+		RLOG("RadixSort   " << tm);
+		if(v != expected)
+			Panic("Failed!");
+	}
+	{
+		Vector<T> v = clone(data);
+		TimeStop tm;
+		CoRadixSort(v);
+		RLOG("CoRadixSort " << tm);
+		if(v != expected)
+			Panic("Failed!");
+	}
+}
+
+CONSOLE_APP_MAIN
+{
+	StdLogSetup(LOG_COUT|LOG_FILE);
+	SeedRandom(0);
+
+	Vector<int64> i64;
+	Vector<double> d;
+	Vector<String> s, url;
+	for(int i = 0; i < N; i++) {
+		i64.Add((int64)Random64());
+		d.Add((Randomf() - 0.5) * 1e6);
+		s.Add(AsString(Random()));
+		if(i < N / 4)
+			url.Add("https://www.ultimatepp.org/src/Core/" + AsString(Random(100)) + "/file" + AsString(Random()));
+	}
+
+	Bench("int64", i64);
+	Bench("double", d);
+	Bench("String", s);
+	Bench("String with common prefix", url);
+}
@@ -0,0 +1,56 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+const int N = 200000;
+
+int Fill(Sql& sql, bool generic)
+{
+	sql.Execute("delete from TEST");
+	int t0 = msecs();
+	SqlMassInsert m(sql, SqlId("TEST"));
+	m.Generic(generic);
+	for(int i = 0; i < N; i++)
+		m(SqlId("ID"), i)
+		 (SqlId("NAME"), AsString(i))
+		 (SqlId("AMOUNT"), i * 1.5)
+		 (SqlId("NOTE"), i % 3 ? Value() : Value("note " + AsString(i)))
+		 .EndRow();
+	m.Flush();
+	ASSERT(!m.IsError());
+	int t = max(msecs(t0), 1);
+	sql.Execute("select count(*) from TEST");
+	ASSERT(sql.Fetch() && (int)sql[0] == N);
+	return t;
+}
+
+CONSOLE_APP_MAIN
+{
+	String path = GetHomeDirFile("SqlMassInsert.db");
+	DeleteFile(path);
+
+	Sqlite3Session sqlite;
+	if(!sqlite.Open(path)) {
+		RLOG("Cannot open " << path);
+		return;
+	}
+	Sql sql(sqlite);
+	sql.Execute("create table TEST (ID integer, NAME text, AMOUNT real, NOTE text)");
+	
+	for(int pass = 0; pass < 3; pass++) {
+		int generic, bulk;
+		{
+			RTIMING("generic");
+			generic = Fill(sql, true);
+		}
+		{
+			RTIMING("bulk");
+			bulk = Fill(sql, false);
+		}
+		RLOG("generic: " << 1000 * int64(N) / generic << " rows/s, bulk: "
+		     << 1000 * int64(N) / bulk << " rows/s");
+	}
+	
+	sqlite.Close();
+	DeleteFile(path);
+}
@@ -0,0 +1,55 @@
+#include <plugin/sqlite3/Sqlite3.h>
+
+using namespace Upp;
+
+const int N = 200000;
+
+int Run(Sqlite3Session& sqlite, int cache)
+{
+	sqlite.NoStatementCache();
+	sqlite.StatementCache(cache);
+	Sql sql(sqlite);
+	sql.Execute("delete from TEST");
+	int t0 = msecs();
+	sql.Begin();
+	for(int i = 0; i < N; i++)
+		sql.Execute("insert into TEST(ID, NAME, AMOUNT) values (?, ?, ?)", i, "name " + AsString(i), i * 1.5);
+	sql.Commit();
+	for(int i = 0; i < N; i++) {
+		sql.Execute("select NAME, AMOUNT from TEST where ID = ?", i);
+		ASSERT(sql.Fetch() && sql[0] == "name " + AsString(i) && (double)sql[1] == i * 1.5);
+	}
+	return max(msecs(t0), 1);
+}
+
+CONSOLE_APP_MAIN
+{
+	String path = GetHomeDirFile("SqlStatementCache.db");
+	DeleteFile(path);
+
+	Sqlite3Session sqlite;
+	if(!sqlite.Open(path)) {
+		RLOG("Cannot open " << path);
+		return;
+	}
+	Sql sql(sqlite);
+	sql.Execute("create table TEST (ID integer primary key, NAME text, AMOUNT real)");
+
+	for(int pass = 0; pass < 3; pass++) {
+		int prepared, cached;
+		{
+			RTIMING("prepared");
+			prepared = Run(sqlite, 0);
+		}
+		{
+			RTIMING("cached");
+			cached = Run(sqlite, 32);
+		}
+		RLOG("prepared: " << 2000 * int64(N) / prepared << " statements/s, cached: "
+		     << 2000 * int64(N) / cached << " statements/s");
+	}
+	RLOG("cache hits: " << sqlite.GetStatementCacheHits() << ", misses: " << sqlite.GetStatementCacheMisses());
+	
+	sqlite.Close();
+	DeleteFile(path);
+}
@@ -0,0 +1,92 @@
+#include <PostgreSQL/PostgreSQL.h>
+#include <MySql/MySql.h>
+
+using namespace Upp;
+
+// Needs running database server, e.g.
+// SqlStreamingFetch pgsql "host=localhost dbname=test user=test password=test"
+// SqlStreamingFetch mysql test test test localhost
+
+const int N = 5000000;
+
+int PeakMemoryKb()
+{
+	String s = LoadFile("/proc/self/status");
+	int q = s.Find("VmHWM:");
+	return q >= 0 ? ScanInt(~s + q + 6) : 0;
+}
+
+void Run(SqlSession& session, bool streaming)
+{
+	Sql sql(session);
+	if(streaming)
+		sql.StreamingFetch();
+	int t0 = msecs();
+	if(!sql.Execute("select ID, NAME, AMOUNT from STREAMTEST")) {
+		RLOG(sql.GetLastError());
+		return;
+	}
+	int first = -1;
+	int64 sum = 0;
+	int n = 0;
+	while(sql.Fetch()) {
+		if(first < 0)
+			first = msecs(t0);
+		sum += (int)sql[0];
+		n++;
+	}
+	RLOG((streaming ? "streaming" : "stored") << ": " << n << " rows, first row after " << first
+	     << " ms, total " << msecs(t0) << " ms, peak memory " << PeakMemoryKb() / 1024 << " MB");
+	ASSERT(n == N && sum == (int64)N * (N - 1) / 2);
+	
+	sql.Execute("select ID from STREAMTEST"); // canceled after the first row
+	sql.Fetch();
+	sql.Cancel();
+	ASSERT(sql.Execute("select count(*) from STREAMTEST") && sql.Fetch() && (int)sql[0] == N);
+}
+
+CONSOLE_APP_MAIN
+{
+	const Vector<String>& arg = CommandLine();
+	
+	One<SqlSession> session;
+	if(arg.GetCount() >= 2 && arg[0] == "pgsql") {
+		PostgreSQLSession& pg = session.Create<PostgreSQLSession>();
+		if(!pg.Open(arg[1])) {
+			RLOG("Cannot open " << arg[1] << ": " << pg.GetLastError());
+			return;
+		}
+	}
+	else
+	if(arg.GetCount() >= 5 && arg[0] == "mysql") {
+		MySqlSession& my = session.Create<MySqlSession>();
+		if(!my.Connect(arg[1], arg[2], arg[3], arg[4])) {
+			RLOG("Cannot connect to " << arg[4] << ": " << my.GetLastError());
+			return;
+		}
+	}
+	else {
+		RLOG("Usage: SqlStreamingFetch pgsql connection | mysql user password database host");
+		return;
+	}
+
+	Sql sql(*session);
+	sql.Execute("drop table STREAMTEST");
+	sql.Execute("create table STREAMTEST (ID integer primary key, NAME varchar(200), AMOUNT double precision)");
+	int bulk = session->GetBulkInsertRows(3);
+	for(int i = 0; i < N; i += bulk) {
+		Vector< Vector<Value> > data;
+		data.SetCount(3);
+		for(int j = i; j < min(i + bulk, N); j++) {
+			data[0].Add(j);
+			data[1].Add("name of row number " + AsString(j));
+			data[2].Add(j * 1.5);
+		}
+		session->BulkInsert("STREAMTEST", { "ID", "NAME", "AMOUNT" }, data);
+	}
+
+	Run(*session, true); // first, as peak memory cannot go down
+	Run(*session, false);
+
+	sql.Execute("drop table STREAMTEST");
+}
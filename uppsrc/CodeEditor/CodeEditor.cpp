@@ -19,44 +19,109 @@ INITBLOCK {
 	RegisterSyntaxModules();
 }
 
-One<EditorSyntax> CodeEditor::GetSyntax(int line)
+void CodeEditor::ClearSyntaxState()
 {
+	syntax_state.Clear();
+	syntax_dirty = INT_MAX;
+	syntax_dirty_end = 0;
+	syntax_last.Clear();
+	syntax_scan.Kill();
+}
+
+One<EditorSyntax> CodeEditor::GetSyntax(int line)
+{ // state snapshots are recomputed only from edit until the new state is the same as before
 	LTIMING("GetSyntax");
 	One<EditorSyntax> syntax = EditorSyntax::Create(highlight);
 	syntax->SpellCheckComments(spellcheck_comments);
-	int ln = 0;
-	for(int i = 0; i < __countof(syntax_cache); i++)
-		if(line >= syntax_cache[i].line && syntax_cache[i].line > 0) {
-			syntax->Set(syntax_cache[i].data);
-			ln = syntax_cache[i].line;
-			LLOG("Found " << line << " " << syntax_cache[i].line);
-			break;
+	line = max(min(line, GetLineCount()), 0);
+	auto Start = [&](int& ln) { // last valid snapshot before line, returns index of the next snapshot
+		int i = FindUpperBound(syntax_state, line, [](int l, const SyntaxPos& p) { return l < p.line; });
+		int q = i - 1;
+		while(q >= 0 && syntax_state[q].line >= syntax_dirty)
+			q--;
+		ln = 0;
+		if(q >= 0) {
+			syntax->Set(syntax_state[q].data);
+			ln = syntax_state[q].line;
+			i = q + 1;
 		}
-	line = min(line, GetLineCount());
-	if(line - ln > 10000) { // optimization hack for very huge files
+		else {
+			syntax->Clear();
+			i = 0;
+		}
+		if(syntax_last.line > ln && syntax_last.line <= line && syntax_last.line < syntax_dirty) {
+			syntax->Set(syntax_last.data);
+			ln = syntax_last.line;
+			while(i < syntax_state.GetCount() && syntax_state[i].line <= ln)
+				i++;
+		}
+		return i;
+	};
+	int ln;
+	int i = Start(ln);
+	bool guess = false;
+	if(line - ln > 10000) { // optimization hack for very huge files, before they are scanned by ScanSyntaxState
 		syntax = EditorSyntax::Create(highlight);
+		syntax->SpellCheckComments(spellcheck_comments);
 		ln = line - 10000; // we just pray it gets synced
+		guess = true;
 	}
 	while(ln < line) {
 		WString l = GetWLine(ln);
 		CTIMING("ScanSyntax3");
 		syntax->ScanSyntax(l, l.End(), ln, GetTabSize());
 		ln++;
-		static int d[] = { 0, 100, 1000, 3000, 7000 };
-		for(int i = 0; i < __countof(d); i++)
-			if(ln == cline - d[i]) {
-				syntax_cache[i + 1].data = syntax->Get();
-				syntax_cache[i + 1].line = ln;
+		if(guess)
+			continue;
+		bool at_snapshot = i < syntax_state.GetCount() && syntax_state[i].line == ln;
+		if(at_snapshot || ln - (i ? syntax_state[i - 1].line : 0) >= SYNTAX_STEP) {
+			String data = syntax->Get();
+			if(at_snapshot) {
+				if(ln >= syntax_dirty && ln > syntax_dirty_end && syntax_state[i].data == data) { // converged
+					LLOG("Syntax converged at " << ln);
+					syntax_dirty = INT_MAX;
+					i = Start(ln);
+					continue;
+				}
+				syntax_state[i].data = data;
+			}
+			else {
+				SyntaxPos& p = syntax_state.Insert(i);
+				p.line = ln;
+				p.data = data;
 			}
+			i++;
+		}
+		if(syntax_dirty <= ln)
+			syntax_dirty = ln + 1;
+	}
+	if(syntax_dirty < INT_MAX && (syntax_state.IsEmpty() || syntax_dirty > syntax_state.Top().line))
+		syntax_dirty = INT_MAX; // all snapshots are valid
+	if(!guess) {
+		syntax_last.data = syntax->Get();
+		syntax_last.line = ln;
 	}
-	syntax_cache[0].data = syntax->Get();
-	syntax_cache[0].line = ln;
 	return pick(syntax);
 }
 
+void CodeEditor::ScanSyntaxState()
+{ // computes missing or invalid states in small steps, so that highlighting of any line is fast
+	if(IsView())
+		return;
+	int start = msecs();
+	while(msecs(start) < 20) {
+		int ln = syntax_dirty < INT_MAX ? syntax_dirty : syntax_state.GetCount() ? syntax_state.Top().line : 0;
+		if(ln + SYNTAX_STEP > GetLineCount() && syntax_dirty == INT_MAX)
+			return;
+		GetSyntax(ln + 1000);
+	}
+	syntax_scan.KillPost([=] { ScanSyntaxState(); });
+}
+
 void CodeEditor::Highlight(const String& h)
 {
 	highlight = h;
+	ClearSyntaxState();
 	SetColor(LineEdit::INK_NORMAL, hl_style[HighlightSetup::INK_NORMAL].color);
 	SetColor(LineEdit::INK_DISABLED, hl_style[HighlightSetup::INK_DISABLED].color);
 	SetColor(LineEdit::INK_SELECTED, hl_style[HighlightSetup::INK_SELECTED].color);
@@ -214,9 +279,11 @@ void CodeEditor::NewScrollPos() {
 }
 
 void CodeEditor::DirtyFrom(int line) {
-	for(int i = 0; i < __countof(syntax_cache); i++)
-		if(syntax_cache[i].line >= line)
-			syntax_cache[i].Clear();
+	syntax_dirty_end = syntax_dirty == INT_MAX ? line : max(syntax_dirty_end, syntax_dirty - 1, line);
+	syntax_dirty = min(syntax_dirty, line + 1);
+	if(syntax_last.line > line)
+		syntax_last.Clear();
+	syntax_scan.KillSet(200, [=] { ScanSyntaxState(); });
 
 	if(check_edited)
 		bar.Refresh();
@@ -286,13 +353,24 @@ void CodeEditor::PostRemove(int pos, int size) {
 }
 
 void CodeEditor::ClearLines() {
+	ClearSyntaxState();
 	bar.ClearLines();
 	sbi.Refresh();
 }
 
+void CodeEditor::DropSyntaxState(int line)
+{ // states contain line numbers (blocks, statements), so they cannot be shifted when lines are inserted or removed
+	while(syntax_state.GetCount() && syntax_state.Top().line >= line)
+		syntax_state.Drop();
+	if(syntax_last.line >= line)
+		syntax_last.Clear();
+	syntax_scan.KillSet(200, [=] { ScanSyntaxState(); });
+}
+
 void CodeEditor::InsertLines(int line, int count) {
 	if(IsView())
 		return;
+	DropSyntaxState(line + 1);
 	bar.InsertLines(line, count);
 	if(line <= line2.GetCount())
 		line2.Insert(line, GetLine2(line), count);
@@ -300,6 +378,7 @@ void CodeEditor::InsertLines(int line, int count) {
 }
 
 void CodeEditor::RemoveLines(int line, int count) {
+	DropSyntaxState(line);
 	bar.RemoveLines(line, count);
 	if(line + count <= line2.GetCount())
 		line2.Remove(line, count);
@@ -1336,8 +1415,7 @@ void CodeEditor::MouseWheel(Point p, int zdelta, dword keyFlags) {
 
 void CodeEditor::Clear()
 {
-	for(SyntaxPos& p : syntax_cache)
-		p.Clear();
+	ClearSyntaxState();
 	LineEdit::Clear();
 	found = notfoundfw = notfoundbk = false;
 }
@@ -1402,6 +1480,7 @@ void CodeEditor::Layout()
 
 CodeEditor::CodeEditor()
 :	sbi(sb.y, *this) {
+	ClearSyntaxState();
 	bracket_flash = false;
 	highlight_bracket_pos0 = 0;
 	bracket_start = 0;
@@ -233,14 +233,20 @@ protected:
 	EditorBar   bar;
 	Vector<int> line2;
 
-	struct SyntaxPos {
+	struct SyntaxPos : Moveable<SyntaxPos> {
 		int    line;
 		String data;
 		
 		void Clear() { line = 0; data.Clear(); }
 	};
 	
-	SyntaxPos   syntax_cache[6];
+	enum { SYNTAX_STEP = 32 }; // distance of syntax state snapshots in lines
+
+	Vector<SyntaxPos> syntax_state; // syntax state at the start of line, ordered by line
+	int               syntax_dirty; // states at this line and after might be invalid after edit
+	int               syntax_dirty_end; // last edited line, states can converge only after it
+	SyntaxPos         syntax_last; // last state computed, for sequential highlighting of lines
+	TimeCallback      syntax_scan;
 
 //	EditorSyntax rm_ins;
 
@@ -355,6 +361,9 @@ protected:
 	void   NotFound();
 	void   NoFindError();
 	void   CheckSyntaxRefresh(int64 pos, const WString& text);
+	void   ClearSyntaxState();
+	void   DropSyntaxState(int line);
+	void   ScanSyntaxState();
 	void   RefreshBlkHeader();
 
 	void   SetFound(int fi, int type, const WString& text);
@@ -24,9 +24,50 @@ void CoWork::Pool::Free(MJob& job)
 	free = &job;
 }
 
+void CoWork::Deque::Push(MJob *m)
+{ // only called by owner and only if !IsFull
+	int64 b = bottom.load(std::memory_order_relaxed);
+	job[b & (DEQUE_SIZE - 1)].store(m, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+CoWork::MJob *CoWork::Deque::Pop()
+{ // only called by owner, takes the most recently pushed job
+	int64 b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 t = top.load(std::memory_order_relaxed);
+	if(t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return NULL;
+	}
+	MJob *m = job[b & (DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+	if(t == b) { // last job, race with thieves
+		if(!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			m = NULL;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return m;
+}
+
+CoWork::MJob *CoWork::Deque::Steal()
+{ // called by other threads, takes the oldest job
+	int64 t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 b = bottom.load(std::memory_order_acquire);
+	if(t >= b)
+		return NULL;
+	MJob *m = job[t & (DEQUE_SIZE - 1)].load(std::memory_order_relaxed);
+	return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed) ? m : NULL;
+}
+
 void CoWork::Pool::InitThreads(int nthreads)
 {
 	LLOG("Pool::InitThreads: " << nthreads);
+	deque.Clear();
+	for(int i = 0; i < nthreads; i++)
+		deque.Add();
 	for(int i = 0; i < nthreads; i++)
 		CHECK(threads.Add().RunNice([=] { worker_index = i; ThreadRun(i); }, true));
 }
@@ -55,13 +96,15 @@ CoWork::Pool::Pool()
 {
 	ASSERT(!IsWorker());
 
+	free = NULL;
+	global_count = 0;
+	waiting_threads = 0;
+	quit = false;
+
 	InitThreads(CPU_Cores() + 2);
 
-	free = NULL;
 	for(int i = 0; i < SCHEDULED_MAX; i++)
 		Free(slot[i]);
-	
-	quit = false;
 }
 
 CoWork::Pool::~Pool()
@@ -88,6 +131,7 @@ void CoWork::Pool::DoJob(MJob& job)
 	finlock = false;
 
 	CoWork *work = job.work;
+	CoWork *prev = CoWork::current;
 	CoWork::current = work;
 	bool looper = job.looper;
 	Function<void ()> fn;
@@ -95,11 +139,13 @@ void CoWork::Pool::DoJob(MJob& job)
 		ASSERT(work);
 		if(--work->looper_count <= 0) {
 			job.UnlinkAll();
+			global_count--;
 			Free(job);
 		}
 	}
 	else {
 		job.UnlinkAll();
+		global_count--;
 		fn = pick(job.fn);
 		Free(job); // using 'job' after this point is grave error....
 	}
@@ -107,6 +153,7 @@ void CoWork::Pool::DoJob(MJob& job)
 	lock.Leave();
 	std::exception_ptr exc = nullptr;
 	try {
+		RZONE("CoWork job");
 		if(looper)
 			work->looper_fn();
 		else
@@ -116,7 +163,7 @@ void CoWork::Pool::DoJob(MJob& job)
 		LLOG("DoJob caught exception");
 		exc = std::current_exception();
 	}
-	CoWork::current = NULL;
+	CoWork::current = prev;
 	if(!finlock)
 		lock.Enter();
 	if(!work)
@@ -138,30 +185,122 @@ void CoWork::Pool::DoJob(MJob& job)
 	LLOG("Finished, remaining todo " << work->todo);
 }
 
+void CoWork::Pool::DoLocalJob(MJob *job)
+{
+	LLOG("DoLocalJob (CoWork " << FormatIntHex(job->work) << ")");
+	finlock = false;
+
+	CoWork *work = job->work;
+	CoWork *prev = CoWork::current;
+	CoWork::current = work;
+	std::exception_ptr exc = nullptr;
+	if(!work->canceled)
+		try {
+			RZONE("CoWork job");
+			job->fn();
+		}
+		catch(...) {
+			LLOG("DoLocalJob caught exception");
+			exc = std::current_exception();
+		}
+	delete job;
+	CoWork::current = prev;
+	if(finlock || exc) {
+		if(!finlock)
+			lock.Enter();
+		work->Done(exc);
+		lock.Leave();
+		return;
+	}
+	int n = work->todo;
+	while(n > 1) // lock-free unless this is the last job of 'work'
+		if(work->todo.compare_exchange_weak(n, n - 1))
+			return;
+	Mutex::Lock __(lock);
+	work->Done(nullptr);
+}
+
+bool CoWork::Pool::IsWork()
+{
+	if(global_count)
+		return true;
+	for(const Deque& q : deque)
+		if(!q.IsEmpty())
+			return true;
+	return false;
+}
+
+CoWork::MJob *CoWork::Pool::Steal(int tno)
+{
+	int n = deque.GetCount();
+	int ii = Random(n);
+	for(int i = 0; i < n; i++) {
+		int q = (ii + i) % n;
+		if(q != tno) {
+			MJob *m = deque[q].Steal();
+			if(m) {
+				LHITCOUNT("CoWork: Stolen job");
+				return m;
+			}
+		}
+	}
+	return NULL;
+}
+
+void CoWork::Pool::Notify()
+{
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(waiting_threads) {
+		LTIMING("Releasing thread waiting for job");
+		Mutex::Lock __(lock);
+		waitforjob.Signal();
+	}
+}
+
 void CoWork::Pool::ThreadRun(int tno)
 {
 	LLOG("CoWork thread #" << tno << " started");
 	Pool& p = GetPool();
-	p.lock.Enter();
+	Deque& q = p.deque[tno];
 	for(;;) {
-		while(!p.jobs.InList()) {
-			LHITCOUNT("CoWork: Parking thread to Wait");
-			if(p.quit) {
-				p.lock.Leave();
-				return;
+		MJob *m = q.Pop();
+		if(m) {
+			LHITCOUNT("CoWork: Running local job");
+			p.DoLocalJob(m);
+			continue;
+		}
+		if(p.global_count) {
+			p.lock.Enter();
+			if(p.jobs.InList()) {
+				LLOG("#" << tno << " Job acquired");
+				LHITCOUNT("CoWork: Running new job");
+				p.DoJob(*(MJob *)p.jobs.GetNext());
+				LLOG("#" << tno << " Job finished");
 			}
-			p.waiting_threads++;
+			p.lock.Leave();
+			continue;
+		}
+		m = p.Steal(tno);
+		if(m) {
+			p.DoLocalJob(m);
+			continue;
+		}
+		p.lock.Enter();
+		if(p.quit && !p.IsWork()) {
+			p.lock.Leave();
+			break;
+		}
+		LHITCOUNT("CoWork: Parking thread to Wait");
+		p.waiting_threads++;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(!p.IsWork()) {
 			LLOG("#" << tno << " Waiting for job");
 			p.waitforjob.Wait(p.lock);
 			LLOG("#" << tno << " Waiting ended");
-			p.waiting_threads--;
 		}
-		LLOG("#" << tno << " Job acquired");
-		LHITCOUNT("CoWork: Running new job");
-		p.DoJob(*(MJob *)p.jobs.GetNext());
-		LLOG("#" << tno << " Job finished");
+		p.waiting_threads--;
+		p.lock.Leave();
 	}
-	p.lock.Leave();
 	LLOG("CoWork thread #" << tno << " finished");
 }
 
@@ -171,6 +310,7 @@ void CoWork::Pool::PushJob(Function<void ()>&& fn, CoWork *work, bool looper)
 	MJob& job = *(MJob *)free;
 	free = job.GetNext();
 	job.LinkAfter(&jobs);
+	global_count++;
 	if(work)
 		job.LinkAfter(&work->jobs, 1);
 	job.work = work;
@@ -192,6 +332,21 @@ void CoWork::Pool::PushJob(Function<void ()>&& fn, CoWork *work, bool looper)
 	}
 }
 
+bool CoWork::Pool::PushLocalJob(Function<void ()>& fn, CoWork *work)
+{
+	Deque& q = deque[worker_index];
+	if(q.IsFull())
+		return false;
+	MJob *m = new MJob;
+	m->fn = pick(fn);
+	m->work = work;
+	work->todo++; // before Push, job can be stolen and finished immediately
+	q.Push(m);
+	LLOG("Adding local job");
+	Notify();
+	return true;
+}
+
 bool CoWork::TrySchedule(Function<void ()>&& fn)
 {
 	Pool& p = GetPool();
@@ -213,6 +368,16 @@ void CoWork::Do0(Function<void ()>&& fn, bool looper)
 	LHITCOUNT("CoWork: Scheduling callback");
 	LLOG("Do0, looper: " << looper << ", previous todo: " << todo);
 	Pool& p = GetPool();
+	if(!looper && worker_index >= 0) {
+		if(p.PushLocalJob(fn, this))
+			return;
+		LLOG("Local deque full: running in the originating thread");
+		Pool::finlock = false;
+		fn();
+		if(Pool::finlock)
+			p.lock.Leave();
+		return;
+	}
 	p.lock.Enter();
 	if(!p.free) {
 		LLOG("Stack full: running in the originating thread");
@@ -247,6 +412,7 @@ void CoWork::Cancel0()
 		LHITCOUNT("CoWork::Canceling scheduled Job");
 		MJob& job = *(MJob *)jobs.GetNext(1);
 		job.UnlinkAll();
+		p.global_count--;
 		if(job.looper)
 			todo -= job.work->looper_count;
 		else
@@ -272,9 +438,22 @@ void CoWork::Finish0()
 	}
 }
 
+void CoWork::Done(std::exception_ptr e)
+{ // called with pool lock
+	if(e && !exc) {
+		canceled = true;
+		Cancel0();
+		exc = e;
+	}
+	if(--todo == 0) {
+		LLOG("Releasing waitforfinish of (CoWork " << FormatIntHex(this) << ")");
+		waitforfinish.Signal();
+	}
+	ASSERT(todo >= 0);
+}
+
 int CoWork::GetScheduledCount() const
 {
-	Mutex::Lock __(GetPool().lock);
 	return todo;
 }
 
@@ -284,13 +463,20 @@ void CoWork::Cancel()
 	p.lock.Enter();
 	canceled = true;
 	Cancel0();
-	Finish0();
 	p.lock.Leave();
+	Finish(); // jobs in worker deques are skipped because of 'canceled'
 	LLOG("CoWork " << FormatIntHex(this) << " canceled and finished");
 }
 
 void CoWork::Finish() {
 	Pool& p = GetPool();
+	if(worker_index >= 0)
+		while(todo) { // help by running jobs from own deque, most recent first
+			MJob *m = p.deque[worker_index].Pop();
+			if(!m)
+				break;
+			p.DoLocalJob(m);
+		}
 	p.lock.Enter();
 	while(todo && !jobs.IsEmpty(1)) {
 		LLOG("Finish: todo: " << todo << " (CoWork " << FormatIntHex(this) << ")");
@@ -303,11 +489,7 @@ void CoWork::Finish() {
 
 bool CoWork::IsFinished()
 {
-	Pool& p = GetPool();
-	p.lock.Enter();
-	bool b = todo == 0;
-	p.lock.Leave();
-	return b;
+	return todo == 0;
 }
 
 void CoWork::SetPoolSize(int n)
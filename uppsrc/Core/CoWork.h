@@ -5,15 +5,33 @@ class CoWork : NoCopy {
 		bool              looper = false;
 	};
 	
-	enum { SCHEDULED_MAX = 2048 };
+	enum { SCHEDULED_MAX = 2048, DEQUE_SIZE = 1024 };
 
 public:
+	struct Deque { // Chase-Lev work-stealing deque, owned by single worker thread
+		std::atomic<int64>  top;
+		byte                pad1[64 - sizeof(int64)];
+		std::atomic<int64>  bottom;
+		byte                pad2[64 - sizeof(int64)];
+		std::atomic<MJob *> job[DEQUE_SIZE];
+
+		void  Push(MJob *m);
+		MJob *Pop();
+		MJob *Steal();
+		bool  IsEmpty() const          { return bottom.load(std::memory_order_acquire) <= top.load(std::memory_order_acquire); }
+		bool  IsFull() const           { return bottom.load(std::memory_order_relaxed) - top.load(std::memory_order_acquire) >= DEQUE_SIZE; }
+
+		Deque()                        { top = bottom = 0; }
+	};
+
 	struct Pool {
 		Link<2>          *free;
 		Link<2>           jobs;
 		MJob              slot[SCHEDULED_MAX];
-		int               waiting_threads;
+		Atomic            global_count;
+		Atomic            waiting_threads;
 		Array<Thread>     threads;
+		Array<Deque>      deque;
 		bool              quit;
 
 		Mutex             lock;
@@ -21,7 +39,12 @@ public:
 		
 		void              Free(MJob& m);
 		void              DoJob(MJob& m);
+		void              DoLocalJob(MJob *m);
 		void              PushJob(Function<void ()>&& fn, CoWork *work, bool looper = false);
+		bool              PushLocalJob(Function<void ()>& fn, CoWork *work);
+		void              Notify();
+		MJob             *Steal(int tno);
+		bool              IsWork();
 
 		void              InitThreads(int nthreads);
 		void              ExitThreads();
@@ -44,8 +67,8 @@ public:
 
 	ConditionVariable  waitforfinish;
 	Link<2>            jobs; // global stack and CoWork stack as double-linked lists
-	int                todo;
-	bool               canceled;
+	Atomic             todo;
+	std::atomic<bool>  canceled;
 	std::exception_ptr exc = nullptr; // workaround for sanitizer bug(?)
 	Function<void ()>  looper_fn;
 	int                looper_count;
@@ -54,6 +77,7 @@ public:
 
 	void Cancel0();
 	void Finish0();
+	void Done(std::exception_ptr exc);
 	
 	Atomic             index;
 
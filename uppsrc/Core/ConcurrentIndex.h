@@ -0,0 +1,258 @@
+// Find, FindAdd, GetKey and operator[] can be called concurrently (Find is lock-free), no removal.
+// GetCount can include items being added by other threads, Clear must not be called concurrently.
+template <class K, class D>
+class ConcurrentHashBase : NoCopy {
+protected:
+	enum {
+		SHARD_BITS = 6, SHARDS = 1 << SHARD_BITS,
+		BASE_BITS = 6, // first segment has 64 items, each next one is twice as big
+		SEGMENTS = 26,
+	};
+
+	struct Table {
+		Table               *prev; // replaced table, kept alive for concurrent readers
+		dword                mask;
+		std::atomic<uint64>  slot[1]; // (hash << 32) | (index + 1), 0 is empty
+	};
+
+	struct Shard {
+		std::atomic<Table *> table;
+		int                  count = 0;
+		Mutex                lock;
+		byte                 pad[64]; // avoid false sharing of locks
+
+		Shard() { table = nullptr; }
+	};
+
+	Shard              shard[SHARDS];
+	std::atomic<D *>   segment[SEGMENTS];
+	std::atomic<int>   count;
+	Mutex              segment_lock;
+
+	static dword Hash(const K& k)                 { return FoldHash(GetHashValue(k)); }
+	static Shard& GetShard(Shard *s, dword h)     { return s[h & (SHARDS - 1)]; }
+
+	D   *Item(int i) const;
+	D   *NewItem(int i);
+	int  Probe(Table *t, dword h, const K& k, dword& empty) const;
+	int  Find0(const K& k, dword h) const;
+	Table *Grow(Shard& s);
+	void Free();
+
+	template <class KK, class... Args>
+	int  FindAdd0(KK&& k, Args&&... args);
+
+public:
+	int  Find(const K& k) const                   { return Find0(k, Hash(k)); }
+	int  GetCount() const                         { return count; }
+	bool IsEmpty() const                          { return count == 0; }
+	const K& GetKey(int i) const                  { ASSERT(i >= 0 && i < count); return Item(i)->key; }
+
+	Vector<K> GetKeys() const;
+
+	void Clear()                                  { Free(); }
+
+	ConcurrentHashBase();
+	~ConcurrentHashBase()                         { Free(); }
+};
+
+template <class K, class D>
+ConcurrentHashBase<K, D>::ConcurrentHashBase()
+{
+	for(auto& s : segment)
+		s = nullptr;
+	count = 0;
+}
+
+template <class K, class D>
+force_inline
+D *ConcurrentHashBase<K, D>::Item(int i) const
+{
+	int n = i + (1 << BASE_BITS);
+	int b = SignificantBits(n) - 1;
+	return segment[b - BASE_BITS].load(std::memory_order_acquire) + (n - (1 << b));
+}
+
+template <class K, class D>
+D *ConcurrentHashBase<K, D>::NewItem(int i)
+{
+	int n = i + (1 << BASE_BITS);
+	int b = SignificantBits(n) - 1;
+	ASSERT(b - BASE_BITS < SEGMENTS);
+	std::atomic<D *>& sg = segment[b - BASE_BITS];
+	D *p = sg.load(std::memory_order_acquire);
+	if(!p) {
+		Mutex::Lock __(segment_lock);
+		p = sg.load(std::memory_order_relaxed);
+		if(!p) {
+			p = (D *)MemoryAlloc(sizeof(D) << b);
+			sg.store(p, std::memory_order_release);
+		}
+	}
+	return p + (n - (1 << b));
+}
+
+template <class K, class D>
+force_inline
+int ConcurrentHashBase<K, D>::Probe(Table *t, dword h, const K& k, dword& empty) const
+{
+	for(dword i = (h >> SHARD_BITS) & t->mask;; i = (i + 1) & t->mask) {
+		uint64 v = t->slot[i].load(std::memory_order_acquire);
+		if(!v) {
+			empty = i;
+			return -1;
+		}
+		if((dword)(v >> 32) == h) {
+			int ii = (int)(dword)v - 1;
+			if(Item(ii)->key == k)
+				return ii;
+		}
+	}
+}
+
+template <class K, class D>
+int ConcurrentHashBase<K, D>::Find0(const K& k, dword h) const
+{ // lock-free, only reads the current table of shard
+	Table *t = GetShard(const_cast<Shard *>(shard), h).table.load(std::memory_order_acquire);
+	dword empty;
+	return t ? Probe(t, h, k, empty) : -1;
+}
+
+template <class K, class D>
+typename ConcurrentHashBase<K, D>::Table *ConcurrentHashBase<K, D>::Grow(Shard& s)
+{ // s.lock must be locked; readers keep using the old table until the new one is published
+	Table *t = s.table.load(std::memory_order_relaxed);
+	dword n = t ? 2 * (t->mask + 1) : 16;
+	Table *nt = (Table *)MemoryAlloc(sizeof(Table) + (n - 1) * sizeof(std::atomic<uint64>));
+	nt->prev = t;
+	nt->mask = n - 1;
+	for(dword i = 0; i < n; i++)
+		new(&nt->slot[i]) std::atomic<uint64>(0);
+	if(t)
+		for(dword i = 0; i <= t->mask; i++) {
+			uint64 v = t->slot[i].load(std::memory_order_relaxed);
+			if(v) {
+				dword j = (dword)(v >> (32 + SHARD_BITS)) & nt->mask;
+				while(nt->slot[j].load(std::memory_order_relaxed))
+					j = (j + 1) & nt->mask;
+				nt->slot[j].store(v, std::memory_order_relaxed);
+			}
+		}
+	s.table.store(nt, std::memory_order_release);
+	return nt;
+}
+
+template <class K, class D>
+template <class KK, class... Args>
+int ConcurrentHashBase<K, D>::FindAdd0(KK&& k, Args&&... args)
+{
+	dword h = Hash(k);
+	int q = Find0(k, h);
+	if(q >= 0)
+		return q;
+	Shard& s = GetShard(shard, h);
+	Mutex::Lock __(s.lock);
+	Table *t = s.table.load(std::memory_order_relaxed);
+	dword empty = 0;
+	if(t) {
+		q = Probe(t, h, k, empty); // other thread might have added k meanwhile
+		if(q >= 0)
+			return q;
+	}
+	if(!t || 2 * (s.count + 1) > (int)t->mask + 1) {
+		t = Grow(s);
+		Probe(t, h, k, empty);
+	}
+	int ii = count++;
+	new(NewItem(ii)) D(std::forward<KK>(k), std::forward<Args>(args)...);
+	t->slot[empty].store(((uint64)h << 32) | (dword)(ii + 1), std::memory_order_release);
+	s.count++;
+	return ii;
+}
+
+template <class K, class D>
+Vector<K> ConcurrentHashBase<K, D>::GetKeys() const
+{
+	Vector<K> r;
+	int n = GetCount();
+	r.Reserve(n);
+	for(int i = 0; i < n; i++)
+		r.Add(Item(i)->key);
+	return r;
+}
+
+template <class K, class D>
+void ConcurrentHashBase<K, D>::Free()
+{
+	for(Shard& s : shard) {
+		Table *t = s.table;
+		while(t) {
+			Table *prev = t->prev;
+			MemoryFree(t);
+			t = prev;
+		}
+		s.table = nullptr;
+		s.count = 0;
+	}
+	int n = count;
+	for(int i = 0; i < n; i++)
+		Item(i)->~D();
+	for(auto& sg : segment) {
+		if(sg)
+			MemoryFree(sg);
+		sg = nullptr;
+	}
+	count = 0;
+}
+
+template <class K>
+struct ConcurrentIndexItem__ {
+	K key;
+
+	template <class KK>
+	ConcurrentIndexItem__(KK&& k) : key(std::forward<KK>(k)) {}
+};
+
+template <class K>
+class ConcurrentIndex : public ConcurrentHashBase<K, ConcurrentIndexItem__<K>> {
+public:
+	int      FindAdd(const K& k)                 { return this->FindAdd0(k); }
+	int      FindAdd(K&& k)                      { return this->FindAdd0(pick(k)); }
+
+	const K& operator[](int i) const             { return this->GetKey(i); }
+};
+
+template <class K, class T>
+struct ConcurrentMapItem__ {
+	K key;
+	T value;
+
+	template <class KK, class... Args>
+	ConcurrentMapItem__(KK&& k, Args&&... args) : key(std::forward<KK>(k)), value(std::forward<Args>(args)...) {}
+};
+
+template <class K, class T>
+class ConcurrentVectorMap : public ConcurrentHashBase<K, ConcurrentMapItem__<K, T>> {
+	typedef ConcurrentHashBase<K, ConcurrentMapItem__<K, T>> B;
+
+public:
+	int      FindAdd(const K& k)                 { return B::FindAdd0(k); }
+	int      FindAdd(const K& k, const T& init)  { return B::FindAdd0(k, init); }
+	int      FindAdd(K&& k)                      { return B::FindAdd0(pick(k)); }
+	int      FindAdd(K&& k, const T& init)       { return B::FindAdd0(pick(k), init); }
+
+	T&       GetAdd(const K& k)                  { return (*this)[FindAdd(k)]; }
+	T&       GetAdd(const K& k, const T& init)   { return (*this)[FindAdd(k, init)]; }
+	T&       GetAdd(K&& k)                       { return (*this)[FindAdd(pick(k))]; }
+	T&       GetAdd(K&& k, const T& init)        { return (*this)[FindAdd(pick(k), init)]; }
+
+	T       *FindPtr(const K& k)                 { int q = B::Find(k); return q >= 0 ? &(*this)[q] : nullptr; }
+	const T *FindPtr(const K& k) const           { int q = B::Find(k); return q >= 0 ? &(*this)[q] : nullptr; }
+
+	const T& Get(const K& k, const T& d) const   { const T *p = FindPtr(k); return p ? *p : d; }
+
+	T&       operator[](int i)                   { ASSERT(i >= 0 && i < B::GetCount()); return B::Item(i)->value; }
+	const T& operator[](int i) const             { ASSERT(i >= 0 && i < B::GetCount()); return B::Item(i)->value; }
+
+	Vector<T> GetValues() const                  { Vector<T> r; for(int i = 0; i < B::GetCount(); i++) r.Add((*this)[i]); return r; }
+};
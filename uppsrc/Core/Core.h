@@ -335,6 +335,7 @@ class JsonIO;
 #include "Obsolete.h"
 #include "FixedMap.h"
 #include "InVector.h"
+#include "ConcurrentIndex.h"
 
 #include "CharSet.h"
 
@@ -345,6 +346,7 @@ class JsonIO;
 #include "SplitMerge.h"
 
 #include "Other.h"
+#include "FlatIndex.h"
 
 #include "Lang.h"
 
@@ -391,6 +393,7 @@ class JsonIO;
 
 #include "CoAlgo.h"
 #include "CoSort.h"
+#include "RadixSort.h"
 
 #include "LocalProcess.h"
 
@@ -58,45 +58,44 @@ static TimingInspector s_zero; // time of Start / End without actual body to mea
 
 TimingInspector::TimingInspector(const char *_name) {
 	name = _name ? _name : "";
-	all_count = call_count = max_nesting = min_time = max_time = total_time = 0;
-	static bool init;
-	if(!init) {
-#if defined(PLATFORM_WIN32) && !defined(PLATFORM_WINCE)
-		timeBeginPeriod(1);
-#endif
-		init = true;
-	}
+	all_count = call_count = max_nesting = 0;
+	total_time = max_time = 0;
+	min_time = INT64_MAX;
 }
 
 TimingInspector::~TimingInspector() {
 	if(this == &s_zero) return;
-	Mutex::Lock __(mutex);
 	StdLog() << Dump() << "\r\n";
 }
 
-void TimingInspector::Add(dword time, int nesting)
+static void sMin(std::atomic<int64>& a, int64 v)
+{
+	int64 x = a;
+	while(v < x && !a.compare_exchange_weak(x, v));
+}
+
+static void sMax(std::atomic<int64>& a, int64 v)
 {
-	time = tmGetTime() - time;
-	Mutex::Lock __(mutex);
+	int64 x = a;
+	while(v > x && !a.compare_exchange_weak(x, v));
+}
+
+void TimingInspector::Add(int64 time, int nesting)
+{ // lock-free, can be called from many threads
+	time = nsecs() - time;
 	if(!active) return;
 	all_count++;
-	if(nesting > max_nesting)
-		max_nesting = nesting;
+	int n = max_nesting;
+	while(nesting > n && !max_nesting.compare_exchange_weak(n, nesting));
 	if(nesting == 0) {
 		total_time += time;
-		if(call_count++ == 0)
-			min_time = max_time = time;
-		else {
-			if(time < min_time)
-				min_time = time;
-			if(time > max_time)
-				max_time = time;
-		}
+		call_count++;
+		sMin(min_time, time);
+		sMax(max_time, time);
 	}
 }
 
 String TimingInspector::Dump() {
-	Mutex::Lock __(mutex);
 	String s = Sprintf("TIMING %-15s: ", name);
 	if(call_count == 0)
 		return s + "No active hit";
@@ -107,16 +106,17 @@ String TimingInspector::Dump() {
 			TimingInspector::Routine __(s_zero, nesting);
 		}
 	}
-	double tm = max(0.0, double(total_time) / call_count / 1000 -
-			             double(s_zero.total_time) / s_zero.call_count / 1000);
+	int count = call_count;
+	double tm = max(0.0, double(total_time) / count / 1e9 -
+			             double(s_zero.total_time) / s_zero.call_count / 1e9);
 	return s
-	       + timeFormat(tm * call_count)
+	       + timeFormat(tm * count)
 	       + " - " + timeFormat(tm)
-	       + " (" + timeFormat((double)total_time  / 1000) + " / "
-	       + Sprintf("%d )", call_count)
-		   + ", min: " + timeFormat((double)min_time / 1000)
-		   + ", max: " + timeFormat((double)max_time / 1000)
-		   + Sprintf(", nesting: %d - %d", max_nesting, all_count);
+	       + " (" + timeFormat((double)total_time / 1e9) + " / "
+	       + Sprintf("%d )", count)
+		   + ", min: " + timeFormat((double)min_time / 1e9)
+		   + ", max: " + timeFormat((double)max_time / 1e9)
+		   + Sprintf(", nesting: %d - %d", (int)max_nesting, (int)all_count);
 }
 
 HitCountInspector::~HitCountInspector()
@@ -0,0 +1,107 @@
+#include <Core/Core.h>
+
+namespace Upp {
+
+byte FlatIndexCommon::empty_group[GROUP] = {
+	EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+	EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+};
+
+FlatIndexCommon::FlatIndexCommon()
+{
+	ctrl = empty_group;
+	slot = NULL;
+	gmask = 0;
+	used = 0;
+}
+
+void FlatIndexCommon::Free()
+{
+	if(ctrl != empty_group)
+		MemoryFree(ctrl);
+	ctrl = empty_group;
+	slot = NULL;
+	gmask = 0;
+	used = 0;
+}
+
+void FlatIndexCommon::Alloc(int n)
+{ // table for n keys, at most 7/8 full
+	Free();
+	if(n <= 0)
+		return;
+	int groups = 1;
+	while(8 * n > 7 * GROUP * groups)
+		groups += groups;
+	int count = GROUP * groups;
+	ctrl = (byte *)MemoryAlloc(count * (sizeof(int) + 1));
+	slot = (int *)(ctrl + count);
+	memset(ctrl, EMPTY, count);
+	gmask = groups - 1;
+}
+
+void FlatIndexCommon::Place(dword h, int ii)
+{
+	ASSERT(!NeedsRehash());
+	dword g = (h >> 7) & gmask;
+	for(dword step = 0;;) {
+		byte *c = ctrl + GROUP * g;
+		dword m = MatchFree(c);
+		if(m) {
+			int q = GROUP * g + CountTrailingZeroBits(m);
+			if(ctrl[q] == EMPTY)
+				used++;
+			ctrl[q] = h & 0x7f;
+			slot[q] = ii;
+			return;
+		}
+		g = (g + ++step) & gmask;
+	}
+}
+
+void FlatIndexCommon::Erase(int q)
+{
+	ASSERT(q >= 0 && ctrl[q] < 0x80);
+	if(MatchEmpty(ctrl + (q & ~(GROUP - 1)))) { // probing never continues past this group
+		ctrl[q] = EMPTY;
+		used--;
+	}
+	else
+		ctrl[q] = DELETED;
+}
+
+void FlatIndexCommon::Copy(const FlatIndexCommon& b)
+{
+	Free();
+	if(b.ctrl == empty_group)
+		return;
+	int count = b.GetCapacity();
+	ctrl = (byte *)MemoryAlloc(count * (sizeof(int) + 1));
+	slot = (int *)(ctrl + count);
+	memcpy(ctrl, b.ctrl, count * (sizeof(int) + 1));
+	gmask = b.gmask;
+	used = b.used;
+}
+
+void FlatIndexCommon::Pick(FlatIndexCommon& b)
+{
+	Free();
+	ctrl = b.ctrl;
+	slot = b.slot;
+	gmask = b.gmask;
+	used = b.used;
+	b.ctrl = empty_group;
+	b.slot = NULL;
+	b.gmask = 0;
+	b.used = 0;
+}
+
+void FlatIndexCommon::Swap(FlatIndexCommon& b)
+{
+	UPP::Swap(ctrl, b.ctrl);
+	UPP::Swap(slot, b.slot);
+	UPP::Swap(gmask, b.gmask);
+	UPP::Swap(used, b.used);
+}
+
+}
@@ -0,0 +1,420 @@
+struct FlatIndexCommon {
+	enum { EMPTY = 0x80, DELETED = 0xfe, GROUP = 16 };
+
+	byte  *ctrl;  // EMPTY, DELETED or lower 7 bits of hash, GROUP bytes per group
+	int   *slot;  // key index for each ctrl byte
+	dword  gmask; // number of groups - 1
+	int    used;  // full + DELETED slots
+
+	static byte empty_group[GROUP];
+
+#ifdef CPU_SIMD
+	static dword Match(const byte *c, int h)   { return BitMask(i8x16(c) == i8all(h)); }
+	static dword MatchEmpty(const byte *c)     { return BitMask(i8x16(c) == i8all(EMPTY)); }
+	static dword MatchFree(const byte *c)      { return BitMask(i8x16(c) < i8all(0)); }
+#else
+	static dword Match(const byte *c, int h)   { dword m = 0; for(int i = 0; i < GROUP; i++) m |= (c[i] == h) << i; return m; }
+	static dword MatchEmpty(const byte *c)     { return Match(c, EMPTY); }
+	static dword MatchFree(const byte *c)      { dword m = 0; for(int i = 0; i < GROUP; i++) m |= (c[i] >> 7) << i; return m; }
+#endif
+
+	int  GetCapacity() const                   { return ctrl == empty_group ? 0 : GROUP * (gmask + 1); }
+	bool NeedsRehash() const                   { return 8 * (used + 1) > 7 * GetCapacity(); }
+
+	void Place(dword h, int ii);
+	void Erase(int q);
+	void Alloc(int n);
+	void Free();
+
+	void Copy(const FlatIndexCommon& b);
+	void Pick(FlatIndexCommon& b);
+	void Swap(FlatIndexCommon& b);
+
+	FlatIndexCommon();
+	~FlatIndexCommon()                         { Free(); }
+};
+
+template <class T>
+class FlatIndex : MoveableAndDeepCopyOption<FlatIndex<T>>, FlatIndexCommon {
+	Vector<T> key;
+	Bits      unlinked;
+	int       unlinked_count = 0;
+
+	static dword Hash(const T& k)              { return FoldHash(GetHashValue(k)); }
+
+	template <class P> int Probe(dword h, P pred) const;
+
+	int  Find0(const T& k, dword h) const;
+	int  SlotOf(int i) const                   { return Probe(Hash(key[i]), [&](int ii) { return ii == i; }); }
+	void Rehash(int n);
+	template <class U> void Add0(U&& k, dword h);
+	template <class U> int  FindAdd0(U&& k);
+
+public:
+	void        Add(const T& k)                { Add0(k, Hash(k)); }
+	void        Add(T&& k)                     { dword h = Hash(k); Add0(pick(k), h); }
+	FlatIndex&  operator<<(const T& x)         { Add(x); return *this; }
+	FlatIndex&  operator<<(T&& x)              { Add(pick(x)); return *this; }
+
+	int         Find(const T& k) const         { return Find0(k, Hash(k)); }
+	int         FindNext(int i) const;
+
+	int         FindAdd(const T& k)            { return FindAdd0(k); }
+	int         FindAdd(T&& k)                 { return FindAdd0(pick(k)); }
+
+	void        Unlink(int i);
+	int         UnlinkKey(const T& k);
+	bool        IsUnlinked(int i) const        { return unlinked_count && unlinked[i]; }
+	bool        HasUnlinked() const            { return unlinked_count; }
+	void        Sweep();
+
+	void        Set(int i, const T& k);
+
+	const T&    operator[](int i) const        { return key[i]; }
+	int         GetCount() const               { return key.GetCount(); }
+	bool        IsEmpty() const                { return key.IsEmpty(); }
+
+	void        Clear();
+	void        Trim(int n = 0);
+	void        Drop(int n = 1)                { Trim(GetCount() - n); }
+	const T&    Top() const                    { return key.Top(); }
+
+	void        Reserve(int n);
+	void        Shrink()                       { key.Shrink(); Rehash(GetCount()); }
+	int         GetAlloc() const               { return key.GetAlloc(); }
+
+	Vector<T>        PickKeys()                { Vector<T> r = pick(key); Clear(); return r; }
+	const Vector<T>& GetKeys() const           { return key; }
+
+	void     Remove(const int *sorted_list, int count);
+	void     Remove(const Vector<int>& sorted_list)         { Remove(sorted_list, sorted_list.GetCount()); }
+	template <typename Pred> void RemoveIf(Pred p)          { Remove(FindAlli(key, p)); }
+
+	void     Serialize(Stream& s);
+	String   ToString() const                               { return AsStringArray(*this); }
+
+	FlatIndex()                                             {}
+	FlatIndex(FlatIndex&& s) : key(pick(s.key)), unlinked(pick(s.unlinked)), unlinked_count(s.unlinked_count) { FlatIndexCommon::Pick(s); s.unlinked_count = 0; }
+	FlatIndex(const FlatIndex& s, int);
+	explicit FlatIndex(Vector<T>&& s) : key(pick(s))        { Rehash(GetCount()); }
+	FlatIndex(std::initializer_list<T> init) : key(init)    { Rehash(GetCount()); }
+
+	FlatIndex& operator=(FlatIndex&& x);
+	FlatIndex& operator=(Vector<T>&& x)                     { Clear(); key = pick(x); Rehash(GetCount()); return *this; }
+
+	typedef ConstIteratorOf<Vector<T>> ConstIterator;
+	ConstIterator begin() const                             { return key.begin(); }
+	ConstIterator end() const                               { return key.end(); }
+
+	friend void Swap(FlatIndex& a, FlatIndex& b)            { a.FlatIndexCommon::Swap(b); UPP::Swap(a.key, b.key);
+	                                                          UPP::Swap(a.unlinked, b.unlinked); UPP::Swap(a.unlinked_count, b.unlinked_count); }
+};
+
+template <class T>
+template <class P>
+force_inline
+int FlatIndex<T>::Probe(dword h, P pred) const
+{ // groups are probed in triangular sequence, which visits all of them
+	dword g = (h >> 7) & gmask;
+	for(dword step = 0;;) {
+		const byte *c = ctrl + GROUP * g;
+		for(dword m = Match(c, h & 0x7f); m; m &= m - 1) {
+			int q = GROUP * g + CountTrailingZeroBits(m);
+			if(pred(slot[q]))
+				return q;
+		}
+		if(MatchEmpty(c))
+			return -1;
+		g = (g + ++step) & gmask;
+	}
+}
+
+template <class T>
+force_inline
+int FlatIndex<T>::Find0(const T& k, dword h) const
+{
+	int q = Probe(h, [&](int ii) { return key[ii] == k; });
+	return q >= 0 ? slot[q] : -1;
+}
+
+template <class T>
+int FlatIndex<T>::FindNext(int i) const
+{ // without unlinking, same keys are found in the order of adding
+	const T& k = key[i];
+	bool next = false;
+	int q = Probe(Hash(k), [&](int ii) {
+		if(next)
+			return key[ii] == k;
+		next = ii == i;
+		return false;
+	});
+	return q >= 0 ? slot[q] : -1;
+}
+
+template <class T>
+void FlatIndex<T>::Rehash(int n)
+{
+	Alloc(n);
+	for(int i = 0; i < key.GetCount(); i++)
+		if(!IsUnlinked(i))
+			Place(Hash(key[i]), i);
+}
+
+template <class T>
+template <class U>
+void FlatIndex<T>::Add0(U&& k, dword h)
+{
+	if(NeedsRehash())
+		Rehash(2 * GetCount() + 1);
+	Place(h, key.GetCount());
+	key.Add(std::forward<U>(k));
+}
+
+template <class T>
+template <class U>
+int FlatIndex<T>::FindAdd0(U&& k)
+{
+	dword h = Hash(k);
+	int q = Find0(k, h);
+	if(q >= 0)
+		return q;
+	q = key.GetCount();
+	Add0(std::forward<U>(k), h);
+	return q;
+}
+
+template <class T>
+void FlatIndex<T>::Unlink(int i)
+{
+	if(IsUnlinked(i))
+		return;
+	Erase(SlotOf(i));
+	unlinked.Set(i);
+	unlinked_count++;
+}
+
+template <class T>
+int FlatIndex<T>::UnlinkKey(const T& k)
+{
+	int n = 0;
+	dword h = Hash(k);
+	for(;;) {
+		int q = Probe(h, [&](int ii) { return key[ii] == k; });
+		if(q < 0)
+			return n;
+		Unlink(slot[q]);
+		n++;
+	}
+}
+
+template <class T>
+void FlatIndex<T>::Sweep()
+{
+	if(!unlinked_count)
+		return;
+	Vector<int> rm;
+	for(int i = 0; i < key.GetCount(); i++)
+		if(unlinked[i])
+			rm.Add(i);
+	Remove(rm);
+}
+
+template <class T>
+void FlatIndex<T>::Set(int i, const T& k)
+{
+	if(IsUnlinked(i)) {
+		unlinked.Set(i, false);
+		unlinked_count--;
+	}
+	else
+		Erase(SlotOf(i));
+	key[i] = k;
+	if(NeedsRehash())
+		Rehash(2 * GetCount());
+	else
+		Place(Hash(k), i);
+}
+
+template <class T>
+void FlatIndex<T>::Clear()
+{
+	key.Clear();
+	unlinked.Clear();
+	unlinked_count = 0;
+	Free();
+}
+
+template <class T>
+void FlatIndex<T>::Trim(int n)
+{
+	for(int i = GetCount() - 1; i >= n; i--)
+		if(IsUnlinked(i)) {
+			unlinked.Set(i, false);
+			unlinked_count--;
+		}
+		else
+			Erase(SlotOf(i));
+	key.Trim(n);
+}
+
+template <class T>
+void FlatIndex<T>::Reserve(int n)
+{
+	key.Reserve(n);
+	if(8 * n > 7 * GetCapacity())
+		Rehash(n);
+}
+
+template <class T>
+void FlatIndex<T>::Remove(const int *sorted_list, int count)
+{
+	if(!count)
+		return;
+	if(unlinked_count) {
+		Bits nu;
+		int ni = 0;
+		int j = 0;
+		for(int i = 0; i < key.GetCount(); i++)
+			if(j < count && sorted_list[j] == i)
+				j++;
+			else
+				nu.Set(ni++, unlinked[i]);
+		unlinked = pick(nu);
+		unlinked_count = 0;
+		for(int i = 0; i < ni; i++)
+			unlinked_count += unlinked[i];
+	}
+	key.Remove(sorted_list, count);
+	Rehash(GetCount());
+}
+
+template <class T>
+void FlatIndex<T>::Serialize(Stream& s)
+{
+	if(s.IsStoring())
+		Sweep();
+	key.Serialize(s);
+	if(s.IsLoading()) {
+		unlinked.Clear();
+		unlinked_count = 0;
+		Rehash(GetCount());
+	}
+}
+
+template <class T>
+FlatIndex<T>::FlatIndex(const FlatIndex& s, int)
+:	key(s.key, 0)
+{
+	FlatIndexCommon::Copy(s);
+	int n;
+	const dword *b = s.unlinked.Raw(n);
+	if(n)
+		memcpy(unlinked.CreateRaw(n), b, n * sizeof(dword));
+	unlinked_count = s.unlinked_count;
+}
+
+template <class T>
+FlatIndex<T>& FlatIndex<T>::operator=(FlatIndex&& x)
+{
+	if(this != &x) {
+		key = pick(x.key);
+		unlinked = pick(x.unlinked);
+		unlinked_count = x.unlinked_count;
+		x.unlinked_count = 0;
+		FlatIndexCommon::Pick(x);
+	}
+	return *this;
+}
+
+template <class K, class T>
+class FlatVectorMap : MoveableAndDeepCopyOption<FlatVectorMap<K, T>> {
+	FlatIndex<K> key;
+	Vector<T>    value;
+
+public:
+	T&       Add(const K& k, const T& x)            { key.Add(k); return value.Add(x); }
+	T&       Add(const K& k, T&& x)                 { key.Add(k); return value.Add(pick(x)); }
+	T&       Add(const K& k)                        { key.Add(k); return value.Add(); }
+	T&       Add(K&& k, const T& x)                 { key.Add(pick(k)); return value.Add(x); }
+	T&       Add(K&& k, T&& x)                      { key.Add(pick(k)); return value.Add(pick(x)); }
+	T&       Add(K&& k)                             { key.Add(pick(k)); return value.Add(); }
+
+	int      Find(const K& k) const                 { return key.Find(k); }
+	int      FindNext(int i) const                  { return key.FindNext(i); }
+
+	int      FindAdd(const K& k)                    { int n = GetCount(); int q = key.FindAdd(k); if(q == n) value.Add(); return q; }
+	int      FindAdd(const K& k, const T& init)     { int n = GetCount(); int q = key.FindAdd(k); if(q == n) value.Add(init); return q; }
+	int      FindAdd(K&& k)                         { int n = GetCount(); int q = key.FindAdd(pick(k)); if(q == n) value.Add(); return q; }
+	int      FindAdd(K&& k, const T& init)          { int n = GetCount(); int q = key.FindAdd(pick(k)); if(q == n) value.Add(init); return q; }
+
+	T&       GetAdd(const K& k)                     { return value[FindAdd(k)]; }
+	T&       GetAdd(const K& k, const T& x)         { return value[FindAdd(k, x)]; }
+	T&       GetAdd(K&& k)                          { return value[FindAdd(pick(k))]; }
+	T&       GetAdd(K&& k, const T& x)              { return value[FindAdd(pick(k), x)]; }
+
+	T       *FindPtr(const K& k)                    { int q = Find(k); return q >= 0 ? &value[q] : NULL; }
+	const T *FindPtr(const K& k) const              { int q = Find(k); return q >= 0 ? &value[q] : NULL; }
+
+	T&       Get(const K& k)                        { return value[Find(k)]; }
+	const T& Get(const K& k) const                  { return value[Find(k)]; }
+	const T& Get(const K& k, const T& d) const      { int q = Find(k); return q >= 0 ? value[q] : d; }
+
+	void     Unlink(int i)                          { key.Unlink(i); }
+	int      UnlinkKey(const K& k)                  { return key.UnlinkKey(k); }
+	bool     IsUnlinked(int i) const                { return key.IsUnlinked(i); }
+	bool     HasUnlinked() const                    { return key.HasUnlinked(); }
+	void     Sweep();
+
+	const K& GetKey(int i) const                    { return key[i]; }
+	T&       operator[](int i)                      { return value[i]; }
+	const T& operator[](int i) const                { return value[i]; }
+	int      GetCount() const                       { return value.GetCount(); }
+	bool     IsEmpty() const                        { return value.IsEmpty(); }
+
+	void     Clear()                                { key.Clear(); value.Clear(); }
+	void     Trim(int n)                            { key.Trim(n); value.Trim(n); }
+	void     Drop(int n = 1)                        { Trim(GetCount() - n); }
+	void     Reserve(int n)                         { key.Reserve(n); value.Reserve(n); }
+	void     Shrink()                               { key.Shrink(); value.Shrink(); }
+
+	void     Remove(const int *sorted_list, int count) { key.Remove(sorted_list, count); value.Remove(sorted_list, count); }
+	void     Remove(const Vector<int>& sorted_list)    { Remove(sorted_list, sorted_list.GetCount()); }
+
+	const FlatIndex<K>& GetIndex() const            { return key; }
+	const Vector<K>&    GetKeys() const             { return key.GetKeys(); }
+	const Vector<T>&    GetValues() const           { return value; }
+	Vector<T>&          GetValues()                 { return value; }
+	Vector<K>           PickKeys()                  { return key.PickKeys(); }
+	Vector<T>           PickValues()                { Vector<T> r = pick(value); return r; }
+
+	void     Serialize(Stream& s);
+
+	FlatVectorMap()                                 {}
+	FlatVectorMap(FlatVectorMap&& s) : key(pick(s.key)), value(pick(s.value)) {}
+	FlatVectorMap(const FlatVectorMap& s, int) : key(s.key, 0), value(s.value, 0) {}
+	FlatVectorMap& operator=(FlatVectorMap&& s)     { key = pick(s.key); value = pick(s.value); return *this; }
+
+	friend void Swap(FlatVectorMap& a, FlatVectorMap& b) { Swap(a.key, b.key); UPP::Swap(a.value, b.value); }
+};
+
+template <class K, class T>
+void FlatVectorMap<K, T>::Sweep()
+{
+	Vector<int> rm;
+	for(int i = 0; i < GetCount(); i++)
+		if(key.IsUnlinked(i))
+			rm.Add(i);
+	Remove(rm);
+}
+
+template <class K, class T>
+void FlatVectorMap<K, T>::Serialize(Stream& s)
+{
+	if(s.IsStoring())
+		Sweep();
+	s % key % value;
+	if(s.IsLoading() && key.GetCount() != value.GetCount()) {
+		Clear();
+		s.LoadError();
+	}
+}
@@ -4,6 +4,8 @@ struct MemoryOptions { // sizes are in KB
 	int master_reserve; // free master blocks kept in reserve
 	int large_reserve; // free large blocks kept in reserve
 	int small_reserve; // free formatted small block pages kept in reserve
+	int huge_pages; // 0: 4KB pages, 1: transparent 2MB pages (madvise), 2: explicit 2MB pages if available
+	bool numa; // master blocks are allocated and reused per NUMA node of allocating thread
 	
 	MemoryOptions(); // loads default options
 	~MemoryOptions(); // sets options
@@ -12,6 +14,7 @@ struct MemoryOptions { // sizes are in KB
 enum {
 	UPP_HEAP_ALIGNMENT = 16,
 	UPP_HEAP_MINBLOCK = 32,
+	UPP_HEAP_NODES = 8, // maximum number of NUMA arenas
 };
 
 #ifdef UPP_HEAP
@@ -29,6 +32,7 @@ void  MemoryDumpHuge();
 int   MemoryUsedKb();
 int   MemoryUsedKbMax();
 void  MemoryLimitKb(int kb);
+void  MemoryThreadNode(int node); // NUMA arena of current thread, -1: node of current CPU
 
 size_t GetMemoryBlockSize(void *ptr);
 
@@ -80,6 +84,9 @@ struct MemoryProfile {
 	int    sys_count; // blocks directly allocated from the system (>32MB
 	size_t sys_total; // ^total size
 	int    master_chunks; // master blocks
+	int    huge_page_chunks; // ^ backed by explicit 2MB pages
+	int    arena_chunks[UPP_HEAP_NODES]; // master blocks per NUMA arena
+	size_t arena_free[UPP_HEAP_NODES]; // ^ unused 4KB pages
 
 	MemoryProfile();
 };
@@ -146,6 +153,7 @@ inline void   MemoryCheck() {}
 inline void   MemoryCheckDebug() {}
 inline int    MemoryUsedKb() { return 0; }
 inline int    MemoryUsedKbMax() { return 0; }
+inline void   MemoryThreadNode(int) {}
 
 inline void   MemoryIgnoreLeaksBegin() {}
 inline void   MemoryIgnoreLeaksEnd() {}
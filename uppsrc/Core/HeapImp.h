@@ -15,6 +15,7 @@ struct BlkPrefix { // this part is at the start of Blk allocated block, client m
 	word        size;
 	bool        free;
 	bool        last;
+	byte        node; // NUMA arena of huge block
 	Heap       *heap; // we need this for 4KB pages and large blocks, NULL for Huge blocks
 #ifdef CPU_32
 	dword       filler;
@@ -181,6 +182,7 @@ void BlkHeap<Detail, BlkSize>::Split(BlkHeader *h, word wcount, bool fill)
 	h2->SetSize(nsz);
 	h2->SetPrevSize(wcount);
 	h2->SetNextPrevSz();
+	h2->node = h->node;
 	D::LinkFree(h2);
 	if(fill)
 		FillFree(h2);
@@ -254,10 +256,10 @@ typename BlkHeap<Detail, BlkSize>::BlkHeader *BlkHeap<Detail, BlkSize>::Free(Blk
 }
 
 struct HugeHeapDetail {
-	static BlkHeader_<4096> freelist[20][1];
+	static BlkHeader_<4096> freelist[UPP_HEAP_NODES][20][1]; // per NUMA arena
 
 	static int  Cv(int n)                         { return n < 16 ? 0 : SignificantBits(n - 16) + 1; }
-	static void LinkFree(BlkHeader_<4096> *h)     { Dbl_LinkAfter(h, freelist[Cv(h->GetSize())]); }
+	static void LinkFree(BlkHeader_<4096> *h)     { Dbl_LinkAfter(h, freelist[h->node][Cv(h->GetSize())]); }
 	static void NewFreeSize(BlkHeader_<4096> *h)  {}
 };
 
@@ -278,6 +280,11 @@ struct Heap : BlkHeap<HugeHeapDetail, 4096> {
 	static int  max_free_lpages; // maximum free large pages kept in reserve (if more, they are returned to huge system)
 	static int  max_free_spages; // maximum free small pages kept in reserve (but HugeAlloc also converts them)
 	static word sys_block_limit; // > this (in 4KB) blocks are managed directly by system
+	static int  huge_page_mode; // 0: none, 1: madvise transparent huge pages, 2: explicit huge pages
+	static bool numa; // master blocks per NUMA node
+
+	static int   GetNode();
+	static void *SysAllocHuge(size_t size, int node, bool& explicit_huge);
 
 	void *HugeAlloc(size_t count); // count in 4KB, client needs to not touch HugePrefix
 	int   HugeFree(void *ptr);
@@ -376,6 +383,7 @@ struct Heap : BlkHeap<HugeHeapDetail, 4096> {
 	struct HugePage { // to store the list of all huge pages in permanent storage
 		void     *page;
 		HugePage *next;
+		bool      explicit_huge; // allocated as explicit 2MB pages
 	};
 
 	static HugePage *huge_pages;
@@ -390,6 +398,7 @@ struct Heap : BlkHeap<HugeHeapDetail, 4096> {
 	static size_t sys_size;  // blocks allocated directly from system (included in big too)
 	static size_t sys_count;
 	static size_t huge_chunks; // 32MB master pages
+	static size_t explicit_huge_chunks; // ^ backed by explicit 2MB pages
 	static size_t huge_4KB_count_max; // peak huge memory allocated
 	static HugePage *free_huge_pages; // list of records of freed hpages (to be reused)
 	static int       free_hpages; // empty huge pages (in reserve)
@@ -69,6 +69,9 @@ void HttpRequest::Init()
 	chunked_encoding = false;
 	waitevents = 0;
 	ssl_get_proxy = false;
+	pooled = false;
+	reused = false;
+	request_sent = false;
 }
 
 HttpRequest::HttpRequest()
@@ -422,6 +425,14 @@ bool HttpRequest::Do()
 	}
 	
 	if(phase == FAILED) {
+		if(reused && status_code == 0 && (IsIdempotent() || !request_sent)) { // server has closed kept-alive connection meanwhile
+			LLOGS("HTTP reconnect, kept-alive connection failed: " << GetErrorDesc());
+			reused = false;
+			Close();
+			ClearError();
+			StartPhase(START);
+		}
+		else
 		if(retry_count++ < max_retries) {
 			LLOGS("HTTP retry on error " << GetErrorDesc());
 			start_time = msecs();
@@ -436,7 +447,6 @@ bool HttpRequest::Do()
 void HttpRequest::Start()
 {
 	LLOG("HTTP START");
-	Close();
 	ClearError();
 	gzip = false;
 	z.Clear();
@@ -444,6 +454,7 @@ void HttpRequest::Start()
 	status_code = 0;
 	reason_phrase.Clear();
 	body.Clear();
+	chunked_encoding = false;
 	WhenStart();
 
 	bool ssl_connect = ssl && !ssl_get_proxy;
@@ -455,6 +466,18 @@ void HttpRequest::Start()
 	phost = use_proxy ? ssl_connect ? ssl_proxy_host : proxy_host : host;
 	LLOG("Using " << (use_proxy ? "proxy " : "") << phost << ":" << p);
 
+	String target;
+	target << phost << ':' << p << ':' << ssl << ':' << host << ':' << port;
+	if(pooled && keep_alive && IsOpen() && !IsEof() && connection == target) {
+		LLOG("Reusing connection " << target);
+		reused = true;
+		StartRequest();
+		return;
+	}
+	Close();
+	reused = false;
+	connection = target;
+
 	SSLServerNameIndication(host);
 
 	StartPhase(DNS);
@@ -545,6 +568,7 @@ void HttpRequest::StartRequest()
 	StartPhase(REQUEST);
 	waitevents = WAIT_WRITE;
 	count = 0;
+	request_sent = false;
 	String ctype = contenttype;
 	if((method == METHOD_POST || method == METHOD_PUT) && IsNull(ctype))
 		ctype = "application/x-www-form-urlencoded";
@@ -641,6 +665,7 @@ bool HttpRequest::SendingData(bool request)
 				return false;
 			}
 			count += n;
+			request_sent = true;
 		}
 	if(poststream && request)
 		for(;;) {
@@ -753,9 +778,19 @@ void HttpRequest::StartBody()
 	has_content_length = HasContentLength();
 	
 	
-	if(method == METHOD_HEAD)
+	if(status_code == 204 || status_code == 304) { // no body
+		gzip = false;
+		body.Clear();
+		Finish();
+		return;
+	}
+	if(method == METHOD_HEAD) {
+		CopyCookies();
+		if(pooled && !CanKeepAlive())
+			Close();
 		phase = FINISHED;
-	else
+		return;
+	}
 	if(header["transfer-encoding"] == "chunked") {
 		count = 0;
 		chunked_encoding = true;
@@ -868,13 +903,14 @@ void HttpRequest::Finish()
 	}
 	CopyCookies();
 	if(status_code == 401 && redirect_count++ < max_redirects && WhenAuthenticate()) {
-		if(keep_alive)
+		if(CanKeepAlive())
 			StartRequest();
 		else
 			Start();
 		return;
 	}
-	Close();
+	if(!pooled || !CanKeepAlive())
+		Close();
 	if(status_code >= 300 && status_code < 400) {
 		String url = GetRedirectUrl();
 		GET();
@@ -889,6 +925,38 @@ void HttpRequest::Finish()
 	phase = FINISHED;
 }
 
+bool HttpRequest::CanKeepAlive()
+{ // connection can be used for the next request
+	if(!keep_alive || !IsOpen() || IsEof() || IsError())
+		return false;
+	if(!has_content_length && !chunked_encoding && method != METHOD_HEAD &&
+	   status_code != 204 && status_code != 304)
+		return false; // body was terminated by closing the connection
+	String c = ToLower(header["connection"]);
+	return c.Find("close") < 0 && (protocol == "HTTP/1.1" || c.Find("keep-alive") >= 0);
+}
+
+bool HttpRequest::IsIdempotent() const
+{ // request can be sent again even if server might have processed it
+	return IsNull(custom_method) &&
+	       findarg(method, METHOD_GET, METHOD_HEAD, METHOD_PUT, METHOD_DELETE, METHOD_TRACE, METHOD_OPTIONS) >= 0;
+}
+
+void HttpRequest::AddTo(SocketEventLoop& loop, Event<> whenfinished)
+{
+	Timeout(0);
+	loop.Drive([=] {
+	                  while(Do())
+	                      if(!(GetWaitEvents() & WAIT_READ) || Peek() < 0)
+	                          return true; // data already in socket buffer would not wake the loop
+	                  whenfinished();
+	                  return false;
+	              },
+	           [=] { return GetSOCKET(); },
+	           [=] { return GetWaitEvents(); },
+	           timeout == INT_MAX ? (int)Null : timeout);
+}
+
 String HttpRequest::Execute()
 {
 	New();
@@ -0,0 +1,196 @@
+#include "Core.h"
+
+namespace Upp {
+
+#define LLOG(x)  // LOG("HttpClientPool " << x)
+
+String HttpClientPool::GetTarget(const String& url)
+{ // requests with the same target can share connections, parsed the same way as HttpRequest::Url
+	const char *u = url;
+	bool ssl = memcmp(u, "https", 5) == 0;
+	const char *t = u;
+	while(*t && *t != '?')
+		if(*t++ == '/' && *t == '/') {
+			u = ++t;
+			break;
+		}
+	t = u;
+	while(*u && *u != ':' && *u != '/' && *u != '?')
+		u++;
+	int port = *u == ':' ? ScanInt(u + 1) : 0;
+	return GetTarget(ssl, String(t, u), port);
+}
+
+String HttpClientPool::GetTarget(bool ssl, const String& host, int port)
+{
+	return String(ssl ? "https://" : "http://") + ToLower(host) + ':' + AsString(Nvl(port, ssl ? 443 : 80));
+}
+
+int HttpClientPool::Add(const String& url, Event<HttpRequest&> setup, Event<HttpRequest&> done)
+{
+	Job& job = queue.Add();
+	job.id = ++job_id;
+	job.url = url;
+	job.target = GetTarget(url);
+	job.setup = pick(setup);
+	job.done = pick(done);
+	Schedule();
+	return job.id;
+}
+
+bool HttpClientPool::Cancel(int id)
+{ // only requests still waiting in the queue can be canceled
+	for(int i = 0; i < queue.GetCount(); i++)
+		if(queue[i].id == id) {
+			queue.Remove(i);
+			return true;
+		}
+	return false;
+}
+
+void HttpClientPool::Schedule()
+{ // Pump runs from timer so that it is never called from HttpRequest::Do of finished request
+	if(pump_timer < 0)
+		pump_timer = loop->SetTimer(0, [=] { pump_timer = -1; Pump(); });
+}
+
+void HttpClientPool::Park(Slot& s)
+{ // idle connection is closed when server closes it (becomes readable) or after idle_timeout
+	Slot *sp = &s;
+	s.idle_socket = s.request.GetSOCKET();
+	loop->Add(s.idle_socket, WAIT_READ, [=](dword) { LLOG("Server closed " << sp->target); RemoveSlot(sp); });
+	s.idle_timer = loop->SetTimer(idle_timeout, [=] { sp->idle_timer = -1; RemoveSlot(sp); });
+}
+
+void HttpClientPool::Unpark(Slot& s)
+{
+	if(s.idle_socket != INVALID_SOCKET) {
+		loop->Remove(s.idle_socket);
+		s.idle_socket = INVALID_SOCKET;
+	}
+	if(s.idle_timer >= 0) {
+		loop->KillTimer(s.idle_timer);
+		s.idle_timer = -1;
+	}
+}
+
+void HttpClientPool::RemoveSlot(Slot *s)
+{
+	Unpark(*s);
+	s->request.Close();
+	for(int i = 0; i < slot.GetCount(); i++)
+		if(&slot[i] == s) {
+			slot.Remove(i);
+			break;
+		}
+}
+
+void HttpClientPool::StartJob(Slot& s, Job& job)
+{
+	LLOG("Start " << job.url << (s.request.IsOpen() ? " (reused connection)" : ""));
+	Unpark(s);
+	s.active = true;
+	active++;
+	HttpRequest& r = s.request;
+	r.NewRequest(); // keeps the connection open
+	r.ClearCookies();
+	r.WhenContent.Clear();
+	r.WhenStart.Clear();
+	r.WhenDo.Clear();
+	r.KeepAlive();
+	r.pooled = true;
+	r.Url(job.url);
+	WhenRequest(r);
+	job.setup(r);
+	Slot *sp = &s;
+	r.AddTo(*loop, [=, done = pick(job.done)] { Finished(sp, done); });
+}
+
+void HttpClientPool::Finished(Slot *s, Event<HttpRequest&> done)
+{ // called from HttpRequest::Do, slot is parked or removed later in Pump
+	s->active = false;
+	active--;
+	done(s->request);
+	Schedule();
+}
+
+void HttpClientPool::Pump()
+{
+	for(int i = slot.GetCount() - 1; i >= 0; i--) { // connections of finished requests
+		Slot& s = slot[i];
+		if(!s.active && s.idle_socket == INVALID_SOCKET) {
+			if(s.request.IsOpen() && !s.request.IsError()) {
+				HttpRequest& r = s.request;
+				s.target = GetTarget(r.ssl, r.host, r.port); // request could be redirected to another host
+				Park(s);
+			}
+			else
+				RemoveSlot(&s);
+		}
+	}
+	VectorMap<String, int> host; // connections per target
+	for(const Slot& s : slot)
+		host.GetAdd(s.target, 0)++;
+	for(int i = 0; i < queue.GetCount() && active < max_connections;) {
+		Job& job = queue[i];
+		Slot *s = NULL;
+		for(Slot& m : slot)
+			if(!m.active && m.target == job.target) {
+				s = &m;
+				break;
+			}
+		if(s)
+			reuse_count++;
+		else {
+			if(host.Get(job.target, 0) >= max_host_connections) {
+				i++; // keep in queue, try requests for other hosts
+				continue;
+			}
+			if(slot.GetCount() >= max_connections)
+				for(Slot& m : slot) // close idle connection to another host
+					if(!m.active) {
+						host.GetAdd(m.target)--;
+						RemoveSlot(&m);
+						break;
+					}
+			s = &slot.Add();
+			s->target = job.target;
+			host.GetAdd(job.target, 0)++;
+			connect_count++;
+		}
+		StartJob(*s, job);
+		queue.Remove(i);
+	}
+}
+
+bool HttpClientPool::Do(int timeout)
+{
+	if(!InProgress())
+		return false;
+	loop->Wait(timeout);
+	return InProgress();
+}
+
+void HttpClientPool::Finish()
+{
+	while(Do())
+		;
+}
+
+void HttpClientPool::CloseIdle()
+{
+	for(int i = slot.GetCount() - 1; i >= 0; i--)
+		if(!slot[i].active)
+			RemoveSlot(&slot[i]);
+}
+
+HttpClientPool::~HttpClientPool()
+{ // requests still in progress in external loop would refer to destroyed pool
+	ASSERT(loop == &own_loop || active == 0);
+	if(pump_timer >= 0)
+		loop->KillTimer(pump_timer);
+	for(Slot& s : slot)
+		Unpark(s);
+}
+
+}
@@ -262,7 +262,11 @@ public:
 
 class SocketWaitEvent {
 	Vector<Tuple<int, dword>> socket;
+#ifdef PLATFORM_POSIX
+	Buffer<byte>              pollfds; // struct pollfd, poll has no FD_SETSIZE limit
+#else
 	fd_set read[1], write[1], exception[1];
+#endif
 	SocketWaitEvent(const SocketWaitEvent &);
 
 public:
@@ -276,6 +280,72 @@ public:
 	SocketWaitEvent();
 };
 
+class HttpRequest;
+class WebSocket;
+
+class SocketEventLoop : NoCopy {
+	struct Slot : Moveable<Slot> {
+		dword        events;
+		Event<dword> cb;
+	};
+	
+	struct Timer : Moveable<Timer> {
+		int64 at;
+		int   id;
+	};
+	
+	struct Driver : Link<> {
+		Gate<>              step;
+		Function<SOCKET ()> socket;
+		Function<dword ()>  events;
+		int                 idle;
+		SOCKET              fd = INVALID_SOCKET;
+		int                 timer = -1;
+	};
+
+	VectorMap<SOCKET, Slot> slot;
+	Vector<Timer>           timer; // binary heap ordered by 'at'
+	VectorMap<int, Event<>> timer_fn;
+	Link<>                  drivers;
+	int                     timer_id = 0;
+	bool                    quit = false;
+	bool                    edge = true;
+	int                     epoll_fd = -1;
+
+	bool  Ctl(int op, SOCKET s, dword events);
+	int   GetWaitTimeout(int timeout) const;
+	int   FireTimers();
+	void  Dispatch(SOCKET s, dword events);
+	void  DriveStep(Driver *d);
+
+public:
+	SocketEventLoop& EdgeTriggered(bool b = true)                   { edge = b; return *this; }
+	SocketEventLoop& LevelTriggered()                               { return EdgeTriggered(false); }
+
+	bool  Add(SOCKET s, dword events, Event<dword> cb);
+	bool  Add(TcpSocket& s, dword events, Event<dword> cb)          { return Add(s.GetSOCKET(), events, cb); }
+	bool  Modify(SOCKET s, dword events);
+	bool  Modify(TcpSocket& s, dword events)                        { return Modify(s.GetSOCKET(), events); }
+	void  Remove(SOCKET s);
+	void  Remove(TcpSocket& s)                                      { Remove(s.GetSOCKET()); }
+	bool  Has(SOCKET s) const                                       { return slot.Find(s) >= 0; }
+	int   GetCount() const                                          { return slot.GetCount(); }
+
+	int   SetTimer(int delay_ms, Event<> cb);
+	void  KillTimer(int id);
+	int   GetTimerCount() const                                     { return timer_fn.GetCount(); }
+
+	void  Drive(Gate<> step, Function<SOCKET ()> socket, Function<dword ()> events, int idle_ms = Null);
+
+	int   Wait(int timeout = Null);
+	void  Run();
+	void  Exit()                                                    { quit = true; }
+	bool  IsExit() const                                            { return quit; }
+
+	SocketEventLoop();
+	~SocketEventLoop();
+};
+
 struct UrlInfo {
 	String                            url;
 
@@ -398,6 +468,12 @@ class HttpRequest : public TcpSocket {
 	String       phost;
 	bool         ssl;
 	bool         ssl_get_proxy;
+	String       connection; // target of open socket, to reuse it with keep-alive
+	bool         pooled; // managed by HttpClientPool, Start can reuse kept-alive connection
+	bool         reused;
+	bool         request_sent; // some bytes of the request were sent
+
+	friend class HttpClientPool;
 
 	int          method;
 	String       custom_method;
@@ -454,6 +530,8 @@ class HttpRequest : public TcpSocket {
 	bool         ReadingBody();
 	void         ReadingChunkHeader();
 	void         Finish();
+	bool         CanKeepAlive();
+	bool         IsIdempotent() const;
 	bool         IsRequestTimeout();
 	void         CopyCookies();
 
@@ -588,6 +666,7 @@ public:
 
 	bool    Do();
 	dword   GetWaitEvents()                       { return waitevents; }
+	void    AddTo(SocketEventLoop& loop, Event<> whenfinished);
 	int     GetPhase() const                      { return phase; }
 	String  GetPhaseName() const;
 	bool    InProgress() const                    { return phase != FAILED && phase != FINISHED; }
@@ -609,6 +688,77 @@ public:
 	static void  TraceShort(bool b = true);
 };
 
+class HttpClientPool : NoCopy {
+	struct Job : Moveable<Job> {
+		int                 id;
+		String              url;
+		String              target; // scheme://host:port
+		Event<HttpRequest&> setup;
+		Event<HttpRequest&> done;
+	};
+
+	struct Slot { // one connection
+		HttpRequest request;
+		String      target;
+		bool        active = false;
+		int         idle_timer = -1;
+		SOCKET      idle_socket = INVALID_SOCKET;
+	};
+
+	SocketEventLoop  own_loop;
+	SocketEventLoop *loop;
+	Array<Slot>      slot;
+	Vector<Job>      queue;
+	int              job_id = 0;
+	int              pump_timer = -1;
+	int              active = 0;
+	int64            connect_count = 0; // requests started on new connection
+	int64            reuse_count = 0; // requests started on kept-alive connection
+
+	int              max_connections = 64;
+	int              max_host_connections = 6;
+	int              idle_timeout = 30000;
+
+	static String GetTarget(const String& url);
+	static String GetTarget(bool ssl, const String& host, int port);
+
+	void  Schedule();
+	void  Pump();
+	void  StartJob(Slot& s, Job& job);
+	void  Finished(Slot *s, Event<HttpRequest&> done);
+	void  Park(Slot& s);
+	void  Unpark(Slot& s);
+	void  RemoveSlot(Slot *s);
+
+public:
+	Event<HttpRequest&> WhenRequest; // common setup of all requests
+
+	HttpClientPool& MaxConnections(int n)                 { max_connections = max(n, 1); Schedule(); return *this; }
+	HttpClientPool& MaxHostConnections(int n)             { max_host_connections = max(n, 1); Schedule(); return *this; }
+	HttpClientPool& IdleTimeout(int ms)                   { idle_timeout = ms; return *this; }
+
+	int   Add(const String& url, Event<HttpRequest&> setup, Event<HttpRequest&> done);
+	int   Add(const String& url, Event<HttpRequest&> done) { return Add(url, Event<HttpRequest&>(), pick(done)); }
+	bool  Cancel(int id);
+
+	int   GetQueueCount() const                           { return queue.GetCount(); }
+	int   GetActiveCount() const                          { return active; }
+	int   GetConnectionCount() const                      { return slot.GetCount(); }
+	int   GetIdleCount() const                            { return slot.GetCount() - active; }
+	int64 GetConnectCount() const                         { return connect_count; }
+	int64 GetReuseCount() const                           { return reuse_count; }
+	bool  InProgress() const                              { return active || queue.GetCount(); }
+
+	SocketEventLoop& GetLoop()                            { return *loop; }
+	bool  Do(int timeout = Null);
+	void  Finish();
+	void  CloseIdle();
+
+	HttpClientPool()                                      { loop = &own_loop; }
+	HttpClientPool(SocketEventLoop& loop) : loop(&loop)   {}
+	~HttpClientPool();
+};
+
 bool HttpResponse(TcpSocket& socket, bool scgi, int code, const char *phrase = NULL,
                   const char *content_type = NULL, const String& data = Null,
                   const char *server = NULL, bool gzip = false);
@@ -740,6 +890,7 @@ public:
 	SOCKET GetSOCKET() const                            { return socket ? socket->GetSOCKET() : INVALID_SOCKET; }
 	String GetPeerAddr() const                          { return socket ? socket->GetPeerAddr() : String(); }
 	void   AddTo(SocketWaitEvent& e)                    { e.Add(*socket, GetWaitEvents()); }
+	void   AddTo(SocketEventLoop& loop, Event<> whenevent);
 
 	static void Trace(bool b = true);
 
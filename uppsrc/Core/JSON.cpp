@@ -168,6 +168,92 @@ void JsonIO::Set(const char *key, const Value& v)
 	map->Add(key, v);
 }
 
+JsonIO::JsonIO(JsonReader& r)
+{ // loads directly from reader, without building the Value tree where possible
+	reader = &r;
+	src = &tgt;
+	if(r.GetToken() == JSON_KEY)
+		r.Next();
+	type = r.GetToken();
+	depth = r.GetDepth();
+	open = type == JSON_ARRAY || type == JSON_OBJECT;
+	if(!open)
+		tgt = r.GetValue();
+}
+
+void JsonIO::Load()
+{ // converts the rest of current array or object to Value
+	if(type == JSON_OBJECT) {
+		ValueMap m;
+		if(map)
+			m = pick(*map);
+		while(reader->Next() == JSON_KEY) {
+			String key = reader->GetText();
+			reader->Next();
+			m.Add(key, reader->GetValue());
+		}
+		tgt = m;
+	}
+	else
+		tgt = reader->GetValue();
+	type = JSON_EOF;
+	open = false;
+}
+
+const Value *JsonIO::StreamMember(const char *key)
+{ // NULL means that the value is at the reader position
+	if(type != JSON_OBJECT)
+		return &Get()[key];
+	if(map) {
+		int q = map->Find(key);
+		if(q >= 0)
+			return &map->GetValue(q);
+	}
+	while(open) { // members usually come in the same order as Jsonize asks for them
+		if(reader->Next() != JSON_KEY) {
+			open = false;
+			break;
+		}
+		String k = reader->GetText();
+		reader->Next();
+		if(k == key)
+			return NULL;
+		if(!map)
+			map.Create();
+		map->Add(k, reader->GetValue());
+	}
+	return &tgt; // void
+}
+
+Value JsonIO::Get(const char *key)
+{
+	ASSERT(IsLoading());
+	const Value *v = Member(key);
+	if(v)
+		return *v;
+	Value r = reader->GetValue(); // keep it for another Get of the same key
+	if(!map)
+		map.Create();
+	map->Add(key, r);
+	return r;
+}
+
+bool JsonIO::NextItem()
+{
+	ASSERT(type == JSON_ARRAY);
+	if(open && reader->Next() != JSON_END_ARRAY)
+		return true;
+	open = false;
+	return false;
+}
+
+void JsonIO::End()
+{ // skips the rest of current value
+	if(open)
+		while(reader->Next() != JSON_EOF && reader->GetDepth() >= depth);
+	open = false;
+}
+
 String AsJSON(const Value& v, bool pretty)
 {
 	return AsJSON(v, String(), pretty);
@@ -415,4 +501,4 @@ String sJsonFile(const char *file)
 	return file ? String(file) : ConfigFile(GetExeTitle() + ".json");
 }
 
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -1,6 +1,134 @@
 Value  ParseJSON(CParser& p);
 Value  ParseJSON(const char *s);
 
+enum { JSON_EOF, JSON_NULL, JSON_BOOL, JSON_NUMBER, JSON_STRING, JSON_KEY,
+       JSON_ARRAY, JSON_END_ARRAY, JSON_OBJECT, JSON_END_OBJECT };
+
+struct JsonError : Exc {
+	JsonError(const String& s) : Exc(s) {}
+};
+
+class JsonReader {
+	enum { CHUNK = 16384 };
+
+	Stream      *in;
+	Buffer<char> buffer;
+	String       source;
+	const char  *ptr;
+	const char  *end;
+	int          line;
+
+	Vector<char> stack;
+	bool         after;
+	bool         member;
+
+	int          token;
+	String       text;
+	double       number;
+	bool         date;
+
+	bool   More();
+	int    Peek()                          { return ptr < end || More() ? (byte)*ptr : -1; }
+	int    Get()                           { return ptr < end || More() ? (byte)*ptr++ : -1; }
+	void   SkipWhites();
+	void   ReadString();
+	void   ReadNumber();
+	int    Close();
+	void   Init();
+
+public:
+	int           Next();
+	int           GetToken() const         { return token; }
+	bool          IsEof() const            { return token == JSON_EOF; }
+
+	const String& GetText() const          { return text; }
+	double        GetNumber() const        { return number; }
+	bool          GetBool() const          { return number; }
+	int           GetDepth() const         { return stack.GetCount(); }
+	int           GetLine() const          { return line; }
+
+	Value         GetValue();
+	Value         ReadValue()              { Next(); return GetValue(); }
+	void          Skip();
+
+	void          Error(const char *s);
+
+	JsonReader(Stream& in);
+	JsonReader(const String& s);
+};
+
+class JsonDom {
+	struct Item {
+		byte   type;
+		bool   date;
+		int    count; // string length, array elements or object members
+		union {
+			double      number;
+			const char *text;
+			const Item *item; // object members are stored as key, value pairs
+		};
+	};
+
+	String               source;
+	Vector<Buffer<byte>> arena;
+	byte                *aptr;
+	byte                *aend;
+	int64                used;
+	Vector<Item>         temp;
+	Item                 root;
+	String               error;
+	const char          *s;
+	int                  line;
+
+	void  *Alloc(size_t size);
+	void   Error(const char *text);
+	void   SkipWhites();
+	void   ReadString(Item& m);
+	void   ReadValue(Item& m, int depth);
+
+public:
+	class Node : Moveable<Node> {
+		const Item *item;
+
+		friend class JsonDom;
+
+	public:
+		bool        IsVoid() const             { return !item; }
+		int         GetType() const            { return item ? (int)item->type : (int)JSON_EOF; }
+		bool        IsNull() const             { return GetType() == JSON_NULL; }
+		bool        IsBool() const             { return GetType() == JSON_BOOL; }
+		bool        IsNumber() const           { return GetType() == JSON_NUMBER; }
+		bool        IsString() const           { return GetType() == JSON_STRING; }
+		bool        IsArray() const            { return GetType() == JSON_ARRAY; }
+		bool        IsObject() const           { return GetType() == JSON_OBJECT; }
+
+		int         GetCount() const           { return IsArray() || IsObject() ? item->count : 0; }
+		Node        operator[](int i) const;
+		Node        operator[](const char *key) const;
+		Node        GetKey(int i) const;
+
+		const char *GetText() const            { return IsString() ? item->text : NULL; } // not zero terminated
+		int         GetLength() const          { return IsString() ? item->count : 0; }
+		String      GetString() const          { return String(GetText(), GetLength()); }
+		bool        IsEqual(const char *s) const;
+		double      GetNumber() const          { return IsNumber() || IsBool() ? item->number : (double)Null; }
+		bool        GetBool() const            { return IsBool() && item->number; }
+
+		Value       ToValue() const;
+
+		Node(const Item *item = NULL) : item(item) {}
+	};
+
+	bool   Parse(const String& json);
+	Node   GetRoot() const                     { return error.GetCount() ? Node() : Node(&root); }
+	String GetError() const                    { return error; }
+	int64  GetMemoryUsed() const               { return used; }
+	void   Clear();
+
+	JsonDom()                                  { Clear(); }
+	JsonDom(const String& json)                { Parse(json); }
+};
+
 inline String AsJSON(int i)             { return IsNull(i) ? String("null") : AsString(i); }
 inline String AsJSON(double n)          { return IsNull(n) ? String("null") : AsString(n); }
 inline String AsJSON(float f)           { return IsNull(f) ? String("null") : AsString(f); }
@@ -91,17 +219,27 @@ inline Json& Json::operator()(const char *key, const JsonArray& array)
 
 class JsonIO {
 	const Value   *src;
-	One<ValueMap>  map;
+	One<ValueMap>  map; // when loading from JsonReader, members skipped while looking for a key
 	Value          tgt;
 
+	JsonReader    *reader = NULL;
+	int            type;
+	int            depth;
+	bool           open; // reader is inside of current array or object
+
+	void         Load();
+	const Value *StreamMember(const char *key);
+	const Value *Member(const char *key)         { return reader ? StreamMember(key) : &(*src)[key]; }
+
 public:
 	bool IsLoading() const                       { return src; }
 	bool IsStoring() const                       { return !src; }
 
-	const Value& Get() const                     { ASSERT(IsLoading()); return *src; }
+	const Value& Get() const                     { ASSERT(IsLoading() && !open); return *src; }
+	const Value& Get()                           { ASSERT(IsLoading()); if(reader && open) Load(); return *src; }
 	void         Set(const Value& v)             { ASSERT(IsStoring() && !map); tgt = v; }
 
-	Value        Get(const char *key)            { ASSERT(IsLoading()); return (*src)[key]; }
+	Value        Get(const char *key);
 	void         Set(const char *key, const Value& v);
 
 	void         Put(Value& v)                   { ASSERT(IsStoring()); if(map) v = *map; else v = tgt; }
@@ -122,8 +260,14 @@ public:
 	template <class T, class X>
 	JsonIO& Array(const char *key, T& value, X item_jsonize, const char * = NULL);
 
-	JsonIO(const Value& src) : src(&src)         {}
-	JsonIO()                                     { src = NULL; }
+	JsonReader  *GetReader() const               { return reader; }
+	bool         IsArrayStream() const           { return reader && open && type == JSON_ARRAY; }
+	bool         NextItem();
+	void         End();
+
+	JsonIO(const Value& src) : src(&src)         { open = false; }
+	JsonIO(JsonReader& r);
+	JsonIO()                                     { src = NULL; open = false; }
 };
 
 struct JsonizeError : Exc {
@@ -140,9 +284,15 @@ template <class T>
 JsonIO& JsonIO::operator()(const char *key, T& value)
 {
 	if(IsLoading()) {
-		const Value& v = (*src)[key];
-		if(!v.IsVoid()) {
-			JsonIO jio(v);
+		const Value *v = Member(key);
+		if(!v) { // value is at reader position
+			JsonIO jio(*reader);
+			Jsonize(jio, value);
+			jio.End();
+		}
+		else
+		if(!v->IsVoid()) {
+			JsonIO jio(*v);
 			Jsonize(jio, value);
 		}
 	}
@@ -164,9 +314,15 @@ template <class T, class X>
 JsonIO& JsonIO::Var(const char *key, T& value, X jsonize)
 {
 	if(IsLoading()) {
-		const Value& v = (*src)[key];
-		if(!v.IsVoid()) {
-			JsonIO jio(v);
+		const Value *v = Member(key);
+		if(!v) { // value is at reader position
+			JsonIO jio(*reader);
+			jsonize(jio, value);
+			jio.End();
+		}
+		else
+		if(!v->IsVoid()) {
+			JsonIO jio(*v);
 			jsonize(jio, value);
 		}
 	}
@@ -188,6 +344,18 @@ JsonIO& JsonIO::Var(const char *key, T& value, X jsonize)
 template <class T, class X>
 void JsonizeArray(JsonIO& io, T& array, X item_jsonize)
 {
+	if(io.IsArrayStream()) { // elements are loaded directly from JsonReader
+		int n = 0;
+		while(io.NextItem()) {
+			if(n >= array.GetCount())
+				array.SetCount(n + 1);
+			JsonIO jio(*io.GetReader());
+			item_jsonize(jio, array[n++]);
+			jio.End();
+		}
+		array.SetCount(n);
+	}
+	else
 	if(io.IsLoading()) {
 		const Value& va = io.Get();
 		array.SetCount(va.GetCount());
@@ -211,9 +379,15 @@ void JsonizeArray(JsonIO& io, T& array, X item_jsonize)
 template <class T, class X> JsonIO& JsonIO::Array(const char *key, T& value, X item_jsonize, const char *)
 {
 	if(IsLoading()) {
-		const Value& v = (*src)[key];
-		if(!v.IsVoid()) {
-			JsonIO jio(v);
+		const Value *v = Member(key);
+		if(!v) { // value is at reader position
+			JsonIO jio(*reader);
+			JsonizeArray(jio, value, item_jsonize);
+			jio.End();
+		}
+		else
+		if(!v->IsVoid()) {
+			JsonIO jio(*v);
 			JsonizeArray(jio, value, item_jsonize);
 		}
 	}
@@ -235,11 +409,17 @@ template <class T>
 JsonIO& JsonIO::operator()(const char *key, T& value, const T& defvalue)
 {
 	if(IsLoading()) {
-		const Value& v = (*src)[key];
-		if(v.IsVoid())
+		const Value *v = Member(key);
+		if(!v) {
+			JsonIO jio(*reader);
+			Jsonize(jio, value);
+			jio.End();
+		}
+		else
+		if(v->IsVoid())
 			value = defvalue;
 		else {
-			JsonIO jio(v);
+			JsonIO jio(*v);
 			Jsonize(jio, value);
 		}
 	}
@@ -296,6 +476,34 @@ bool LoadFromJson(T& var, const char *json)
 	return true;
 }
 
+template <class T>
+void LoadFromJson(T& var, JsonReader& r)
+{ // loads the value at current position of r, e.g. single element of large array
+	JsonIO io(r);
+	Jsonize(io, var);
+	io.End();
+}
+
+template <class T>
+bool LoadFromJson(T& var, Stream& in)
+{
+	try {
+		JsonReader r(in);
+		r.Next();
+		LoadFromJson(var, r);
+	}
+	catch(JsonError) {
+		return false;
+	}
+	catch(ValueTypeError) {
+		return false;
+	}
+	catch(JsonizeError) {
+		return false;
+	}
+	return true;
+}
+
 String sJsonFile(const char *file);
 
 template <class T>
@@ -0,0 +1,590 @@
+#include "Core.h"
+
+namespace Upp {
+
+static int sHex4(const char *s)
+{
+	int n = 0;
+	for(int i = 0; i < 4; i++) {
+		int c = ToUpper(s[i]);
+		if(IsDigit(c))
+			n = 16 * n + c - '0';
+		else
+		if(c >= 'A' && c <= 'F')
+			n = 16 * n + c - 'A' + 10;
+		else
+			return -1;
+	}
+	return n;
+}
+
+static bool sIsDate(const String& s)
+{
+	return s.StartsWith("/Date(");
+}
+
+static Value sDate(const String& s)
+{
+	CParser p(s);
+	if(p.Char('/') && p.Id("Date") && p.Char('(') && p.IsInt()) {
+		int64 n = p.ReadInt64();
+		if(!IsNull(n))
+			return Time(1970, 1, 1) + n / 1000;
+	}
+	return s;
+}
+
+void JsonReader::Init()
+{
+	line = 1;
+	after = member = false;
+	token = JSON_EOF;
+	number = 0;
+	date = false;
+}
+
+JsonReader::JsonReader(Stream& in_)
+{
+	in = &in_;
+	buffer.Alloc(CHUNK);
+	ptr = end = ~buffer;
+	Init();
+}
+
+JsonReader::JsonReader(const String& s)
+{
+	in = NULL;
+	source = s;
+	ptr = ~source;
+	end = source.End();
+	Init();
+}
+
+bool JsonReader::More()
+{
+	if(!in)
+		return false;
+	int n = in->Get(~buffer, CHUNK);
+	if(n <= 0)
+		return false;
+	ptr = ~buffer;
+	end = ptr + n;
+	return true;
+}
+
+void JsonReader::Error(const char *s)
+{
+	throw JsonError(Format("(%d): %s", line, s));
+}
+
+void JsonReader::SkipWhites()
+{
+	for(;;) {
+		while(ptr < end && (byte)*ptr <= ' ')
+			if(*ptr++ == '\n')
+				line++;
+		int c = Peek();
+		if(c == '/') { // C comments are accepted like in ParseJSON
+			Get();
+			c = Get();
+			if(c == '/')
+				while((c = Get()) >= 0 && c != '\n');
+			else
+			if(c == '*') {
+				int c0 = 0;
+				while((c = Get()) >= 0 && !(c0 == '*' && c == '/')) {
+					if(c == '\n')
+						line++;
+					c0 = c;
+				}
+			}
+			else
+				Error("Unexpected '/'");
+			if(c == '\n')
+				line++;
+			if(c < 0)
+				return;
+		}
+		else
+		if(c < 0 || c > ' ')
+			return;
+	}
+}
+
+void JsonReader::ReadString()
+{
+	StringBuffer r;
+	Get();
+	date = Peek() == '\\';
+	for(;;) {
+		const char *s = ptr;
+		while(s < end && *s != '\"' && *s != '\\' && *s != '\n')
+			s++;
+		r.Cat(ptr, int(s - ptr));
+		ptr = s;
+		int c = Get();
+		if(c == '\"')
+			break;
+		if(c < 0)
+			Error("Unterminated string");
+		if(c != '\\') { // '\n' or buffer was refilled
+			if(c == '\n')
+				line++;
+			r.Cat(c);
+			continue;
+		}
+		c = Get();
+		switch(c) {
+		case 'b': r.Cat('\b'); break;
+		case 'f': r.Cat('\f'); break;
+		case 'n': r.Cat('\n'); break;
+		case 'r': r.Cat('\r'); break;
+		case 't': r.Cat('\t'); break;
+		case 'u': {
+				char h[4];
+				for(int i = 0; i < 4; i++)
+					h[i] = Get();
+				int code = sHex4(h);
+				if(code < 0)
+					Error("Invalid \\u escape");
+				if(code >= 0xD800 && code < 0xDC00 && Peek() == '\\') {
+					Get();
+					if(Get() != 'u')
+						Error("Invalid surrogate pair");
+					for(int i = 0; i < 4; i++)
+						h[i] = Get();
+					int lo = sHex4(h);
+					if(lo < 0xDC00 || lo >= 0xE000)
+						Error("Invalid surrogate pair");
+					code = ((code - 0xD800) << 10) + (lo - 0xDC00) + 0x10000;
+				}
+				r.Cat(ToUtf8((wchar)code));
+			}
+			break;
+		default:
+			if(c < 0)
+				Error("Unterminated string");
+			r.Cat(c);
+		}
+	}
+	text = r;
+}
+
+void JsonReader::ReadNumber()
+{
+	char h[64];
+	int n = 0;
+	for(;;) {
+		int c = Peek();
+		if(!(IsDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') || n >= 63)
+			break;
+		h[n++] = Get();
+	}
+	h[n] = 0;
+	const char *e;
+	number = ScanDouble(h, &e, false);
+	if(IsNull(number) || *e)
+		Error("Invalid number");
+	text = String(h, n);
+}
+
+int JsonReader::Close()
+{
+	Get();
+	token = stack.Pop() == '[' ? JSON_END_ARRAY : JSON_END_OBJECT;
+	after = true;
+	member = false;
+	return token;
+}
+
+int JsonReader::Next()
+{
+	SkipWhites();
+	if(stack.GetCount()) {
+		int close = stack.Top() == '[' ? ']' : '}';
+		if(!member) {
+			if(Peek() == close)
+				return Close();
+			if(after) {
+				if(Get() != ',')
+					Error("',' expected");
+				SkipWhites();
+				if(Peek() == close) // Stray ',' at the end of list is allowed...
+					return Close();
+			}
+			if(close == '}') {
+				if(Peek() != '\"')
+					Error("Key expected");
+				ReadString();
+				SkipWhites();
+				if(Get() != ':')
+					Error("':' expected");
+				member = true;
+				after = false;
+				return token = JSON_KEY;
+			}
+		}
+	}
+	else
+	if(Peek() < 0) // more top-level values are allowed (JSON lines)
+		return token = JSON_EOF;
+	member = false;
+	after = true;
+	int c = Peek();
+	if(c == '{' || c == '[') {
+		Get();
+		stack.Add(c);
+		after = false;
+		return token = c == '[' ? JSON_ARRAY : JSON_OBJECT;
+	}
+	if(c == '\"') {
+		ReadString();
+		return token = JSON_STRING;
+	}
+	if(IsDigit(c) || c == '-' || c == '+' || c == '.') {
+		ReadNumber();
+		return token = JSON_NUMBER;
+	}
+	if(IsAlpha(c)) {
+		char h[8];
+		int n = 0;
+		while(IsAlNum(Peek()) && n < 7)
+			h[n++] = Get();
+		h[n] = 0;
+		text = h;
+		if(text == "null")
+			return token = JSON_NULL;
+		number = text == "true";
+		if(number || text == "false")
+			return token = JSON_BOOL;
+	}
+	Error("Unrecognized JSON element");
+	return token = JSON_EOF;
+}
+
+Value JsonReader::GetValue()
+{
+	switch(token) {
+	case JSON_NULL:
+		return Null;
+	case JSON_BOOL:
+		return (bool)number;
+	case JSON_NUMBER:
+		return number;
+	case JSON_STRING:
+		return date && sIsDate(text) ? sDate(text) : Value(text);
+	case JSON_KEY:
+		Next();
+		return GetValue();
+	case JSON_ARRAY: {
+			ValueArray va;
+			while(Next() != JSON_END_ARRAY)
+				va.Add(GetValue());
+			return va;
+		}
+	case JSON_OBJECT: {
+			ValueMap m;
+			while(Next() == JSON_KEY) {
+				String key = text;
+				Next();
+				m.Add(key, GetValue());
+			}
+			return m;
+		}
+	}
+	Error("Value expected");
+	return Null;
+}
+
+void JsonReader::Skip()
+{
+	if(token == JSON_KEY)
+		Next();
+	if(token == JSON_ARRAY || token == JSON_OBJECT) {
+		int depth = stack.GetCount();
+		while(Next() != JSON_EOF && stack.GetCount() >= depth);
+	}
+}
+
+void JsonDom::Clear()
+{
+	source.Clear();
+	arena.Clear();
+	aptr = aend = NULL;
+	used = 0;
+	temp.Clear();
+	error.Clear();
+	root.type = JSON_NULL;
+	root.count = 0;
+	root.date = false;
+	root.item = NULL;
+}
+
+void *JsonDom::Alloc(size_t size)
+{
+	size = (size + 7) & ~(size_t)7;
+	if(aptr + size > aend) {
+		size_t sz = max(size, (size_t)min(64 * 1024 << min(arena.GetCount(), 8), 16 * 1024 * 1024));
+		Buffer<byte>& b = arena.Add();
+		b.Alloc(sz);
+		aptr = ~b;
+		aend = aptr + sz;
+		used += sz;
+	}
+	void *p = aptr;
+	aptr += size;
+	return p;
+}
+
+void JsonDom::Error(const char *text)
+{
+	throw JsonError(Format("(%d): %s", line, text));
+}
+
+void JsonDom::SkipWhites()
+{
+	for(;;) {
+		while((byte)*s <= ' ' && *s)
+			if(*s++ == '\n')
+				line++;
+		if(*s != '/')
+			return;
+		if(s[1] == '/')
+			while(*s && *s != '\n')
+				s++;
+		else
+		if(s[1] == '*') {
+			s += 2;
+			while(*s && !(s[0] == '*' && s[1] == '/'))
+				if(*s++ == '\n')
+					line++;
+			if(*s)
+				s += 2;
+		}
+		else
+			Error("Unexpected '/'");
+	}
+}
+
+void JsonDom::ReadString(Item& m)
+{
+	const char *b = ++s;
+	while(*s != '\"' && *s != '\\' && *s)
+		if(*s++ == '\n')
+			line++;
+	m.type = JSON_STRING;
+	m.date = *b == '\\';
+	if(*s == '\"') { // no escapes, string is a view into source
+		m.text = b;
+		m.count = int(s - b);
+		s++;
+		return;
+	}
+	const char *e = s;
+	while(*e != '\"') {
+		if(*e == '\\' && e[1])
+			e++;
+		if(!*e++)
+			Error("Unterminated string");
+	}
+	char *t = (char *)Alloc(e - b);
+	m.text = t;
+	memcpy(t, b, s - b);
+	t += s - b;
+	while(*s != '\"') {
+		if(*s != '\\') {
+			if(*s == '\n')
+				line++;
+			*t++ = *s++;
+			continue;
+		}
+		s++;
+		switch(*s++) {
+		case 'b': *t++ = '\b'; break;
+		case 'f': *t++ = '\f'; break;
+		case 'n': *t++ = '\n'; break;
+		case 'r': *t++ = '\r'; break;
+		case 't': *t++ = '\t'; break;
+		case 'u': {
+				int code = sHex4(s);
+				if(code < 0)
+					Error("Invalid \\u escape");
+				s += 4;
+				if(code >= 0xD800 && code < 0xDC00 && s[0] == '\\' && s[1] == 'u') {
+					int lo = sHex4(s + 2);
+					if(lo < 0xDC00 || lo >= 0xE000)
+						Error("Invalid surrogate pair");
+					code = ((code - 0xD800) << 10) + (lo - 0xDC00) + 0x10000;
+					s += 6;
+				}
+				String h = ToUtf8((wchar)code); // never longer than escape sequence
+				memcpy(t, ~h, h.GetCount());
+				t += h.GetCount();
+			}
+			break;
+		default:
+			*t++ = s[-1];
+		}
+	}
+	s++;
+	m.count = int(t - m.text);
+}
+
+void JsonDom::ReadValue(Item& m, int depth)
+{
+	SkipWhites();
+	m.date = false;
+	int c = *s;
+	if(c == '{' || c == '[') {
+		if(depth > 1000)
+			Error("Too deeply nested");
+		s++;
+		int close = c == '[' ? ']' : '}';
+		int base = temp.GetCount();
+		for(;;) {
+			SkipWhites();
+			if(*s == close)
+				break;
+			Item h;
+			if(close == '}') {
+				if(*s != '\"')
+					Error("Key expected");
+				ReadString(h);
+				temp.Add(h);
+				SkipWhites();
+				if(*s++ != ':')
+					Error("':' expected");
+			}
+			ReadValue(h, depth + 1);
+			temp.Add(h);
+			SkipWhites();
+			if(*s == close) // Stray ',' at the end of list is allowed...
+				break;
+			if(*s++ != ',')
+				Error("',' expected");
+		}
+		s++;
+		int n = temp.GetCount() - base;
+		Item *q = n ? (Item *)Alloc(n * sizeof(Item)) : NULL;
+		if(n)
+			memcpy(q, temp.begin() + base, n * sizeof(Item));
+		temp.Trim(base);
+		m.type = c == '[' ? JSON_ARRAY : JSON_OBJECT;
+		m.count = c == '[' ? n : n / 2;
+		m.item = q;
+		return;
+	}
+	if(c == '\"') {
+		ReadString(m);
+		return;
+	}
+	m.count = 0;
+	if(IsDigit(c) || c == '-' || c == '+' || c == '.') {
+		const char *e;
+		m.type = JSON_NUMBER;
+		m.number = ScanDouble(s, &e, false);
+		if(IsNull(m.number))
+			Error("Invalid number");
+		s = e;
+		return;
+	}
+	auto id = [&](const char *t, int n) {
+		if(strncmp(s, t, n) || IsAlNum(s[n]))
+			return false;
+		s += n;
+		return true;
+	};
+	m.number = 0;
+	if(id("null", 4))
+		m.type = JSON_NULL;
+	else
+	if(id("true", 4)) {
+		m.type = JSON_BOOL;
+		m.number = 1;
+	}
+	else
+	if(id("false", 5))
+		m.type = JSON_BOOL;
+	else
+		Error("Unrecognized JSON element");
+}
+
+bool JsonDom::Parse(const String& json)
+{
+	Clear();
+	source = json;
+	s = ~source;
+	line = 1;
+	try {
+		ReadValue(root, 0);
+		SkipWhites();
+		if(s < source.End())
+			Error("Unexpected text after JSON value");
+	}
+	catch(JsonError e) {
+		error = e;
+		return false;
+	}
+	temp.Shrink();
+	return true;
+}
+
+JsonDom::Node JsonDom::Node::operator[](int i) const
+{
+	if(IsArray() && i >= 0 && i < item->count)
+		return Node(item->item + i);
+	if(IsObject() && i >= 0 && i < item->count)
+		return Node(item->item + 2 * i + 1);
+	return Node();
+}
+
+JsonDom::Node JsonDom::Node::GetKey(int i) const
+{
+	return IsObject() && i >= 0 && i < item->count ? Node(item->item + 2 * i) : Node();
+}
+
+bool JsonDom::Node::IsEqual(const char *s) const
+{
+	int len = (int)strlen(s);
+	return IsString() && item->count == len && memcmp(item->text, s, len) == 0;
+}
+
+JsonDom::Node JsonDom::Node::operator[](const char *key) const
+{
+	if(IsObject()) {
+		int len = (int)strlen(key);
+		for(const Item *q = item->item, *e = q + 2 * item->count; q < e; q += 2)
+			if(q->count == len && memcmp(q->text, key, len) == 0)
+				return Node(q + 1);
+	}
+	return Node();
+}
+
+Value JsonDom::Node::ToValue() const
+{
+	switch(GetType()) {
+	case JSON_BOOL:
+		return GetBool();
+	case JSON_NUMBER:
+		return item->number;
+	case JSON_STRING: {
+			String s = GetString();
+			return item->date && sIsDate(s) ? sDate(s) : Value(s);
+		}
+	case JSON_ARRAY: {
+			ValueArray va;
+			for(int i = 0; i < GetCount(); i++)
+				va.Add((*this)[i].ToValue());
+			return va;
+		}
+	case JSON_OBJECT: {
+			ValueMap m;
+			for(int i = 0; i < GetCount(); i++)
+				m.Add(GetKey(i).GetString(), (*this)[i].ToValue());
+			return m;
+		}
+	}
+	return Null;
+}
+
+}
@@ -23,11 +23,14 @@ struct LogOut {
 	
 	bool  line_begin;
 	
-	int   prev_msecs;
+	StringBuffer *batch; // collects file output while draining async queues
 	
 	void  Create(bool append);
 	void  Create()                                     { Create(options & LOG_APPEND); }
 	void  Close();
+	int   Format(char *h, const char *s, int len, int depth, bool& line_begin, int& beg);
+	void  Write(const char *h, int count, int beg);
+	void  FlushBatch();
 	void  Line(const char *buffer, int len, int depth);
 	bool  IsOpen() const;
 	void  Rotate();
@@ -156,75 +159,103 @@ void LogOut::Close()
 #endif
 }
 
-void LogOut::Line(const char *s, int len, int depth)
+static std::atomic<int> sPrevMsecs;
+
+int LogOut::Format(char *h, const char *s, int len, int depth, bool& line_begin, int& beg)
 {
-	Mutex::Lock __(log_mutex);
-	
 	ASSERT(len < 600);
 
-	char h[1200]; // 2 * 600 to make snprintf easier
 	char *p = h;
 	int   ll = 0;
 	if(options & LOG_ELAPSED) {
 		int t = msecs();
-		int e = prev_msecs ? t - prev_msecs : 0;
+		int prev = sPrevMsecs.exchange(t);
+		int e = prev ? t - prev : 0;
 		ll = snprintf(p, 600, "[+%6d ms] ", e);
 		if(ll < 0)
-			return;
+			return 0;
 		p += ll;
-		prev_msecs = t;
 	}
 	if((options & (LOG_TIMESTAMP|LOG_TIMESTAMP_UTC)) && line_begin) {
 		Time t = (options & LOG_TIMESTAMP_UTC) ? GetUtcTime() : GetSysTime();
 		ll = snprintf(p, 600, "%02d.%02d.%04d %02d:%02d:%02d ",
 		              t.day, t.month, t.year, t.hour, t.minute, t.second);
 		if(ll < 0)
-			return;
+			return 0;
 		p += ll;
 	}
-	char *beg = p;
+	beg = int(p - h);
 	for(int q = min(depth, 99); q--;)
 		*p++ = '\t';
 	line_begin = len && s[len - 1] == '\n';
 	memcpy(p, s, len);
 	p += len;
 	*p = '\0';
-	int count = (int)(p - h);
+	return int(p - h);
+}
+
+void LogOut::FlushBatch()
+{
+	if(!batch || batch->GetCount() == 0)
+		return;
+#ifdef PLATFORM_WIN32
+	if(hfile != INVALID_HANDLE_VALUE) {
+		dword n;
+		WriteFile(hfile, ~*batch, batch->GetCount(), &n, NULL);
+	}
+#else
+	if(hfile >= 0)
+		IGNORE_RESULT(
+			write(hfile, ~*batch, batch->GetCount())
+		);
+#endif
+	batch->Clear();
+}
+
+void LogOut::Write(const char *h, int count, int beg)
+{ // log_mutex has to be locked, h is zero terminated
 	if(count == 0) return;
+	const char *b = h + beg;
+	int bn = count - beg;
 	if(options & LOG_COUT)
-		for(const char *s = beg; *s; s++)
-			putchar(*s);
+		fwrite(b, 1, bn, stdout);
 	if(options & LOG_CERR)
-		for(const char *s = beg; *s; s++)
-			putc(*s, stderr);
+		fwrite(b, 1, bn, stderr);
 	if(options & LOG_COUTW)
 		Cout().Put(h, count);
 	if(options & LOG_CERRW)
 		Cerr().Put(h, count);
+	if(options & LOG_FILE) {
+		if(batch)
+			batch->Cat(h, count);
+		else {
 #ifdef PLATFORM_WIN32
-	if(options & LOG_FILE)
-		if(hfile != INVALID_HANDLE_VALUE) {
-			dword n;
-			WriteFile(hfile, h, count, &n, NULL);
+			if(hfile != INVALID_HANDLE_VALUE) {
+				dword n;
+				WriteFile(hfile, h, count, &n, NULL);
+			}
+#else
+			if(hfile >= 0)
+				IGNORE_RESULT(
+					write(hfile, h, count)
+				);
+#endif
 		}
-	if(options & LOG_DBG) {
-		*p = 0;
-		::OutputDebugString((LPCSTR)h);
 	}
+#ifdef PLATFORM_WIN32
+	if(options & LOG_DBG)
+		::OutputDebugString((LPCSTR)h);
 #else
-	if(options & LOG_FILE)
-		if(hfile >= 0)
-			IGNORE_RESULT(
-				write(hfile, h, count)
-			);
 	if(options & LOG_DBG)
 		Cerr().Put(h, count);
 	if(options & LOG_SYS)
-		syslog(LOG_INFO|LOG_USER, "%s", beg);
+		syslog(LOG_INFO|LOG_USER, "%s", b);
 #endif
 	filesize += count;
-	if(sizelimit > 0 && filesize > sizelimit)
+	if(sizelimit > 0 && filesize > sizelimit) {
+		FlushBatch();
 		Create(false);
+	}
 }
 
 #ifdef PLATFORM_POSIX
@@ -233,6 +264,305 @@ static LogOut sLog = { LOG_FILE, 10 * 1024 * 1024, -1 };
 static LogOut sLog = { LOG_FILE, 10 * 1024 * 1024 };
 #endif
 
+struct LogQueue { // single producer is the logging thread, consumer is whoever holds log_mutex
+	enum { SIZE = 128 * 1024 };
+
+	struct Header {
+		int64 seq;
+		int   len;
+		int   beg;
+	};
+
+	char               data[SIZE];
+	std::atomic<int64> head; // bytes written so far
+	std::atomic<int64> tail; // bytes consumed so far
+	std::atomic<bool>  finished; // thread has ended
+	LogQueue          *next;
+
+	void Copy(int64 pos, const void *src, int n);
+	void Read(int64 pos, void *dst, int n) const;
+	bool Put(int64 seq, const char *h, int len, int beg);
+};
+
+void LogQueue::Copy(int64 pos, const void *src, int n)
+{
+	int p = int(pos % SIZE);
+	int n1 = min(n, SIZE - p);
+	memcpy(data + p, src, n1);
+	memcpy(data, (const char *)src + n1, n - n1);
+}
+
+void LogQueue::Read(int64 pos, void *dst, int n) const
+{
+	int p = int(pos % SIZE);
+	int n1 = min(n, SIZE - p);
+	memcpy(dst, data + p, n1);
+	memcpy((char *)dst + n1, data, n - n1);
+}
+
+bool LogQueue::Put(int64 seq, const char *h, int len, int beg)
+{
+	int64 pos = head.load(std::memory_order_relaxed);
+	int need = sizeof(Header) + len;
+	if(pos + need - tail.load(std::memory_order_acquire) > SIZE)
+		return false;
+	Header hdr;
+	hdr.seq = seq;
+	hdr.len = len;
+	hdr.beg = beg;
+	Copy(pos, &hdr, sizeof(hdr));
+	Copy(pos + sizeof(hdr), h, len);
+	head.store(pos + need, std::memory_order_release);
+	return true;
+}
+
+static LogQueue          *sLogQueues; // guarded by log_mutex
+static std::atomic<int64> sLogSeq;
+static std::atomic<bool>  sLogWriterRunning;
+static std::atomic<bool>  sLogWriterQuit;
+
+static Semaphore& sLogWake()
+{ // not destructed, used by EXITBLOCK
+	static Semaphore *s;
+	ONCELOCK {
+		MemoryIgnoreLeaksBlock __;
+		s = new Semaphore;
+	}
+	return *s;
+}
+
+static Thread& sLogWriter()
+{
+	static Thread *t;
+	ONCELOCK {
+		MemoryIgnoreLeaksBlock __;
+		t = new Thread;
+	}
+	return *t;
+}
+
+static void sLogDrain()
+{ // log_mutex has to be locked; writes queued lines of all threads in the order they were logged
+	struct Entry : Moveable<Entry> {
+		int64     seq;
+		LogQueue *q;
+		int64     pos;
+		int       len;
+		int       beg;
+	};
+	Vector<Entry> entry;
+	Vector<int64> head;
+	for(LogQueue *q = sLogQueues; q; q = q->next) {
+		int64 h = q->head.load(std::memory_order_acquire);
+		head.Add(h);
+		for(int64 pos = q->tail; pos < h;) {
+			LogQueue::Header hdr;
+			q->Read(pos, &hdr, sizeof(hdr));
+			Entry& e = entry.Add();
+			e.seq = hdr.seq;
+			e.q = q;
+			e.pos = pos + sizeof(hdr);
+			e.len = hdr.len;
+			e.beg = hdr.beg;
+			pos = e.pos + e.len;
+		}
+	}
+	if(entry.GetCount()) {
+		Sort(entry, [](const Entry& a, const Entry& b) { return a.seq < b.seq; });
+		StringBuffer batch;
+		sLog.batch = &batch;
+		for(const Entry& e : entry) {
+			char h[1200];
+			e.q->Read(e.pos, h, e.len);
+			h[e.len] = '\0';
+			sLog.Write(h, e.len, e.beg);
+		}
+		sLog.FlushBatch();
+		sLog.batch = NULL;
+	}
+	int i = 0;
+	for(LogQueue **qq = &sLogQueues; *qq;) {
+		LogQueue *q = *qq;
+		q->tail.store(head[i++], std::memory_order_release);
+		if(q->finished && q->tail == q->head) {
+			*qq = q->next;
+			delete q;
+		}
+		else
+			qq = &q->next;
+	}
+}
+
+static void sStopLogWriter()
+{
+	if(sLogWriterRunning) {
+		sLogWriterQuit = true;
+		sLogWake().Release();
+		sLogWriter().Wait();
+	}
+	Mutex::Lock __(log_mutex);
+	sLogDrain();
+}
+
+EXITBLOCK {
+	sStopLogWriter();
+}
+
+#ifdef PLATFORM_POSIX
+static const int        sLogFatalSignal[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+static struct sigaction sLogPrevAction[__countof(sLogFatalSignal)];
+
+static char sLogFatalBuffer[64 * 1024];
+static int  sLogFatalLen;
+
+static void sLogFatalFlush()
+{
+	const char *s = sLogFatalBuffer;
+	int n = sLogFatalLen;
+	if(sLog.options & LOG_FILE && sLog.hfile >= 0)
+		IGNORE_RESULT(write(sLog.hfile, s, n));
+	if(sLog.options & (LOG_COUT|LOG_COUTW))
+		IGNORE_RESULT(write(1, s, n));
+	if(sLog.options & (LOG_CERR|LOG_CERRW|LOG_DBG))
+		IGNORE_RESULT(write(2, s, n));
+	sLogFatalLen = 0;
+}
+
+static void sLogFatalDrain()
+{ // async-signal-safe version of sLogDrain, no heap, output by write only
+	for(;;) {
+		LogQueue *next = NULL;
+		LogQueue::Header hdr;
+		for(LogQueue *q = sLogQueues; q; q = q->next) // lines of each queue are ordered by seq
+			if(q->tail < q->head.load(std::memory_order_acquire)) {
+				LogQueue::Header h;
+				q->Read(q->tail, &h, sizeof(h));
+				if(!next || h.seq < hdr.seq) {
+					next = q;
+					hdr = h;
+				}
+			}
+		if(!next)
+			break;
+		if(sLogFatalLen + hdr.len > (int)sizeof(sLogFatalBuffer))
+			sLogFatalFlush();
+		next->Read(next->tail + sizeof(hdr), sLogFatalBuffer + sLogFatalLen, hdr.len);
+		sLogFatalLen += hdr.len;
+		next->tail.store(next->tail + sizeof(hdr) + hdr.len, std::memory_order_release);
+	}
+	sLogFatalFlush();
+}
+
+static void sLogFatalHandler(int sig)
+{ // best effort, if log_mutex is not available the lines are lost
+	static std::atomic<bool> flushing;
+	if(!flushing.exchange(true) && log_mutex.TryEnter()) {
+		sLogFatalDrain();
+		log_mutex.Leave();
+	}
+	for(int i = 0; i < __countof(sLogFatalSignal); i++)
+		if(sLogFatalSignal[i] == sig)
+			sigaction(sig, &sLogPrevAction[i], NULL);
+	raise(sig); // delivered to the previous handler after return
+}
+
+static void sLogInstallFatalHandler()
+{ // flushes queued lines when the application crashes
+	for(int i = 0; i < __countof(sLogFatalSignal); i++) {
+		struct sigaction sa;
+		memset(&sa, 0, sizeof(sa));
+		sa.sa_handler = sLogFatalHandler;
+		sigemptyset(&sa.sa_mask);
+		sigaction(sLogFatalSignal[i], &sa, &sLogPrevAction[i]);
+	}
+}
+#endif
+
+static void sStartLogWriter()
+{ // log_mutex has to be locked
+	if(sLogWriterRunning || sLogWriterQuit || Thread::IsShutdownThreads())
+		return;
+	sLogWriterRunning = true;
+	Thread::AtShutdown(sStopLogWriter);
+#ifdef PLATFORM_POSIX
+	ONCELOCK {
+		sLogInstallFatalHandler();
+	}
+#endif
+	sLogWriter().Run([] {
+		while(!sLogWriterQuit) {
+			sLogWake().Wait(20);
+			Mutex::Lock __(log_mutex);
+			sLogDrain();
+		}
+		sLogWriterRunning = false;
+	});
+}
+
+struct LogQueueOwner {
+	LogQueue *q = NULL;
+	bool      ended = false; // lines logged later by the thread are written directly
+
+	~LogQueueOwner() { if(q) q->finished = true; q = NULL; ended = true; }
+};
+
+static thread_local LogQueueOwner sLogQueue;
+
+static bool sLogAsyncPut(const char *h, int count, int beg)
+{
+	LogQueue *q = sLogQueue.q;
+	if(!q) {
+		if(sLogQueue.ended)
+			return false;
+		Mutex::Lock __(log_mutex);
+		sStartLogWriter();
+		if(!sLogWriterRunning)
+			return false;
+		q = new LogQueue;
+		q->head = q->tail = 0;
+		q->finished = false;
+		q->next = sLogQueues;
+		sLogQueues = q;
+		sLogQueue.q = q;
+	}
+	int64 seq = sLogSeq++;
+	while(!q->Put(seq, h, count, beg)) { // queue is full, writer is late
+		if(!sLogWriterRunning)
+			return false;
+		if(log_mutex.TryEnter()) {
+			sLogDrain();
+			log_mutex.Leave();
+		}
+		else
+			Sleep(0);
+	}
+	if(q->head - q->tail > LogQueue::SIZE / 2)
+		sLogWake().Release();
+	return true;
+}
+
+void LogOut::Line(const char *s, int len, int depth)
+{
+	char h[1200]; // 2 * 600 to make snprintf easier
+	int beg;
+	if((options & LOG_ASYNC) && !IsPanicMode() && !sLogWriterQuit) {
+		static thread_local bool line_begin = true;
+		int count = Format(h, s, len, depth, line_begin, beg);
+		if(count == 0 || sLogAsyncPut(h, count, beg))
+			return;
+	}
+	Mutex::Lock __(log_mutex);
+	sLogDrain(); // keep the order of lines, also flushes queues on panic
+	int count = Format(h, s, len, depth, line_begin, beg);
+	Write(h, count, beg);
+}
+
+void FlushLog()
+{
+	Mutex::Lock __(log_mutex);
+	sLogDrain();
+}
+
 struct ThreadLog {
 	char  buffer[512];
 	int   len;
@@ -386,11 +716,13 @@ LogStream& StdLogStream()
 
 void CloseStdLog()
 {
+	FlushLog();
 	StdLogStream().Close();
 }
 
 void ReopenLog()
 {
+	FlushLog();
 	if(sLog.IsOpen()) {
 		sLog.Close();
 		sLog.Create();
@@ -399,6 +731,7 @@ void ReopenLog()
 
 void StdLogSetup(dword options, const char *filepath, int filesize_limit)
 {
+	FlushLog();
 	sLog.options = options;
 	sLog.sizelimit = filesize_limit;
 	if(filepath)
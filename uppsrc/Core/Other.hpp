@@ -187,12 +187,12 @@ T& LRUCache<T, K>::Get(const Maker& m, B before_make, A after_make, int& sz)
 	if(q < 0) {
 		One<T> val;
 		before_make();
-		int sz = m.Make(val.Create());
+		int n = m.Make(val.Create());
 		after_make();
 		q = key.Put(k);
 		Item& t = data.At(q);
 		t.data = pick(val);
-		t.size = sz + InternalSize;
+		t.size = n + InternalSize;
 		size += t.size;
 		newsize += t.size;
 		t.flag = flag;
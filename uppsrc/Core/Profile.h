@@ -14,20 +14,19 @@ class TimingInspector {
 protected:
 	static bool active;
 
-	const char *name;
-	int         call_count;
-	dword       total_time;
-	dword       min_time;
-	dword       max_time;
-	int         max_nesting;
-	int         all_count;
-	StaticMutex mutex;
+	const char         *name;
+	std::atomic<int>    call_count;
+	std::atomic<int64>  total_time; // all times in ns
+	std::atomic<int64>  min_time;
+	std::atomic<int64>  max_time;
+	std::atomic<int>    max_nesting;
+	std::atomic<int>    all_count;
 
 public:
 	TimingInspector(const char *name = NULL); // Not String !!!
 	~TimingInspector();
 
-	void   Add(dword time, int nesting);
+	void   Add(int64 start_time, int nesting);
 
 	String Dump();
 
@@ -35,7 +34,7 @@ public:
 	public:
 		Routine(TimingInspector& stat, int& nesting)
 		: nesting(nesting), stat(stat) {
-			start_time = tmGetTime();
+			start_time = nsecs();
 			nesting++;
 		}
 
@@ -45,7 +44,7 @@ public:
 		}
 
 	protected:
-		dword start_time;
+		int64 start_time;
 		int& nesting;
 		TimingInspector& stat;
 	};
@@ -79,3 +78,37 @@ private:
 
 #define RHITCOUNT(n) \
 	{ static HitCountInspector hitcount(n); hitcount.Step(); }
+
+struct ProfileEvent {
+	const char *name;
+	int64       start; // nsecs
+	int64       end;
+};
+
+extern std::atomic<bool> ProfilerActive__;
+
+void ProfileEvent__(const char *name, int64 start, int64 end);
+
+class ProfileZone {
+	const char *name;
+	int64       start;
+
+public:
+	ProfileZone(const char *name) : name(name) { start = ProfilerActive__.load(std::memory_order_relaxed) ? nsecs() : 0; }
+	~ProfileZone()                              { if(start) ProfileEvent__(name, start, nsecs()); }
+};
+
+void   StartProfiler(int events_per_thread = 65536);
+void   StopProfiler();
+bool   IsProfilerActive();
+void   ClearProfiler();
+
+Vector<ProfileEvent> GetProfilerEvents(int thread);
+int                  GetProfilerThreadCount();
+
+String GetProfilerTrace(); // Chrome / Perfetto trace JSON
+bool   SaveProfilerTrace(const char *path);
+String GetProfilerSummary();
+
+#define RZONE(x)          UPP::ProfileZone COMBINE(sProfileZone, __LINE__)(x)
+#define RZONE_FUNCTION()  RZONE(__func__)
@@ -0,0 +1,186 @@
+#include "Core.h"
+
+namespace Upp {
+
+std::atomic<bool> ProfilerActive__;
+
+struct ProfileBuffer { // written only by its thread
+	Buffer<ProfileEvent> event;
+	int                  mask;
+	std::atomic<int64>   count;
+	int64                cleared = 0; // events before this were cleared
+	String               thread;
+	bool                 done = false; // thread has finished, buffer can be reused by a new thread
+};
+
+static StaticMutex sProfilerLock;
+static int         sProfilerEvents = 65536;
+
+static Array<ProfileBuffer>& sProfileBuffers()
+{ // buffers are never released, threads keep pointers to them
+	static Array<ProfileBuffer> *b;
+	ONCELOCK {
+		MemoryIgnoreLeaksBlock __;
+		b = new Array<ProfileBuffer>;
+	}
+	return *b;
+}
+
+static thread_local ProfileBuffer *sProfileBuffer;
+
+struct ProfileBufferOwner { // marks the buffer for reuse when thread ends
+	ProfileBuffer *buffer = NULL;
+
+	~ProfileBufferOwner() {
+		if(buffer) {
+			Mutex::Lock __(sProfilerLock);
+			buffer->done = true;
+		}
+	}
+};
+
+static ProfileBuffer *sNewProfileBuffer()
+{ // events of finished thread stay in reused buffer, as they do not overlap with the new ones
+	static thread_local ProfileBufferOwner owner;
+	Mutex::Lock __(sProfilerLock);
+	Array<ProfileBuffer>& bb = sProfileBuffers();
+	int n = 1024;
+	while(n < sProfilerEvents)
+		n += n;
+	for(ProfileBuffer& b : bb)
+		if(b.done && b.mask + 1 >= n) {
+			b.done = false;
+			return owner.buffer = &b;
+		}
+	MemoryIgnoreLeaksBlock ___;
+	ProfileBuffer& b = bb.Add();
+	b.event.Alloc(n);
+	b.mask = n - 1;
+	b.count = 0;
+	b.thread = IsMainThread() ? String("Main thread") : "Thread " + AsString(bb.GetCount());
+	return owner.buffer = &b;
+}
+
+void ProfileEvent__(const char *name, int64 start, int64 end)
+{ // no locking, each thread writes to its own ring buffer
+	ProfileBuffer *b = sProfileBuffer;
+	if(!b)
+		b = sProfileBuffer = sNewProfileBuffer();
+	int64 n = b->count.load(std::memory_order_relaxed);
+	ProfileEvent& e = b->event[(int)(n & b->mask)];
+	e.name = name;
+	e.start = start;
+	e.end = end;
+	b->count.store(n + 1, std::memory_order_release);
+}
+
+void StartProfiler(int events_per_thread)
+{
+	Mutex::Lock __(sProfilerLock);
+	sProfilerEvents = max(events_per_thread, 1);
+	ProfilerActive__ = true;
+}
+
+void StopProfiler()
+{
+	ProfilerActive__ = false;
+}
+
+bool IsProfilerActive()
+{
+	return ProfilerActive__;
+}
+
+void ClearProfiler()
+{
+	Mutex::Lock __(sProfilerLock);
+	for(ProfileBuffer& b : sProfileBuffers())
+		b.cleared = b.count;
+}
+
+int GetProfilerThreadCount()
+{
+	Mutex::Lock __(sProfilerLock);
+	return sProfileBuffers().GetCount();
+}
+
+Vector<ProfileEvent> GetProfilerEvents(int thread)
+{ // only complete results after StopProfiler, otherwise oldest events might get overwritten while reading
+	Mutex::Lock __(sProfilerLock);
+	Vector<ProfileEvent> r;
+	ProfileBuffer& b = sProfileBuffers()[thread];
+	int64 n = b.count.load(std::memory_order_acquire);
+	for(int64 i = max(b.cleared, n - b.mask - 1); i < n; i++)
+		r.Add(b.event[(int)(i & b.mask)]);
+	return r;
+}
+
+String GetProfilerTrace()
+{
+	int n = GetProfilerThreadCount();
+	Vector<Vector<ProfileEvent>> event;
+	int64 t0 = INT64_MAX;
+	for(int i = 0; i < n; i++)
+		for(const ProfileEvent& e : event.Add(GetProfilerEvents(i)))
+			t0 = min(t0, e.start);
+	StringBuffer r;
+	r << "{\"traceEvents\":[";
+	bool next = false;
+	for(int i = 0; i < n; i++) {
+		String thread;
+		{
+			Mutex::Lock __(sProfilerLock);
+			thread = sProfileBuffers()[i].thread;
+		}
+		if(next)
+			r << ',';
+		next = true;
+		r << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i + 1
+		  << ",\"args\":{\"name\":" << AsJSON(thread) << "}}";
+		for(const ProfileEvent& e : event[i])
+			r << ",\n{\"name\":" << AsJSON(String(e.name)) << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << i + 1
+			  << ",\"ts\":" << Format("%.3f", (e.start - t0) / 1000.0)
+			  << ",\"dur\":" << Format("%.3f", (e.end - e.start) / 1000.0) << "}";
+	}
+	r << "\n],\"displayTimeUnit\":\"ns\"}\n";
+	return String(r);
+}
+
+bool SaveProfilerTrace(const char *path)
+{
+	return SaveFile(path, GetProfilerTrace());
+}
+
+String GetProfilerSummary()
+{
+	struct Stat {
+		int   count = 0;
+		int64 total = 0;
+		int64 min = INT64_MAX;
+		int64 max = 0;
+	};
+	VectorMap<String, Stat> stat;
+	int n = GetProfilerThreadCount();
+	for(int i = 0; i < n; i++)
+		for(const ProfileEvent& e : GetProfilerEvents(i)) {
+			Stat& s = stat.GetAdd(e.name);
+			int64 t = e.end - e.start;
+			s.count++;
+			s.total += t;
+			s.min = min(s.min, t);
+			s.max = max(s.max, t);
+		}
+	SortByValue(stat, [](const Stat& a, const Stat& b) { return a.total > b.total; });
+	String r;
+	for(int i = 0; i < stat.GetCount(); i++) {
+		const Stat& s = stat[i];
+		r << Sprintf("ZONE %-30s: ", ~stat.GetKey(i))
+		  << timeFormat(s.total / 1e9)
+		  << " - " << timeFormat(s.total / 1e9 / s.count)
+		  << Sprintf(" (%d), min: ", s.count) << timeFormat(s.min / 1e9)
+		  << ", max: " << timeFormat(s.max / 1e9) << "\n";
+	}
+	return r;
+}
+
+}
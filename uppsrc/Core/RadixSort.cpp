@@ -0,0 +1,113 @@
+#include "Core.h"
+
+namespace Upp {
+
+enum {
+	RADIX_STRING_SMALL = 64, // buckets smaller than this are sorted by comparison
+	RADIX_STRING_CO = 16384, // buckets bigger than this are sorted in parallel
+};
+
+static void sLoadKeys(const byte *const *s, RadixStringItem__ *a, int n, int depth)
+{
+	for(int i = 0; i < n; i++) {
+		RadixStringItem__& m = a[i];
+		const byte *p = s[m.index] + depth;
+		int l = m.len - depth;
+		if(l >= 8)
+			m.key = Peek64be(p);
+		else {
+			uint64 k = 0;
+			for(int q = 0; q < l; q++)
+				k |= (uint64)p[q] << (56 - 8 * q);
+			m.key = k;
+		}
+	}
+}
+
+force_inline
+static int sDigit(const RadixStringItem__& m, int depth, int j)
+{ // 0 is for strings that end before depth + j
+	return m.len > depth + j ? (byte)(m.key >> (56 - 8 * j)) + 1 : 0;
+}
+
+static void sRadixSortStrings(CoWork *co, const byte *const *s, RadixStringItem__ *a, RadixStringItem__ *t, int n,
+                              int depth, int j, bool swapped)
+{ // keys of items contain 8 bytes at depth, we are sorting by byte j of them;
+  // data are in a, result has to end in t if swapped (buffers are exchanged on each level)
+	auto Done = [&] {
+		if(swapped)
+			memcpy(t, a, n * sizeof(RadixStringItem__));
+	};
+	for(;;) {
+		if(n < RADIX_STRING_SMALL) {
+			int d = depth + j;
+			Sort__(a, a + n, [=](const RadixStringItem__& x, const RadixStringItem__& y) {
+				if(x.key != y.key) // bytes before j are equal, so this compares bytes that follow
+					return x.key < y.key;
+				int q = memcmp(s[x.index] + d, s[y.index] + d, max(min(x.len, y.len) - d, 0));
+				if(q)
+					return q < 0;
+				return x.len != y.len ? x.len < y.len : x.index < y.index;
+			});
+			Done();
+			return;
+		}
+		if(j == 8) {
+			depth += 8;
+			j = 0;
+			sLoadKeys(s, a, n, depth);
+		}
+		int count[257];
+		memset(count, 0, sizeof(count));
+		for(int i = 0; i < n; i++)
+			count[sDigit(a[i], depth, j)]++;
+		int first = sDigit(a[0], depth, j);
+		if(count[first] == n) { // common prefix
+			if(first == 0) { // all strings are equal
+				Done();
+				return;
+			}
+			j++;
+			continue;
+		}
+		int offset[257];
+		int sum = 0;
+		for(int d = 0; d < 257; d++) {
+			offset[d] = sum;
+			sum += count[d];
+		}
+		for(int i = 0; i < n; i++)
+			t[offset[sDigit(a[i], depth, j)]++] = a[i];
+		int b = 0;
+		for(int d = 0; d < 257; d++) {
+			int m = count[d];
+			RadixStringItem__ *ba = a + b;
+			RadixStringItem__ *bt = t + b;
+			if(d && m > 1) {
+				if(co && m > RADIX_STRING_CO)
+					*co & [=] { sRadixSortStrings(co, s, bt, ba, m, depth, j + 1, !swapped); };
+				else
+					sRadixSortStrings(co, s, bt, ba, m, depth, j + 1, !swapped);
+			}
+			else
+			if(m && !swapped) // strings ending here are equal and already in order
+				memcpy(ba, bt, m * sizeof(RadixStringItem__));
+			b += m;
+		}
+		return;
+	}
+}
+
+void RadixSortStrings__(RadixStringItem__ *a, const byte *const *s, int n, bool co)
+{
+	Buffer<RadixStringItem__> t(n);
+	sLoadKeys(s, a, n, 0);
+	if(co && n > RADIX_STRING_CO) {
+		CoWork cw;
+		sRadixSortStrings(&cw, s, a, t, n, 0, 0, false);
+	}
+	else
+		sRadixSortStrings(NULL, s, a, t, n, 0, 0, false);
+}
+
+}
@@ -0,0 +1,314 @@
+// Radix sorts for integral, floating point and String keys. All of them are stable.
+// Floating point keys are ordered by their bit patterns: -0.0 < 0.0, NaNs are placed at the ends.
+
+template <class T>
+force_inline auto RadixKey__(const T& x)
+{ // maps the key to unsigned integer with the same ordering
+	if constexpr(std::is_enum<T>::value)
+		return RadixKey__((std::underlying_type_t<T>)x);
+	else
+	if constexpr(std::is_floating_point<T>::value) {
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "Unsupported floating point type");
+		typedef std::conditional_t<sizeof(T) == 4, dword, uint64> U;
+		const U sign = (U)1 << (8 * sizeof(U) - 1);
+		U u;
+		memcpy(&u, &x, sizeof(U));
+		return U(u & sign ? ~u : u | sign);
+	}
+	else {
+		static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+		              "Radix sort key has to be integral, floating point or String");
+		typedef std::make_unsigned_t<T> U;
+		const U sign = (U)1 << (8 * sizeof(U) - 1);
+		return U(std::is_signed<T>::value ? (U)x ^ sign : (U)x);
+	}
+}
+
+template <class T, class U>
+force_inline T RadixUnKey__(U u)
+{
+	const U sign = (U)1 << (8 * sizeof(U) - 1);
+	if constexpr(std::is_floating_point<T>::value) {
+		u = u & sign ? U(u & ~sign) : U(~u);
+		T x;
+		memcpy(&x, &u, sizeof(T));
+		return x;
+	}
+	else
+		return T(std::is_signed<T>::value ? U(u ^ sign) : u);
+}
+
+template <class Fn>
+void RadixFor__(bool co, int n, const Fn& fn)
+{ // calls fn(begin, end) for chunks of [0, n), in parallel if co
+	int chunks = co ? min(CPU_Cores(), n >> 16) : 1;
+	if(chunks > 1)
+		CoFor(chunks, [&](int c) {
+			fn(int((int64)n * c / chunks), int((int64)n * (c + 1) / chunks));
+		});
+	else
+		fn(0, n);
+}
+
+template <class T, class Key>
+T *RadixLSD__(T *a, T *t, int n, const Key& key, bool co)
+{ // sorts a by key, 8 bits per pass, returns a or t, whichever contains the result
+	typedef decltype(key(*a)) U;
+	enum { PASSES = sizeof(U) };
+	int chunks = co ? min(CPU_Cores(), n >> 16) : 1;
+	if(chunks < 1)
+		chunks = 1;
+	auto Chunk = [&](int c, int& b, int& e) {
+		b = int((int64)n * c / chunks);
+		e = int((int64)n * (c + 1) / chunks);
+	};
+	Buffer<int> chist(chunks * PASSES * 256, 0); // histograms of all passes for each chunk
+	CoFor(chunks > 1, chunks, [&](int c) {
+		int b, e;
+		Chunk(c, b, e);
+		int *h = ~chist + c * PASSES * 256;
+		for(int i = b; i < e; i++) {
+			U k = key(a[i]);
+			for(int p = 0; p < PASSES; p++)
+				h[p * 256 + (byte)(k >> (8 * p))]++;
+		}
+	});
+	Buffer<int> offset(chunks * 256);
+	bool moved = false;
+	for(int p = 0; p < PASSES; p++) {
+		int total[256];
+		memset(total, 0, sizeof(total));
+		for(int c = 0; c < chunks; c++)
+			for(int d = 0; d < 256; d++)
+				total[d] += chist[(c * PASSES + p) * 256 + d];
+		if(n == 0 || total[(byte)(key(a[0]) >> (8 * p))] == n)
+			continue; // all keys have the same digit
+		if(moved) // chunks have changed, histograms of chunks for this pass have to be recomputed
+			CoFor(chunks > 1, chunks, [&](int c) {
+				int b, e;
+				Chunk(c, b, e);
+				int *h = ~chist + (c * PASSES + p) * 256;
+				memset(h, 0, 256 * sizeof(int));
+				for(int i = b; i < e; i++)
+					h[(byte)(key(a[i]) >> (8 * p))]++;
+			});
+		int sum = 0;
+		for(int d = 0; d < 256; d++)
+			for(int c = 0; c < chunks; c++) {
+				offset[c * 256 + d] = sum;
+				sum += chist[(c * PASSES + p) * 256 + d];
+			}
+		CoFor(chunks > 1, chunks, [&](int c) {
+			int b, e;
+			Chunk(c, b, e);
+			int *o = ~offset + c * 256;
+			for(int i = b; i < e; i++)
+				t[o[(byte)(key(a[i]) >> (8 * p))]++] = a[i];
+		});
+		Swap(a, t);
+		moved = true;
+	}
+	return a;
+}
+
+struct RadixStringItem__ {
+	uint64 key; // next 8 bytes of string, cached to avoid cache misses
+	int    len;
+	int    index;
+};
+
+void RadixSortStrings__(RadixStringItem__ *a, const byte *const *s, int n, bool co);
+
+template <class Range, class Key>
+Vector<int> GetRadixSortOrder__(const Range& r, const Key& key, bool co)
+{
+	typedef decltype(key(*r.begin())) KR;
+	typedef std::decay_t<KR> K;
+	int n = r.GetCount();
+	auto begin = r.begin();
+	Vector<int> order;
+	order.SetCount(n);
+	if constexpr(std::is_same<K, String>::value) {
+		Buffer<String> keys; // used only if key returns a temporary
+		if(!std::is_reference<KR>::value)
+			keys.Alloc(n);
+		Buffer<RadixStringItem__> a(n);
+		Buffer<const byte *> ptr(n);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++) {
+				const String *s;
+				if constexpr(std::is_reference<KR>::value)
+					s = &key(*(begin + i));
+				else {
+					keys[i] = key(*(begin + i));
+					s = &keys[i];
+				}
+				RadixStringItem__& m = a[i];
+				ptr[i] = (const byte *)~*s;
+				m.len = s->GetLength();
+				m.index = i;
+			}
+		});
+		RadixSortStrings__(a, ptr, n, co);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				order[i] = a[i].index;
+		});
+	}
+	else {
+		typedef decltype(RadixKey__(key(*begin))) U;
+		struct Item {
+			U   key;
+			int index;
+		};
+		Buffer<Item> a(n), t(n);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++) {
+				a[i].key = RadixKey__(key(*(begin + i)));
+				a[i].index = i;
+			}
+		});
+		Item *s = RadixLSD__(~a, ~t, n, [](const Item& m) { return m.key; }, co);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				order[i] = s[i].index;
+		});
+	}
+	return order;
+}
+
+template <class Range>
+void ApplyRadixOrder__(Range& r, const Vector<int>& order, bool co)
+{
+	typedef std::remove_const_t<ValueTypeOf<Range>> T;
+	int n = order.GetCount();
+	auto begin = r.begin();
+	if constexpr(is_trivially_relocatable<T> && std::is_same<decltype(*begin), T&>::value) {
+		Buffer<byte> tmp(n * sizeof(T)); // just move bytes
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				memcpy(~tmp + i * sizeof(T), (void *)&*(begin + order[i]), sizeof(T));
+		});
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				memcpy((void *)&*(begin + i), ~tmp + i * sizeof(T), sizeof(T));
+		});
+	}
+	else {
+		Buffer<T> tmp(n);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				tmp[i] = pick(*(begin + order[i]));
+		});
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				*(begin + i) = pick(tmp[i]);
+		});
+	}
+}
+
+struct RadixIdentity__ {
+	template <class T>
+	const T& operator()(const T& x) const { return x; }
+};
+
+template <class Range>
+void RadixSort__(Range& r, bool co)
+{
+	typedef std::remove_const_t<ValueTypeOf<Range>> T;
+	if constexpr(std::is_arithmetic<T>::value) { // sort keys directly, no index needed
+		typedef decltype(RadixKey__(T())) U;
+		int n = r.GetCount();
+		auto begin = r.begin();
+		Buffer<U> a(n), t(n);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				a[i] = RadixKey__(*(begin + i));
+		});
+		U *s = RadixLSD__(~a, ~t, n, [](U k) { return k; }, co);
+		RadixFor__(co, n, [&](int b, int e) {
+			for(int i = b; i < e; i++)
+				*(begin + i) = RadixUnKey__<T>(s[i]);
+		});
+	}
+	else
+		ApplyRadixOrder__(r, GetRadixSortOrder__(r, RadixIdentity__(), co), co);
+}
+
+template <class Range, class Key>
+Vector<int> GetRadixSortOrder(const Range& r, const Key& key)
+{
+	return GetRadixSortOrder__(r, key, false);
+}
+
+template <class Range>
+Vector<int> GetRadixSortOrder(const Range& r)
+{
+	return GetRadixSortOrder__(r, RadixIdentity__(), false);
+}
+
+template <class Range, class Key>
+Vector<int> CoGetRadixSortOrder(const Range& r, const Key& key)
+{
+	return GetRadixSortOrder__(r, key, true);
+}
+
+template <class Range>
+Vector<int> CoGetRadixSortOrder(const Range& r)
+{
+	return GetRadixSortOrder__(r, RadixIdentity__(), true);
+}
+
+template <class Range, class Key>
+void RadixSort(Range&& r, const Key& key)
+{
+	ApplyRadixOrder__(r, GetRadixSortOrder__(r, key, false), false);
+}
+
+template <class Range>
+void RadixSort(Range&& r)
+{
+	RadixSort__(r, false);
+}
+
+template <class Range, class Key>
+void CoRadixSort(Range&& r, const Key& key)
+{
+	ApplyRadixOrder__(r, GetRadixSortOrder__(r, key, true), true);
+}
+
+template <class Range>
+void CoRadixSort(Range&& r)
+{
+	RadixSort__(r, true);
+}
+
+template <class MasterRange, class Range2, class Key>
+void RadixIndexSort(MasterRange&& r, Range2&& r2, const Key& key)
+{
+	ASSERT(r.GetCount() == r2.GetCount());
+	Vector<int> order = GetRadixSortOrder__(r, key, false);
+	ApplyRadixOrder__(r, order, false);
+	ApplyRadixOrder__(r2, order, false);
+}
+
+template <class MasterRange, class Range2>
+void RadixIndexSort(MasterRange&& r, Range2&& r2)
+{
+	RadixIndexSort(r, r2, RadixIdentity__());
+}
+
+template <class MasterRange, class Range2, class Key>
+void CoRadixIndexSort(MasterRange&& r, Range2&& r2, const Key& key)
+{
+	ASSERT(r.GetCount() == r2.GetCount());
+	Vector<int> order = GetRadixSortOrder__(r, key, true);
+	ApplyRadixOrder__(r, order, true);
+	ApplyRadixOrder__(r2, order, true);
+}
+
+template <class MasterRange, class Range2>
+void CoRadixIndexSort(MasterRange&& r, Range2&& r2)
+{
+	CoRadixIndexSort(r, r2, RadixIdentity__());
+}
@@ -252,6 +252,13 @@ force_inline int    CountTrue(i8x16 a)             { return CountBits64(cmask8__
 force_inline int    FirstTrue(i8x16 a)             { return CountTrailingZeroBits64(cmask8__(a.data)) >> 2; }
 force_inline int    FirstFalse(i8x16 a)            { return CountTrailingZeroBits64(~cmask8__(a.data)) >> 2; }
 force_inline bool   IsTrue(i8x16 a, int i)         { return cmask8__(a.data) & ((uint64)1 << (i << 2)); }
+force_inline dword  BitMask(i8x16 a) { // one bit per element
+	uint64 m = cmask8__(a.data) & 0x1111111111111111ull;
+	m = (m | (m >> 3)) & 0x0303030303030303ull;
+	m = (m | (m >> 6)) & 0x000f000f000f000full;
+	m = (m | (m >> 12)) & 0x000000ff000000ffull;
+	return (dword)(m | (m >> 24)) & 0xffff;
+}
 
 force_inline f32x4 ToFloat(i32x4 a)               { return vcvtq_f32_s32(a); }
 force_inline i32x4 Truncate(f32x4 a)              { return vcvtq_s32_f32(a); }
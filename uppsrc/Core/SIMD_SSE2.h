@@ -185,6 +185,7 @@ force_inline int    CountTrue(i8x16 a)             { return CountBits(_mm_movema
 force_inline int    FirstTrue(i8x16 a)             { return CountTrailingZeroBits(_mm_movemask_epi8(a.data)); }
 force_inline int    FirstFalse(i8x16 a)            { return CountTrailingZeroBits(~_mm_movemask_epi8(a.data)); }
 force_inline bool   IsTrue(i8x16 a, int i)         { return _mm_movemask_epi8(a.data) & (1 << i); }
+force_inline dword  BitMask(i8x16 a)               { return _mm_movemask_epi8(a.data); }
 
 force_inline f32x4 ToFloat(i32x4 a)               { return _mm_cvtepi32_ps(a.data); }
 force_inline i32x4 Truncate(f32x4 a)              { return _mm_cvttps_epi32(a.data); }
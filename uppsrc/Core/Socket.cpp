@@ -7,6 +7,7 @@
 
 #ifdef PLATFORM_POSIX
 #include <arpa/inet.h>
+#include <poll.h>
 #endif
 
 namespace Upp {
@@ -628,6 +629,17 @@ bool TcpSocket::RawWait(dword flags, int end_time)
 			tvalp = &tval;
 			LLOG("RawWait timeout: " << to);
 		}
+#ifdef PLATFORM_POSIX
+		pollfd pfd;
+		pfd.fd = socket;
+		pfd.events = POLLPRI;
+		if(flags & WAIT_READ)
+			pfd.events |= POLLIN;
+		if(flags & WAIT_WRITE)
+			pfd.events |= POLLOUT;
+		pfd.revents = 0;
+		int avail = poll(&pfd, 1, tvalp ? to : -1);
+#else
 		fd_set fdsetr[1], fdsetw[1], fdsetx[1];;
 		FD_ZERO(fdsetr);
 		if(flags & WAIT_READ)
@@ -638,6 +650,7 @@ bool TcpSocket::RawWait(dword flags, int end_time)
 		FD_ZERO(fdsetx);
 		FD_SET(socket, fdsetx);
 		int avail = select((int)socket + 1, fdsetr, fdsetw, fdsetx, tvalp);
+#endif
 		LLOG("Wait select avail: " << avail);
 		if(avail < 0 && GetErrorCode() != SOCKERR(EINTR)) {
 			SetSockError("wait");
@@ -984,6 +997,46 @@ void TcpSocket::Clear()
 	Reset();
 }
 
+#ifdef PLATFORM_POSIX
+
+int SocketWaitEvent::Wait(int timeout)
+{
+	pollfds.Alloc(max(socket.GetCount(), 1) * sizeof(pollfd));
+	pollfd *pfd = (pollfd *)~pollfds;
+	for(int i = 0; i < socket.GetCount(); i++) {
+		const Tuple<int, dword>& s = socket[i];
+		pfd[i].fd = s.a; // negative fd is ignored by poll
+		pfd[i].events = POLLPRI;
+		if(s.b & WAIT_READ)
+			pfd[i].events |= POLLIN;
+		if(s.b & WAIT_WRITE)
+			pfd[i].events |= POLLOUT;
+		pfd[i].revents = 0;
+	}
+	return poll(pfd, socket.GetCount(), IsNull(timeout) ? -1 : timeout);
+}
+
+dword SocketWaitEvent::Get(int i) const
+{
+	if(socket[i].a < 0 || !~pollfds)
+		return 0;
+	short revents = ((const pollfd *)~pollfds)[i].revents;
+	dword events = 0;
+	if(revents & (POLLIN|POLLHUP))
+		events |= WAIT_READ;
+	if(revents & POLLOUT)
+		events |= WAIT_WRITE;
+	if(revents & (POLLPRI|POLLERR))
+		events |= WAIT_IS_EXCEPTION;
+	return events;
+}
+
+SocketWaitEvent::SocketWaitEvent()
+{
+}
+
+#else
+
 int SocketWaitEvent::Wait(int timeout)
 {
 	FD_ZERO(read);
@@ -1034,4 +1087,6 @@ SocketWaitEvent::SocketWaitEvent()
 	FD_ZERO(exception);
 }
 
+#endif
+
 }
@@ -0,0 +1,290 @@
+#include "Core.h"
+
+#ifdef PLATFORM_LINUX
+#include <sys/epoll.h>
+#endif
+
+namespace Upp {
+
+#define LLOG(x)  // LOG("SocketEventLoop " << x)
+
+template <class K, class T>
+static void sRemove(VectorMap<K, T>& map, int i)
+{ // O(1) removal, order of items is not important here
+	int last = map.GetCount() - 1;
+	if(i < last) {
+		map.SetKey(i, map.GetKey(last));
+		map[i] = pick(map[last]);
+	}
+	map.Drop();
+}
+
+SocketEventLoop::SocketEventLoop()
+{
+#ifdef PLATFORM_LINUX
+	epoll_fd = epoll_create1(EPOLL_CLOEXEC); // if this fails, epoll_fd < 0 and the loop falls back to poll
+#endif
+}
+
+SocketEventLoop::~SocketEventLoop()
+{
+	while(drivers.InList())
+		delete (Driver *)drivers.GetNext();
+#ifdef PLATFORM_LINUX
+	if(epoll_fd >= 0)
+		close(epoll_fd);
+#endif
+}
+
+bool SocketEventLoop::Ctl(int op, SOCKET s, dword events)
+{
+#ifdef PLATFORM_LINUX
+	if(epoll_fd < 0)
+		return true;
+	epoll_event ev;
+	memset(&ev, 0, sizeof(ev));
+	ev.data.fd = s;
+	if(events & WAIT_READ)
+		ev.events |= EPOLLIN|EPOLLRDHUP;
+	if(events & WAIT_WRITE)
+		ev.events |= EPOLLOUT;
+	if(edge)
+		ev.events |= EPOLLET;
+	if(epoll_ctl(epoll_fd, op, s, &ev) == 0)
+		return true;
+	if(op == EPOLL_CTL_MOD && errno == ENOENT) // descriptor was closed and its number reused
+		return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, s, &ev) == 0;
+	if(op == EPOLL_CTL_ADD && errno == EEXIST)
+		return epoll_ctl(epoll_fd, EPOLL_CTL_MOD, s, &ev) == 0;
+	LLOG("epoll_ctl failed, socket " << (int)s << ", errno " << errno);
+	return op == EPOLL_CTL_DEL;
+#else
+	return true;
+#endif
+}
+
+bool SocketEventLoop::Add(SOCKET s, dword events, Event<dword> cb)
+{
+	if(s == INVALID_SOCKET)
+		return false;
+	int i = slot.Find(s);
+	bool isnew = i < 0;
+	if(isnew) {
+		i = slot.GetCount();
+		slot.Add(s);
+	}
+	Slot& m = slot[i];
+	m.events = events;
+	m.cb = pick(cb);
+#ifdef PLATFORM_LINUX
+	if(!Ctl(isnew ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, s, events)) {
+		sRemove(slot, i);
+		return false;
+	}
+#endif
+	return true;
+}
+
+bool SocketEventLoop::Modify(SOCKET s, dword events)
+{
+	int i = slot.Find(s);
+	if(i < 0)
+		return false;
+	slot[i].events = events;
+#ifdef PLATFORM_LINUX
+	return Ctl(EPOLL_CTL_MOD, s, events);
+#else
+	return true;
+#endif
+}
+
+void SocketEventLoop::Remove(SOCKET s)
+{
+	int i = slot.Find(s);
+	if(i < 0)
+		return;
+	sRemove(slot, i);
+#ifdef PLATFORM_LINUX
+	Ctl(EPOLL_CTL_DEL, s, 0);
+#endif
+}
+
+int SocketEventLoop::SetTimer(int delay_ms, Event<> cb)
+{
+	int id = ++timer_id;
+	if(id <= 0)
+		id = timer_id = 1;
+	timer_fn.Add(id, pick(cb));
+	Timer& t = timer.Add();
+	t.at = usecs() / 1000 + max(delay_ms, 0);
+	t.id = id;
+	int i = timer.GetCount() - 1;
+	while(i > 0) { // sift up
+		int parent = (i - 1) / 2;
+		if(timer[parent].at <= timer[i].at)
+			break;
+		Swap(timer[parent], timer[i]);
+		i = parent;
+	}
+	return id;
+}
+
+void SocketEventLoop::KillTimer(int id)
+{ // heap entry is removed lazily
+	int i = timer_fn.Find(id);
+	if(i >= 0)
+		sRemove(timer_fn, i);
+}
+
+int SocketEventLoop::GetWaitTimeout(int timeout) const
+{
+	if(timer.GetCount()) {
+		int to = (int)clamp(timer[0].at - usecs() / 1000, (int64)0, (int64)INT_MAX);
+		return IsNull(timeout) ? to : min(to, timeout);
+	}
+	return timeout;
+}
+
+int SocketEventLoop::FireTimers()
+{
+	int n = 0;
+	int64 now = usecs() / 1000;
+	while(timer.GetCount() && timer[0].at <= now) {
+		int id = timer[0].id;
+		timer[0] = timer.Top();
+		timer.Drop();
+		int i = 0;
+		for(;;) { // sift down
+			int l = 2 * i + 1;
+			if(l >= timer.GetCount())
+				break;
+			if(l + 1 < timer.GetCount() && timer[l + 1].at < timer[l].at)
+				l++;
+			if(timer[i].at <= timer[l].at)
+				break;
+			Swap(timer[i], timer[l]);
+			i = l;
+		}
+		int q = timer_fn.Find(id);
+		if(q >= 0) {
+			Event<> cb = pick(timer_fn[q]);
+			sRemove(timer_fn, q);
+			cb();
+			n++;
+		}
+	}
+	return n;
+}
+
+void SocketEventLoop::Dispatch(SOCKET s, dword events)
+{
+	int i = slot.Find(s);
+	if(i < 0) // removed by previous callback
+		return;
+	events &= slot[i].events | WAIT_IS_EXCEPTION;
+	if(events) {
+		Event<dword> cb = slot[i].cb; // callback can remove or replace itself
+		cb(events);
+	}
+}
+
+int SocketEventLoop::Wait(int timeout)
+{
+	int n = 0;
+	timeout = GetWaitTimeout(timeout);
+#ifdef PLATFORM_LINUX
+	if(epoll_fd >= 0) {
+		epoll_event ev[256];
+		int count = epoll_wait(epoll_fd, ev, __countof(ev), IsNull(timeout) ? -1 : timeout);
+		if(count < 0 && errno != EINTR)
+			return -1;
+		for(int i = 0; i < count; i++) {
+			dword e = ev[i].events;
+			dword events = 0;
+			if(e & (EPOLLIN|EPOLLRDHUP|EPOLLHUP|EPOLLERR))
+				events |= WAIT_READ;
+			if(e & (EPOLLOUT|EPOLLHUP|EPOLLERR))
+				events |= WAIT_WRITE;
+			if(e & EPOLLERR)
+				events |= WAIT_IS_EXCEPTION;
+			Dispatch(ev[i].data.fd, events);
+		}
+		n = max(count, 0);
+	}
+	else
+#endif
+	{
+		SocketWaitEvent we;
+		Vector<SOCKET> s;
+		for(int i = 0; i < slot.GetCount(); i++) {
+			we.Add(slot.GetKey(i), slot[i].events);
+			s.Add(slot.GetKey(i));
+		}
+		if(s.GetCount() == 0 && !IsNull(timeout))
+			Sleep(timeout);
+		else
+		if(we.Wait(timeout) < 0)
+			return -1;
+		else
+			for(int i = 0; i < s.GetCount(); i++) {
+				dword events = we.Get(i);
+				if(events) {
+					Dispatch(s[i], events);
+					n++;
+				}
+			}
+	}
+	return n + FireTimers();
+}
+
+void SocketEventLoop::Run()
+{
+	quit = false;
+	while(!quit && (slot.GetCount() || timer_fn.GetCount()))
+		if(Wait() < 0)
+			break;
+}
+
+void SocketEventLoop::DriveStep(Driver *d)
+{
+	if(d->timer >= 0) {
+		KillTimer(d->timer);
+		d->timer = -1;
+	}
+	bool progress = d->step();
+	SOCKET s = progress ? d->socket() : INVALID_SOCKET;
+	dword events = s != INVALID_SOCKET ? d->events() : 0;
+	if(d->fd != INVALID_SOCKET && (d->fd != s || !events)) {
+		Remove(d->fd);
+		d->fd = INVALID_SOCKET;
+	}
+	if(!progress) {
+		delete d;
+		return;
+	}
+	if(!events) // no socket (e.g. dns lookup) or nothing to wait for
+		d->timer = SetTimer(10, [=] { d->timer = -1; DriveStep(d); });
+	else {
+		if(d->fd == s)
+			Modify(s, events);
+		else {
+			d->fd = s;
+			Add(s, events, [=](dword) { DriveStep(d); });
+		}
+		if(!IsNull(d->idle))
+			d->timer = SetTimer(d->idle, [=] { d->timer = -1; DriveStep(d); });
+	}
+}
+
+void SocketEventLoop::Drive(Gate<> step, Function<SOCKET ()> socket, Function<dword ()> events, int idle_ms)
+{
+	Driver *d = new Driver;
+	d->LinkAfter(&drivers);
+	d->step = pick(step);
+	d->socket = pick(socket);
+	d->events = pick(events);
+	d->idle = idle_ms;
+	DriveStep(d);
+}
+
+}
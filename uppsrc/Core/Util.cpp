@@ -206,6 +206,12 @@ int64 usecs(int64 prev)
 	return std::chrono::duration_cast<std::chrono::microseconds>(p2.time_since_epoch()).count() - prev;
 }
 
+int64 nsecs(int64 prev)
+{
+	auto p2 = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(p2.time_since_epoch()).count() - prev;
+}
+
 int msecs(int from) { return GetTickCount() - (dword)from; }
 
 /* // it looks like there might be a problem with std::chrono in llvm-mingw, reverting to original implementation for now
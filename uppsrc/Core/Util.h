@@ -10,6 +10,7 @@ dword  GetTickCount();
 #endif
 
 int64 usecs(int64 prev = 0);
+int64 nsecs(int64 prev = 0);
 int msecs(int prev = 0);
 
 class TimeStop : Moveable<TimeStop> {
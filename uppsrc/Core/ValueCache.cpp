@@ -4,18 +4,21 @@
 
 namespace Upp {
 
-StaticMutex ValueCacheMutex;
+StaticMutex ValueCacheMutex; // protects cache limits
 
 std::atomic<bool> sValueCacheFinished;
 
-struct ValueMakeCacheClass : LRUCache<Value> {
+struct ValueMakeCacheClass {
+	ValueCacheShard shard[VALUECACHE_SHARDS];
+
 	~ValueMakeCacheClass() { sValueCacheFinished = true; }
 };
 
-LRUCache<Value>& TheValueCache()
+ValueCacheShard& GetValueCacheShard(int i)
 {
+	ASSERT(i >= 0 && i < VALUECACHE_SHARDS);
 	static ValueMakeCacheClass m;
-	return m;
+	return m.shard[i];
 }
 
 bool IsValueCacheActive()
@@ -23,9 +26,68 @@ bool IsValueCacheActive()
 	return !sValueCacheFinished;
 }
 
+static std::atomic<int64> sValueCacheHits;
+static std::atomic<int64> sValueCacheFrontHits;
+static std::atomic<int64> sValueCacheMisses;
+static std::atomic<int64> sValueCacheEvictions;
+
+struct ValueFrontCache { // small direct mapped per-thread cache, lookups do not need any lock
+	enum { COUNT = 64, REFRESH = 32 };
+
+	struct Entry {
+		String  key;
+		Value   value;
+		dword   hash = 0;
+		dword   serial = 0;
+		int     size = 0;
+		int     touched = 0; // front hits since the item was moved to the head of shard LRU
+	};
+
+	Entry entry[COUNT];
+	int   hits = 0; // not yet accounted in sValueCacheFrontHits
+
+	void Flush() {
+		if(hits) {
+			sValueCacheFrontHits += hits;
+			sValueCacheHits += hits;
+			hits = 0;
+		}
+	}
+
+	~ValueFrontCache() { Flush(); }
+};
+
+static ValueFrontCache& sFrontCache()
+{
+	if(IsMainThread()) {
+		static ValueFrontCache cache; // this is basically to avoid problem with leaks detection
+		return cache;
+	}
+	thread_local ValueFrontCache cache;
+	return cache;
+}
+
 bool ValueCacheFixed = false;
-int  ValueCacheMaxSize = 0;
-int  ValueCacheMaxCount = 20000;
+std::atomic<int> ValueCacheMaxSize;
+std::atomic<int> ValueCacheMaxCount(20000);
+
+static dword sValueCacheHash(const String& key)
+{
+	return FoldHash(GetHashValue(key));
+}
+
+static void sShrink(ValueCacheShard& s, int maxsize, int maxcount)
+{ // s.mutex must be locked
+	if(maxsize < 0 || maxcount < 0)
+		return;
+	maxsize = (maxsize + VALUECACHE_SHARDS - 1) / VALUECACHE_SHARDS;
+	maxcount = (maxcount + VALUECACHE_SHARDS - 1) / VALUECACHE_SHARDS;
+	while(s.cache.GetCount() > maxcount || s.cache.GetSize() > maxsize) {
+		s.Serial(sValueCacheHash(s.cache.GetLRUKey()))++; // only front entries of the same hash are invalidated
+		s.cache.DropLRU();
+		sValueCacheEvictions++;
+	}
+}
 
 void AdjustValueCache()
 {
@@ -34,28 +96,38 @@ void AdjustValueCache()
 		return;
 	uint64 total, available;
 	GetSystemMemoryStatus(total, available);
-	ValueCacheMaxSize = int(available >> 10);
-	if(!ValueCacheMaxSize)
-		ValueCacheMaxSize = available ? 128*1024*1024 : 16*1024;
-	ValueCacheMaxCount = max(ValueCacheMaxSize / 200, 20000);
+	int maxsize = int(available >> 10);
+	if(!maxsize)
+		maxsize = available ? 128*1024*1024 : 16*1024;
+	ValueCacheMaxSize = maxsize;
+	ValueCacheMaxCount = max(maxsize / 200, 20000);
 	LLOG("New MakeValue max size " << ValueCacheMaxSize << " count " << ValueCacheMaxCount);
 	ShrinkValueCache();
 }
 
-void ShrinkValueCache()
+static void sCheckValueCacheLimits()
 {
-	Mutex::Lock __(ValueCacheMutex);
 	if(!ValueCacheMaxSize) {
 		static bool lock;
-		if(!lock) { // prevent (unlikely) recursion
+		Mutex::Lock __(ValueCacheMutex);
+		if(!lock && !ValueCacheMaxSize) { // prevent (unlikely) recursion
 			lock = true;
 			AdjustValueCache();
 			lock = false;
 		}
 	}
-	LLOG("MakeValue cache size before shrink: " << TheValueCache().GetSize());
-	TheValueCache().Shrink(ValueCacheMaxSize, ValueCacheMaxCount);
-	LLOG("MakeValue cache size after shrink: " << TheValueCache().GetSize());
+}
+
+void ShrinkValueCache()
+{
+	sCheckValueCacheLimits();
+	for(int i = 0; i < VALUECACHE_SHARDS; i++) {
+		ValueCacheShard& s = GetValueCacheShard(i);
+		Mutex::Lock __(s.mutex);
+		LLOG("MakeValue cache shard " << i << " size before shrink: " << s.cache.GetSize());
+		sShrink(s, ValueCacheMaxSize, ValueCacheMaxCount);
+		LLOG("MakeValue cache shard " << i << " size after shrink: " << s.cache.GetSize());
+	}
 }
 
 void SetupValueCache(int maxsize, int maxcount)
@@ -73,14 +145,57 @@ void SetupValueCache(int maxsize, int maxcount)
 	}
 }
 
-
 Value MakeValueSz(ValueMaker& m, int& sz)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	LLOG("MakeValue cache size before make: " << TheValueCache().GetSize());
-	Value v = TheValueCache().Get(m, [] { ValueCacheMutex.Leave(); }, [] { ValueCacheMutex.Enter(); }, sz);
-	LLOG("MakeValue cache size after make: " << TheValueCache().GetSize());
-	ShrinkValueCache();
+	StringBuffer kb;
+	kb.Cat(typeid(m).name());
+	kb.Cat(m.Key());
+	String key = kb;
+	dword hash = sValueCacheHash(key);
+
+	ValueCacheShard& s = GetValueCacheShard(hash % VALUECACHE_SHARDS);
+	ValueFrontCache& f = sFrontCache();
+	ValueFrontCache::Entry& e = f.entry[(hash / VALUECACHE_SHARDS) % ValueFrontCache::COUNT];
+	if(e.hash == hash && e.serial == s.Serial(hash) && e.key == key &&
+	   ++e.touched < ValueFrontCache::REFRESH) { // once in a while go to the shard to keep the item in LRU
+		if(++f.hits >= 256)
+			f.Flush();
+		sz = e.size;
+		return e.value;
+	}
+
+	struct Maker : ValueMaker { // key already contains the type of m
+		const String&     key;
+		const ValueMaker& m;
+
+		String Key() const override              { return key; }
+		int    Make(Value& object) const override { return m.Make(object); }
+
+		Maker(const String& key, const ValueMaker& m) : key(key), m(m) {}
+	};
+
+	sCheckValueCacheLimits();
+
+	Maker maker(key, m);
+	bool made = false;
+	Value v;
+	dword serial;
+	{
+		Mutex::Lock __(s.mutex);
+		LLOG("MakeValue cache size before make: " << s.cache.GetSize());
+		v = s.cache.Get(maker, [&] { made = true; s.mutex.Leave(); }, [&] { s.mutex.Enter(); }, sz);
+		LLOG("MakeValue cache size after make: " << s.cache.GetSize());
+		sShrink(s, ValueCacheMaxSize, ValueCacheMaxCount);
+		serial = s.Serial(hash); // read under the lock, any later removal changes it
+	}
+	(made ? sValueCacheMisses : sValueCacheHits)++;
+
+	e.key = key;
+	e.value = v;
+	e.hash = hash;
+	e.serial = serial;
+	e.size = sz;
+	e.touched = 0;
 	LLOG("-------------");
 	return v;
 }
@@ -91,4 +206,35 @@ Value MakeValue(ValueMaker& m)
 	return MakeValueSz(m, sz);
 }
 
-};
\ No newline at end of file
+ValueCacheStats GetValueCacheStats()
+{
+	sFrontCache().Flush();
+	ValueCacheStats st;
+	st.hits = sValueCacheHits;
+	st.front_hits = sValueCacheFrontHits;
+	st.misses = sValueCacheMisses;
+	st.evictions = sValueCacheEvictions;
+	st.size = 0;
+	st.count = 0;
+	for(int i = 0; i < VALUECACHE_SHARDS; i++) {
+		ValueCacheShard& s = GetValueCacheShard(i);
+		Mutex::Lock __(s.mutex);
+		st.size += s.cache.GetSize();
+		st.count += s.cache.GetCount();
+	}
+	return st;
+}
+
+void ClearValueCacheStats()
+{
+	sFrontCache().hits = 0;
+	sValueCacheHits = sValueCacheFrontHits = sValueCacheMisses = sValueCacheEvictions = 0;
+}
+
+String ValueCacheStats::ToString() const
+{
+	return Format("hits: %d (front %d), misses: %d, evictions: %d, size: %d, count: %d",
+	              hits, front_hits, misses, evictions, size, count);
+}
+
+};
@@ -1,6 +1,17 @@
 extern StaticMutex ValueCacheMutex;
 
-LRUCache<Value>& TheValueCache();
+enum { VALUECACHE_SHARDS = 8, VALUECACHE_BUCKETS = 256 };
+
+struct ValueCacheShard {
+	Mutex                 mutex;
+	LRUCache<Value>       cache;
+	std::atomic<dword>    serial[VALUECACHE_BUCKETS]; // per key hash, changed when items are removed, invalidates thread front caches
+
+	std::atomic<dword>& Serial(dword hash)   { return serial[hash / VALUECACHE_SHARDS % VALUECACHE_BUCKETS]; }
+	void                Invalidate()         { for(auto& s : serial) s++; }
+};
+
+ValueCacheShard& GetValueCacheShard(int i);
 
 typedef LRUCache<Value>::Maker ValueMaker;
 
@@ -14,25 +25,50 @@ void ShrinkValueCache();
 
 void SetupValueCache(int maxsize, int maxcount);
 
+struct ValueCacheStats {
+	int64 hits;       // including front_hits
+	int64 front_hits; // served by per-thread front cache without locking
+	int64 misses;
+	int64 evictions;
+	int64 size;
+	int   count;
+	
+	String ToString() const;
+};
+
+ValueCacheStats GetValueCacheStats();
+void            ClearValueCacheStats();
+
 template <class P>
 int ValueCacheRemove(P what)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	return TheValueCache().Remove(what);
+	int n = 0;
+	for(int i = 0; i < VALUECACHE_SHARDS; i++) {
+		ValueCacheShard& s = GetValueCacheShard(i);
+		Mutex::Lock __(s.mutex);
+		int q = s.cache.Remove(what);
+		if(q) {
+			s.Invalidate();
+			n += q;
+		}
+	}
+	return n;
 }
 
 template <class P>
 int ValueCacheRemoveOne(P what)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	return TheValueCache().Remove(what);
+	return ValueCacheRemove(what);
 }
 
 template <class P>
 void ValueCacheAdjustSize(P getsize)
 {
-	Mutex::Lock __(ValueCacheMutex);
-	TheValueCache().AdjustSize(getsize);
+	for(int i = 0; i < VALUECACHE_SHARDS; i++) {
+		ValueCacheShard& s = GetValueCacheShard(i);
+		Mutex::Lock __(s.mutex);
+		s.cache.AdjustSize(getsize);
+	}
 }
 
 template <class M>
@@ -415,6 +415,18 @@ void WebSocket::Do()
 	Do0();
 }
 
+void WebSocket::AddTo(SocketEventLoop& loop, Event<> whenevent)
+{
+	NonBlocking();
+	loop.Drive([=] {
+	                  Do();
+	                  whenevent();
+	                  return IsOpen() && !IsError();
+	              },
+	           [=] { return GetSOCKET(); },
+	           [=] { return GetWaitEvents(); });
+}
+
 String WebSocket::Receive()
 {
 	current_opcode = 0;
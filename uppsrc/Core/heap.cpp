@@ -13,6 +13,8 @@ word Heap::sys_block_limit = 16 * 256; // 16MB default value
 int  Heap::max_free_hpages = 1; // default value
 int  Heap::max_free_lpages = 2; // default value
 int  Heap::max_free_spages = 256; // default value (1MB)
+int  Heap::huge_page_mode = 0; // default value
+bool Heap::numa = false; // default value
 
 MemoryOptions::MemoryOptions()
 {
@@ -21,6 +23,8 @@ MemoryOptions::MemoryOptions()
 	master_reserve = Heap::max_free_hpages;
 	small_reserve = Heap::max_free_spages;
 	large_reserve = Heap::max_free_lpages;
+	huge_pages = Heap::huge_page_mode;
+	numa = Heap::numa;
 }
 
 MemoryOptions::~MemoryOptions()
@@ -30,6 +34,8 @@ MemoryOptions::~MemoryOptions()
 	Heap::max_free_hpages = master_reserve;
 	Heap::max_free_spages = small_reserve;
 	Heap::max_free_lpages = large_reserve;
+	Heap::huge_page_mode = clamp(huge_pages, 0, 2);
+	Heap::numa = numa;
 }
 
 const char *asString(int i)
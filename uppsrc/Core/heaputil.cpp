@@ -6,6 +6,11 @@
 #include <sys/mman.h>
 #endif
 
+#ifdef PLATFORM_LINUX
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
 namespace Upp {
 
 #include "HeapImp.h"
@@ -24,6 +29,7 @@ size_t Heap::big_count;
 size_t Heap::sys_size;
 size_t Heap::sys_count;
 size_t Heap::huge_chunks;
+size_t Heap::explicit_huge_chunks;
 size_t Heap::huge_4KB_count_max;
 
 int MemoryUsedKb()
@@ -64,6 +70,60 @@ void  SysFreeRaw(void *ptr, size_t size)
 #endif
 }
 
+static thread_local int sThreadNode = -1;
+
+void MemoryThreadNode(int node)
+{
+	sThreadNode = node;
+}
+
+int Heap::GetNode()
+{
+	if(!numa)
+		return 0;
+	int node = sThreadNode;
+#ifdef PLATFORM_LINUX
+	unsigned cpu, n;
+	if(node < 0 && syscall(SYS_getcpu, &cpu, &n, NULL) == 0)
+		node = n;
+#endif
+	return clamp(node, 0, UPP_HEAP_NODES - 1);
+}
+
+void *Heap::SysAllocHuge(size_t size, int node, bool& explicit_huge)
+{ // master blocks and blocks allocated directly from the system
+	explicit_huge = false;
+#ifdef PLATFORM_LINUX
+	const size_t HUGE_PAGE = 2048 * 1024;
+	byte *ptr = NULL;
+	if(huge_page_mode == 2 && size % HUGE_PAGE == 0) {
+		ptr = (byte *)mmap(0, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+		if(ptr == MAP_FAILED) // no huge pages reserved in the system, use transparent ones
+			ptr = NULL;
+		else
+			explicit_huge = true;
+	}
+	if(!ptr && huge_page_mode && size >= HUGE_PAGE) { // align to 2MB so that whole block can be backed
+		byte *raw = (byte *)SysAllocRaw(size + HUGE_PAGE, 0);
+		ptr = (byte *)(((uintptr_t)raw + HUGE_PAGE - 1) & ~(uintptr_t)(HUGE_PAGE - 1));
+		if(ptr > raw)
+			munmap(raw, ptr - raw);
+		if(raw + HUGE_PAGE > ptr)
+			munmap(ptr + size, raw + HUGE_PAGE - ptr);
+		madvise(ptr, size, MADV_HUGEPAGE);
+	}
+	if(!ptr)
+		ptr = (byte *)SysAllocRaw(size, 0);
+	if(numa) { // pages are faulted in later, possibly by thread running on another node
+		unsigned long mask = 1ul << node;
+		syscall(SYS_mbind, ptr, size, MPOL_PREFERRED, &mask, 8 * sizeof(mask), 0);
+	}
+	return ptr;
+#else
+	return SysAllocRaw(size, 0); // huge pages and NUMA options are only implemented in Linux
+#endif
+}
+
 void *MemoryAllocPermanent(size_t size)
 {
 	Mutex::Lock __(Heap::mutex);
@@ -162,16 +222,20 @@ void Heap::Make(MemoryProfile& f)
 	f.huge_total = big_size - sys_size; // this is not 100% correct, but approximate
 	
 	f.master_chunks = (int)huge_chunks;
+	f.huge_page_chunks = (int)explicit_huge_chunks;
 
 	HugePage *pg = huge_pages;
 	while(pg) {
 		BlkPrefix *h = (BlkPrefix *)pg->page;
+		int node = h->node;
+		f.arena_chunks[node]++;
 		for(;;) {
 			if(h->IsFree()) {
 				word sz = h->GetSize();
 				f.huge_fragments[sz]++;
 				f.huge_fragments_count++;
 				f.huge_fragments_total += sz;
+				f.arena_free[node] += sz;
 			}
 			if(h->IsLast())
 				break;
@@ -257,6 +321,12 @@ String AsString(const MemoryProfile& mem)
 	text << "Sys block count " << mem.sys_count
 	     << ", total size " << int(mem.sys_total >> 10) << " KB\n";
 	text << Heap::HPAGE * 4 / 1024 << "MB master blocks " << mem.master_chunks << "\n";
+	if(mem.huge_page_chunks)
+		text << "Master blocks in explicit 2MB pages " << mem.huge_page_chunks << "\n";
+	for(int i = 0; i < UPP_HEAP_NODES; i++)
+		if(mem.arena_chunks[i] && (i || mem.arena_chunks[i] < mem.master_chunks))
+			text << "NUMA arena " << i << ": master blocks " << mem.arena_chunks[i]
+			     << ", free " << int(4 * mem.arena_free[i]) << " KB\n";
 	text << "\nLarge fragments:\n";
 	for(int i = 0; i < 2048; i++)
 		if(mem.large_fragments[i])
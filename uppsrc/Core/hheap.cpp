@@ -14,7 +14,7 @@ namespace Upp {
 // used as manager of huge memory blocks. 4KB and 64KB blocks are allocated from here too
 // also able to deal with bigger blocks, those are directly allocated / freed from system
 
-BlkHeader_<4096> HugeHeapDetail::freelist[20][1]; // only single global Huge heap...
+BlkHeader_<4096> HugeHeapDetail::freelist[UPP_HEAP_NODES][20][1]; // only single global Huge heap, per NUMA node...
 Heap::HugePage *Heap::huge_pages;
 
 #ifdef LSTAT
@@ -73,14 +73,18 @@ void *Heap::HugeAlloc(size_t count) // count in 4kb pages
 		}
 	};
 
-	if(!D::freelist[0]->next) { // initialization
-		for(int i = 0; i < __countof(D::freelist); i++)
-			Dbl_Self(D::freelist[i]);
+	if(!D::freelist[0][0]->next) { // initialization
+		for(int n = 0; n < UPP_HEAP_NODES; n++)
+			for(int i = 0; i < __countof(D::freelist[n]); i++)
+				Dbl_Self(D::freelist[n][i]);
 	}
-		
+
+	int node = GetNode();
+	bool explicit_huge;
+
 	if(count > sys_block_limit) { // we are wasting 4KB to store just 4 bytes here, but this is n MB after all..
 		LTIMING("SysAlloc");
-		byte *sysblk = (byte *)SysAllocRaw((count + 1) * 4096, 0);
+		byte *sysblk = (byte *)SysAllocHuge((count + 1) * 4096, node, explicit_huge);
 		BlkHeader *h = (BlkHeader *)(sysblk + 4096);
 		h->size = 0;
 		*((size_t *)sysblk) = count;
@@ -94,9 +98,9 @@ void *Heap::HugeAlloc(size_t count) // count in 4kb pages
 
 	word wcount = (word)count;
 	
-	for(int pass = 0; pass < 2; pass++) {
-		for(int i = Cv(wcount); i < __countof(D::freelist); i++) {
-			BlkHeader *l = D::freelist[i];
+	for(;;) { // with NUMA, FreeSmallEmpty can succeed in another arena
+		for(int i = Cv(wcount); i < __countof(D::freelist[node]); i++) {
+			BlkHeader *l = D::freelist[node][i];
 			BlkHeader *h = l->next;
 			while(h != l) {
 				word sz = h->GetSize();
@@ -112,7 +116,7 @@ void *Heap::HugeAlloc(size_t count) // count in 4kb pages
 		}
 
 		if(!FreeSmallEmpty(wcount, INT_MAX)) { // try to coalesce 4KB small free blocks back to huge storage
-			void *ptr = SysAllocRaw(HPAGE * 4096, 0); // failed, add HPAGE from the system
+			void *ptr = SysAllocHuge(HPAGE * 4096, node, explicit_huge); // failed, add HPAGE from the system
 
 			HugePage *pg; // record in set of huge pages
 			if(free_huge_pages) {
@@ -124,14 +128,15 @@ void *Heap::HugeAlloc(size_t count) // count in 4kb pages
 
 			pg->page = ptr;
 			pg->next = huge_pages;
+			pg->explicit_huge = explicit_huge;
 			huge_pages = pg;
 			huge_chunks++;
+			explicit_huge_chunks += explicit_huge;
 			free_hpages++;
+			((BlkHeader *)ptr)->node = node;
 			AddChunk((BlkHeader *)ptr, HPAGE);
 		}
 	}
-	Panic("Out of memory");
-	return NULL;
 }
 
 int Heap::HugeFree(void *ptr)
@@ -163,6 +168,8 @@ int Heap::HugeFree(void *ptr)
 					huge_pages->next = p;
 					p = huge_pages;
 				}
+				else
+					explicit_huge_chunks -= huge_pages->explicit_huge;
 				huge_pages = n;
 			}
 			huge_pages = p;
@@ -182,4 +189,4 @@ bool Heap::HugeTryRealloc(void *ptr, size_t count)
 
 #endif
 
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -381,6 +381,8 @@ Value ArrayCtrl::Get0(int i, int ii) const {
 		if(ii < v.GetCount())
 			return v[ii];
 	}
+	if(source)
+		return GetSource(i, ii);
 	return Null;
 }
 
@@ -514,7 +516,11 @@ void ArrayCtrl::Set0(int i, int ii, const Value& v) {
 		Set(ii, v);
 	else
 		SetCtrlValue(i, ii, v);
-	array.At(i).line.At(ii) = v;
+	Vector<Value>& line = array.At(i).line;
+	if(source)
+		while(line.GetCount() < ii) // stored values hide values of source
+			line.Add(GetSource(i, line.GetCount()));
+	line.At(ii) = v;
 }
 
 void  ArrayCtrl::Set(int i, const Vector<Value>& v) {
@@ -644,6 +650,232 @@ void ArrayCtrl::SetVirtualCount(int c) {
 		GoEnd();
 }
 
+void ArrayCtrl::Source::Fetch(int ii, const int *row, int count, Value *out) const
+{ // runs of consecutive rows are fetched together
+	for(int i = 0; i < count;) {
+		int n = 1;
+		while(i + n < count && row[i + n] == row[i] + n)
+			n++;
+		Fetch(ii, row[i], n, out + i);
+		i += n;
+	}
+}
+
+Value ArrayCtrl::GetSource(int i, int ii) const
+{
+	LTIMING("GetSource");
+	int count = source_ordered ? source_row.GetCount() : source->GetCount();
+	if(i < 0 || i >= count)
+		return Null;
+	int page = i / SOURCE_PAGE;
+	int q = FindMatch(source_page, [&](const SourcePage& p) { return p.page == page; });
+	if(q > 0)
+		source_page.Insert(0, source_page.Detach(q));
+	if(q < 0) {
+		if(source_page.GetCount() >= SOURCE_PAGES)
+			source_page.Drop();
+		SourcePage& p = source_page.Insert(0);
+		p.page = page;
+		int from = page * SOURCE_PAGE;
+		int n = min((int)SOURCE_PAGE, count - from);
+		p.index.SetCount(idx.GetCount());
+		for(int j = 0; j < p.index.GetCount(); j++) {
+			Vector<Value>& v = p.index[j];
+			v.SetCount(n);
+			if(source_ordered)
+				source->Fetch(j, source_row.begin() + from, n, v.begin());
+			else
+				source->Fetch(j, from, n, v.begin());
+		}
+	}
+	const Vector< Vector<Value> >& index = source_page[0].index;
+	return ii < index.GetCount() ? index[ii][i - page * SOURCE_PAGE] : Value();
+}
+
+static Vector<int> sSourceOrder(const ArrayCtrl::Source *src, int indexes,
+                                Function<bool (const Vector<Value>& row)> filter,
+                                int ii, Function<bool (const Value& a, const Value& b)> less)
+{ // runs in CoWork, returns rows of source that pass filter in sorted order
+	const int CHUNK = 4096;
+	int count = src->GetCount();
+	Vector<int> row;
+	Vector<Value> key;
+	if(filter) {
+		Vector< Vector<Value> > chunk;
+		chunk.SetCount(indexes);
+		Vector<Value> line;
+		line.SetCount(indexes);
+		for(int i = 0; i < count; i += CHUNK) {
+			if(CoWork::IsCanceled())
+				return Vector<int>();
+			int n = min(CHUNK, count - i);
+			for(int j = 0; j < indexes; j++) {
+				chunk[j].SetCount(n);
+				src->Fetch(j, i, n, chunk[j].begin());
+			}
+			for(int q = 0; q < n; q++) {
+				for(int j = 0; j < indexes; j++)
+					line[j] = chunk[j][q];
+				if(filter(line)) {
+					row.Add(i + q);
+					if(ii >= 0)
+						key.Add(ii < indexes ? line[ii] : Value());
+				}
+			}
+		}
+	}
+	else {
+		row.SetCount(count);
+		for(int i = 0; i < count; i++)
+			row[i] = i;
+		if(ii >= 0) {
+			key.SetCount(count);
+			for(int i = 0; i < count; i += CHUNK) {
+				if(CoWork::IsCanceled())
+					return Vector<int>();
+				src->Fetch(ii, i, min(CHUNK, count - i), key.begin() + i);
+			}
+		}
+	}
+	if(ii >= 0) {
+		Vector<int> h;
+		h.SetCount(row.GetCount());
+		for(int i = 0; i < h.GetCount(); i++)
+			h[i] = i;
+		CoStableSort(h, [&](int a, int b) { return less(key[a], key[b]); });
+		if(CoWork::IsCanceled())
+			return Vector<int>();
+		Vector<int> r;
+		r.SetCount(h.GetCount());
+		for(int i = 0; i < h.GetCount(); i++)
+			r[i] = row[h[i]];
+		row = pick(r);
+	}
+	return row;
+}
+
+void ArrayCtrl::SyncSource()
+{ // filtering and sorting runs in background, current lines are displayed meanwhile
+	const Source *src = source;
+	int indexes = idx.GetCount();
+	auto filter = source_filter;
+	auto less = source_less;
+	int ii = source_sort_ii;
+	source_work.Cancel();
+	source_work = Async([=] {
+		SourceOrder o;
+		o.row = sSourceOrder(src, indexes, filter, ii, less);
+		if(!CoWork::IsCanceled()) {
+			o.pos.SetCount(src->GetCount(), -1);
+			for(int i = 0; i < o.row.GetCount(); i++)
+				o.pos[o.row[i]] = i;
+		}
+		return o;
+	});
+	source_working = true;
+	source_done.KillSet(10, THISBACK(SourceDone));
+}
+
+void ArrayCtrl::SourceDone()
+{
+	if(!source_work.IsFinished()) {
+		source_done.KillSet(10, THISBACK(SourceDone));
+		return;
+	}
+	source_working = false;
+	SetSourceOrder(source_work.Pick(), true);
+}
+
+void ArrayCtrl::SetSourceOrder(SourceOrder&& o, bool ordered)
+{ // lines changed by Set are moved with their source row
+	int row = IsCursor() ? GetSourceRow(cursor) : -1;
+	KillCursor();
+	ClearSelection();
+	int n = min(array.GetCount(), source_ordered ? source_row.GetCount() : virtualcount);
+	for(int i = 0; i < n; i++) {
+		Line& l = array[i];
+		if(l.line.GetCount() || !l.enabled || !l.visible || l.heading || !IsNull(l.paper))
+			source_line.GetAdd(GetSourceRow(i)) = pick(l);
+	}
+	source_row = pick(o.row);
+	source_pos = pick(o.pos);
+	source_ordered = ordered;
+	array.Clear();
+	cellinfo.Clear();
+	ln.Clear();
+	source_page.Clear();
+	ClearCache();
+	int count = ordered ? source_row.GetCount() : source->GetCount();
+	Vector<int> restored;
+	for(int q = 0; q < source_line.GetCount(); q++) {
+		int r = source_line.GetKey(q);
+		int i = !ordered ? r : r < source_pos.GetCount() ? source_pos[r] : -1;
+		if(i >= 0 && i < count) {
+			array.At(i) = pick(source_line[q]);
+			restored.Add(q);
+		}
+	}
+	source_line.Remove(restored);
+	SetVirtualCount(count);
+	if(row >= 0) {
+		int i = FindSourceRow(row);
+		if(i >= 0 && i < count)
+			SetCursor(i);
+	}
+	WhenSourceReady();
+}
+
+void ArrayCtrl::SetSource(const Source& src)
+{
+	Clear();
+	source = &src;
+	RefreshSource();
+}
+
+void ArrayCtrl::RefreshSource()
+{
+	if(!source)
+		return;
+	source_page.Clear();
+	ClearCache();
+	if(source_filter || source_sort_ii >= 0)
+		SyncSource();
+	else {
+		source_work.Cancel();
+		source_done.Kill();
+		source_working = false;
+		SetSourceOrder(SourceOrder(), false);
+	}
+	Refresh();
+}
+
+void ArrayCtrl::FilterSource(Function<bool (const Vector<Value>& row)> filter)
+{
+	source_filter = pick(filter);
+	RefreshSource();
+}
+
+void ArrayCtrl::SortSource(int ii, Function<bool (const Value& a, const Value& b)> less)
+{
+	source_sort_ii = ii;
+	source_less = pick(less);
+	RefreshSource();
+}
+
+void ArrayCtrl::NoSortSource()
+{
+	source_sort_ii = -1;
+	source_less.Clear();
+	RefreshSource();
+}
+
+int ArrayCtrl::FindSourceRow(int row) const
+{
+	if(source_ordered)
+		return row >= 0 && row < source_pos.GetCount() ? source_pos[row] : -1;
+	return row >= 0 && row < GetCount() ? row : -1;
+}
+
 void ArrayCtrl::SetSb() {
 	sb.SetTotal(GetTotalCy() + IsInserting() * (GetLineCy() + horzgrid));
 	sb.SetPage(GetSize().cy);
@@ -2698,7 +2930,10 @@ void ArrayCtrl::DoColumnSort()
 			cs.cmp = c.cmp;
 			if(!cs.order && !cs.cmp)
 				cs.cmp = StdValueCompare;
-			ColumnSort(sortcolumn, cs);
+			if(source && c.pos.GetCount()) // source is sorted in background by raw values
+				SortSource(Pos(c.pos[0]), [=](const Value& a, const Value& b) { return cs(a, b); });
+			else
+				ColumnSort(sortcolumn, cs);
 		}
 	}
 	WhenColumnSorted();
@@ -2769,6 +3004,19 @@ void ArrayCtrl::Clear() {
 	ClearCache();
 	DisableCtrls();
 	virtualcount = -1;
+	source = NULL;
+	source_work.Cancel();
+	source_work = AsyncWork<SourceOrder>(); // waits for canceled work
+	source_done.Kill();
+	source_working = false;
+	source_ordered = false;
+	source_row.Clear();
+	source_pos.Clear();
+	source_line.Clear();
+	source_page.Clear();
+	source_filter.Clear();
+	source_less.Clear();
+	source_sort_ii = -1;
 	anchor = -1;
 	SetSb();
 	Refresh();
@@ -3180,6 +3428,30 @@ ArrayCtrl::ArrayCtrl() {
 
 ArrayCtrl::~ArrayCtrl() {}
 
+int ArrayColumns::GetCount() const
+{ // all columns are supposed to have the same count
+	int n = column.GetCount() ? INT_MAX : 0;
+	for(const ColumnBase& c : column)
+		n = min(n, c.GetCount());
+	return n;
+}
+
+void ArrayColumns::Fetch(int ii, int row, int count, Value *out) const
+{
+	if(ii < column.GetCount())
+		column[ii].Get(row, count, out);
+	else
+		Fill(out, out + count, Value());
+}
+
+void ArrayColumns::Fetch(int ii, const int *row, int count, Value *out) const
+{
+	if(ii < column.GetCount())
+		column[ii].Get(row, count, out);
+	else
+		Fill(out, out + count, Value());
+}
+
 ArrayOption::ArrayOption()
 {
 	array = NULL;
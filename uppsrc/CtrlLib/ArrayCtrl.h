@@ -139,6 +139,15 @@ public:
 		virtual ~Order() {}
 	};
 
+	struct Source { // lines provided on demand instead of being stored in ArrayCtrl
+		virtual int  GetCount() const = 0;
+		// Fetch is also called by the background job of SortSource, FilterSource and column sorting,
+		// so it must be thread-safe, as must be the sort comparators and filters of ArrayCtrl with Source
+		virtual void Fetch(int ii, int row, int count, Value *out) const = 0;
+		virtual void Fetch(int ii, const int *row, int count, Value *out) const;
+		virtual ~Source() {}
+	};
+
 private:
 	struct ItemOrder;
 	struct RowOrder;
@@ -221,6 +230,31 @@ private:
 	int   anchor;
 	int   linecy;
 	int   virtualcount;
+
+	enum { SOURCE_PAGE = 256, SOURCE_PAGES = 32 };
+
+	struct SourcePage {
+		int                    page;
+		Vector< Vector<Value> > index;
+	};
+
+	struct SourceOrder : Moveable<SourceOrder> {
+		Vector<int> row; // rows of source in displayed order
+		Vector<int> pos; // line of each source row, -1 if filtered out
+	};
+
+	const Source              *source;
+	Vector<int>                source_row; // rows of source when filtered or sorted
+	Vector<int>                source_pos; // inverse of source_row
+	bool                       source_ordered;
+	VectorMap<int, Line>       source_line; // lines changed by Set that are filtered out, by source row
+	mutable Array<SourcePage>  source_page; // most recently used first
+	Function<bool (const Vector<Value>& row)>   source_filter;
+	Function<bool (const Value& a, const Value& b)> source_less;
+	int                        source_sort_ii;
+	bool                       source_working;
+	AsyncWork<SourceOrder>     source_work;
+	TimeCallback               source_done;
 	Point clickpos;
 	int   dropline, dropcol;
 	int   sortcolumn;
@@ -303,6 +337,7 @@ private:
 	void   ColEditSetData(int col);
 	void   CtrlSetData(int col);
 	Value  Get0(int i, int ii) const;
+	Value  GetSource(int i, int ii) const;
 	void   Set0(int i, int ii, const Value& v);
 	void   AfterSet(int i, bool sync_ctrls = true);
 
@@ -338,6 +373,9 @@ private:
 	void   SyncInfo();
 	void   SortA();
 	void   SortB(const Vector<int>& o);
+	void   SyncSource();
+	void   SourceDone();
+	void   SetSourceOrder(SourceOrder&& o, bool ordered);
 
 	void   SelectOne(int i, bool sel = true, bool raise = true);
 	
@@ -377,6 +415,7 @@ public:
 	Event<>           WhenScroll;
 	Event<>           WhenHeaderLayout;
 	Event<>           WhenColumnSorted;
+	Event<>           WhenSourceReady;
 
 	Event<int, bool&> WhenLineEnabled;
 	Event<int, bool&> WhenLineVisible;
@@ -442,6 +481,16 @@ public:
 	void       SetVirtualCount(int c);
 	int        GetCount() const;
 	void       Clear();
+
+	void       SetSource(const Source& src);
+	const Source *GetSource() const               { return source; }
+	void       RefreshSource();
+	void       FilterSource(Function<bool (const Vector<Value>& row)> filter); // filter runs in background thread
+	void       SortSource(int ii, Function<bool (const Value& a, const Value& b)> less); // less runs in background thread
+	void       NoSortSource();
+	bool       IsSourceWorking() const             { return source_working; }
+	int        GetSourceRow(int i) const           { return source_ordered ? source_row[i] : i; }
+	int        FindSourceRow(int row) const;
 	void       Shrink();
 	Value      Get(int i, int ii) const;
 	Value      Get(int i, const Id& id) const;
@@ -737,6 +786,40 @@ public:
 	virtual ~ArrayCtrl();
 };
 
+class ArrayColumns : public ArrayCtrl::Source { // typed column buffers for ArrayCtrl::SetSource
+	struct ColumnBase {
+		virtual int  GetCount() const = 0;
+		virtual void Get(int row, int count, Value *out) const = 0;
+		virtual void Get(const int *row, int count, Value *out) const = 0;
+		virtual ~ColumnBase() {}
+	};
+
+	template <class T>
+	struct TypedColumn : ColumnBase {
+		Vector<T> data;
+
+		virtual int  GetCount() const                                { return data.GetCount(); }
+		virtual void Get(int row, int count, Value *out) const       { for(int i = 0; i < count; i++) out[i] = data[row + i]; }
+		virtual void Get(const int *row, int count, Value *out) const { for(int i = 0; i < count; i++) out[i] = data[row[i]]; }
+	};
+
+	Array<ColumnBase> column;
+
+public:
+	virtual int  GetCount() const;
+	virtual void Fetch(int ii, int row, int count, Value *out) const;
+	virtual void Fetch(int ii, const int *row, int count, Value *out) const;
+
+	template <class T>
+	Vector<T>&   Add()                       { TypedColumn<T> *c = new TypedColumn<T>; column.Add(c); return c->data; }
+	template <class T>
+	Vector<T>&   Get(int ii)                 { return dynamic_cast<TypedColumn<T>&>(column[ii]).data; }
+	template <class T>
+	const Vector<T>& Get(int ii) const       { return dynamic_cast<const TypedColumn<T>&>(column[ii]).data; }
+	int          GetColumnCount() const      { return column.GetCount(); }
+	void         Clear()                     { column.Clear(); }
+};
+
 class ArrayOption : public Display, public Pte<ArrayOption> {
 public:
 	typedef ArrayOption CLASSNAME;
@@ -171,7 +171,9 @@ int   TextCtrl::Load0(Stream& in, byte charset_, bool view) {
 		return 0;
 	}
 
-	int m = LoadLines(lin, INT_MAX, total, in, charset, max_line_len, max_total, truncated);
+	Vector<Ln> ls;
+	int m = LoadLines(ls, INT_MAX, total, in, charset, max_line_len, max_total, truncated);
+	lin.Set(pick(ls));
 
 	InsertLines(0, lin.GetCount());
 	Update();
@@ -432,6 +434,181 @@ void TextCtrl::SerializeViewMap(Stream& s)
 	}
 }
 
+int64 TextCtrl::Lines::Len(const Vector<Ln>& line, int from, int to)
+{
+	int64 len = to - from;
+	for(int i = from; i < to; i++)
+		len += line[i].len;
+	return len;
+}
+
+void TextCtrl::Lines::Sync() const
+{
+	int n = block.GetCount();
+	if(valid >= n && line0.GetCount() == n)
+		return;
+	line0.SetCount(n);
+	pos0.SetCount(n);
+	for(int b = valid; b < n; b++) {
+		line0[b] = b ? line0[b - 1] + block[b - 1].line.GetCount() : 0;
+		pos0[b] = b ? pos0[b - 1] + block[b - 1].len : 0;
+	}
+	valid = n;
+}
+
+int TextCtrl::Lines::FindBlock(int& i) const
+{
+	ASSERT(i >= 0 && i < count);
+	Sync();
+	int b = cache;
+	if(b >= block.GetCount() || i < line0[b] || i >= line0[b] + block[b].line.GetCount())
+		cache = b = FindUpperBound(line0, i) - 1;
+	i -= line0[b];
+	return b;
+}
+
+void TextCtrl::Lines::Split(int b)
+{
+	Vector<Ln> line = pick(block[b].line);
+	int n = line.GetCount();
+	int m = n / BLOCK;
+	block.InsertN(b + 1, m - 1);
+	for(int q = 0; q < m; q++) {
+		int from = int((int64)n * q / m);
+		int to = int((int64)n * (q + 1) / m);
+		Block& k = block[b + q];
+		k.line.SetCount(to - from);
+		for(int i = from; i < to; i++)
+			k.line[i - from] = pick(line[i]);
+		k.len = Len(k.line, 0, k.line.GetCount());
+	}
+	Invalidate(b);
+}
+
+void TextCtrl::Lines::Join(int b)
+{ // merges small block with its neighbour
+	if(b < 0 || b >= block.GetCount() || block[b].line.GetCount() >= BLOCK / 2)
+		return;
+	if(b > 0 && block[b - 1].line.GetCount() + block[b].line.GetCount() <= 2 * BLOCK)
+		b--;
+	else
+	if(b + 1 >= block.GetCount() || block[b].line.GetCount() + block[b + 1].line.GetCount() > 2 * BLOCK)
+		return;
+	Block& k = block[b];
+	k.len += block[b + 1].len;
+	k.line.AppendPick(pick(block[b + 1].line));
+	block.Remove(b + 1);
+	Invalidate(b + 1);
+}
+
+void TextCtrl::Lines::Set(int i, const String& text, int len)
+{
+	int b = FindBlock(i);
+	Ln& ln = block[b].line[i];
+	block[b].len += len - ln.len;
+	ln.text = text;
+	ln.len = len;
+	Invalidate(b + 1);
+}
+
+void TextCtrl::Lines::InsertN(int i, int n)
+{
+	ASSERT(i >= 0 && i <= count);
+	if(n <= 0)
+		return;
+	int b;
+	if(i == count) {
+		if(block.IsEmpty())
+			block.Add();
+		b = block.GetCount() - 1;
+		i = block[b].line.GetCount();
+	}
+	else
+		b = FindBlock(i);
+	Block& k = block[b];
+	k.line.InsertN(i, n);
+	k.len += n;
+	count += n;
+	Invalidate(b + 1);
+	if(k.line.GetCount() > 2 * BLOCK)
+		Split(b);
+}
+
+void TextCtrl::Lines::Remove(int i, int n)
+{
+	ASSERT(i >= 0 && n >= 0 && i + n <= count);
+	if(n <= 0)
+		return;
+	int b = FindBlock(i);
+	count -= n;
+	Block& k = block[b];
+	int q = min(n, k.line.GetCount() - i);
+	k.len -= Len(k.line, i, i + q);
+	k.line.Remove(i, q);
+	n -= q;
+	int e = b + 1;
+	while(n > 0 && block[e].line.GetCount() <= n) // whole blocks
+		n -= block[e++].line.GetCount();
+	block.Remove(b + 1, e - b - 1);
+	if(n > 0) {
+		Block& k = block[b + 1];
+		k.len -= Len(k.line, 0, n);
+		k.line.Remove(0, n);
+	}
+	if(block[b].line.IsEmpty())
+		block.Remove(b);
+	Invalidate(b);
+	Join(b + 1);
+	Join(b);
+}
+
+void TextCtrl::Lines::Set(Vector<Ln>&& line)
+{
+	Clear();
+	count = line.GetCount();
+	if(count) {
+		Block& k = block.Add();
+		k.line = pick(line);
+		k.len = Len(k.line, 0, count);
+		if(count > 2 * BLOCK)
+			Split(0);
+	}
+}
+
+void TextCtrl::Lines::Clear()
+{
+	block.Clear();
+	line0.Clear();
+	pos0.Clear();
+	valid = cache = count = 0;
+}
+
+int TextCtrl::Lines::FindLine(int64& pos) const
+{ // pos becomes position in the line, positions past the end are at the end of the last line
+	Sync();
+	int b = FindUpperBound(pos0, pos) - 1;
+	if(b < 0)
+		return 0;
+	pos -= pos0[b];
+	const Vector<Ln>& line = block[b].line;
+	for(int i = 0; i < line.GetCount(); i++) {
+		int n = line[i].len + 1;
+		if(pos < n)
+			return line0[b] + i;
+		pos -= n;
+	}
+	pos = line.Top().len;
+	return count - 1;
+}
+
+int64 TextCtrl::Lines::GetPos(int i) const
+{
+	int b = FindBlock(i);
+	const Vector<Ln>& line = block[b].line;
+	return i < line.GetCount() / 2 ? pos0[b] + Len(line, 0, i)
+	                               : pos0[b] + block[b].len - Len(line, i, line.GetCount());
+}
+
 const TextCtrl::Ln& TextCtrl::GetLn(int i) const
 {
 	if(view) {
@@ -614,81 +791,47 @@ String TextCtrl::GetEncodedLine(int i, byte charset) const
 
 int   TextCtrl::GetLinePos64(int64& pos) const {
 	GuiLock __;
-	if(pos < cpos && cpos - pos < pos && !view) {
-		int i = cline;
-		int64 ps = cpos;
-		for(;;) {
-			ps -= GetLineLength(--i) + 1;
-			if(ps <= pos) {
-				pos = pos - ps;
-				return i;
-			}
+	if(!view)
+		return lin.FindLine(pos);
+	int blk = 0;
+	for(;;) {
+		int n = total256[blk];
+		if(pos < n)
+			break;
+		pos -= n;
+		if(++blk >= total256.GetCount()) {
+			pos = GetLineLength(GetLineCount() - 1);
+			return GetLineCount() - 1;
 		}
 	}
-	else {
-		int i = 0;
-		if(view) {
-			GuiLock __;
-			int blk = 0;
-			for(;;) {
-				int n = total256[blk];
-				if(pos < n)
-					break;
-				pos -= n;
-				if(++blk >= total256.GetCount()) {
-					pos = GetLineLength(GetLineCount() - 1);
-					return GetLineCount() - 1;
-				}
-			}
-			i = blk << 8;
-		}
-		else
-		if(pos >= cpos) {
-			pos -= cpos;
-			i = cline;
-		}
-		for(;;) {
-			int n = GetLineLength(i) + 1;
-			if(pos < n) return i;
-			pos -= n;
-			i++;
-			if(i >= GetLineCount()) {
-				pos = GetLineLength(GetLineCount() - 1);
-				return GetLineCount() - 1;
-			}
+	int i = blk << 8;
+	for(;;) {
+		int n = GetLineLength(i) + 1;
+		if(pos < n) return i;
+		pos -= n;
+		i++;
+		if(i >= GetLineCount()) {
+			pos = GetLineLength(GetLineCount() - 1);
+			return GetLineCount() - 1;
 		}
 	}
-	return 0; // just silencing GCC warning, cannot get here
 }
 
 int64  TextCtrl::GetPos64(int ln, int lpos) const {
 	GuiLock __;
 	ln = minmax(ln, 0, GetLineCount() - 1);
-	int i;
-	int64 pos;
-	if(ln < cline && cline - ln < ln && !view) {
-		pos = cpos;
-		i = cline;
-		while(i > ln)
-			pos -= GetLineLength(--i) + 1;
-	}
-	else {
-		pos = 0;
-		i = 0;
-		if(view) {
-			for(int j = 0; j < ln >> 8; j++) {
-				pos += total256[j];
-				i += 256;
-			}
-		}
-		else
-		if(ln >= cline) {
-			pos = cpos;
-			i = cline;
+	int64 pos = 0;
+	if(view) {
+		int i = 0;
+		for(int j = 0; j < ln >> 8; j++) {
+			pos += total256[j];
+			i += 256;
 		}
 		while(i < ln)
 			pos += GetLineLength(i++) + 1;
 	}
+	else
+		pos = lin.GetPos(ln);
 	return pos + min(GetLineLength(ln), lpos);
 }
 
@@ -75,7 +75,45 @@ protected:
 		Ln()                             { len = 0; }
 	};
 
-	Vector<Ln>       lin;
+	class Lines { // lines stored in blocks, edits do not move the whole document
+		struct Block : Moveable<Block> {
+			Vector<Ln> line;
+			int64      len = 0; // characters, including line ends
+		};
+
+		enum { BLOCK = 512 }; // blocks have BLOCK / 2 .. 2 * BLOCK lines
+
+		Vector<Block>         block;
+		mutable Vector<int>   line0; // index of first line of block
+		mutable Vector<int64> pos0; // position of first character of block
+		mutable int           valid = 0; // line0 and pos0 are valid for blocks before this
+		mutable int           cache = 0; // last found block
+		int                   count = 0;
+
+		static int64 Len(const Vector<Ln>& line, int from, int to);
+
+		void Invalidate(int b)                    { valid = min(valid, b); }
+		void Sync() const;
+		int  FindBlock(int& i) const;
+		void Split(int b);
+		void Join(int b);
+
+	public:
+		int       GetCount() const                { return count; }
+		const Ln& operator[](int i) const         { int b = FindBlock(i); return block[b].line[i]; }
+
+		void      Set(int i, const String& text, int len);
+		void      InsertN(int i, int n);
+		void      Remove(int i, int n);
+		void      Add()                           { InsertN(count, 1); }
+		void      Set(Vector<Ln>&& line);
+		void      Clear();
+
+		int       FindLine(int64& pos) const;
+		int64     GetPos(int i) const;
+	};
+
+	Lines            lin;
 	int64            total;
 
 	int64            cpos;
@@ -137,7 +175,7 @@ protected:
 	                 int *view_line_count = NULL) const;
 	void   ViewLoading();
 
-	void   SetLine(int i, const String& txt, int len) { lin[i].text = txt; lin[i].len = len; }
+	void   SetLine(int i, const String& txt, int len) { lin.Set(i, txt, len); }
 	void   SetLine(int i, const WString& w)           { SetLine(i, ToUtf8(w), w.GetCount()); }
 	void   LineRemove(int i, int n)                   { lin.Remove(i, n); }
 	void   LineInsert(int i, int n)                   { lin.InsertN(i, n); }
@@ -10,14 +10,6 @@ namespace Upp {
 
 #define LTIMING(x)  // RTIMING(x)
 
-force_inline void Esc::Limit(int64 count)
-{
-	LTIMING("Limit");
-	if(count > op_limit)
-		ThrowError("out of operations limit");
-	op_limit -= count;
-}
-
 EscValue Esc::Get(const SRVal& val)
 {
 	LTIMING("Get");
@@ -149,28 +141,37 @@ void Esc::Assign(const SRVal& val, const EscValue& src)
 		*val.lval = src;
 }
 
-EscValue Esc::ExecuteLambda(const String& id, EscValue lambda, SRVal self, Vector<SRVal>& arg)
+EscValue Esc::ExecuteLambda(const String& id, EscValue lambda, SRVal self, SRVal *arg, int argc)
 {
 	LTIMING("ExecuteLambda");
 	if(!lambda.IsLambda())
 		ThrowError(Format("'%s' is not a lambda", id));
 	const EscLambda& l = lambda.GetLambda();
-	if(!l.varargs && arg.GetCount() > l.arg.GetCount()
-	   || arg.GetCount() < l.arg.GetCount() - l.def.GetCount())
+	if(!l.varargs && argc > l.arg.GetCount()
+	   || argc < l.arg.GetCount() - l.def.GetCount())
 		ThrowError("invalid number of arguments in call to '" + id + "'");
 	Esc sub(global, l.code, op_limit, l.filename, l.line);
 	sub.self = Get(self);
+	const EscCode *code = l.escape ? NULL : GetEscCode(l);
+	if(!sub.CanRun(code))
+		code = NULL;
+	if(code) {
+		sub.local.Alloc(code->nlocal);
+		sub.local_used.Alloc(code->nlocal, false);
+	}
 	for(int i = 0; i < l.arg.GetCount(); i++) {
-		sub.var.GetAdd(l.arg[i]) =
-			i < arg.GetCount() ? Get(arg[i])
-		                       : Evaluatexl(l.def[i - (l.arg.GetCount() - l.def.GetCount())], global, op_limit);
+		EscValue& v = code ? sub.local[i] : sub.var.GetAdd(l.arg[i]);
+		v = i < argc ? Get(arg[i])
+		             : Evaluatexl(l.def[i - (l.arg.GetCount() - l.def.GetCount())], global, op_limit);
+		if(code)
+			sub.local_used[i] = true;
 		Limit();
 	}
 	EscValue retval;
 	Array<EscValue> argvar;
 	if(l.escape) {
 		argvar = sub.var.PickValues();
-		for(int i = l.arg.GetCount(); i < arg.GetCount(); i++) {
+		for(int i = l.arg.GetCount(); i < argc; i++) {
 			argvar.Add(Get(arg[i]));
 		}
 		EscValue v = Get(self);
@@ -182,23 +183,34 @@ EscValue Esc::ExecuteLambda(const String& id, EscValue lambda, SRVal self, Vecto
 	}
 	else {
 		if(l.varargs) {
-			EscValue& argv = sub.var.GetAdd("argv");
+			EscValue& argv = code ? sub.local[code->argv] : sub.var.GetAdd("argv");
+			if(code)
+				sub.local_used[code->argv] = true;
 			argv.SetEmptyArray();
-			for(int i = l.arg.GetCount(); i < arg.GetCount(); i++)
+			for(int i = l.arg.GetCount(); i < argc; i++)
 				argv.ArrayAdd(Get(arg[i]));
 		}
-		sub.Run();
+		if(code)
+			sub.RunCode(*code, l.code);
+		else {
+			sub.Run();
+			argvar = sub.var.PickValues();
+		}
 		retval = sub.return_value;
-		argvar = sub.var.PickValues();
 	}
 	for(int i = 0; i < l.inout.GetCount(); i++)
-		if(l.inout[i] && i < arg.GetCount() && arg[i].lval)
-			Assign(arg[i], argvar[i]);
+		if(l.inout[i] && i < argc && arg[i].lval)
+			Assign(arg[i], code ? sub.local[i] : argvar[i]);
 	if(self.lval)
 		Assign(self, sub.self);
 	return retval;
 }
 
+EscValue Esc::ExecuteLambda(const String& id, EscValue lambda, SRVal self, Vector<SRVal>& arg)
+{
+	return ExecuteLambda(id, lambda, self, arg.begin(), arg.GetCount());
+}
+
 void Esc::Subscript(Esc::SRVal& r, Esc::SRVal _self, String id)
 {
 	LTIMING("Subscript");
@@ -1085,10 +1097,8 @@ void  Esc::DoStatement()
 					}
 					Assign(var, map.GetKey(i));
 				}
-				if(!no_break || !no_return || !no_continue) {
-					SkipStatement();
-					break;
-				}
+				if(!no_break || !no_return || !no_continue)
+					break; // statement is skipped below
 				DoStatement();
 				no_continue = true;
 				i++;
@@ -1217,8 +1227,13 @@ void  Esc::DoStatement()
 	}
 	else
 	if(Char('{')) {
-		while(!Char('}') && no_break && no_return && no_continue)
-			DoStatement();
+		while(!Char('}'))
+			if(no_break && no_return && no_continue)
+				DoStatement();
+			else {
+				SkipBlock(*this); // leave the parser after the block so that enclosing statement can continue
+				break;
+			}
 	}
 	else
 	if(!Char(';')) {
@@ -13,6 +13,7 @@ String EscTypeName(int sv_type);
 struct EscEscape;
 class  EscLambda;
 struct EscHandle;
+struct EscCode;
 struct Esc;
 
 class EscValue : Moveable<EscValue> {
@@ -167,10 +168,13 @@ class EscLambda {
 	void     Retain()        { AtomicInc(refcount); }
 	void     Release()       { if(AtomicDec(refcount) == 0) delete this; }
 
-	EscLambda()                 { refcount = 1; varargs = false; handle = NULL; }
-	~EscLambda()                { if(handle) handle->Release(); }
+	mutable std::atomic<EscCode *> compiled;
+
+	EscLambda()                 { refcount = 1; varargs = false; handle = NULL; compiled = NULL; }
+	~EscLambda();
 
 	friend class EscValue;
+	friend const EscCode *GetEscCode(const EscLambda& l);
 
 public:
 	Vector<String>        arg;
@@ -200,6 +204,42 @@ void     SkipBlock(CParser& p);
 EscValue ReadLambda(CParser& p, bool args = true, const char *alt_args = nullptr);
 EscValue ReadLambda(const char *s);
 
+struct EscCode { // lambda body compiled to the bytecode
+	struct Instr {
+		int op;
+		int a;
+		int b;
+		int c;
+	};
+
+	struct Pos {
+		int ptr;
+		int lineptr;
+		int line;
+	};
+
+	struct Region { // errors inside are prefixed with "id: ", as Esc::Term does
+		int begin;
+		int end;
+		int id;
+	};
+
+	Vector<Instr>    instr;
+	Vector<Pos>      pos;
+	Vector<EscValue> konst;
+	Vector<String>   name;
+	Vector<Region>   region;
+	int              nlocal = 0;
+	int              argv = -1;
+	int              maxdepth = 0;
+	int              maxstack = 0;
+	bool             ok = false;
+};
+
+const EscCode *GetEscCode(const EscLambda& l);
+void           UseEscCompiler(bool b = true);
+bool           IsEscCompiler();
+
 struct Esc : public CParser {
 	struct SRVal : Moveable<SRVal> {
 		EscValue *lval;
@@ -231,12 +271,22 @@ struct Esc : public CParser {
 	int      r_stack_level;
 	EscValue return_value;
 
+	const EscCode   *compiled;
+	const char      *compiled_text;
+	int              pc;
+	Buffer<EscValue> local;
+	Buffer<bool>     local_used;
+
 	static int stack_level;
 
-	void       Limit(int64 count = 1);
+	void       ThrowError(const char *s);
+	void       ThrowError()                  { ThrowError(""); }
+
+	void       Limit(int64 count = 1)  { if(count > op_limit) ThrowError("out of operations limit"); op_limit -= count; }
 	double     DoCompare(const EscValue& a, const EscValue& b, const char *op);
 	double     DoCompare(const SRVal& a, const char *op);
 	String     ReadName();
+	EscValue   ExecuteLambda(const String& id, EscValue lambda, SRVal self, SRVal *arg, int argc);
 	EscValue   ExecuteLambda(const String& id, EscValue lambda, SRVal self, Vector<SRVal>& arg);
 
 	void       Assign(EscValue& val, const Vector<SRVal::Subscript>& sbs, int si, const EscValue& src);
@@ -280,10 +330,13 @@ struct Esc : public CParser {
 
 	void  Run();
 
+	bool  CanRun(const EscCode *code) const { return code && stack_level - code->maxdepth > 0; }
+	void  RunCode(const EscCode& code, const char *text);
+
 	Esc(ArrayMap<String, EscValue>& global, const char *s, int64& oplimit,
 	    const String& fn, int line = 1)
 	: CParser(s, fn, line), global(global), op_limit(oplimit)
-	{ r_stack_level = stack_level;  skipexp = false; }
+	{ r_stack_level = stack_level;  skipexp = false; compiled = NULL; compiled_text = NULL; pc = 0; }
 	~Esc() { stack_level = r_stack_level; }
 };
 
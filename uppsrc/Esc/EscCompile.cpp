@@ -0,0 +1,1700 @@
+#include "Esc.h"
+
+namespace Upp {
+
+#define LLOG(x)     // LOG(x)
+#define LTIMING(x)  // RTIMING(x)
+
+// Lambda bodies are compiled to the code for simple stack machine. Compiler follows Esc
+// interpreter step by step, so that instructions are executed in the same order and with
+// the same source positions as interpreter would perform corresponding actions (this makes
+// error messages and op_limit accounting identical). Anything unusual makes compilation
+// fail and lambda is then interpreted.
+
+enum {
+	ESC_NOP, ESC_END, ESC_LIMIT, ESC_THROW,
+	ESC_PUSH, ESC_LOCAL, ESC_GLOBAL, ESC_MEMBER, ESC_SELF, ESC_CALLEE, ESC_NONE,
+	ESC_CHECKSELF, ESC_TOUCH, ESC_TOUCHGLOBAL, ESC_TOUCHCALLEE,
+	ESC_NEWMAP, ESC_MAPSET, ESC_NEWARRAY, ESC_ARRAYADD,
+	ESC_SUBSCRIPT, ESC_DOT, ESC_BANG, ESC_CALL,
+	ESC_POP, ESC_GET, ESC_GETCOPY,
+	ESC_PREINC, ESC_PREDEC, ESC_POSTINC, ESC_POSTDEC, ESC_NEG, ESC_PLUS, ESC_NOT, ESC_BNOT,
+	ESC_MUL, ESC_DIV, ESC_MOD, ESC_ADD, ESC_SUB, ESC_SHL, ESC_SHR,
+	ESC_GE, ESC_LE, ESC_GT, ESC_LT, ESC_EQ, ESC_NE, ESC_BAND, ESC_BXOR, ESC_BOR,
+	ESC_TOBOOL, ESC_BOOL, ESC_JT, ESC_JF, ESC_JFALSE, ESC_JMP,
+	ESC_ASSIGN, ESC_ADDASSIGN, ESC_SUBASSIGN, ESC_MULASSIGN, ESC_DIVASSIGN, ESC_MODASSIGN,
+	ESC_JEQ, ESC_FORIN, ESC_INC, ESC_SETFLAG, ESC_CLRFLAG, ESC_JFLAGS, ESC_RETURN,
+	ESC_DEFLOCAL, ESC_DEFMEMBER, ESC_DEFGLOBAL,
+};
+
+enum { ESC_BREAK = 1, ESC_CONTINUE = 2, ESC_RETURNED = 4, ESC_FLAGS = 7 };
+
+static bool sIsJump(int op)
+{
+	return findarg(op, ESC_JT, ESC_JF, ESC_JFALSE, ESC_JMP, ESC_JEQ, ESC_FORIN, ESC_JFLAGS) >= 0;
+}
+
+struct EscCompiler : CParser {
+	EscCode&            code;
+	const char         *text;
+	Index<String>       local;
+
+	enum { SKIP_STATEMENT, SKIP_BLOCK, SKIP_SWITCH };
+	Vector<EscValue>    konst;
+	Index<String>       name;
+	int                 sp = 0;
+	int                 depth = 0;
+	int                 loop = 0;
+	int                 skip = 0;
+
+	int  Emit(int op, int a = 0, int b = 0, int c = 0);
+	int  Label() const                       { return code.instr.GetCount(); }
+	void Patch(int i)                        { code.instr[i].a = Label(); }
+	void Op(int op, int pop = 0)             { if(!skip) { Emit(op); Pop(pop); } }
+	void Push(int n = 1)                     { sp += n; code.maxstack = max(code.maxstack, sp); }
+	void Pop(int n = 1)                      { sp -= n; ASSERT(sp >= 0); }
+	void Depth(int d)                        { code.maxdepth = max(code.maxdepth, d); }
+	int  Konst(const EscValue& v)            { konst.Add(v); return konst.GetCount() - 1; }
+	int  Name(const String& s)               { return name.FindAdd(s); }
+	void PushConst(const EscValue& v);
+
+	bool IsSubscript() const                 { return IsChar('[') || IsChar('.') || IsChar('('); }
+	void Subscript(String id);
+	void Subscript();
+	void Term();
+	void Unary();
+	void Mul();
+	void Add();
+	void Shift();
+	void Compare();
+	void Equal();
+	void BinAnd();
+	void BinXor();
+	void BinOr();
+	void And();
+	void Or();
+	void Cond();
+	void Assign();
+	void Exp();
+	void GetExp();
+
+	void SkipTerm();
+	void SkipExp();
+	int  SkipStatement();
+	void CheckSkip(const Pos& p, const char *end, int mode = SKIP_STATEMENT);
+
+	int  Statement();
+	int  SubStatement();
+	int  Switch();
+	void Run();
+
+	EscCompiler(EscCode& code, const EscLambda& l)
+	:	CParser(l.code, l.filename, l.line), code(code), text(l.code) {}
+};
+
+int EscCompiler::Emit(int op, int a, int b, int c)
+{
+	EscCode::Instr& m = code.instr.Add();
+	m.op = op;
+	m.a = a;
+	m.b = b;
+	m.c = c;
+	EscCode::Pos& p = code.pos.Add();
+	p.ptr = int(term - text);
+	p.lineptr = int(lineptr - text);
+	p.line = line;
+	return code.instr.GetCount() - 1;
+}
+
+void EscCompiler::PushConst(const EscValue& v)
+{
+	if(!skip) {
+		Emit(ESC_PUSH, Konst(v));
+		Push();
+	}
+}
+
+void EscCompiler::Subscript(String id)
+{
+	for(;;) {
+		if(Char('[')) {
+			int n = 0, slice = 0;
+			if(!IsChar(',') && !IsChar(':') && !IsChar(']')) {
+				GetExp();
+				n |= 1;
+			}
+			if(Char(','))
+				slice = 1;
+			else
+			if(Char(':'))
+				slice = 2;
+			if(slice && !IsChar(']')) {
+				GetExp();
+				n |= 2;
+			}
+			PassChar(']');
+			if(!skip) {
+				Emit(ESC_SUBSCRIPT, n, slice);
+				Pop((n & 1) + (n >> 1));
+			}
+		}
+		else
+		if(Char('.')) {
+			id = ReadId();
+			if(!skip)
+				Emit(ESC_DOT, Konst(id));
+		}
+		else
+		if(Char('(')) {
+			int argc = 0;
+			if(!Char(')'))
+				for(;;) {
+					Exp();
+					argc++;
+					if(Char(')')) break;
+					PassChar(',');
+				}
+			if(!IsChar2('!', '=') && Char('!')) {
+				Term();
+				if(skip) // Get returns 1 in skip mode
+					Emit(ESC_THROW, Name("l-value map or l-value void expected on the right side of !"));
+				else {
+					Emit(ESC_BANG, argc);
+					Pop();
+				}
+			}
+			if(!skip) {
+				Emit(ESC_CALL, argc, Name(id), depth);
+				Pop(argc);
+			}
+		}
+		else
+			return;
+	}
+}
+
+void EscCompiler::Subscript()
+{
+	if(IsSubscript()) {
+		if(!skip) {
+			Emit(ESC_NONE);
+			Push();
+		}
+		Subscript(String());
+		Op(ESC_POP, 1);
+	}
+}
+
+void EscCompiler::Term()
+{
+	if(Char2('0', 'x') || Char2('0', 'X')) {
+		PushConst((int64)ReadNumber64(16));
+		return;
+	}
+	if(Char2('0', 'b') || Char2('0', 'B')) {
+		PushConst((int64)ReadNumber64(2));
+		return;
+	}
+	if(IsChar2('0', '.')) {
+		PushConst(ReadDouble());
+		return;
+	}
+	if(Char('0')) {
+		PushConst(IsNumber() ? (int64)ReadNumber64(8) : (int64)0);
+		return;
+	}
+	if(IsNumber()) {
+		Pos p = GetPos();
+		EscValue v = ReadInt64();
+		if(Char('.')) {
+			SetPos(p);
+			v = ReadDouble();
+		}
+		PushConst(v);
+		return;
+	}
+	if(IsString()) {
+		PushConst(EscValue(ToUtf32(ReadString())));
+		return;
+	}
+	if(IsChar('\'')) {
+		WString s = ToUtf32(ReadString('\''));
+		if(s.GetLength() != 1)
+			ThrowError("invalid character literal");
+		PushConst((int64)s[0]);
+		return;
+	}
+	if(Char('@')) {
+		PushConst(ReadLambda(*this));
+		Subscript();
+		return;
+	}
+	if(Id("void")) {
+		PushConst(EscValue());
+		return;
+	}
+	if(Char('{')) {
+		Op(ESC_NEWMAP);
+		if(!skip)
+			Push();
+		if(!Char('}'))
+			for(;;) {
+				GetExp();
+				PassChar(':');
+				GetExp();
+				Op(ESC_MAPSET, 2);
+				if(Char('}'))
+					break;
+				PassChar(',');
+			}
+		Subscript();
+		return;
+	}
+	if(Char('[')) {
+		Op(ESC_NEWARRAY);
+		if(!skip)
+			Push();
+		if(!Char(']'))
+			for(;;) {
+				GetExp();
+				Op(ESC_ARRAYADD, 1);
+				if(Char(']'))
+					break;
+				PassChar(',');
+			}
+		Subscript();
+		return;
+	}
+	if(Char('(')) {
+		Exp();
+		PassChar(')');
+		Subscript();
+		return;
+	}
+
+	bool member = false;
+	bool global = false;
+	if(Char('.')) {
+		Emit(ESC_CHECKSELF, Name("member-access in non-member code"));
+		member = true;
+	}
+	else
+	if(Char(':'))
+		global = true;
+	if(!IsId())
+		ThrowError("invalid expression");
+	String id = ReadId();
+	bool chain = IsSubscript();
+	int n = 1 + chain;
+	if(id == "self") {
+		Emit(ESC_CHECKSELF, Name("self in non-member code"));
+		if(!skip)
+			Emit(ESC_SELF, chain);
+	}
+	else
+	if(!member && !global && IsChar('(')) // method, global lambda or local variable
+		Emit(skip ? ESC_TOUCHCALLEE : ESC_CALLEE, local.FindAdd(id), Name(id), Konst(id));
+	else
+	if(member) {
+		if(!skip)
+			Emit(ESC_MEMBER, Konst(id), chain);
+	}
+	else
+	if(global)
+		Emit(skip ? ESC_TOUCHGLOBAL : ESC_GLOBAL, Name(id), chain);
+	else
+		Emit(skip ? ESC_TOUCH : ESC_LOCAL, local.FindAdd(id), chain);
+	if(!skip)
+		Push(n);
+	if(chain) {
+		int begin = Label();
+		Subscript(id);
+		if(Label() > begin) {
+			EscCode::Region& r = code.region.Add();
+			r.begin = begin;
+			r.end = Label();
+			r.id = Name(id);
+		}
+		Op(ESC_POP, 1);
+	}
+}
+
+void EscCompiler::Unary()
+{
+	if(Char2('+', '+')) {
+		Unary();
+		Op(ESC_PREINC);
+	}
+	else
+	if(Char2('-', '-')) {
+		Unary();
+		Op(ESC_PREDEC);
+	}
+	else
+	if(Char('-')) {
+		Unary();
+		Op(ESC_NEG);
+	}
+	else
+	if(Char('+')) {
+		Unary();
+		Op(ESC_PLUS);
+	}
+	else
+	if(Char('!')) {
+		Unary();
+		Op(ESC_NOT);
+	}
+	else
+	if(Char('~')) {
+		Unary();
+		Op(ESC_BNOT);
+	}
+	else
+		Term();
+
+	if(Char2('+', '+'))
+		Op(ESC_POSTINC);
+	if(Char2('-', '-'))
+		Op(ESC_POSTDEC);
+}
+
+void EscCompiler::Mul()
+{
+	Unary();
+	for(;;)
+		if(!IsChar2('*', '=') && Char('*')) {
+			Op(ESC_GET); // left operand is read before right one is evaluated
+			Unary();
+			Op(ESC_MUL, 1);
+		}
+		else
+		if(!IsChar2('/', '=') && Char('/')) {
+			Unary();
+			Op(ESC_DIV, 1);
+		}
+		else
+		if(!IsChar2('%', '=') && Char('%')) {
+			Unary();
+			Op(ESC_MOD, 1);
+		}
+		else
+			return;
+}
+
+void EscCompiler::Add()
+{
+	Mul();
+	for(;;)
+		if(!IsChar2('+', '=') && Char('+')) {
+			Op(ESC_GETCOPY);
+			if(!skip)
+				Push();
+			Mul();
+			Op(ESC_ADD, 2);
+		}
+		else
+		if(!IsChar2('-', '=') && Char('-')) {
+			Mul();
+			Op(ESC_SUB, 1);
+		}
+		else
+			return;
+}
+
+void EscCompiler::Shift()
+{
+	Add();
+	for(;;)
+		if(Char2('<', '<')) {
+			Op(ESC_GETCOPY);
+			if(!skip)
+				Push();
+			Add();
+			Op(ESC_SHL, 2);
+		}
+		else
+		if(Char2('>', '>')) {
+			Add();
+			Op(ESC_SHR, 1);
+		}
+		else
+			return;
+}
+
+void EscCompiler::Compare()
+{
+	Shift();
+	for(;;) {
+		int op;
+		if(Char2('>', '='))
+			op = ESC_GE;
+		else
+		if(Char2('<', '='))
+			op = ESC_LE;
+		else
+		if(Char('>'))
+			op = ESC_GT;
+		else
+		if(Char('<'))
+			op = ESC_LT;
+		else
+			return;
+		Shift();
+		Op(op, 1);
+	}
+}
+
+void EscCompiler::Equal()
+{
+	Compare();
+	for(;;)
+		if(Char2('=', '=')) {
+			Compare();
+			Op(ESC_EQ, 1);
+		}
+		else
+		if(Char2('!', '=')) {
+			Compare();
+			Op(ESC_NE, 1);
+		}
+		else
+			return;
+}
+
+void EscCompiler::BinAnd()
+{
+	Equal();
+	while(!IsChar2('&', '&') && Char('&')) {
+		Equal();
+		Op(ESC_BAND, 1);
+	}
+}
+
+void EscCompiler::BinXor()
+{
+	BinAnd();
+	while(Char('^')) {
+		BinAnd();
+		Op(ESC_BXOR, 1);
+	}
+}
+
+void EscCompiler::BinOr()
+{
+	BinXor();
+	while(!IsChar2('|', '|') && Char('|')) {
+		BinXor();
+		Op(ESC_BOR, 1);
+	}
+}
+
+void EscCompiler::And()
+{
+	BinOr();
+	if(IsChar2('&', '&')) {
+		Op(ESC_TOBOOL);
+		if(skip) {
+			while(Char2('&', '&'))
+				BinOr();
+			return;
+		}
+		Vector<int> jump;
+		Array<Pos> operand;
+		while(Char2('&', '&')) {
+			jump.Add(Emit(ESC_JF));
+			operand.Add(GetPos());
+			BinOr();
+			Op(ESC_BOOL, 1);
+		}
+		Pos end = GetPos();
+		int j = Emit(ESC_JMP);
+		skip++;
+		for(int i = 0; i < jump.GetCount(); i++) { // once false, remaining operands are skipped
+			Patch(jump[i]);
+			SetPos(operand[i]);
+			BinOr();
+		}
+		skip--;
+		SetPos(end);
+		Patch(j);
+	}
+}
+
+void EscCompiler::Or()
+{
+	And();
+	if(IsChar2('|', '|')) {
+		Op(ESC_TOBOOL);
+		if(skip) {
+			while(Char2('|', '|'))
+				And();
+			return;
+		}
+		Vector<int> jump;
+		Array<Pos> operand;
+		while(Char2('|', '|')) {
+			jump.Add(Emit(ESC_JT));
+			operand.Add(GetPos());
+			And();
+			Op(ESC_BOOL, 1);
+		}
+		Pos end = GetPos();
+		int j = Emit(ESC_JMP);
+		skip++;
+		for(int i = 0; i < jump.GetCount(); i++) {
+			Patch(jump[i]);
+			SetPos(operand[i]);
+			And();
+		}
+		skip--;
+		SetPos(end);
+		Patch(j);
+	}
+}
+
+void EscCompiler::Cond()
+{
+	Or();
+	if(Char('?')) {
+		if(skip) {
+			Cond();
+			PassChar(':');
+			Cond();
+			return;
+		}
+		int jf = Emit(ESC_JFALSE);
+		Pop();
+		Pos t = GetPos();
+		Cond();
+		PassChar(':');
+		Pos f = GetPos();
+		skip++;
+		Cond();
+		skip--;
+		Pos end = GetPos();
+		int j = Emit(ESC_JMP);
+		Patch(jf);
+		Pop();
+		SetPos(t);
+		skip++;
+		Cond();
+		skip--;
+		PassChar(':');
+		Cond();
+		if(GetPtr() != end.ptr)
+			ThrowError("internal: conditional expression mismatch");
+		Patch(j);
+	}
+}
+
+void EscCompiler::Assign()
+{
+	Cond();
+	if(Char('=')) {
+		Assign();
+		Op(ESC_ASSIGN, 1);
+	}
+	else
+	if(Char2('+', '=')) {
+		Op(ESC_GETCOPY);
+		if(!skip)
+			Push();
+		Cond();
+		Op(ESC_ADDASSIGN, 2);
+	}
+	else
+	if(Char2('-', '=')) {
+		Cond();
+		Op(ESC_SUBASSIGN, 1);
+	}
+	else
+	if(Char2('*', '=')) {
+		Cond();
+		Op(ESC_MULASSIGN, 1);
+	}
+	else
+	if(Char2('/', '=')) {
+		Cond();
+		Op(ESC_DIVASSIGN, 1);
+	}
+	else
+	if(Char2('%', '=')) {
+		Cond();
+		Op(ESC_MODASSIGN, 1);
+	}
+}
+
+void EscCompiler::Exp()
+{
+	Spaces();
+	Depth(++depth); // interpreter checks stack_level here
+	Assign();
+	depth--;
+}
+
+void EscCompiler::GetExp()
+{
+	Exp();
+	Op(ESC_GET);
+}
+
+void EscCompiler::SkipTerm()
+{
+	if(IsEof())
+		ThrowError("unexpected end of file");
+	CParser::SkipTerm();
+	Spaces();
+}
+
+void EscCompiler::SkipExp()
+{
+	int level = 0;
+	for(;;) {
+		if(IsChar(';'))
+			return;
+		if(IsChar(')') && level == 0)
+			return;
+		if(Char(')'))
+			level--;
+		else
+		if(Char('('))
+			level++;
+		else
+			SkipTerm();
+		if(IsEof())
+			ThrowError("unexpected end of file");
+	}
+}
+
+int EscCompiler::SkipStatement()
+{ // same as Esc::SkipStatement, returns nesting level
+	int level = 0;
+	if(Id("if")) {
+		PassChar('(');
+		SkipExp();
+		PassChar(')');
+		level = SkipStatement();
+		if(Id("else"))
+			level = max(level, SkipStatement());
+	}
+	else
+	if(Id("for")) {
+		PassChar('(');
+		if(!IsChar(';'))
+			SkipExp();
+		PassChar(';');
+		if(!IsChar(';'))
+			SkipExp();
+		PassChar(';');
+		if(!IsChar(')'))
+			SkipExp();
+		PassChar(')');
+		level = SkipStatement();
+	}
+	else
+	if(Id("while") || Id("switch")) {
+		PassChar('(');
+		SkipExp();
+		PassChar(')');
+		level = SkipStatement();
+	}
+	else
+	if(Id("do")) {
+		SkipBlock(*this);
+		PassId("while");
+		PassChar('(');
+		SkipExp();
+		PassChar(')');
+		PassChar(';');
+	}
+	else
+	if(Char('{'))
+		SkipBlock(*this);
+	else {
+		SkipExp();
+		PassChar(';');
+	}
+	return level + 1;
+}
+
+void EscCompiler::CheckSkip(const Pos& p, const char *end, int mode)
+{ // code that interpreter can skip has to end at the same place when skipped
+	Pos pos = GetPos();
+	SetPos(p);
+	if(mode == SKIP_SWITCH) // rest of switch after break
+		while(!Char('}'))
+			Depth(SkipStatement());
+	else
+	if(mode == SKIP_BLOCK) { // rest of block after break
+		if(!Char('}'))
+			SkipBlock(*this);
+	}
+	else
+		Depth(SkipStatement());
+	if(GetPtr() != end)
+		ThrowError("statement skipping mismatch");
+	SetPos(pos);
+}
+
+int EscCompiler::SubStatement()
+{
+	Pos p = GetPos();
+	int flags = Statement();
+	CheckSkip(p, GetPtr());
+	return flags;
+}
+
+int EscCompiler::Switch()
+{
+	loop++;
+	PassChar('(');
+	GetExp();
+	PassChar(')');
+	PassChar('{');
+	Pos body = GetPos();
+	Vector<int> jump;
+	Vector<const char *> item;
+	int exit = -1;
+	for(;;) { // dispatch part, interpreter skips statements until matching case
+		item.Add(GetPtr());
+		if(Char('}')) {
+			exit = Emit(ESC_JMP);
+			break;
+		}
+		if(Id("case")) {
+			GetExp();
+			PassChar(':');
+			jump.Add(Emit(ESC_JEQ));
+			Pop();
+		}
+		else
+		if(Id("default")) {
+			PassChar(':');
+			jump.Add(Emit(ESC_JMP));
+			break;
+		}
+		else
+			Depth(SkipStatement());
+	}
+	SetPos(body);
+	Vector<int> jflags;
+	Array<Pos> residual;
+	int label = 0;
+	int flags = 0;
+	for(int i = 0;; i++) { // FinishSwitch, each iteration is optional label and one statement
+		if(i < item.GetCount() && item[i] != GetPtr())
+			ThrowError("switch statement mismatch");
+		if(Id("case")) {
+			Exp();
+			Op(ESC_POP, 1);
+			PassChar(':');
+		}
+		else
+		if(Id("default"))
+			PassChar(':');
+		else
+		if(Char('}'))
+			break;
+		else {
+			int f = Statement();
+			if(f) {
+				jflags.Add(Emit(ESC_JFLAGS, 0, ESC_FLAGS));
+				residual.Add(GetPos());
+			}
+			flags |= f;
+			continue;
+		}
+		int entry = label < jump.GetCount() ? jump[label++] : -1;
+		if(IsChar('}')) { // falling through the label executes '}' as statement, entering it ends switch
+			if(entry >= 0)
+				jflags.Add(entry);
+			Emit(ESC_LIMIT);
+			Depth(1);
+			Emit(ESC_THROW, Name("invalid expression"));
+		}
+		else
+		if(IsId("case") || IsId("default")) { // same for two labels, entering starts with the next label
+			Pos p = GetPos();
+			Emit(ESC_LIMIT);
+			bool c = Id("case");
+			if(!c)
+				Id("default");
+			Emit(ESC_THROW, Name(c ? "misplaced 'case'" : "misplaced 'default'"));
+			SetPos(p);
+			if(entry >= 0)
+				Patch(entry);
+		}
+		else
+		if(entry >= 0)
+			Patch(entry);
+	}
+	if(label < jump.GetCount())
+		ThrowError("switch statement mismatch");
+	for(const Pos& p : residual)
+		CheckSkip(p, GetPtr(), SKIP_SWITCH);
+	if(exit >= 0)
+		Patch(exit);
+	for(int j : jflags)
+		Patch(j);
+	Op(ESC_POP, 1);
+	loop--;
+	if(flags & ESC_BREAK)
+		Emit(ESC_CLRFLAG, ESC_BREAK);
+	return flags & ~ESC_BREAK;
+}
+
+int EscCompiler::Statement()
+{
+	Emit(ESC_LIMIT);
+	if(Id("if")) {
+		PassChar('(');
+		Exp();
+		int jf = Emit(ESC_JFALSE);
+		Pop();
+		PassChar(')');
+		int flags = SubStatement();
+		if(Id("else")) {
+			int j = Emit(ESC_JMP);
+			Patch(jf);
+			flags |= SubStatement();
+			Patch(j);
+		}
+		else
+			Patch(jf);
+		return flags;
+	}
+	if(Id("do")) {
+		loop++;
+		int top = Label();
+		int flags = Statement();
+		if(flags & ESC_CONTINUE)
+			Emit(ESC_CLRFLAG, ESC_CONTINUE);
+		PassId("while");
+		PassChar('(');
+		Exp();
+		int jf = Emit(ESC_JFALSE);
+		Pop();
+		PassChar(')');
+		int jflags = flags ? Emit(ESC_JFLAGS, 0, ESC_BREAK|ESC_RETURNED) : -1;
+		Emit(ESC_JMP, top);
+		Patch(jf);
+		if(jflags >= 0)
+			Patch(jflags);
+		PassChar(';');
+		if(flags & ESC_BREAK)
+			Emit(ESC_CLRFLAG, ESC_BREAK);
+		loop--;
+		return flags & ESC_RETURNED;
+	}
+	if(Id("while")) {
+		loop++;
+		int top = Label();
+		PassChar('(');
+		Exp();
+		int jf = Emit(ESC_JFALSE);
+		Pop();
+		PassChar(')');
+		int jflags = Emit(ESC_JFLAGS, 0, ESC_FLAGS);
+		int flags = SubStatement();
+		if(!flags)
+			code.instr[jflags].op = ESC_NOP;
+		if(flags & ESC_CONTINUE)
+			Emit(ESC_CLRFLAG, ESC_CONTINUE);
+		Emit(ESC_JMP, top);
+		Patch(jf);
+		Patch(jflags);
+		if(flags & ESC_BREAK)
+			Emit(ESC_CLRFLAG, ESC_BREAK);
+		loop--;
+		return flags & ESC_RETURNED;
+	}
+	if(Id("for")) {
+		loop++;
+		PassChar('(');
+		bool init = !IsChar(';');
+		if(init)
+			Exp();
+		int flags;
+		if(Id("in") || Char(':')) {
+			if(!init) {
+				Emit(ESC_NONE);
+				Push();
+			}
+			GetExp();
+			PassChar(')');
+			Emit(ESC_PUSH, Konst((int64)0));
+			Push();
+			int top = Emit(ESC_FORIN);
+			int jflags = Emit(ESC_JFLAGS, 0, ESC_FLAGS);
+			flags = SubStatement();
+			if(!flags)
+				code.instr[jflags].op = ESC_NOP;
+			if(flags & ESC_CONTINUE)
+				Emit(ESC_CLRFLAG, ESC_CONTINUE);
+			Emit(ESC_INC);
+			Emit(ESC_JMP, top);
+			Patch(top);
+			Patch(jflags);
+			for(int i = 0; i < 3; i++)
+				Op(ESC_POP, 1);
+		}
+		else {
+			if(init)
+				Op(ESC_POP, 1);
+			PassChar(';');
+			Pos cond;
+			if(!IsChar(';')) {
+				cond = GetPos();
+				SkipExp();
+			}
+			PassChar(';');
+			Pos after;
+			if(!IsChar(')')) {
+				after = GetPos();
+				SkipExp();
+			}
+			PassChar(')');
+			Pos stmt = GetPos();
+			int top = Label();
+			int jf = -1;
+			if(cond.ptr) {
+				SetPos(cond);
+				Exp();
+				jf = Emit(ESC_JFALSE);
+				Pop();
+				SetPos(stmt);
+			}
+			int jflags = Emit(ESC_JFLAGS, 0, ESC_FLAGS);
+			flags = SubStatement();
+			if(!flags)
+				code.instr[jflags].op = ESC_NOP;
+			if(flags & ESC_CONTINUE)
+				Emit(ESC_CLRFLAG, ESC_CONTINUE);
+			Pos end = GetPos();
+			if(after.ptr) {
+				SetPos(after);
+				Exp();
+				Op(ESC_POP, 1);
+				SetPos(end);
+			}
+			Emit(ESC_JMP, top);
+			if(jf >= 0)
+				Patch(jf);
+			Patch(jflags);
+		}
+		if(flags & ESC_BREAK)
+			Emit(ESC_CLRFLAG, ESC_BREAK);
+		loop--;
+		return flags & ESC_RETURNED;
+	}
+	if(Id("break")) {
+		if(!loop)
+			Emit(ESC_THROW, Name("misplaced 'break'"));
+		else
+			Emit(ESC_SETFLAG, ESC_BREAK);
+		PassChar(';');
+		return ESC_BREAK;
+	}
+	if(Id("continue")) {
+		if(!loop)
+			Emit(ESC_THROW, Name("misplaced 'continue'"));
+		else
+			Emit(ESC_SETFLAG, ESC_CONTINUE);
+		PassChar(';');
+		return ESC_CONTINUE;
+	}
+	if(IsId("case") || IsId("default") || IsId("else"))
+		ThrowError("misplaced keyword");
+	if(Id("return")) {
+		if(!Char(';')) {
+			Exp();
+			Emit(ESC_RETURN, 1);
+			Pop();
+			PassChar(';');
+		}
+		else
+			Emit(ESC_RETURN, 0);
+		return ESC_RETURNED;
+	}
+	if(Id("switch"))
+		return Switch();
+	if(Char('#')) {
+		int type = 0;
+		if(Char('.'))
+			type = 1;
+		else
+		if(Char(':'))
+			type = 2;
+		String id = ReadId();
+		int l = Konst(ReadLambda(*this));
+		if(type == 1)
+			Emit(ESC_DEFMEMBER, Konst(id), l);
+		else
+		if(type == 2)
+			Emit(ESC_DEFGLOBAL, Name(id), l);
+		else
+			Emit(ESC_DEFLOCAL, local.FindAdd(id), l);
+		return 0;
+	}
+	if(Char('{')) {
+		Vector<int> jflags;
+		Array<Pos> residual;
+		int flags = 0;
+		while(!Char('}')) {
+			int f = Statement();
+			if(f) {
+				jflags.Add(Emit(ESC_JFLAGS, 0, ESC_FLAGS));
+				residual.Add(GetPos());
+			}
+			flags |= f;
+		}
+		for(const Pos& p : residual)
+			CheckSkip(p, GetPtr(), SKIP_BLOCK);
+		for(int j : jflags)
+			Patch(j);
+		return flags;
+	}
+	if(!Char(';')) {
+		Exp();
+		Op(ESC_POP, 1);
+		PassChar(';');
+	}
+	return 0;
+}
+
+void EscCompiler::Run()
+{
+	Vector<int> jflags;
+	while(!IsEof())
+		if(Statement())
+			jflags.Add(Emit(ESC_JFLAGS, 0, ESC_FLAGS));
+	for(int j : jflags)
+		Patch(j);
+	Emit(ESC_END);
+}
+
+static void sRemoveNops(EscCode& code)
+{
+	Vector<int> map;
+	int n = 0;
+	for(const EscCode::Instr& m : code.instr) {
+		map.Add(n);
+		if(m.op != ESC_NOP)
+			n++;
+	}
+	map.Add(n);
+	if(n == code.instr.GetCount())
+		return;
+	int j = 0;
+	for(int i = 0; i < code.instr.GetCount(); i++) {
+		EscCode::Instr m = code.instr[i];
+		if(m.op != ESC_NOP) {
+			if(sIsJump(m.op))
+				m.a = map[m.a];
+			code.instr[j] = m;
+			code.pos[j++] = code.pos[i];
+		}
+	}
+	code.instr.Trim(j);
+	code.pos.Trim(j);
+	for(EscCode::Region& r : code.region) {
+		r.begin = map[r.begin];
+		r.end = map[r.end];
+	}
+}
+
+static bool sUseCompiler = true;
+
+void UseEscCompiler(bool b)
+{
+	sUseCompiler = b;
+}
+
+bool IsEscCompiler()
+{
+	return sUseCompiler;
+}
+
+static void sCompile(EscCode& code, const EscLambda& l)
+{
+	LTIMING("Compile");
+	if(l.code.Find(CParser::LINEINFO_ESC) >= 0) // source positions could not be restored
+		return;
+	try {
+		EscCompiler c(code, l);
+		for(const String& id : l.arg) {
+			if(c.local.Find(id) >= 0)
+				return;
+			c.local.Add(id);
+		}
+		if(l.varargs)
+			code.argv = c.local.FindAdd("argv");
+		c.Run();
+		code.nlocal = c.local.GetCount();
+		code.konst = pick(c.konst);
+		code.name = c.name.PickKeys();
+		sRemoveNops(code);
+		code.ok = true;
+	}
+	catch(CParser::Error e) {
+		LLOG("Esc compilation failed: " << e);
+	}
+}
+
+const EscCode *GetEscCode(const EscLambda& l)
+{
+	if(!sUseCompiler)
+		return NULL;
+	EscCode *code = l.compiled;
+	if(!code) {
+		code = new EscCode;
+		sCompile(*code, l);
+		EscCode *expected = NULL;
+		if(!l.compiled.compare_exchange_strong(expected, code)) {
+			delete code;
+			code = expected;
+		}
+	}
+	return code->ok ? code : NULL;
+}
+
+EscLambda::~EscLambda()
+{
+	if(handle)
+		handle->Release();
+	delete compiled.load();
+}
+
+void Esc::ThrowError(const char *s)
+{
+	if(compiled) { // restore the position so that the message is the same as from interpreter
+		const EscCode::Pos& p = compiled->pos[pc];
+		term = wspc = compiled_text + p.ptr;
+		lineptr = compiled_text + p.lineptr;
+		line = p.line;
+	}
+	CParser::ThrowError(s);
+}
+
+force_inline
+static void sPop(Esc::SRVal *sp)
+{
+	sp->lval = NULL;
+	sp->rval = EscValue();
+	if(sp->subscript.GetCount())
+		sp->subscript.Clear();
+}
+
+force_inline
+static void sSet(Esc::SRVal& r, const EscValue& v)
+{
+	r.lval = NULL;
+	r.rval = v;
+	if(r.subscript.GetCount())
+		r.subscript.Clear();
+}
+
+void Esc::RunCode(const EscCode& code, const char *text)
+{
+	LTIMING("RunCode");
+	compiled = &code;
+	compiled_text = text;
+	Buffer<SRVal> stack(code.maxstack + 1);
+	SRVal *sp = stack;
+	const EscCode::Instr *ip0 = code.instr.begin();
+	const EscCode::Instr *ip = ip0;
+	const EscValue *konst = code.konst.begin();
+	int flags = 0;
+
+	auto Pop = [&](int n) {
+		while(n--)
+			sPop(--sp);
+	};
+
+	try {
+		for(;;) {
+			pc = int(ip - ip0);
+			const EscCode::Instr& m = *ip++;
+			switch(m.op) {
+			case ESC_NOP:
+				break;
+			case ESC_END:
+				compiled = NULL;
+				return;
+			case ESC_LIMIT:
+				Limit();
+				break;
+			case ESC_THROW:
+				ThrowError(code.name[m.a]);
+				break;
+			case ESC_PUSH:
+				(sp++)->rval = konst[m.a];
+				break;
+			case ESC_LOCAL:
+				local_used[m.a] = true;
+				(sp++)->lval = &local[m.a];
+				sp += m.b;
+				break;
+			case ESC_GLOBAL:
+				(sp++)->lval = &global.GetPut(code.name[m.a]);
+				sp += m.b;
+				break;
+			case ESC_MEMBER:
+				sp->lval = &self;
+				sp->subscript.Add().i1 = konst[m.a];
+				sp++;
+				if(m.b)
+					(sp++)->lval = &self;
+				break;
+			case ESC_SELF:
+				(sp++)->rval = self;
+				if(m.a)
+					(sp++)->lval = &self;
+				break;
+			case ESC_CALLEE: {
+				SRVal& r = *sp++;
+				SRVal& s = *sp++;
+				if(local_used[m.a])
+					r.lval = &local[m.a];
+				else {
+					EscValue method;
+					int ii;
+					if(self.IsMap() && (method = self.MapGet(konst[m.c])).IsLambda()) {
+						s.lval = &self;
+						r.rval = method;
+					}
+					else
+					if((ii = global.Find(code.name[m.b])) >= 0 && global[ii].IsLambda())
+						r.rval = global[ii];
+					else {
+						local_used[m.a] = true;
+						r.lval = &local[m.a];
+					}
+				}
+				break;
+			}
+			case ESC_NONE:
+				sp++;
+				break;
+			case ESC_CHECKSELF:
+				if(!self.IsMap())
+					ThrowError(code.name[m.a]);
+				break;
+			case ESC_TOUCH:
+				local_used[m.a] = true;
+				break;
+			case ESC_TOUCHGLOBAL:
+				global.GetPut(code.name[m.a]);
+				break;
+			case ESC_TOUCHCALLEE: {
+				int ii;
+				if(!local_used[m.a] &&
+				   !(self.IsMap() && self.MapGet(konst[m.c]).IsLambda()) &&
+				   !((ii = global.Find(code.name[m.b])) >= 0 && global[ii].IsLambda()))
+					local_used[m.a] = true;
+				break;
+			}
+			case ESC_NEWMAP:
+				(sp++)->rval.SetEmptyMap();
+				break;
+			case ESC_MAPSET:
+				sp[-3].rval.MapSet(sp[-2].rval, sp[-1].rval);
+				Pop(2);
+				break;
+			case ESC_NEWARRAY:
+				(sp++)->rval.SetEmptyArray();
+				break;
+			case ESC_ARRAYADD:
+				sp[-2].rval.ArrayAdd(sp[-1].rval);
+				Pop(1);
+				break;
+			case ESC_SUBSCRIPT: {
+				int n = (m.a & 1) + (m.a >> 1);
+				SRVal::Subscript& ss = sp[-2 - n].subscript.Add();
+				SRVal *s = sp - n;
+				if(m.a & 1)
+					ss.i1 = (s++)->rval;
+				if(m.a & 2)
+					ss.i2 = s->rval;
+				ss.slice = m.b;
+				Pop(n);
+				break;
+			}
+			case ESC_DOT:
+				sp[-1] = sp[-2];
+				sp[-2].subscript.Add().i1 = konst[m.a];
+				break;
+			case ESC_BANG: {
+				SRVal& s = sp[-m.a - 2];
+				s = sp[-1];
+				Pop(1);
+				EscValue g = Get(s);
+				if(!s.lval || (!g.IsVoid() && !g.IsMap()))
+					ThrowError("l-value map or l-value void expected on the right side of !");
+				if(g.IsVoid()) {
+					EscValue v;
+					v.SetEmptyMap();
+					Assign(s, v);
+				}
+				break;
+			}
+			case ESC_CALL: {
+				SRVal *arg = sp - m.a;
+				SRVal& r = arg[-2];
+				const String& id = code.name[m.b];
+				stack_level = r_stack_level - m.c;
+				try {
+					sSet(r, ExecuteLambda(id, Get(r), arg[-1], arg, m.a));
+				}
+				catch(Exc e) {
+					throw Error(Format("%s.%s(): %s", Get(r).GetTypeName(), id, e));
+				}
+				Pop(m.a);
+				break;
+			}
+			case ESC_POP:
+				sPop(--sp);
+				break;
+			case ESC_GET:
+				if(sp[-1].lval || sp[-1].subscript.GetCount())
+					sSet(sp[-1], Get(sp[-1]));
+				break;
+			case ESC_GETCOPY:
+				sp->rval = Get(sp[-1]);
+				sp++;
+				break;
+			case ESC_PREINC:
+			case ESC_PREDEC:
+			case ESC_POSTINC:
+			case ESC_POSTDEC: {
+				SRVal& r = sp[-1];
+				EscValue v = Get(r);
+				bool inc = findarg(m.op, ESC_PREINC, ESC_POSTINC) >= 0;
+				const char *op = inc ? "++" : "--";
+				int d = inc ? 1 : -1;
+				if(v.IsInt64())
+					Assign(r, Int(v, op) + d);
+				else
+					Assign(r, Number(v, op) + d);
+				if(m.op == ESC_POSTINC || m.op == ESC_POSTDEC)
+					sSet(r, v);
+				break;
+			}
+			case ESC_NEG: {
+				EscValue v = Get(sp[-1]);
+				if(v.IsInt64())
+					sSet(sp[-1], -Int(v, "-"));
+				else
+					sSet(sp[-1], -Number(v, "-"));
+				break;
+			}
+			case ESC_PLUS: {
+				EscValue v = Get(sp[-1]);
+				if(v.IsInt64())
+					sSet(sp[-1], Int(v, "+"));
+				else
+					sSet(sp[-1], Number(v, "+"));
+				break;
+			}
+			case ESC_NOT:
+				sSet(sp[-1], (int64)!IsTrue(Get(sp[-1])));
+				break;
+			case ESC_BNOT:
+				sSet(sp[-1], ~Int(Get(sp[-1]), "~"));
+				break;
+			case ESC_MUL: {
+				EscValue x = sp[-2].rval;
+				EscValue y = Get(sp[-1]);
+				SRVal& r = sp[-2];
+				if(x.IsArray() && y.IsInt())
+					sSet(r, MulArray(x, y));
+				else
+				if(y.IsArray() && x.IsInt())
+					sSet(r, MulArray(y, x));
+				else
+				if(x.IsInt64() && y.IsInt64())
+					sSet(r, Int(x, "*") * Int(y, "*"));
+				else
+					sSet(r, Number(x, "*") * Number(y, "*"));
+				Pop(1);
+				break;
+			}
+			case ESC_DIV: {
+				EscValue x = Get(sp[-2]);
+				EscValue y = Get(sp[-1]);
+				double b = Number(y, "/");
+				if(b == 0)
+					ThrowError("divide by zero");
+				sSet(sp[-2], Number(x, "/") / b);
+				Pop(1);
+				break;
+			}
+			case ESC_MOD: {
+				int64 b = Int(sp[-1], "%");
+				if(b == 0)
+					ThrowError("divide by zero");
+				sSet(sp[-2], Int(sp[-2], "%") % b);
+				Pop(1);
+				break;
+			}
+			case ESC_ADD: {
+				SRVal& r = sp[-3];
+				EscValue& v = sp[-2].rval;
+				EscValue b = Get(sp[-1]);
+				if(v.IsArray() && b.IsArray()) {
+					Limit(b.GetCount());
+					v.Replace(v.GetCount(), 0, b);
+					sSet(r, v);
+				}
+				else
+				if(!(v.IsArray() && b.IsVoid())) {
+					if(v.IsInt64() && b.IsInt64())
+						sSet(r, Int(v, "+") + Int(b, "+"));
+					else
+						sSet(r, Number(v, "+") + Number(b, "+"));
+				}
+				Pop(2);
+				break;
+			}
+			case ESC_SUB: {
+				EscValue v = Get(sp[-2]);
+				EscValue b = Get(sp[-1]);
+				if(v.IsInt64() && b.IsInt64())
+					sSet(sp[-2], Int(v, "-") - Int(b, "-"));
+				else
+					sSet(sp[-2], Number(v, "-") - Number(b, "-"));
+				Pop(1);
+				break;
+			}
+			case ESC_SHL: {
+				SRVal& r = sp[-3];
+				EscValue& v = sp[-2].rval;
+				EscValue b = Get(sp[-1]);
+				if(v.IsArray() && b.IsArray()) {
+					Limit(b.GetCount());
+					v.Replace(v.GetCount(), 0, b);
+					Assign(r, v);
+				}
+				else
+				if(!(v.IsArray() && b.IsVoid()))
+					sSet(r, Int(v, "<<") << Int(b, "<<"));
+				Pop(2);
+				break;
+			}
+			case ESC_SHR:
+				sSet(sp[-2], Int(sp[-2], ">>") >> Int(sp[-1],  ">>"));
+				Pop(1);
+				break;
+			case ESC_GE:
+				sSet(sp[-2], (int64)(DoCompare(Get(sp[-2]), Get(sp[-1]), ">=") >= 0));
+				Pop(1);
+				break;
+			case ESC_LE:
+				sSet(sp[-2], (int64)(DoCompare(Get(sp[-2]), Get(sp[-1]), "<=") <= 0));
+				Pop(1);
+				break;
+			case ESC_GT:
+				sSet(sp[-2], (int64)(DoCompare(Get(sp[-2]), Get(sp[-1]), ">") > 0));
+				Pop(1);
+				break;
+			case ESC_LT:
+				sSet(sp[-2], (int64)(DoCompare(Get(sp[-2]), Get(sp[-1]), "<") < 0));
+				Pop(1);
+				break;
+			case ESC_EQ:
+				sSet(sp[-2], (int64)(Get(sp[-2]) == Get(sp[-1])));
+				Pop(1);
+				break;
+			case ESC_NE:
+				sSet(sp[-2], (int64)(Get(sp[-2]) != Get(sp[-1])));
+				Pop(1);
+				break;
+			case ESC_BAND:
+				sSet(sp[-2], Int(sp[-2], "&") & Int(sp[-1], "&"));
+				Pop(1);
+				break;
+			case ESC_BXOR:
+				sSet(sp[-2], Int(sp[-2], "^") ^ Int(sp[-1], "^"));
+				Pop(1);
+				break;
+			case ESC_BOR:
+				sSet(sp[-2], Int(sp[-2], "|") | Int(sp[-1], "|"));
+				Pop(1);
+				break;
+			case ESC_TOBOOL:
+				sSet(sp[-1], (int64)IsTrue(Get(sp[-1])));
+				break;
+			case ESC_BOOL:
+				sSet(sp[-2], (int64)IsTrue(Get(sp[-1])));
+				Pop(1);
+				break;
+			case ESC_JT:
+				if(IsTrue(sp[-1].rval))
+					ip = ip0 + m.a;
+				break;
+			case ESC_JF:
+				if(!IsTrue(sp[-1].rval))
+					ip = ip0 + m.a;
+				break;
+			case ESC_JFALSE: {
+				bool c = IsTrue(Get(sp[-1]));
+				sPop(--sp);
+				if(!c)
+					ip = ip0 + m.a;
+				break;
+			}
+			case ESC_JMP:
+				ip = ip0 + m.a;
+				break;
+			case ESC_ASSIGN:
+				Assign(sp[-2], Get(sp[-1]));
+				Pop(1);
+				break;
+			case ESC_ADDASSIGN: {
+				SRVal& r = sp[-3];
+				EscValue& v = sp[-2].rval;
+				EscValue b = Get(sp[-1]);
+				if(v.IsArray() && b.IsArray()) {
+					Limit(b.GetCount());
+					v.Replace(v.GetCount(), 0, b);
+					Assign(r, v);
+				}
+				else
+				if(!(v.IsArray() && b.IsVoid())) {
+					if(v.IsInt64() && b.IsInt64())
+						Assign(r, Int(v, "+=") + Int(b, "+="));
+					else
+						Assign(r, Number(v, "+=") + Number(b, "+="));
+				}
+				Pop(2);
+				break;
+			}
+			case ESC_SUBASSIGN: {
+				EscValue v = Get(sp[-2]);
+				EscValue b = Get(sp[-1]);
+				if(v.IsInt64() && b.IsInt64())
+					Assign(sp[-2], Int(v, "-=") - Int(b, "-="));
+				else
+					Assign(sp[-2], Number(v, "-=") - Number(b, "-="));
+				Pop(1);
+				break;
+			}
+			case ESC_MULASSIGN: {
+				EscValue x = Get(sp[-2]);
+				EscValue y = Get(sp[-1]);
+				if(x.IsInt64() && y.IsInt64())
+					Assign(sp[-2], Int(x, "*=") * Int(y, "*="));
+				else
+					Assign(sp[-2], Number(x, "*=") * Number(y, "*="));
+				Pop(1);
+				break;
+			}
+			case ESC_DIVASSIGN: {
+				EscValue v = Get(sp[-2]);
+				EscValue b = Get(sp[-1]);
+				double q = Number(v, "/=");
+				if(q == 0)
+					ThrowError("divide by zero");
+				Assign(sp[-2], Number(b, "/=") / q);
+				Pop(1);
+				break;
+			}
+			case ESC_MODASSIGN: {
+				int64 a = Int(sp[-2], "%=");
+				int64 b = Int(sp[-1], "%=");
+				if(b == 0)
+					ThrowError("divide by zero");
+				Assign(sp[-2], a % b);
+				Pop(1);
+				break;
+			}
+			case ESC_JEQ: {
+				bool eq = sp[-2].rval == sp[-1].rval;
+				sPop(--sp);
+				if(eq)
+					ip = ip0 + m.a;
+				break;
+			}
+			case ESC_FORIN: {
+				const EscValue& range = sp[-2].rval;
+				int i = (int)sp[-1].rval.GetInt64();
+				if(range.IsArray()) {
+					if(i >= range.GetCount()) {
+						ip = ip0 + m.a;
+						break;
+					}
+					Assign(sp[-3], (int64)i);
+				}
+				else
+				if(range.IsMap()) {
+					const VectorMap<EscValue, EscValue>& map = range.GetMap();
+					while(i < map.GetCount() && map.IsUnlinked(i))
+						i++;
+					sp[-1].rval = (int64)i;
+					if(i >= map.GetCount()) {
+						ip = ip0 + m.a;
+						break;
+					}
+					Assign(sp[-3], map.GetKey(i));
+				}
+				break;
+			}
+			case ESC_INC:
+				sp[-1].rval = sp[-1].rval.GetInt64() + 1;
+				break;
+			case ESC_SETFLAG:
+				flags |= m.a;
+				break;
+			case ESC_CLRFLAG:
+				flags &= ~m.a;
+				break;
+			case ESC_JFLAGS:
+				if(flags & m.b)
+					ip = ip0 + m.a;
+				break;
+			case ESC_RETURN:
+				if(m.a) {
+					return_value = Get(sp[-1]);
+					sPop(--sp);
+				}
+				else
+					return_value = EscValue();
+				flags |= ESC_RETURNED;
+				break;
+			case ESC_DEFLOCAL:
+				local[m.a] = konst[m.b];
+				local_used[m.a] = true;
+				break;
+			case ESC_DEFMEMBER:
+				if(self.IsVoid())
+					ThrowError("no instance");
+				self.MapSet(konst[m.a], konst[m.b]);
+				break;
+			case ESC_DEFGLOBAL:
+				global.GetAdd(code.name[m.a]) = konst[m.b];
+				break;
+			default:
+				NEVER();
+			}
+		}
+	}
+	catch(CParser::Error e) {
+		String err = e;
+		int len = 0;
+		for(;;) { // apply Term error prefixes from the innermost one
+			const EscCode::Region *q = NULL;
+			for(const EscCode::Region& r : code.region)
+				if(pc >= r.begin && pc < r.end && r.end - r.begin > len && (!q || r.end - r.begin < q->end - q->begin))
+					q = &r;
+			if(!q)
+				break;
+			err = code.name[q->id] + ": " + err;
+			len = q->end - q->begin;
+		}
+		compiled = NULL;
+		throw CParser::Error(err);
+	}
+}
+
+}
@@ -189,9 +189,21 @@ EscValue Execute(ArrayMap<String, EscValue>& global, EscValue *self,
 		Esc sub(global, l.code, op_limit, l.filename, l.line);
 		if(self)
 			sub.self = *self;
-		for(int i = 0; i < l.arg.GetCount(); i++)
-			sub.var.GetPut(l.arg[i]) = arg[i];
-		sub.Run();
+		const EscCode *code = l.escape ? NULL : GetEscCode(l);
+		if(sub.CanRun(code)) {
+			sub.local.Alloc(code->nlocal);
+			sub.local_used.Alloc(code->nlocal, false);
+			for(int i = 0; i < l.arg.GetCount(); i++) {
+				sub.local[i] = arg[i];
+				sub.local_used[i] = true;
+			}
+			sub.RunCode(*code, l.code);
+		}
+		else {
+			for(int i = 0; i < l.arg.GetCount(); i++)
+				sub.var.GetPut(l.arg[i]) = arg[i];
+			sub.Run();
+		}
 		if(self)
 			*self = sub.self;
 		ret = sub.return_value;
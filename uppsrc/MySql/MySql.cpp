@@ -29,9 +29,11 @@ private:
 	int            rows;
 	int            lastid;
 	Buffer<bool>   convert;
+	bool           streaming = false; // result rows are read from server by mysql_fetch_row
 
 	String         MakeQuery() const;
 	void           FreeResult();
+	void           SkipResults();
 	String         EscapeString(const String& v);
 	bool           MysqlQuery(const char *query);
 
@@ -201,6 +203,140 @@ int MySqlSession::GetTransactionLevel() const
 	return level;
 }
 
+struct MySqlBulkParam {
+	union {
+		int        i;
+		int64      i64;
+		double     d;
+		MYSQL_TIME tm;
+	};
+	String s;
+};
+
+static void sBindParam(MYSQL_BIND& b, MySqlBulkParam& p, const Value& v)
+{
+	memset(&b, 0, sizeof(b));
+	if(IsNull(v)) {
+		b.buffer_type = MYSQL_TYPE_NULL;
+		return;
+	}
+	switch(v.GetType()) {
+	case SQLRAW_V:
+		p.s = SqlRaw(v);
+		b.buffer_type = MYSQL_TYPE_BLOB;
+		b.buffer = (void *)~p.s;
+		b.buffer_length = p.s.GetLength();
+		break;
+	case WSTRING_V:
+	case STRING_V:
+		p.s = ToCharset(CHARSET_UTF8, v);
+		b.buffer_type = MYSQL_TYPE_STRING;
+		b.buffer = (void *)~p.s;
+		b.buffer_length = p.s.GetLength();
+		break;
+	case BOOL_V:
+	case INT_V:
+		p.i = v;
+		b.buffer_type = MYSQL_TYPE_LONG;
+		b.buffer = &p.i;
+		break;
+	case INT64_V:
+		p.i64 = v;
+		b.buffer_type = MYSQL_TYPE_LONGLONG;
+		b.buffer = &p.i64;
+		break;
+	case DOUBLE_V:
+		p.d = v;
+		b.buffer_type = MYSQL_TYPE_DOUBLE;
+		b.buffer = &p.d;
+		break;
+	case DATE_V: {
+			Date d = v;
+			memset(&p.tm, 0, sizeof(p.tm));
+			p.tm.year = d.year;
+			p.tm.month = d.month;
+			p.tm.day = d.day;
+			p.tm.time_type = MYSQL_TIMESTAMP_DATE;
+			b.buffer_type = MYSQL_TYPE_DATE;
+			b.buffer = &p.tm;
+		}
+		break;
+	case TIME_V: {
+			Time t = v;
+			memset(&p.tm, 0, sizeof(p.tm));
+			p.tm.year = t.year;
+			p.tm.month = t.month;
+			p.tm.day = t.day;
+			p.tm.hour = t.hour;
+			p.tm.minute = t.minute;
+			p.tm.second = t.second;
+			p.tm.time_type = MYSQL_TIMESTAMP_DATETIME;
+			b.buffer_type = MYSQL_TYPE_DATETIME;
+			b.buffer = &p.tm;
+		}
+		break;
+	default:
+		NEVER();
+	}
+}
+
+int MySqlSession::GetBulkInsertRows(int columns) const
+{
+	return max(1000000 / max(columns, 1), 1);
+}
+
+bool MySqlSession::BulkInsert(const String& table, const Vector<String>& column,
+                              const Vector< Vector<Value> >& data)
+{ // multi-row prepared insert, the statement is prepared once and reused for all full chunks
+	if(data.GetCount() == 0 || data[0].GetCount() == 0)
+		return true;
+	int rows = data[0].GetCount();
+	int ncol = column.GetCount();
+	int chunk = clamp(65535 / ncol, 1, 1000); // 65535 is the limit of placeholders per statement
+	Buffer<MYSQL_BIND> bind(chunk * ncol);
+	Buffer<MySqlBulkParam> param(chunk * ncol);
+	MYSQL_STMT *stmt = NULL;
+	String statement;
+	int prepared = 0;
+	bool ok = true;
+	for(int r0 = 0; ok && r0 < rows; r0 += chunk) {
+		int n = min(chunk, rows - r0);
+		if(n != prepared) {
+			if(stmt)
+				mysql_stmt_close(stmt);
+			statement.Clear();
+			statement << "insert into " << table << '(' << Join(column, ", ") << ") values ";
+			for(int r = 0; r < n; r++) {
+				statement << (r ? ", (" : "(");
+				for(int i = 0; i < ncol; i++)
+					statement << (i ? ", ?" : "?");
+				statement << ')';
+			}
+			if(trace)
+				*trace << "insert into " << table << " -- " << n << " rows prepared\n";
+			prepared = n;
+			stmt = mysql_stmt_init(mysql);
+			ok = stmt && !mysql_stmt_prepare(stmt, statement, statement.GetLength());
+			if(!ok)
+				break;
+		}
+		int k = 0;
+		for(int r = r0; r < r0 + n; r++)
+			for(int i = 0; i < ncol; i++, k++)
+				sBindParam(bind[k], param[k], data[i][r]);
+		ok = !mysql_stmt_bind_param(stmt, bind) && !mysql_stmt_execute(stmt);
+	}
+	if(!ok) {
+		if(stmt)
+			SetError(mysql_stmt_error(stmt), statement, mysql_stmt_errno(stmt));
+		else
+			SetError(mysql_error(mysql), statement, mysql_errno(mysql));
+	}
+	if(stmt)
+		mysql_stmt_close(stmt);
+	return ok;
+}
+
 static Vector<String> FetchList(Sql& cursor, bool upper = false)
 {
 	Vector<String> out;
@@ -315,12 +451,16 @@ bool MySqlConnection::Execute() {
 	Cancel();
 	if(!MysqlQuery(query))
 		return false;
-	result = mysql_store_result(mysql);
-	rows = (int)mysql_affected_rows(mysql);
-
-	while(mysql_more_results (mysql)) { // Only first resultset is considered, rest is ignored
-		mysql_next_result (mysql);      // This is required to avoid synchronization error on CALL
+	if(IsStreamingFetch()) {
+		result = mysql_use_result(mysql);
+		streaming = result != NULL;
 	}
+	else
+		result = mysql_store_result(mysql);
+	rows = streaming ? 0 : (int)mysql_affected_rows(mysql); // with mysql_use_result, rows are counted by Fetch
+
+	if(!streaming) // unread rows would block mysql_next_result
+		SkipResults();
 
 	if(result) {
 		int fields = mysql_num_fields(result);
@@ -387,13 +527,24 @@ Value MySqlConnection::GetInsertedId() const
 	return lastid;
 }
 
+void MySqlConnection::SkipResults()
+{
+	while(mysql_more_results (mysql)) { // Only first resultset is considered, rest is ignored
+		mysql_next_result (mysql);      // This is required to avoid synchronization error on CALL
+	}
+}
+
 bool MySqlConnection::Fetch() {
 	if(result) {
 		row = mysql_fetch_row(result);
 		if(row) {
 			len = mysql_fetch_lengths(result);
+			if(streaming)
+				rows++;
 			return true;
 		}
+		if(streaming && mysql_errno(mysql)) // connection can break in the middle of result
+			session.SetError(mysql_error(mysql), statement, mysql_errno(mysql));
 	}
 	else
 	if(lastid && rows > 0) {
@@ -454,9 +605,13 @@ void MySqlConnection::GetColumn(int i, Ref f) const {
 void MySqlConnection::FreeResult() {
 	lastid = 0;
 	if(result) {
-		mysql_free_result(result);
+		mysql_free_result(result); // with mysql_use_result, this reads and discards the rest of rows
 		result = NULL;
 	}
+	if(streaming) {
+		streaming = false;
+		SkipResults();
+	}
 }
 
 void MySqlConnection::Cancel() {
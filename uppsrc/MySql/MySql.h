@@ -32,6 +32,9 @@ public:
 	virtual Vector<String> EnumUsers();
 	virtual Vector<String> EnumDatabases();
 	virtual Vector<String> EnumTables(String database);
+	virtual bool           BulkInsert(const String& table, const Vector<String>& column,
+	                                  const Vector< Vector<Value> >& data);
+	virtual int            GetBulkInsertRows(int columns) const;
 
 protected:
 	virtual SqlConnection *CreateConnection();
@@ -212,6 +212,7 @@ Buffer<ClippingLine> BufferPainter::RenderPath(double width, One<SpanSource>& ss
 
 	bool doclip = width == CLIP;
 	auto fill = [&](CoWork *co) {
+		RZONE("Painter fill");
 		int opacity = int(256 * pathattr.opacity);
 		if(!opacity)
 			return;
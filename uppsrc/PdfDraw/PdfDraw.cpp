@@ -9,6 +9,11 @@ namespace Upp {
 
 #define PDF_COMPRESS
 
+enum {
+	PDF_PAGE_BATCH = 32, // pages compressed in parallel
+	PDF_FLUSH = 256 * 1024, // output buffer is written to stream when it grows over this
+};
+
 dword PdfDraw::GetInfo() const
 {
 	return DOTS|DRAWTEXTLINES;
@@ -33,24 +38,46 @@ void PdfDraw::Init(int pagecx, int pagecy, int _margin, bool _pdfa)
 
 void  PdfDraw::Clear()
 {
+	co.Finish();
+	stream = NULL; // offsets of new document start at 0
 	out.Clear();
+	out_pos = 0;
 	page.Clear();
 	offset.Clear();
+	page_batch.Clear();
+	page_queue.Clear();
+	page_content.Clear();
+	page_url.Clear();
+	image_serial.Clear();
+	image_hash.Clear();
+	imageobj.Clear();
+	color_glyph.Clear();
 	out << "%PDF-1.7\n";
 	out << "%\xf1\xf2\xf3\xf4\n\n";
 	empty = true;
 }
 
-int PdfDraw::BeginObj()
-{
-	offset.Add(out.GetLength());
-	out << offset.GetCount() << " 0 obj\n";
-	return offset.GetCount();
+int PdfDraw::BeginObj(int id)
+{ // id can be reserved by NewObj before, objects do not need to be written in order
+	offset[id - 1] = GetOutPos();
+	out << id << " 0 obj\n";
+	return id;
 }
 
 void PdfDraw::EndObj()
 {
 	out << "endobj\n\n";
+	if(out.GetLength() > PDF_FLUSH)
+		Flush();
+}
+
+void PdfDraw::Flush()
+{
+	if(stream && out.GetLength()) {
+		stream->Put(~out, out.GetLength());
+		out_pos += out.GetLength();
+		out.Clear();
+	}
 }
 
 void PdfDraw::PutRect(const Rect& rc)
@@ -59,30 +86,68 @@ void PdfDraw::PutRect(const Rect& rc)
 		 << Pt(rc.Width()) << ' ' << Pt(rc.Height()) << " re\n";
 }
 
-int PdfDraw::PutStream(const String& data, const String& keys, bool compress)
-{
+String PdfDraw::Compress(const String& data)
+{ // returns empty String if compression does not help
 #ifdef PDF_COMPRESS
-	if(compress) {
-		String c = ZCompress(data);
-		if(c.GetLength() < data.GetLength()) {
-			BeginObj();
-			out << "<< " << keys
-			    << "/Length " << c.GetLength() << " "
-			    << "/Length1 " << data.GetLength() << " "
-			    << "/Filter /FlateDecode "
-			    << " >>\n"
-			    << "stream\r\n" << c << "\r\nendstream\n";
-			EndObj();
-			return offset.GetCount();
-		}
-	}
+	String c = ZCompress(data);
+	if(c.GetLength() < data.GetLength())
+		return c;
 #endif
-	BeginObj();
-	out << "<< " << keys << " /Length " << data.GetLength() <<
-	       " /Length1 "<< data.GetLength() << " >>\n"
-	    << "stream\r\n" << data << "\r\nendstream\n";
+	return String();
+}
+
+void PdfDraw::PutStream(int id, const String& data, const String& c, const String& keys)
+{
+	BeginObj(id);
+	if(c.GetCount())
+		out << "<< " << keys
+		    << "/Length " << c.GetLength() << " "
+		    << "/Length1 " << data.GetLength() << " "
+		    << "/Filter /FlateDecode "
+		    << " >>\n"
+		    << "stream\r\n" << c << "\r\nendstream\n";
+	else
+		out << "<< " << keys << " /Length " << data.GetLength() <<
+		       " /Length1 "<< data.GetLength() << " >>\n"
+		    << "stream\r\n" << data << "\r\nendstream\n";
 	EndObj();
-	return offset.GetCount();
+}
+
+int PdfDraw::PutStream(const String& data, const String& keys, bool compress)
+{
+	int id = NewObj();
+	PutStream(id, data, compress ? Compress(data) : String(), keys);
+	return id;
+}
+
+void PdfDraw::QueuePage()
+{
+	PageStream& p = page_queue.Add();
+	p.id = NewObj();
+	p.data = page;
+	page.Clear();
+	page_content.Add(p.id);
+	if(page_queue.GetCount() >= PDF_PAGE_BATCH)
+		FlushPages(false);
+}
+
+void PdfDraw::FlushPages(bool all)
+{ // page contents are compressed in batches, in parallel with drawing of the next batch
+	co.Finish();
+	for(const PageStream& p : page_batch)
+		PutStream(p.id, p.data, p.compressed);
+	page_batch = pick(page_queue);
+	for(PageStream& p : page_batch) {
+		PageStream *q = &p;
+		co & [=] { q->compressed = Compress(q->data); };
+	}
+	if(all) {
+		co.Finish();
+		for(const PageStream& p : page_batch)
+			PutStream(p.id, p.data, p.compressed);
+		page_batch.Clear();
+	}
+	Flush();
 }
 
 void PdfDraw::PutrgColor(Color rg, uint64 pattern)
@@ -132,8 +197,7 @@ void PdfDraw::EndPage()
 		EndOp();
 	if(page.GetCount())
 		empty = false;
-	PutStream(page);
-	page.Clear();
+	QueuePage();
 }
 
 void PdfDraw::PushOffset()
@@ -382,7 +446,7 @@ void PdfDraw::DrawTextOp(int x, int y, int angle, const wchar *s, Font fnt,
 			posx += dx ? dx[i] : fnt[s[i]];
 		}
 		if(url.GetCount()) { // For now, only 'zero angle' text can have links
-			UrlInfo& u = page_url.At(offset.GetCount()).Add();
+			UrlInfo& u = page_url.At(page_content.GetCount()).Add();
 			u.rect = RectC(x, y, posx, fnt.GetCy()).Offseted(current_offset);
 			u.url = url;
 		}
@@ -429,7 +493,7 @@ void PdfDraw::DrawTextOp(int x, int y, int angle, const wchar *s, Font fnt,
 				posx += dx ? dx[i] : ff[s[i]];
 				prev = next;
 				if(q == 0 && url.GetCount()) { // For now, only 'zero angle' text can have links
-					UrlInfo& u = page_url.At(offset.GetCount()).Add();
+					UrlInfo& u = page_url.At(page_content.GetCount()).Add();
 					u.rect = RectC(x, y, posx, ff.GetCy()).Offseted(current_offset);
 					u.url = url;
 				}
@@ -520,14 +584,160 @@ void DrawJPEG(Draw& w, int x, int y, int cx, int cy, const String& jpeg_data)
 	w.DrawImage(x, y, cx, cy, sJPEGDummy());
 }
 
-int PdfDraw::PdfImage(const Image& img, const Rect& src)
+String GetMonoPdfImage(const Image& m, const Rect& sr)
+{
+	String data;
+	for(int y = sr.top; y < sr.bottom; y++) {
+		const RGBA *p = m[y] + sr.left;
+		const RGBA *e = m[y] + sr.right;
+		while(p < e) {
+			int bit = 0x80;
+			byte b = 0;
+			while(bit && p < e) {
+				if(!((p->r | p->g | p->b) == 0 || (p->r & p->g & p->b) == 255))
+					return Null;
+				b |= bit & p->r;
+				bit >>= 1;
+				p++;
+			}
+			data.Cat(b);
+		}
+	}
+	return data;
+}
+
+String GetGrayPdfImage(const Image& m, const Rect& sr)
 {
+	String data;
+	for(int y = sr.top; y < sr.bottom; y++) {
+		const RGBA *p = m[y] + sr.left;
+		const RGBA *e = m[y] + sr.right;
+		while(p < e)
+			if(p->r == p->g && p->g == p->b)
+				data.Cat((p++)->r);
+			else
+				return Null;
+	}
+	return data;
+}
+
+int PdfDraw::PutJPEG(const String& jpg)
+{
+	StringStream ss(jpg);
+	One<StreamRaster> r = StreamRaster::OpenAny(ss);
+	Size isz(1, 1);
+	if(r)
+		isz = r->GetSize();
+	int id = BeginObj();
+	out << "<< " << " /Width " << isz.cx << " /Height " << isz.cy
+	    << " /Length " << jpg.GetLength()
+		<< "/Type/XObject "
+		   "/ColorSpace/DeviceRGB "
+		   "/Subtype/Image "
+		   "/BitsPerComponent 8 "
+	       "/Filter/DCTDecode >>\r\n"
+	    << "stream\r\n" << jpg << "\r\nendstream\n";
+	EndObj();
+	return id;
+}
+
+int PdfDraw::PutImage(const Image& m, const Rect& src)
+{
+	Rect sr = src & m.GetSize();
+	String data;
+	String wh;
+	wh << " /Width " << sr.Width() << " /Height " << sr.Height();
+	int mask = -1;
+	int smask = -1;
+	if(m.GetKind() == IMAGE_MASK) {
+		for(int y = sr.top; y < sr.bottom; y++) {
+			const RGBA *p = m[y] + sr.left;
+			const RGBA *e = m[y] + sr.right;
+			while(p < e) {
+				int bit = 0x80;
+				byte b = 0;
+				while(bit && p < e) {
+					if(p->a != 255)
+						b |= bit;
+					bit >>= 1;
+					p++;
+				}
+				data.Cat(b);
+			}
+		}
+		mask = PutStream(data, String().Cat()
+		                    << "/Type /XObject /Subtype /Image" << wh
+			                << " /BitsPerComponent 1 /ImageMask true /Decode [0 1] ");
+	}
+	if(m.GetKind() == IMAGE_ALPHA) {
+		for(int y = sr.top; y < sr.bottom; y++) {
+			const RGBA *p = m[y] + sr.left;
+			const RGBA *e = m[y] + sr.right;
+			while(p < e)
+				data.Cat((p++)->a);
+		}
+		smask = PutStream(data, String().Cat()
+		                    << "/Type /XObject /Subtype /Image" << wh
+			                << " /BitsPerComponent 8 /ColorSpace /DeviceGray /Decode [0 1] ");
+	}
+	String imgobj;
+	data = GetMonoPdfImage(m, sr);
+	if(data.GetCount())
+		imgobj << "/Type /XObject /Subtype /Image" << wh
+		       << " /BitsPerComponent 1 /Decode [0 1] /ColorSpace /DeviceGray ";
+	else {
+		data = GetGrayPdfImage(m, sr);
+		if(data.GetCount())
+			imgobj << "/Type /XObject /Subtype /Image" << wh
+			       << " /BitsPerComponent 8 /ColorSpace /DeviceGray /Decode [0 1] ";
+		else {
+			data.Clear();
+			for(int y = sr.top; y < sr.bottom; y++) {
+				const RGBA *p = m[y] + sr.left;
+				const RGBA *e = m[y] + sr.right;
+				while(p < e) {
+					data.Cat(p->r);
+					data.Cat(p->g);
+					data.Cat(p->b);
+					p++;
+				}
+			}
+			imgobj << "/Type /XObject /Subtype /Image" << wh
+			       << " /BitsPerComponent 8 /ColorSpace /DeviceRGB /Intent /Perceptual";
+		}
+	}
+	if(mask >= 0)
+		imgobj << " /Mask " << mask << " 0 R";
+	if(smask >= 0)
+		imgobj << " /SMask " << smask << " 0 R";
+	return PutStream(data, imgobj);
+}
+
+int PdfDraw::PdfImage(const Image& img, const Rect& src, const String& jpeg)
+{ // image is written when first used, equal images are found by hash of data
 	Tuple2<int64, Rect> key = MakeTuple(img.GetSerialId(), src);
-	int q = images.Find(key);
+	int q = jpeg.GetCount() ? -1 : image_serial.Find(key);
+	if(q >= 0)
+		return image_serial[q];
+	Tuple2<int64, Size> h;
+	if(jpeg.GetCount())
+		h = MakeTuple(xxHash64(jpeg), Size(jpeg.GetCount(), -1));
+	else {
+		Rect sr = src & img.GetSize();
+		xxHash64Stream hs;
+		hs.Put(img.GetKind());
+		for(int y = sr.top; y < sr.bottom; y++)
+			hs.Put(img[y] + sr.left, sr.Width() * sizeof(RGBA));
+		h = MakeTuple(hs.Finish(), sr.GetSize());
+	}
+	q = image_hash.Find(h);
 	if(q < 0) {
-		q = images.GetCount();
-		images.Add(key, img);
+		q = image_hash.GetCount();
+		image_hash.Add(h);
+		imageobj.Add(jpeg.GetCount() ? PutJPEG(jpeg) : PutImage(img, src));
 	}
+	if(jpeg.IsEmpty())
+		image_serial.Add(key, q);
 	return q;
 }
 
@@ -537,10 +747,7 @@ void PdfDraw::DrawImageOp(int x, int y, int cx, int cy, const Image& _img, const
 	if(!IsNull(c))
 		img = CachedSetColorKeepAlpha(img, c);
 	
-	int q = PdfImage(img, src);
-	
-	if(img.GetSerialId() == sJPEGDummy().GetSerialId())
-		jpeg.Add(data);
+	int q = img.GetSerialId() == sJPEGDummy().GetSerialId() ? PdfImage(img, src, data) : PdfImage(img, src);
 	
 	page << "q "
 	     << Pt(cx) << " 0 0 " << Pt(cy) << ' '
@@ -632,51 +839,20 @@ void PdfDraw::DrawPolyPolyPolygonOp(const Point *vertices, int vertex_count,
 	}
 }
 
-String GetMonoPdfImage(const Image& m, const Rect& sr)
-{
-	String data;
-	for(int y = sr.top; y < sr.bottom; y++) {
-		const RGBA *p = m[y] + sr.left;
-		const RGBA *e = m[y] + sr.right;
-		while(p < e) {
-			int bit = 0x80;
-			byte b = 0;
-			while(bit && p < e) {
-				if(!((p->r | p->g | p->b) == 0 || (p->r & p->g & p->b) == 255))
-					return Null;
-				b |= bit & p->r;
-				bit >>= 1;
-				p++;
-			}
-			data.Cat(b);
-		}
-	}
-	return data;
-}
-
-String GetGrayPdfImage(const Image& m, const Rect& sr)
+String PdfDraw::Finish(const PdfSignatureInfo *sign)
 {
-	String data;
-	for(int y = sr.top; y < sr.bottom; y++) {
-		const RGBA *p = m[y] + sr.left;
-		const RGBA *e = m[y] + sr.right;
-		while(p < e)
-			if(p->r == p->g && p->g == p->b)
-				data.Cat((p++)->r);
-			else
-				return Null;
+	if(sign && stream) { // signature covers the whole document, already written part cannot be signed
+		stream->SetError();
+		return String();
 	}
-	return data;
-}
 
-String PdfDraw::Finish(const PdfSignatureInfo *sign)
-{
 	if(page.GetLength()) {
-		PutStream(page);
+		QueuePage();
 		empty = false;
 	}
+	FlushPages(true);
 
-	int pagecount = offset.GetCount();
+	int pagecount = page_content.GetCount();
 
 	// we need to generate raster glyph char procs before images because we need alpha image
 	// for color emojis
@@ -684,9 +860,8 @@ String PdfDraw::Finish(const PdfSignatureInfo *sign)
 	for(int i = 0; i < pdffont.GetCount(); i++) {
 		Font fnt = pdffont.GetKey(i);
 		if(fnt.GetHeight() != FONTHEIGHT_TTF) {
-			int t3ch = offset.GetCount() + 1;
 			int fa = fnt.GetCy() - fnt.GetInternal();
-			String res;
+			String procs;
 			const Vector<wchar>& cs = pdffont[i];
 			for(int c = 0; c < cs.GetCount(); c++) {
 				RGlyph rg = RasterGlyph(fnt, pdffont[i][c]);
@@ -718,110 +893,11 @@ String PdfDraw::Finish(const PdfSignatureInfo *sign)
 					     << " /BPC 1 /IM true /D [0 1]"
 					     << " ID\n" << rg.data
 					     << "\nEI Q";
-				PutStream(proc);
+				procs << " /Rgch" << c << ' ' << PutStream(proc) << " 0 R";
 			}
 			charprocs.At(i) = BeginObj();
-			out << "<<";
-			for(int c = 0; c < cs.GetCount(); c++)
-				out << " /Rgch" << c << ' ' << t3ch + c<< " 0 R";
-			out << " >>\n";
-			EndObj();
-		}
-	}
-
-	Vector<int> imageobj;
-	int jpegi = 0;
-	for(int i = 0; i < images.GetCount(); i++) {
-		Size sz = images[i].GetSize();
-		Rect sr = images.GetKey(i).b & sz;
-		String data;
-		String wh;
-		wh << " /Width " << sr.Width() << " /Height " << sr.Height();
-		const Image& m = images[i];
-		if(m.GetSerialId() == sJPEGDummy().GetSerialId()) {
-			String jpg = jpeg[jpegi++];
-			StringStream ss(jpg);
-			One<StreamRaster> r = StreamRaster::OpenAny(ss);
-			Size isz(1, 1);
-			if(r)
-				isz = r->GetSize();
-			BeginObj();
-			out << "<< " << " /Width " << isz.cx << " /Height " << isz.cy
-			    << " /Length " << jpg.GetLength()
-				<< "/Type/XObject "
-				   "/ColorSpace/DeviceRGB "
-				   "/Subtype/Image "
-				   "/BitsPerComponent 8 "
-			       "/Filter/DCTDecode >>\r\n"
-			    << "stream\r\n" << jpg << "\r\nendstream\n";
+			out << "<<" << procs << " >>\n";
 			EndObj();
-			imageobj << offset.GetCount();
-		}
-		else {
-			int mask = -1;
-			int smask = -1;
-			if(m.GetKind() == IMAGE_MASK) {
-				for(int y = sr.top; y < sr.bottom; y++) {
-					const RGBA *p = m[y] + sr.left;
-					const RGBA *e = m[y] + sr.right;
-					while(p < e) {
-						int bit = 0x80;
-						byte b = 0;
-						while(bit && p < e) {
-							if(p->a != 255)
-								b |= bit;
-							bit >>= 1;
-							p++;
-						}
-						data.Cat(b);
-					}
-				}
-				mask = PutStream(data, String().Cat()
-				                    << "/Type /XObject /Subtype /Image" << wh
-					                << " /BitsPerComponent 1 /ImageMask true /Decode [0 1] ");
-			}
-			if(m.GetKind() == IMAGE_ALPHA) {
-				for(int y = sr.top; y < sr.bottom; y++) {
-					const RGBA *p = m[y] + sr.left;
-					const RGBA *e = m[y] + sr.right;
-					while(p < e)
-						data.Cat((p++)->a);
-				}
-				smask = PutStream(data, String().Cat()
-				                    << "/Type /XObject /Subtype /Image" << wh
-					                << " /BitsPerComponent 8 /ColorSpace /DeviceGray /Decode [0 1] ");
-			}
-			String imgobj;
-			data = GetMonoPdfImage(m, sr);
-			if(data.GetCount())
-				imgobj << "/Type /XObject /Subtype /Image" << wh
-				       << " /BitsPerComponent 1 /Decode [0 1] /ColorSpace /DeviceGray ";
-			else {
-				data = GetGrayPdfImage(m, sr);
-				if(data.GetCount())
-					imgobj << "/Type /XObject /Subtype /Image" << wh
-					       << " /BitsPerComponent 8 /ColorSpace /DeviceGray /Decode [0 1] ";
-				else {
-					data.Clear();
-					for(int y = sr.top; y < sr.bottom; y++) {
-						const RGBA *p = m[y] + sr.left;
-						const RGBA *e = m[y] + sr.right;
-						while(p < e) {
-							data.Cat(p->r);
-							data.Cat(p->g);
-							data.Cat(p->b);
-							p++;
-						}
-					}
-					imgobj << "/Type /XObject /Subtype /Image" << wh
-					       << " /BitsPerComponent 8 /ColorSpace /DeviceRGB /Intent /Perceptual";
-				}
-			}
-			if(mask >= 0)
-				imgobj << " /Mask " << mask << " 0 R";
-			if(smask >= 0)
-				imgobj << " /SMask " << smask << " 0 R";
-			imageobj << PutStream(data, imgobj);
 		}
 	}
 
@@ -1219,7 +1295,7 @@ String PdfDraw::Finish(const PdfSignatureInfo *sign)
 			out << "<< /Type /Page\n"
 			    << "/Parent " << pages << " 0 R\n"
 			    << "/MediaBox [0 0 " << Pt(pgsz.cx) << ' ' << Pt(pgsz.cy) << "]\n"
-			    << "/Contents " << i + 1 << " 0 R\n"
+			    << "/Contents " << page_content[i] << " 0 R\n"
 			    << "/Resources " << resources << " 0 R\n";
 			bool sgned = sign && sign_page == i;
 			bool urls = i < url_ann.GetCount() && url_ann[i].GetCount();
@@ -1305,12 +1381,12 @@ String PdfDraw::Finish(const PdfSignatureInfo *sign)
 	
 		out << ">>\n";
 		EndObj();
-		int startxref = out.GetCount();
+		int64 startxref = GetOutPos();
 		out << "xref\n"
 		    << "0 " << offset.GetCount() + 1 << "\n";
 		out << "0000000000 65535 f\r\n";
 		for(int i = 0; i < offset.GetCount(); i++)
-			out << Sprintf("%010d 00000 n\r\n", offset[i]);
+			out << Sprintf("%010lld 00000 n\r\n", offset[i]);
 		out << "\n"
 		    << "trailer\n"
 		    << "<< /Size " << offset.GetCount() + 1 << "\n"
@@ -1338,7 +1414,11 @@ String PdfDraw::Finish(const PdfSignatureInfo *sign)
 		out.SetLength(len0); // p7s signature grew, scratch pdf ending and try again
 		offset.SetCount(offset0);
 	}
-	   
+
+	if(stream) {
+		Flush();
+		return String();
+	}
 	return out;
 }
 
@@ -292,14 +292,28 @@ private:
 	VectorMap<Font, Vector<wchar>>              pdffont;
 	VectorMap<Font, VectorMap<wchar, CharPos>>  fontchars;
 	Index<uint64>                               patterns;
-	VectorMap<Tuple2<int64, Rect>, Image>       images;
+	VectorMap<Tuple2<int64, Rect>, int>         image_serial; // serial id and source rect -> image
+	Index<Tuple2<int64, Size>>                  image_hash; // content hash and size -> image
+	Vector<int>                                 imageobj;
 	Array<Array<UrlInfo>>                       page_url;
 	String                                      data; // temporary escape data, e.g. JPEG
-	Vector<String>                              jpeg;
-	
-	Vector<int>  offset;
+
+	struct PageStream {
+		int    id;
+		String data;
+		String compressed;
+	};
+
+	Array<PageStream> page_batch;
+	Array<PageStream> page_queue;
+	Vector<int>       page_content;
+	CoWorkNX          co; // compresses page_batch while next pages are drawn, destroyed before it
+
+	Vector<int64> offset;
 	StringBuffer out;
 	StringBuffer page;
+	Stream      *stream;
+	int64        out_pos; // bytes already written to stream
 	Size        pgsz;
 	Color       rgcolor;
 	Color       RGcolor;
@@ -317,10 +331,18 @@ private:
 	double Pt(double dot)               { return 0.12 * dot; }
 	String Ptf(double dot)              { return FormatF(Pt(dot), 5); }
 
-	int    Pos()                        { return offset.GetCount() + 1; }
-	int    BeginObj();
+	int64  GetOutPos() const            { return out_pos + out.GetLength(); }
+	int    NewObj()                     { offset.Add(-1); return offset.GetCount(); }
+	int    BeginObj(int id);
+	int    BeginObj()                   { return BeginObj(NewObj()); }
 	void   EndObj();
+	void   Flush();
+	void   PutStream(int id, const String& data, const String& compressed, const String& keys = Null);
 	int    PutStream(const String& data, const String& keys = Null, bool compress = true);
+	void   QueuePage();
+	void   FlushPages(bool all);
+
+	static String Compress(const String& data);
 
 	void    PutRect(const Rect& rc);
 	void    PutrgColor(Color rg, uint64 pattern = 0);
@@ -355,17 +377,23 @@ private:
 	
 	VectorMap<Tuple<Font, int>, CGlyph> color_glyph;
 
-	int    PdfImage(const Image& img, const Rect& src);
+	int    PdfImage(const Image& img, const Rect& src, const String& jpeg = Null);
+	int    PutImage(const Image& m, const Rect& src);
+	int    PutJPEG(const String& jpg);
 	CGlyph ColorGlyph(Font fnt, int chr);
 	RGlyph RasterGlyph(Font fnt, int chr);
 
 public:
-	String Finish(const PdfSignatureInfo *sign = NULL);
-	void   Clear();
+	String Finish(const PdfSignatureInfo *sign = NULL); // with stream returns empty, sign sets stream error
+	void   Clear(); // also detaches output stream
 	bool   IsEmpty() const                                   { return empty; }
+	int    GetPageCount() const                              { return page_content.GetCount(); }
+
+	PdfDraw& SetStream(Stream& s)                            { stream = &s; Flush(); return *this; }
 	
 	PdfDraw(int pagecx, int pagecy, bool pdfa = false)       { Init(pagecx, pagecy, 0, pdfa); }
 	PdfDraw(Size pgsz = Size(5100, 6600), bool pdfa = false) { Init(pgsz.cx, pgsz.cy, 0, pdfa); }
+	PdfDraw(Stream& s, Size pgsz = Size(5100, 6600), bool pdfa = false) { Init(pgsz.cx, pgsz.cy, 0, pdfa); SetStream(s); }
 };
 
 void DrawJPEG(Draw& w, int x, int y, int cx, int cy, const String& jpeg_data);
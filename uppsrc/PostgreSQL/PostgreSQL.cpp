@@ -14,6 +14,8 @@
 
 namespace Upp {
 
+enum { PGSQL_STREAMING_CHUNK = 1000 }; // rows per result in streaming mode, if libpq supports chunked rows
+
 enum PGSQL_StandardOid {
 	PGSQL_BOOLOID = 16,
 	PGSQL_BYTEAOID = 17,
@@ -30,13 +32,19 @@ enum PGSQL_StandardOid {
 	PGSQL_XIDOID = 28,
 	PGSQL_CIDOID = 29,
 	PGSQL_OIDVECTOROID = 30,
+	PGSQL_JSONOID = 114,
+	PGSQL_XMLOID = 142,
 	PGSQL_FLOAT4OID = 700,
 	PGSQL_FLOAT8OID = 701,
+	PGSQL_BPCHAROID = 1042,
+	PGSQL_VARCHAROID = 1043,
 	PGSQL_DATEOID = 1082,
 	PGSQL_TIMEOID = 1083,
 	PGSQL_TIMESTAMPOID = 1114,
 	PGSQL_TIMESTAMPZOID = 1184,
-	PGSQL_NUMERICOID = 1700
+	PGSQL_NUMERICOID = 1700,
+	PGSQL_UUIDOID = 2950,
+	PGSQL_JSONBOID = 3802
 };
 
 int OidToType(Oid oid)
@@ -74,6 +82,7 @@ protected:
 	virtual Value       GetInsertedId() const;
 	virtual bool        Fetch();
 	virtual void        GetColumn(int i, Ref f) const;
+	virtual void        CatColumn(int i, const SqlColumnVector& c) const;
 	virtual void        Cancel();
 	virtual SqlSession& GetSession() const;
 	virtual String      GetUser() const;
@@ -89,10 +98,17 @@ private:
 	int             rows;
 	int             fetched_row; //-1, if not fetched yet
 	String          last_insert_table;
+	bool            streaming = false; // rows of result are received in chunks by PQgetResult
+	bool            stream_cancel = false; // outside of transaction, error of canceled query does no harm
+	int             streamed_rows = 0;
 
 	void            FreeResult();
+	bool            SendQuery(const String& query);
+	bool            NextChunk();
+	void            EndStreaming(bool cancel);
 	String          ErrorMessage();
 	String          ErrorCode();
+	Value           GetBinary(int i, const char *s, int len) const;
 
 	String          FromCharset(const String& s) const { return session.FromCharset(s); }
 	String          ToCharset(const String& s) const   { return session.ToCharset(s); }
@@ -321,6 +337,112 @@ void PostgreSQLSession::ExecTrans(const char * statement)
 	PQclear(result);
 }
 
+static void sCopyText(String& out, const String& s)
+{ // COPY text format escapes
+	for(const char *q = ~s; q < s.End(); q++)
+		switch(*q) {
+		case '\\': out.Cat("\\\\"); break;
+		case '\t': out.Cat("\\t"); break;
+		case '\n': out.Cat("\\n"); break;
+		case '\r': out.Cat("\\r"); break;
+		default:   out.Cat(*q);
+		}
+}
+
+int PostgreSQLSession::GetBulkInsertRows(int columns) const
+{
+	return max(1000000 / max(columns, 1), 1);
+}
+
+bool PostgreSQLSession::BulkInsert(const String& table, const Vector<String>& column,
+                                   const Vector< Vector<Value> >& data)
+{ // streams rows through COPY FROM STDIN in text format
+	if(data.GetCount() == 0 || data[0].GetCount() == 0)
+		return true;
+	String statement;
+	statement << "copy " << table << '(' << Join(column, ", ") << ") from stdin";
+	if(trace)
+		*trace << statement << " -- " << data[0].GetCount() << " rows" << UPP::EOL;
+	result = PQexec(conn, statement);
+	if(PQresultStatus(result) != PGRES_COPY_IN) {
+		SetError(ErrorMessage(), statement, 0, ErrorCode());
+		PQclear(result);
+		return false;
+	}
+	PQclear(result);
+	String out;
+	bool ok = true;
+	for(int r = 0; ok && r < data[0].GetCount(); r++) {
+		for(int i = 0; i < column.GetCount(); i++) {
+			if(i)
+				out.Cat('\t');
+			const Value& v = data[i][r];
+			if(IsNull(v))
+				out.Cat("\\N");
+			else
+				switch(v.GetType()) {
+				case SQLRAW_V:
+					out << "\\\\x" << HexString(SqlRaw(v));
+					break;
+				case WSTRING_V:
+				case STRING_V:
+					sCopyText(out, ToCharset(v));
+					break;
+				case BOOL_V:
+				case INT_V:
+					out << int(v);
+					break;
+				case INT64_V:
+					out << int64(v);
+					break;
+				case DOUBLE_V:
+					out << FormatDouble(double(v), 20);
+					break;
+				case DATE_V: {
+						Date d = v;
+						out << Format("%04d-%02d-%02d", d.year, d.month, d.day);
+					}
+					break;
+				case TIME_V: {
+						Time t = v;
+						out << Format("%04d-%02d-%02d %02d:%02d:%02d",
+						              t.year, t.month, t.day, t.hour, t.minute, t.second);
+					}
+					break;
+				default:
+					NEVER();
+				}
+		}
+		out.Cat('\n');
+		if(out.GetLength() >= 256 * 1024 || r == data[0].GetCount() - 1) {
+			ok = PQputCopyData(conn, ~out, out.GetLength()) == 1;
+			out.Clear();
+		}
+	}
+	String error;
+	if(!ok)
+		error = ErrorMessage();
+	if(PQputCopyEnd(conn, ok ? NULL : "U++ bulk insert failed") != 1 && ok) {
+		ok = false;
+		error = ErrorMessage();
+	}
+	String code;
+	while((result = PQgetResult(conn)) != NULL) {
+		if(PQresultStatus(result) != PGRES_COMMAND_OK && ok) {
+			ok = false;
+			error = ErrorMessage();
+			code = ErrorCode();
+		}
+		PQclear(result);
+	}
+	if(!ok) {
+		if(trace)
+			*trace << statement << " failed: " << error << " (level " << level << ")\n";
+		SetError(error, statement, 0, code);
+	}
+	return ok;
+}
+
 String PostgreSQLSession::FromCharset(const String& s) const
 {
 	if(!charset)
@@ -536,22 +658,37 @@ bool PostgreSQLConnection::Execute()
 	if(session.IsTraceTime())
 		time = msecs();
 
+	bool stream = IsStreamingFetch();
 	int itry = 0;
 	int stat;
 	do {
-		result = PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, 0);
-		stat = PQresultStatus(result);
+		if(stream) {
+			stream_cancel = session.level == 0 && PQtransactionStatus(conn) == PQTRANS_IDLE;
+			result = SendQuery(query) ? PQgetResult(conn) : NULL;
+			stat = PQresultStatus(result);
+			streaming = stat == PGRES_SINGLE_TUPLE
+#ifdef LIBPQ_HAS_CHUNK_MODE
+			            || stat == PGRES_TUPLES_CHUNK
+#endif
+			;
+			if(!streaming)
+				EndStreaming(false);
+		}
+		else {
+			result = PQexecParams(conn, query, 0, NULL, NULL, NULL, NULL, session.binary_results);
+			stat = PQresultStatus(result);
+		}
 	}
-	while(stat != PGRES_TUPLES_OK && stat != PGRES_COMMAND_OK && session.level == 0 &&
+	while(stat != PGRES_TUPLES_OK && stat != PGRES_COMMAND_OK && !streaming && session.level == 0 &&
 	      (!session.ConnectionOK() || ErrorMessage().Find("connection") >= 0 && itry == 0) && session.WhenReconnect(itry++));
 
 	if(trace) {
 		if(session.IsTraceTime())
 			*trace << Format("--------------\nexec %d ms:\n", msecs(time));
 	}
-	if(stat == PGRES_TUPLES_OK) //result set
+	if(stat == PGRES_TUPLES_OK || streaming) //result set
 	{
-		rows = PQntuples(result);
+		rows = streamed_rows = PQntuples(result);
 		int fields = PQnfields(result);
 		info.SetCount(fields);
 		oid.SetCount(fields);
@@ -569,6 +706,12 @@ bool PostgreSQLConnection::Execute()
 			Oid type_oid = PQftype(result, i);
 			f.type = OidToType(type_oid);
 			oid[i] = type_oid;
+			if(PQfformat(result, i) && !PostgreSQLIsBinaryType(type_oid)) { // interval, arrays...
+				session.SetError(Format("Column %s of PostgreSQL type %d cannot be received in binary format, "
+				                        "cast it to text", f.name, (int)type_oid), query);
+				Cancel();
+				return false;
+			}
 		}
 		return true;
 	}
@@ -585,7 +728,7 @@ bool PostgreSQLConnection::Execute()
 
 int PostgreSQLConnection::GetRowsProcessed() const
 {
-	return rows;
+	return streaming ? streamed_rows : rows;
 }
 
 Value PostgreSQLConnection::GetInsertedId() const
@@ -614,11 +757,60 @@ Value PostgreSQLConnection::GetInsertedId() const
 		return Null;
 }
 
+bool PostgreSQLConnection::SendQuery(const String& query)
+{ // with streaming, result rows are not collected by libpq, they are returned by PQgetResult as they arrive
+	if(!PQsendQueryParams(conn, query, 0, NULL, NULL, NULL, NULL, session.binary_results))
+		return false;
+#ifdef LIBPQ_HAS_CHUNK_MODE
+	if(PQsetChunkedRowsMode(conn, PGSQL_STREAMING_CHUNK))
+		return true;
+#endif
+	return PQsetSingleRowMode(conn);
+}
+
+bool PostgreSQLConnection::NextChunk()
+{
+	FreeResult();
+	result = PQgetResult(conn);
+	int stat = PQresultStatus(result);
+	if(stat == PGRES_SINGLE_TUPLE
+#ifdef LIBPQ_HAS_CHUNK_MODE
+	   || stat == PGRES_TUPLES_CHUNK
+#endif
+	) {
+		rows = PQntuples(result);
+		streamed_rows += rows;
+		fetched_row = 0;
+		return true;
+	}
+	if(stat != PGRES_TUPLES_OK) // final result is empty, unless the query failed in the middle
+		session.SetError(ErrorMessage(), statement, 0, ErrorCode());
+	EndStreaming(false);
+	return false;
+}
+
+void PostgreSQLConnection::EndStreaming(bool cancel)
+{ // libpq requires reading all results before the next query is sent
+	if(cancel) { // do not transfer the rest of (possibly huge) result set just to throw it away
+		PGcancel *c = PQgetCancel(conn);
+		if(c) {
+			char h[256];
+			PQcancel(c, h, sizeof(h));
+			PQfreeCancel(c);
+		}
+	}
+	while(PGresult *r = PQgetResult(conn))
+		PQclear(r);
+	streaming = false;
+}
+
 bool PostgreSQLConnection::Fetch()
 {
 	fetched_row++;
 	if(result && rows > 0 && fetched_row < rows)
 		return true;
+	if(streaming && NextChunk())
+		return true;
 	Cancel();
 	return false;
 }
@@ -630,6 +822,234 @@ static Date sDate(const char *s)
 	return Date(atoi(s), atoi(s + 5), atoi(s + 8));
 }
 
+// Binary format: integers are big endian, dates count from 2000-01-01,
+// timestamps are in microseconds, numeric has base 10000 digits
+
+static int64 sBinaryInt(const char *s, int len)
+{
+	return len == 8 ? Peek64be(s) : len == 4 ? Peek32be(s) : len == 2 ? (int16)Peek16be(s) : len == 1 ? *s : 0;
+}
+
+static double sBinaryNumeric(const char *s, int len)
+{
+	if(len < 8)
+		return NAN;
+	int ndigits = Peek16be(s);
+	int weight = (int16)Peek16be(s + 2);
+	int sign = Peek16be(s + 4);
+	if(sign >= 0xc000) // NaN, infinity
+		return NAN;
+	ndigits = min(ndigits, (len - 8) / 2);
+	double d = 0;
+	for(int i = 0; i < ndigits; i++)
+		d = 10000 * d + Peek16be(s + 8 + 2 * i);
+	d *= pow(10000.0, weight - ndigits + 1);
+	return sign ? -d : d;
+}
+
+static double sBinaryDouble(Oid oid, const char *s, int len)
+{
+	switch(oid) {
+	case PGSQL_FLOAT4OID: {
+			dword h = Peek32be(s);
+			float f;
+			memcpy(&f, &h, sizeof(f));
+			return f;
+		}
+	case PGSQL_FLOAT8OID: {
+			uint64 h = Peek64be(s);
+			double d;
+			memcpy(&d, &h, sizeof(d));
+			return d;
+		}
+	case PGSQL_NUMERICOID:
+		return sBinaryNumeric(s, len);
+	}
+	return (double)sBinaryInt(s, len);
+}
+
+static Date sBinaryDate(const char *s)
+{
+	int days = Peek32be(s);
+	if(days == INT_MAX || days == INT_MIN) // infinity
+		return Null;
+	return Date(2000, 1, 1) + days;
+}
+
+static Time sLocalTime(int64 sec)
+{ // timestamptz is sent in UTC, text format has it in local time
+	sec += Time(2000, 1, 1) - Time(1970, 1, 1);
+#ifdef PLATFORM_WIN32
+	uint64 h = (uint64)(sec + (Time(1970, 1, 1) - Time(1601, 1, 1))) * 10000000;
+	FILETIME ft;
+	ft.dwLowDateTime = (dword)h;
+	ft.dwHighDateTime = (dword)(h >> 32);
+	SYSTEMTIME utc, tm;
+	if(!FileTimeToSystemTime(&ft, &utc) || !SystemTimeToTzSpecificLocalTime(NULL, &utc, &tm))
+		return Null;
+	return Time(tm.wYear, tm.wMonth, tm.wDay, tm.wHour, tm.wMinute, tm.wSecond);
+#else
+	time_t t = (time_t)sec;
+	struct tm r;
+	if(!localtime_r(&t, &r))
+		return Null;
+	return Time(r.tm_year + 1900, r.tm_mon + 1, r.tm_mday, r.tm_hour, r.tm_min, r.tm_sec);
+#endif
+}
+
+static Time sBinaryTime(Oid oid, const char *s)
+{
+	int64 usec = Peek64be(s);
+	if(usec == INT64_MAX || usec == INT64_MIN)
+		return Null;
+	int64 sec = usec >= 0 ? usec / 1000000 : -((999999 - usec) / 1000000);
+	if(oid == PGSQL_TIMESTAMPZOID)
+		return sLocalTime(sec);
+	return (oid == PGSQL_TIMEOID ? Time(1970, 1, 1) : Time(2000, 1, 1)) + sec;
+}
+
+static String sBinaryUuid(const char *s)
+{
+	String h = HexString(s, 16);
+	return h.Mid(0, 8) + '-' + h.Mid(8, 4) + '-' + h.Mid(12, 4) + '-' + h.Mid(16, 4) + '-' + h.Mid(20);
+}
+
+static bool sIsIntOid(Oid oid)
+{
+	return oid == PGSQL_INT8OID || oid == PGSQL_INT4OID || oid == PGSQL_INT2OID || oid == PGSQL_BOOLOID;
+}
+
+static bool sIsDoubleOid(Oid oid)
+{
+	return oid == PGSQL_FLOAT8OID || oid == PGSQL_FLOAT4OID || oid == PGSQL_NUMERICOID;
+}
+
+static bool sIsTextOid(Oid oid)
+{ // binary format of these is the text itself
+	return oid == PGSQL_TEXTOID || oid == PGSQL_NAMEOID || oid == PGSQL_CHAROID || oid == PGSQL_BPCHAROID ||
+	       oid == PGSQL_VARCHAROID || oid == PGSQL_JSONOID || oid == PGSQL_XMLOID;
+}
+
+bool PostgreSQLIsBinaryType(Oid oid)
+{
+	switch(oid) {
+	case PGSQL_BOOLOID:
+	case PGSQL_INT2OID:
+	case PGSQL_INT4OID:
+	case PGSQL_INT8OID:
+	case PGSQL_OIDOID:
+	case PGSQL_FLOAT4OID:
+	case PGSQL_FLOAT8OID:
+	case PGSQL_NUMERICOID:
+	case PGSQL_DATEOID:
+	case PGSQL_TIMEOID:
+	case PGSQL_TIMESTAMPOID:
+	case PGSQL_TIMESTAMPZOID:
+	case PGSQL_UUIDOID:
+	case PGSQL_BYTEAOID:
+	case PGSQL_JSONBOID:
+		return true;
+	}
+	return sIsTextOid(oid);
+}
+
+Value PostgreSQLBinaryValue(Oid oid, const char *s, int len)
+{
+	switch(oid) {
+	case PGSQL_BOOLOID:
+		return *s ? "1" : "0";
+	case PGSQL_INT2OID:
+	case PGSQL_INT4OID:
+		return (int)sBinaryInt(s, len);
+	case PGSQL_INT8OID:
+		return sBinaryInt(s, len);
+	case PGSQL_OIDOID:
+		return (int64)(dword)Peek32be(s);
+	case PGSQL_FLOAT4OID:
+	case PGSQL_FLOAT8OID:
+	case PGSQL_NUMERICOID:
+		return sBinaryDouble(oid, s, len);
+	case PGSQL_DATEOID:
+		return sBinaryDate(s);
+	case PGSQL_TIMEOID:
+	case PGSQL_TIMESTAMPOID:
+	case PGSQL_TIMESTAMPZOID:
+		return sBinaryTime(oid, s);
+	case PGSQL_UUIDOID:
+		return len == 16 ? sBinaryUuid(s) : String();
+	case PGSQL_BYTEAOID:
+		return String(s, len);
+	case PGSQL_JSONBOID: // version byte followed by text
+		if(len > 0 && *s == 1)
+			return String(s + 1, len - 1);
+		return ErrorValue("Unknown jsonb format");
+	}
+	if(sIsTextOid(oid))
+		return String(s, len);
+	return ErrorValue(Format("Binary format of PostgreSQL type %d is not supported", (int)oid));
+}
+
+Value PostgreSQLConnection::GetBinary(int i, const char *s, int len) const
+{
+	Value v = PostgreSQLBinaryValue(oid[i], s, len);
+	if((sIsTextOid(oid[i]) || oid[i] == PGSQL_JSONBOID) && IsString(v))
+		return FromCharset(v);
+	return v;
+}
+
+void PostgreSQLConnection::CatColumn(int i, const SqlColumnVector& c) const
+{ // common combinations are converted directly to target type
+	if(PQgetisnull(result, fetched_row, i)) {
+		c.Cat(Null);
+		return;
+	}
+	const char *s = PQgetvalue(result, fetched_row, i);
+	int len = PQgetlength(result, fetched_row, i);
+	Oid t = oid[i];
+	bool binary = PQfformat(result, i);
+	switch(c.type) {
+	case INT_V:
+	case INT64_V:
+		if(sIsIntOid(t)) {
+			int64 x = binary ? sBinaryInt(s, len) : t == PGSQL_BOOLOID ? *s == 't' : ScanInt64(s);
+			if(c.type == INT_V)
+				c.Get<int>().Add((int)x);
+			else
+				c.Get<int64>().Add(x);
+			return;
+		}
+		break;
+	case DOUBLE_V:
+		if(t != PGSQL_BOOLOID && (sIsIntOid(t) || sIsDoubleOid(t))) {
+			double d = binary ? sBinaryDouble(t, s, len) : ScanDouble(s);
+			c.Get<double>().Add(IsNull(d) ? NAN : d);
+			return;
+		}
+		break;
+	case DATE_V:
+		if(binary && t == PGSQL_DATEOID) {
+			c.Get<Date>().Add(sBinaryDate(s));
+			return;
+		}
+		break;
+	case TIME_V:
+		if(binary && (t == PGSQL_TIMESTAMPOID || t == PGSQL_TIMESTAMPZOID)) {
+			c.Get<Time>().Add(sBinaryTime(t, s));
+			return;
+		}
+		break;
+	case STRING_V:
+		if(sIsTextOid(t)) {
+			c.Get<String>().Add(FromCharset(String(s, len)));
+			return;
+		}
+		break;
+	}
+	Value v;
+	GetColumn(i, v);
+	c.Cat(v);
+}
+
 void PostgreSQLConnection::GetColumn(int i, Ref f) const
 {
 	if(PQgetisnull(result, fetched_row, i))
@@ -638,6 +1058,10 @@ void PostgreSQLConnection::GetColumn(int i, Ref f) const
 		return;
 	}
 	char *s = PQgetvalue(result, fetched_row, i);
+	if(PQfformat(result, i)) {
+		f.SetValue(GetBinary(i, s, PQgetlength(result, fetched_row, i)));
+		return;
+	}
 	switch(info[i].type)
 	{
 		case INT64_V:
@@ -688,6 +1112,8 @@ void PostgreSQLConnection::Cancel()
 	rows = 0;
 	fetched_row = -1;
 	FreeResult();
+	if(streaming)
+		EndStreaming(stream_cancel);
 }
 
 SqlSession& PostgreSQLConnection::GetSession() const
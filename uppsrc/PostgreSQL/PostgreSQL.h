@@ -28,6 +28,10 @@ bool PostgreSQLPerformScript(const String& text,
 
 String PostgreSQLTextType(int n);
 
+// Values received with BinaryResults; text is returned as received, timestamptz in local time
+bool   PostgreSQLIsBinaryType(Oid oid);
+Value  PostgreSQLBinaryValue(Oid oid, const char *s, int len);
+
 class PostgreSQLConnection;
 
 class PostgreSQLSession : public SqlSession {
@@ -45,6 +49,10 @@ public:
 	virtual String                EnumRowID(String database, String table);
 	virtual Vector<String>        EnumReservedWords();
 
+	virtual bool                  BulkInsert(const String& table, const Vector<String>& column,
+	                                         const Vector< Vector<Value> >& data);
+	virtual int                   GetBulkInsertRows(int columns) const;
+
 protected:
 	virtual SqlConnection *CreateConnection();
 
@@ -56,6 +64,7 @@ private:
 	bool                  keepalive;
 	bool                  hex_blobs;
 	bool                  noquestionparams = false;
+	bool                  binary_results = false;
 	
 	VectorMap<String, String> pkache;
 
@@ -84,6 +93,7 @@ public:
 	void                  SetCharset(byte chrset)         { charset = chrset; }
 	void                  KeepAlive(bool b = true)        { keepalive = b; DoKeepAlive(); }
 	void                  NoQuestionParams(bool b = true) { noquestionparams = b; }
+	void                  BinaryResults(bool b = true)    { binary_results = b; }
 
 	String                GetUser()                       { return PQuser(conn); }
 	operator PGconn *     ()                              { return conn; }
@@ -2,6 +2,81 @@
 
 namespace Upp {
 
+int SqlSession::GetBulkInsertRows(int columns) const
+{
+	return min(5000 / max(columns, 1), 990) + 1; // MSSQL maximum is 1000
+}
+
+bool SqlSession::BulkInsert(const String& table, const Vector<String>& column,
+                            const Vector< Vector<Value> >& data)
+{
+	if(data.GetCount() == 0 || data[0].GetCount() == 0)
+		return true;
+	int rows = data[0].GetCount();
+	int dialect = GetDialect();
+	Sql sql(*this);
+	if(findarg(dialect, MY_SQL, PGSQL, MSSQL) >= 0) {
+		String insert;
+		insert << "insert into " + table + '(' << Join(column, ", ") << ") values ";
+		for(int r = 0; r < rows; r++) {
+			if(r)
+				insert << ", ";
+			insert << "(";
+			for(int i = 0; i < column.GetCount(); i++) {
+				if(i)
+					insert << ", ";
+				insert << SqlCompile(dialect, SqlFormat(data[i][r]));
+			}
+			insert << ")";
+		}
+		return sql.Execute(insert);
+	}
+	else {
+		VectorMap<String, Vector<int>> pattern; // rows grouped by null columns
+		for(int r = 0; r < rows; r++) {
+			StringBuffer nulls(column.GetCount());
+			for(int i = 0; i < column.GetCount(); i++)
+				nulls[i] = IsNull(data[i][r]);
+			pattern.GetAdd(nulls).Add(r);
+		}
+		for(int q = 0; q < pattern.GetCount(); q++)
+		for(int r0 = 0; r0 < pattern[q].GetCount(); r0 += 500) { // SQLite compound select limit
+			const String& nulls = pattern.GetKey(q);
+			String insert;
+			insert << "insert into " + table + '(';
+			bool nextcol = false;
+			for(int i = 0; i < column.GetCount(); i++)
+				if(!nulls[i]) {
+					if(nextcol)
+						insert << ", ";
+					nextcol = true;
+					insert << column[i];
+				}
+			insert << ')';
+			bool nextsel = false;
+			for(int r : SubRange(pattern[q], r0, min(pattern[q].GetCount() - r0, 500))) {
+				if(nextsel)
+					insert << " union all";
+				nextsel = true;
+				insert << " select ";
+				bool nextval = false;
+				for(int i = 0; i < column.GetCount(); i++)
+					if(!nulls[i]) {
+						if(nextval)
+							insert << ", ";
+						nextval = true;
+						insert << SqlCompile(dialect, SqlFormat(data[i][r]));
+					}
+				if(dialect == ORACLE)
+					insert << " from dual";
+			}
+			if(!sql.Execute(insert))
+				return false;
+		}
+	}
+	return true;
+}
+
 SqlMassInsert::~SqlMassInsert()
 {
 	Flush();
@@ -9,20 +84,14 @@ SqlMassInsert::~SqlMassInsert()
 
 SqlMassInsert& SqlMassInsert::operator()(SqlId col, const Value& val)
 {
-	if(pos == 0) {
-		cache.Add().nulls = 0;
-		cache.Top();
-	}
-	if(cache.GetCount() == 1)
+	if(rows == 0) {
 		column.Add(~col);
+		data.Add();
+	}
 	else
-		ASSERT(column[pos] == col.Quoted() || column[pos] == ~col);
-	Row& r = cache.Top();
-	r.value.Add(val);
-	if(IsNull(val))
-		r.nulls |= ((uint64)1 << pos);
+		ASSERT(pos < column.GetCount() && (column[pos] == col.Quoted() || column[pos] == ~col));
+	data[pos].Add(val);
 	pos++;
-	ASSERT(pos < 62);
 	return *this;
 }
 
@@ -33,112 +102,49 @@ SqlMassInsert& SqlMassInsert::operator()(const ValueMap& data)
 	return *this;
 }
 
-SqlMassInsert& SqlMassInsert::EndRow(SqlBool remove)
+SqlMassInsert& SqlMassInsert::EndRow(SqlBool rm)
 {
-	cache.Top().remove = remove;
+	if(!rm.IsEmpty()) {
+		doremove = true;
+		remove = remove || rm;
+	}
 	if(pos == 0)
 		return *this;
-	if(cache.GetCount() && cache[0].value.GetCount() * cache.GetCount() > 5000 || cache.GetCount() > 990) // MSSQL maximum is 1000
-		Flush();
 	ASSERT(column.GetCount() == pos);
 	pos = 0;
+	rows++;
+	SqlSession& session = sql.GetSession();
+	if(rows >= (generic ? session.SqlSession::GetBulkInsertRows(column.GetCount())
+	                    : session.GetBulkInsertRows(column.GetCount())))
+		Flush();
 	return *this;
 }
 
 void SqlMassInsert::Flush()
 {
-	const uint64 DONE = (uint64)-1;
-	if(cache.GetCount() == 0)
+	if(rows == 0 && !doremove)
 		return;
+	SqlSession& session = sql.GetSession();
+	sql.ClearError();
 	if(use_transaction)
-		sql.GetSession().Begin();
-	SqlBool remove;
-	bool doremove = false;
-	for(int ii = 0; ii < cache.GetCount(); ii++) {
-		SqlBool rm = cache[ii].remove;
-		if(!rm.IsEmpty()) {
-			doremove = true;
-			remove = remove || rm;
-		}
-	}
-	if(doremove)
-		sql * Delete(table).Where(remove);
-	String insert;
-	int dialect = sql.GetDialect();
-	if(findarg(dialect, MY_SQL, PGSQL, MSSQL) >= 0) {
-		insert << "insert into " + ~table + '(';
-		for(int i = 0; i < column.GetCount(); i++) {
-			if(i)
-				insert << ", ";
-			insert << column[i];
-		}
-		insert << ") values ";
-		for(int i = 0; i < cache.GetCount(); i++) {
-			Row& r = cache[i];
-			if(r.value.GetCount()) {
-				if(i)
-					insert << ", ";
-				insert << "(";
-				for(int i = 0; i < r.value.GetCount(); i++) {
-					if(i)
-						insert << ", ";
-					insert << SqlCompile(dialect, SqlFormat(r.value[i]));
-				}
-				insert << ")";
-			}
-		}
-	}
-	else
-	for(int ii = 0; ii < cache.GetCount(); ii++) {
-		uint64 nulls = cache[ii].nulls;
-		if(nulls != DONE) {
-			insert << "insert into " + ~table + '(';
-			bool nextcol = false;
-			for(int i = 0; i < column.GetCount(); i++) {
-				if(!(nulls & ((uint64)1 << i))) {
-					if(nextcol)
-						insert << ", ";
-					nextcol = true;
-					insert << column[i];
-				}
-			}
-			insert << ')';
-			bool nextsel = false;
-			for(int i = ii; i < cache.GetCount(); i++) {
-				Row& r = cache[i];
-				if(r.nulls == nulls && r.value.GetCount()) {
-					r.nulls = DONE;
-					if(nextsel)
-						insert << " union all";
-					nextsel = true;
-					insert << " select ";
-					bool nextval = false;
-					for(int i = 0; i < r.value.GetCount(); i++)
-						if(!(nulls & ((uint64)1 << i))) {
-							if(nextval)
-								insert << ", ";
-							nextval = true;
-							insert << SqlCompile(dialect, SqlFormat(r.value[i]));
-						}
-					if(dialect == ORACLE)
-						insert << " from dual";
-				}
-			}
-		}
-	}
-	sql.Execute(insert);
-	if(sql.WasError()) {
+		session.Begin();
+	bool ok = !doremove || sql.Execute(Delete(table).Where(remove));
+	if(ok && rows)
+		ok = generic ? session.SqlSession::BulkInsert(~table, column, data)
+		             : session.BulkInsert(~table, column, data);
+	if(!ok || session.WasError()) {
 		error = true;
 		if(use_transaction)
-			sql.GetSession().Rollback();
+			session.Rollback();
 	}
 	else
 		if(use_transaction)
-			sql.GetSession().Commit();
-	cache.Clear();
+			session.Commit();
+	data.Clear();
 	column.Clear();
-	pos = 0;
+	remove = SqlBool();
+	doremove = false;
+	rows = pos = 0;
 }
 
 }
-
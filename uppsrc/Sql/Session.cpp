@@ -34,6 +34,7 @@ bool           SqlSession::IsOpen() const                                { retur
 int            SqlSession::GetTransactionLevel() const                   { return 0; }
 RunScript      SqlSession::GetRunScript() const                          { return NULL; }
 SqlConnection *SqlSession::CreateConnection()                            { return NULL; }
+void           SqlSession::ClearStatementCache()                         {}
 Vector<String> SqlSession::EnumUsers()                                   { return Vector<String>(); }
 Vector<String> SqlSession::EnumDatabases()                               { return Vector<String>(); }
 Vector<String> SqlSession::EnumTables(String database)                   { return Vector<String>(); }
@@ -65,6 +65,44 @@ SqlConnection::~SqlConnection() {}
 
 void SqlConnection::Cancel() {}
 
+void SqlConnection::CatColumn(int i, const SqlColumnVector& c) const
+{
+	Value v;
+	GetColumn(i, v);
+	c.Cat(v);
+}
+
+void SqlColumnVector::Cat(const Value& v) const
+{
+	switch(type) {
+	case INT_V:
+		Get<int>().Add(IsNull(v) ? (int)Null : (int)v);
+		break;
+	case INT64_V:
+		Get<int64>().Add(IsNull(v) ? (int64)Null : (int64)v);
+		break;
+	case DOUBLE_V:
+		Get<double>().Add(IsNull(v) ? (double)Null : (double)v);
+		break;
+	case STRING_V:
+		Get<String>().Add(IsNull(v) ? String() : v.Is<SqlRaw>() || IsString(v) ? (String)SqlRaw(v) : AsString(v));
+		break;
+	case DATE_V:
+		Get<Date>().Add(IsNull(v) ? (Date)Null : (Date)v);
+		break;
+	case TIME_V:
+		Get<Time>().Add(IsNull(v) ? (Time)Null : (Time)v);
+		break;
+	default:
+		Get<Value>().Add(v);
+	}
+}
+
+bool SqlConnection::IsStreamingFetch() const
+{
+	return stream_fetch < 0 ? GetSession().IsStreamingFetch() : stream_fetch;
+}
+
 int  SqlConnection::GetRowsProcessed() const {
 	NEVER();
 	return 0;
@@ -107,6 +145,7 @@ void Sql::SetStatement(const String& s) {
 }
 
 bool Sql::Execute() {
+	RZONE("Sql::Execute");
 	SqlSession &session = GetSession();
 
 	session.SetStatement(cn->statement);
@@ -264,6 +303,24 @@ bool Sql::Fetch(Vector<Value>& row) {
 	return true;
 }
 
+int Sql::FetchColumns(const Vector<SqlColumnVector>& column, int max_rows)
+{ // appends up to max_rows rows to column vectors, returns the number of rows fetched
+	SqlSession& session = GetSession();
+	session.SetStatus(SqlSession::START_FETCHING);
+	int n = 0;
+	int nc = min(column.GetCount(), GetColumns());
+	while(n < max_rows && cn->Fetch()) {
+		for(int i = 0; i < nc; i++)
+			cn->CatColumn(i, column[i]);
+		n++;
+	}
+	session.SetStatus(SqlSession::END_FETCHING);
+	if(n < max_rows)
+		session.SetStatus(SqlSession::END_FETCHING_MANY);
+	cn->starttime = INT_MAX;
+	return n;
+}
+
 ValueMap Sql::GetRowMap() const
 {
 	ValueMap m;
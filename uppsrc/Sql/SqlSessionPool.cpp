@@ -0,0 +1,288 @@
+#include "Sql.h"
+
+namespace Upp {
+
+#define LLOG(x)  // LOG("SqlSessionPool " << x)
+
+SqlSessionPool::Item *SqlSessionPool::FindItem(SqlSession *s)
+{
+	for(Item& m : item)
+		if(~m.session == s)
+			return &m;
+	return NULL;
+}
+
+void SqlSessionPool::RemoveItem(Item *m, Array<Item>& removed)
+{ // sessions are closed by caller after leaving the mutex
+	for(int i = 0; i < item.GetCount(); i++)
+		if(&item[i] == m) {
+			removed.Add(item.Detach(i));
+			return;
+		}
+}
+
+void SqlSessionPool::EvictIdle(Array<Item>& removed)
+{
+	if(IsNull(idle_timeout))
+		return;
+	for(int i = item.GetCount() - 1; i >= 0 && item.GetCount() > min_size; i--)
+		if(!item[i].leased && msecs(item[i].since) >= idle_timeout) {
+			LLOG("Evicted idle session");
+			removed.Add(item.Detach(i));
+			evicted++;
+		}
+}
+
+bool SqlSessionPool::Ping(SqlSession& s)
+{
+	if(!s.IsOpen())
+		return false;
+	String stmt = ping;
+	if(IsNull(stmt))
+		stmt = s.GetDialect() == ORACLE ? "select 1 from dual" : "select 1";
+	try {
+		Sql sql(s);
+		if(sql.Execute(stmt) && sql.Fetch()) {
+			sql.Cancel();
+			return true;
+		}
+	}
+	catch(SqlExc&) {}
+	return false;
+}
+
+bool SqlSessionPool::Reset(SqlSession& s)
+{ // session goes back to pool as it was opened: no transaction, no error
+	if(!s.IsOpen())
+		return false;
+	try {
+		for(int i = 0; i < 16 && s.GetTransactionLevel() > 0; i++)
+			s.Rollback();
+	}
+	catch(SqlExc&) {}
+	bool ok = s.GetTransactionLevel() == 0 && s.GetErrorClass() != Sql::CONNECTION_BROKEN;
+	s.ClearError();
+	return ok;
+}
+
+SqlSessionPool::Lease SqlSessionPool::Get(int timeout)
+{
+	int t0 = msecs();
+	bool waited = false;
+	Lease lease;
+	Array<Item> removed;
+	mutex.Enter();
+	for(;;) {
+		EvictIdle(removed);
+		Item *m = NULL;
+		for(Item& q : item) // most recently released session, so that excess ones can go idle
+			if(!q.leased && (!m || q.since - m->since > 0))
+				m = &q;
+		if(m) {
+			m->leased = true;
+			bool validate = !IsNull(validate_after) && msecs(m->since) >= validate_after;
+			SqlSession *s = ~m->session;
+			mutex.Leave();
+			if(!validate || Ping(*s)) {
+				lease.session = s;
+				break;
+			}
+			LLOG("Session failed validation");
+			mutex.Enter();
+			discarded++;
+			RemoveItem(FindItem(s), removed);
+			continue;
+		}
+		if(item.GetCount() + opening < max_size && WhenConnect) {
+			opening++;
+			mutex.Leave();
+			One<SqlSession> s(WhenConnect());
+			mutex.Enter();
+			opening--;
+			if(s && s->IsOpen()) {
+				Item& m = item.Add();
+				m.session = pick(s);
+				m.leased = true;
+				m.since = msecs();
+				lease.session = ~m.session;
+				mutex.Leave();
+				break;
+			}
+			connect_failures++;
+			cv.Signal(); // another waiting thread can try to connect
+			mutex.Leave();
+			return lease;
+		}
+		int left = timeout - msecs(t0);
+		if(left <= 0) {
+			timeouts++;
+			mutex.Leave();
+			return lease;
+		}
+		waited = true;
+		cv.Wait(mutex, left);
+	}
+	int wait = msecs(t0);
+	mutex.Enter();
+	Item *m = FindItem(lease.session);
+	if(m)
+		m->since = msecs();
+	lease.pool = this;
+	leases++;
+	if(waited) {
+		waits++;
+		wait_time += wait;
+		max_wait_time = max(max_wait_time, wait);
+	}
+	mutex.Leave();
+	return lease;
+}
+
+void SqlSessionPool::Release(SqlSession *s)
+{
+	bool ok = Reset(*s);
+	Array<Item> removed;
+	Mutex::Lock __(mutex);
+	Item *m = FindItem(s);
+	if(!m)
+		return;
+	leased_time += msecs(m->since);
+	m->leased = false;
+	m->since = msecs();
+	if(!ok) {
+		LLOG("Session discarded on release");
+		discarded++;
+		RemoveItem(m, removed);
+	}
+	else
+	if(m->discard) {
+		LLOG("Cleared session closed on release");
+		RemoveItem(m, removed);
+	}
+	EvictIdle(removed);
+	cv.Signal();
+}
+
+void SqlSessionPool::Lease::Release()
+{
+	if(session && pool)
+		pool->Release(session);
+	session = NULL;
+}
+
+SqlSessionPool::Lease& SqlSessionPool::Lease::operator=(Lease&& s)
+{
+	if(this != &s) {
+		Release();
+		pool = s.pool;
+		session = s.session;
+		s.session = NULL;
+	}
+	return *this;
+}
+
+void SqlSessionPool::Maintain()
+{ // closes sessions idle for too long, opens new ones up to MinSize
+	Array<Item> removed;
+	mutex.Enter();
+	EvictIdle(removed);
+	while(item.GetCount() + opening < min_size && WhenConnect) {
+		opening++;
+		mutex.Leave();
+		One<SqlSession> s(WhenConnect());
+		mutex.Enter();
+		opening--;
+		if(!s || !s->IsOpen()) {
+			connect_failures++;
+			break;
+		}
+		Item& m = item.Add();
+		m.session = pick(s);
+		m.since = msecs();
+		cv.Signal();
+	}
+	mutex.Leave();
+}
+
+void SqlSessionPool::Clear()
+{ // closes idle sessions, leased ones are closed when released
+	Array<Item> removed;
+	Mutex::Lock __(mutex);
+	for(int i = item.GetCount() - 1; i >= 0; i--)
+		if(item[i].leased)
+			item[i].discard = true;
+		else
+			removed.Add(item.Detach(i));
+}
+
+int SqlSessionPool::GetCount()
+{
+	Mutex::Lock __(mutex);
+	return item.GetCount();
+}
+
+int SqlSessionPool::GetIdleCount()
+{
+	Mutex::Lock __(mutex);
+	int n = 0;
+	for(const Item& m : item)
+		n += !m.leased;
+	return n;
+}
+
+SqlSessionPool::Stats SqlSessionPool::GetStats()
+{
+	Mutex::Lock __(mutex);
+	Stats st;
+	st.sessions = item.GetCount();
+	st.leased = 0;
+	int64 lt = leased_time;
+	for(const Item& m : item)
+		if(m.leased) {
+			st.leased++;
+			lt += msecs(m.since);
+		}
+	st.idle = st.sessions - st.leased;
+	st.leases = leases;
+	st.waits = waits;
+	st.wait_time = wait_time;
+	st.max_wait_time = max_wait_time;
+	st.timeouts = timeouts;
+	st.discarded = discarded;
+	st.evicted = evicted;
+	st.connect_failures = connect_failures;
+	st.utilization = (double)lt / max(msecs(stats_start), 1) / max_size;
+	return st;
+}
+
+void SqlSessionPool::ResetStats()
+{
+	Mutex::Lock __(mutex);
+	leases = waits = wait_time = timeouts = discarded = evicted = connect_failures = leased_time = 0;
+	max_wait_time = 0;
+	stats_start = msecs();
+	for(Item& m : item)
+		if(m.leased)
+			m.since = stats_start;
+}
+
+String SqlSessionPool::Stats::ToString() const
+{
+	return Format("sessions: %d (idle %d, leased %d), leases: %d, waits: %d (%d ms, max %d ms), timeouts: %d, "
+	              "discarded: %d, evicted: %d, connect failures: %d, utilization: %.1f%%",
+	              sessions, idle, leased, leases, waits, wait_time, max_wait_time, timeouts,
+	              discarded, evicted, connect_failures, 100 * utilization);
+}
+
+SqlSessionPool::SqlSessionPool()
+{
+	stats_start = msecs();
+	ping = Null;
+}
+
+SqlSessionPool::~SqlSessionPool()
+{ // leases must not outlive the pool
+	ASSERT(GetIdleCount() == item.GetCount());
+}
+
+}
@@ -40,6 +40,23 @@ struct SqlColumnInfo : Moveable<SqlColumnInfo> {
 	bool        binary;    //column holds binary data
 };
 
+struct SqlColumnVector : Moveable<SqlColumnVector> { // typed target of Sql::FetchColumns, Null values are stored as Null
+	dword type;
+	void *data;
+
+	template <class T>
+	Vector<T>& Get() const                      { return *(Vector<T> *)data; }
+	void       Cat(const Value& v) const;
+
+	SqlColumnVector(Vector<int>& v)             { type = INT_V; data = &v; }
+	SqlColumnVector(Vector<int64>& v)           { type = INT64_V; data = &v; }
+	SqlColumnVector(Vector<double>& v)          { type = DOUBLE_V; data = &v; }
+	SqlColumnVector(Vector<String>& v)          { type = STRING_V; data = &v; }
+	SqlColumnVector(Vector<Date>& v)            { type = DATE_V; data = &v; }
+	SqlColumnVector(Vector<Time>& v)            { type = TIME_V; data = &v; }
+	SqlColumnVector(Vector<Value>& v)           { type = VALUE_V; data = &v; }
+};
+
 class SqlConnection {
 protected:
 	friend class Sql;
@@ -51,6 +68,7 @@ protected:
 	virtual Value       GetInsertedId() const;
 	virtual bool        Fetch() = 0;
 	virtual void        GetColumn(int i, Ref r) const = 0;
+	virtual void        CatColumn(int i, const SqlColumnVector& c) const;
 	virtual void        Cancel() = 0;
 	virtual SqlSession& GetSession() const = 0;
 	virtual String      GetUser() const;
@@ -67,6 +85,9 @@ protected:
 	int                    fetchrows;
 	int                    longsize;
 	bool                   parse;
+	int8                   stream_fetch = -1; // -1: as set in session
+
+	bool                   IsStreamingFetch() const;
 };
 
 #define E__ColVal(I)  const char *c##I, const Value& v##I
@@ -155,6 +176,8 @@ public:
 	bool   Fetch(ValueMap& row);
 	bool   Fetch(Fields fields);
 
+	int    FetchColumns(const Vector<SqlColumnVector>& column, int max_rows = INT_MAX);
+
 	int    GetRowsProcessed() const                    { return cn->GetRowsProcessed(); }
 
 	int    GetColumns() const;
@@ -174,6 +197,9 @@ public:
 	void        SetFetchRows(int nrows)                { cn->fetchrows = nrows; } // deprecated
 	void        SetLongSize(int lsz)                   { cn->longsize = lsz; } // deprecated
 
+	void        StreamingFetch(bool b = true)          { cn->stream_fetch = b; }
+	void        NoStreamingFetch()                     { StreamingFetch(false); }
+
 	void        Cancel()                               { if(cn) cn->Cancel(); }
 
 	Value       Select(const String& what); // Deprecated
@@ -335,6 +361,11 @@ protected:
 	int                           status;
 	
 	bool                          use_realcase = false;
+
+	int                           statement_cache = 0; // maximum number of prepared statements kept by backend
+	int64                         statement_cache_hits = 0;
+	int64                         statement_cache_misses = 0;
+	bool                          streaming_fetch = false; // rows are received from server as they are fetched
 	
 	One<Sql>                      sql;
 	One<Sql>                      sqlr;
@@ -369,6 +400,21 @@ public:
 	virtual String                EnumRowID(String database, String table); // deprecated
 	virtual Vector<String>        EnumReservedWords(); // deprecated
 
+	virtual bool                  BulkInsert(const String& table, const Vector<String>& column,
+	                                         const Vector< Vector<Value> >& data); // data[column][row]
+	virtual int                   GetBulkInsertRows(int columns) const;
+
+	virtual void                  ClearStatementCache();
+	SqlSession&                   StatementCache(int count)               { statement_cache = max(count, 0); return *this; }
+	SqlSession&                   NoStatementCache()                      { ClearStatementCache(); return StatementCache(0); }
+	int                           GetStatementCache() const               { return statement_cache; }
+	int64                         GetStatementCacheHits() const           { return statement_cache_hits; }
+	int64                         GetStatementCacheMisses() const         { return statement_cache_misses; }
+
+	SqlSession&                   StreamingFetch(bool b = true)           { streaming_fetch = b; return *this; }
+	SqlSession&                   NoStreamingFetch()                      { return StreamingFetch(false); }
+	bool                          IsStreamingFetch() const                { return streaming_fetch; }
+
 	int                           GetDialect() const                      { ASSERT(dialect != 255); return dialect; }
 
 	void                          SetTrace(Stream& s = VppLog())          { trace = &s; }
@@ -428,6 +474,104 @@ public:
 	virtual ~SqlSession();
 };
 
+class SqlSessionPool : NoCopy { // thread-safe pool of opened sessions
+	struct Item {
+		One<SqlSession> session;
+		bool            leased = false;
+		bool            discard = false; // cleared while leased, closed on release
+		int             since = 0; // msecs of lease or release
+	};
+
+	Mutex                     mutex;
+	ConditionVariable         cv;
+	Array<Item>               item;
+	int                       opening = 0; // sessions being opened by factory outside of mutex
+	int                       stats_start;
+
+	int                       min_size = 0;
+	int                       max_size = 8;
+	int                       idle_timeout = 60000;
+	int                       validate_after = 5000;
+	String                    ping;
+
+	int64                     leases = 0;
+	int64                     waits = 0;
+	int64                     wait_time = 0;
+	int                       max_wait_time = 0;
+	int64                     timeouts = 0;
+	int64                     discarded = 0;
+	int64                     evicted = 0;
+	int64                     connect_failures = 0;
+	int64                     leased_time = 0;
+
+	Item *FindItem(SqlSession *s);
+	void  RemoveItem(Item *m, Array<Item>& removed);
+	void  EvictIdle(Array<Item>& removed);
+	bool  Ping(SqlSession& s);
+	bool  Reset(SqlSession& s);
+	void  Release(SqlSession *s);
+
+public:
+	class Lease : Moveable<Lease> {
+		SqlSessionPool *pool = NULL;
+		SqlSession     *session = NULL;
+
+		friend class SqlSessionPool;
+
+	public:
+		SqlSession& operator*() const                     { ASSERT(session); return *session; }
+		SqlSession *operator->() const                    { ASSERT(session); return session; }
+		operator SqlSession&() const                      { return **this; }
+		SqlSession *Get() const                           { return session; }
+		bool        IsEmpty() const                       { return !session; }
+		explicit operator bool() const                    { return session; }
+
+		void        Release();
+
+		Lease& operator=(Lease&& s);
+		Lease(Lease&& s)                                  { pool = s.pool; session = s.session; s.session = NULL; }
+		Lease() {}
+		~Lease()                                          { Release(); }
+	};
+
+	struct Stats {
+		int    sessions;
+		int    idle;
+		int    leased;
+		int64  leases;
+		int64  waits; // leases that had to wait for a session
+		int64  wait_time; // total, in ms
+		int    max_wait_time;
+		int64  timeouts;
+		int64  discarded; // failed validation, broken connection or transaction reset
+		int64  evicted; // closed after idle timeout
+		int64  connect_failures;
+		double utilization; // average fraction of MaxSize sessions leased since start or ResetStats
+
+		String ToString() const;
+	};
+
+	Function<SqlSession *()> WhenConnect; // returns new opened session or NULL
+
+	SqlSessionPool& MinSize(int n)                        { min_size = max(n, 0); return *this; }
+	SqlSessionPool& MaxSize(int n)                        { max_size = max(n, 1); return *this; }
+	SqlSessionPool& IdleTimeout(int ms)                   { idle_timeout = ms; return *this; }
+	SqlSessionPool& ValidateAfter(int ms)                 { validate_after = ms; return *this; } // idle time before ping, Null: never
+	SqlSessionPool& PingStatement(const String& s)        { ping = s; return *this; }
+
+	Lease  Get(int timeout = INT_MAX);
+	void   Maintain();
+	void   Clear();
+
+	int    GetCount();
+	int    GetIdleCount();
+	Stats  GetStats();
+	void   ResetStats();
+
+	SqlSessionPool();
+	~SqlSessionPool();
+};
+
 
 #ifndef NOAPPSQL
 
@@ -455,24 +599,19 @@ bool SqlPerformScript(const String& script,
                       Gate<int, int> progress_canceled = Null, bool stoponerror = false);
 
 class SqlMassInsert {
-	struct Row : Moveable<Row> {
-		uint64         nulls;
-		Vector <Value> value;
-		SqlBool        remove;
-		
-		rval_default(Row);
-		Row() {}
-	};
-
-	Sql&            sql;
-	SqlId           table;
-	Vector<String>  column;
-	Vector<Row>     cache;
-	int             pos;
-	bool            error;
-	bool            use_transaction;
+	Sql&                    sql;
+	SqlId                   table;
+	Vector<String>          column;
+	Vector< Vector<Value> > data; // columnar row cache, data[column][row]
+	SqlBool                 remove;
+	bool                    doremove;
+	int                     rows;
+	int                     pos;
+	bool                    error;
+	bool                    use_transaction;
+	bool                    generic;
 	
-	void            NewRow();
+	void            Init()                                         { rows = pos = 0; doremove = error = generic = false; use_transaction = true; }
 
 public:
 	SqlMassInsert& operator()(SqlId col, const Value& val);
@@ -482,10 +621,11 @@ public:
 	bool           IsError() const                                 { return error; }
 	SqlMassInsert& UseTransaction(bool b = true)                   { use_transaction = b; return *this; }
 	SqlMassInsert& NoUseTransaction()                              { return UseTransaction(false); }
+	SqlMassInsert& Generic(bool b = true)                          { generic = b; return *this; }
 	
-	SqlMassInsert(Sql& sql, SqlId table) : sql(sql), table(table)  { pos = 0; error = false; use_transaction = true; }
+	SqlMassInsert(Sql& sql, SqlId table) : sql(sql), table(table)  { Init(); }
 #ifndef NOAPPSQL
-	SqlMassInsert(SqlId table) : sql(SQL), table(table)            { pos = 0; error = false; use_transaction = true; }
+	SqlMassInsert(SqlId table) : sql(SQL), table(table)            { Init(); }
 #endif
 	~SqlMassInsert();
 };
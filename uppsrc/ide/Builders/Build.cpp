@@ -229,6 +229,7 @@ One<Builder> MakeBuild::CreateBuilder(Host *host)
 		
 		b->main_conf = !!main_conf.GetCount();
 		b->allow_pch = bm.Get("ALLOW_PRECOMPILED_HEADERS", "") == "1";
+		b->object_cache = bm.Get("OBJECT_CACHE", "") == "1";
 		b->start_time = start_time;
 	}
 	return b;
@@ -363,6 +364,11 @@ bool MakeBuild::BuildPackage(const Workspace& wspc, int pkindex, int pknumber, i
 			if(MatchWhen(f[j].when, mcfg.GetKeys()))
 				HdependAddDependency(SourcePath(package, pkg[i]), SourcePath(package, f[j].text));
 	}
+	Vector<String> sources;
+	for(int i = 0; i < pkg.GetCount(); i++)
+		if(!pkg[i].separator && IsCSourceFile(pkg[i]))
+			sources.Add(SourcePath(package, pkg[i]));
+	HdependPrefetch(sources);
 	String tout = OutDir(mcfg, mainpackage, bm, use_target);
 	host.RealizeDir(tout);
 	if(IsNull(mainfn))
@@ -558,6 +564,8 @@ bool MakeBuild::Build(const Workspace& wspc, String mainparam, String outfile, b
 			                  mainparam, outfile, linkfile, immfile, linkopt, ok) && ok;
 		}
 	}
+	if(GetMethodVars(method).Get("OBJECT_CACHE", "") == "1")
+		ReduceCacheFolder(ObjectCacheDir(), (int64)8192 * 1024 * 1024);
 	EndBuilding(ok);
 	SetErrorEditor();
 	HdependBaseIncludes();
@@ -229,11 +229,18 @@ bool GccBuilder::BuildPackage(const String& package, Vector<String>& linkfile, V
 
 	if(blitz && b.build) {
 		PutConsole("BLITZ:" + b.info);
-		int slot = AllocSlot();
-		if(slot < 0 || !Run(String().Cat() << Join(cc, cpp_options) << ' '
-		                    << GetPathQ(b.path)
-		                    << " -o " << GetPathQ(b.object), slot, b.object, b.count))
-			error = true;
+		String exec = String().Cat() << Join(cc, cpp_options) << ' ' << GetPathQ(b.path);
+		String okey;
+		if(object_cache && pch_use.IsEmpty()) {
+			HdependFileTime(b.path);
+			okey = ObjectCacheKey(exec);
+		}
+		if(!ObjectFromCache(okey, b.object)) {
+			int slot = AllocSlot();
+			if(slot < 0 || !Run(exec + " -o " + GetPathQ(b.object), slot, b.object, b.count))
+				error = true;
+			ObjectToCache(okey, b.object);
+		}
 	}
 
 	int first_ifile = sfile.GetCount();
@@ -303,10 +310,15 @@ bool GccBuilder::BuildPackage(const String& package, Vector<String>& linkfile, V
 					exec << fuse_cxa_atexit << Join(" -x c++", cpp_options) << ' ';
 					exec << pch_use;
 				}
-				exec << GetPathQ(fn)  << " " << soptions[i] << " -o " << GetPathQ(objfile);
+				exec << GetPathQ(fn)  << " " << soptions[i];
+				String okey = object_cache && pch_use.IsEmpty() ? ObjectCacheKey(exec) : String();
+				exec << " -o " << GetPathQ(objfile);
 				PutVerbose(exec);
-				int slot = AllocSlot();
-				execerr = (slot < 0 || !Run(exec, slot, objfile, 1));
+				if(!ObjectFromCache(okey, objfile)) {
+					int slot = AllocSlot();
+					execerr = (slot < 0 || !Run(exec, slot, objfile, 1));
+					ObjectToCache(okey, objfile);
+				}
 			}
 			if(execerr)
 				DeleteFile(objfile);
@@ -333,16 +333,26 @@ bool MscBuilder::BuildPackage(const String& package, Vector<String>& linkfile, V
 		obj.Add(pch_obj);
 	}
 
+	bool use_cache = object_cache && !HasAnyDebug() && pch_use.IsEmpty(); // debug info goes to shared .pdb
+
 	if(blitz && b.build) {
 		PutConsole("BLITZ:" + b.info);
-		int slot = AllocSlot();
 		String c = Join(cc, cpp_options);
-		if(HasAnyDebug())
-			c << Pdb(package, slot, false);
-		if(slot < 0 ||
-		   !Run(c + " -Tp " + GetPathQ(b.path) + " -Fo" + GetPathQ(b.object),
-		        slot, b.object, b.count))
-			error = true;
+		String okey;
+		if(use_cache) {
+			HdependFileTime(b.path);
+			okey = ObjectCacheKey(c + " -Tp " + GetPathQ(b.path));
+		}
+		if(!ObjectFromCache(okey, b.object)) {
+			int slot = AllocSlot();
+			if(HasAnyDebug())
+				c << Pdb(package, slot, false);
+			if(slot < 0 ||
+			   !Run(c + " -Tp " + GetPathQ(b.path) + " -Fo" + GetPathQ(b.object),
+			        slot, b.object, b.count))
+				error = true;
+			ObjectToCache(okey, b.object);
+		}
 	}
 
 	int first_ifile = sfile.GetCount();
@@ -393,22 +403,29 @@ bool MscBuilder::BuildPackage(const String& package, Vector<String>& linkfile, V
 				}
 			}
 			else {
-				int slot = AllocSlot();
-				String c;
-				if(ext == ".cu")
-					c << nvcc << (release ? release_cuda : debug_cuda) << " " << soptions[i]
-					  << " -o " << GetPathQ(objfile) << " " << GetPathQ(fn);
-				else {
-					c = cc;
-					if(HasAnyDebug())
-						c << Pdb(package, slot, !sContainsPchOptions(cc) && !sContainsPchOptions(soptions[i]));
-					c << " " + soptions[i] + (ext == ".c" ? Join(c_options, " -Tc") : Join(cpp_options, " -Tp")) + ' '
-					     + GetPathQ(fn) + " -Fo" + GetPathQ(objfile);
-					if(nopch.Find(fn) < 0)
-						c << pch_use;
+				String okey;
+				if(use_cache && ext != ".cu")
+					okey = ObjectCacheKey(cc + " " + soptions[i] + (ext == ".c" ? Join(c_options, " -Tc") : Join(cpp_options, " -Tp"))
+					                      + ' ' + GetPathQ(fn));
+				if(!ObjectFromCache(okey, objfile)) {
+					int slot = AllocSlot();
+					String c;
+					if(ext == ".cu")
+						c << nvcc << (release ? release_cuda : debug_cuda) << " " << soptions[i]
+						  << " -o " << GetPathQ(objfile) << " " << GetPathQ(fn);
+					else {
+						c = cc;
+						if(HasAnyDebug())
+							c << Pdb(package, slot, !sContainsPchOptions(cc) && !sContainsPchOptions(soptions[i]));
+						c << " " + soptions[i] + (ext == ".c" ? Join(c_options, " -Tc") : Join(cpp_options, " -Tp")) + ' '
+						     + GetPathQ(fn) + " -Fo" + GetPathQ(objfile);
+						if(nopch.Find(fn) < 0)
+							c << pch_use;
+					}
+					if(slot < 0 || !Run(c, slot, objfile, 1))
+						execerr = true;
+					ObjectToCache(okey, objfile);
 				}
-				if(slot < 0 || !Run(c, slot, objfile, 1))
-					execerr = true;
 			}
 			if(execerr)
 				DeleteFile(objfile);
@@ -41,6 +41,80 @@ Time Builder::HdependFileTime(const String& path)
 	                          : HdependGetFileTime(path, &dependencies);
 }
 
+String Builder::ObjectCachePath(const String& s)
+{ // replaces assembly and output directories, so that checkouts at different paths share the cache
+	Vector<String> dir, id;
+	auto Add = [&](const String& d, const String& x) {
+		if(d.GetCount()) {
+			dir.Add(d);
+			id.Add(x);
+		}
+	};
+	Add(outdir, "$OUT");
+	Add(GetUppOut(), "$UPPOUT");
+	Vector<String> nest = GetUppDirs();
+	for(int i = 0; i < nest.GetCount(); i++)
+		Add(nest[i], "$" + AsString(i));
+	IndexSort(dir, id, [](const String& a, const String& b) { return a.GetCount() > b.GetCount(); });
+	String r = s;
+	for(int i = 0; i < dir.GetCount(); i++)
+		r.Replace(dir[i], id[i]);
+	return r;
+}
+
+String Builder::ObjectCacheKey(const String& cmdline)
+{ // hash of compiler, command line and content of all files of the last HdependFileTime
+	if(onefile.GetCount()) // HdependFileTime does not collect dependencies of onefile
+		return Null;
+	static VectorMap<String, Tuple<Time, String>> digest;
+	Sha1Stream sha;
+	String exe = FindInDirs(host->GetExecutablesDirs(), cmdline.Mid(0, cmdline.Find(' ')));
+	sha << exe << ' ' << AsString(GetFileTime(exe)) << '\n' << ObjectCachePath(cmdline) << '\n';
+	Vector<String> file = clone(dependencies.GetKeys());
+	Sort(file);
+	for(const String& path : file) {
+		Time tm = GetFileTime(path);
+		Tuple<Time, String>& h = digest.GetAdd(path);
+		if(h.a != tm || IsNull(h.b)) {
+			h.a = tm;
+			String data = LoadFile(path);
+			h.b = data.IsVoid() ? String("-") : SHA1String(data);
+		}
+		sha << ObjectCachePath(path) << ' ' << h.b << '\n';
+	}
+	return sha.FinishString();
+}
+
+bool Builder::ObjectFromCache(const String& key, const String& objfile)
+{
+	if(IsNull(key))
+		return false;
+	String path = AppendFileName(ObjectCacheDir(), key + ".o");
+	if(!FileExists(path) || !FileCopy(path, objfile))
+		return false;
+	Time tm = GetSysTime();
+	FileSetTime(path, tm); // ReduceCacheFolder removes least recently used files
+	FileSetTime(objfile, tm);
+	PutVerbose("Object cache hit: " + path);
+	return true;
+}
+
+void Builder::ObjectToCache(const String& key, const String& objfile)
+{ // stores objfile after compiler process started by caller finishes
+	if(IsNull(key))
+		return;
+	Time start = GetSysTime();
+	host->OnFinish([=] {
+		Time tm = FileGetTime(objfile);
+		if(IsNull(tm) || tm < start)
+			return; // compilation failed
+		String path = AppendFileName(ObjectCacheDir(), key + ".o");
+		String tmp = path + "." + AsString(Uuid::Create());
+		if(!FileCopy(objfile, tmp) || !FileMove(tmp, path))
+			DeleteFile(tmp);
+	});
+}
+
 String Builder::CmdX(const char *s)
 { // expand ` character delimited sections by executing them as commands
 	String r, cmd;
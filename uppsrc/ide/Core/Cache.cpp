@@ -62,3 +62,12 @@ void ReduceCache()
 {
 	ReduceCacheFolder(CacheDir(), (int64)4096 * 1024 * 1024);
 }
+
+String ObjectCacheDir()
+{
+	String dir = CacheFile("objects");
+	ONCELOCK {
+		RealizeDirectory(dir);
+	}
+	return dir;
+}
@@ -42,6 +42,7 @@ String CacheFile(const char *name);
 void   ReduceCache();
 void   ReduceCache(int mb_limit);
 void   ReduceCacheFolder(const char *path, int64 max_total);
+String ObjectCacheDir();
 
 class PPInfo {
 	enum { AUTO, APPROVED, PROHIBITED };
@@ -56,21 +57,29 @@ class PPInfo {
 		bool                          guarded = false; // has include guards
 		int                           blitz = 0; // AUTO, APPROVED, PROHIBITED
 		Time                          time = Null; // file time
+		int64                         length = -1; // file length
 		
 		bool                          dirty = true; // need to be rechecked for change (filetime)
 		
 		void Dirty()                          { dirty = true; time = Null; }
 		void Parse(Stream& in);
+		void ParseFile(const String& path);
 		void Serialize(Stream& s);
 	};
 	
 	struct Dir : Moveable<Dir> {
 		Index<String>           subdirs;
 		VectorMap<String, Time> files;
+		Vector<int64>           length;
 		
 		void Load(const String& dir);
 	};
 	
+	struct CacheItem : Moveable<CacheItem> {
+		int64 pos;
+		int   len;
+	};
+	
 	ArrayMap<String, PPFile>                   files;
 	Vector<String>                             includes; // include dirs
 	int                                        includes_base_count; // for trimming out additional includes
@@ -80,14 +89,22 @@ class PPInfo {
 	VectorMap<String, String>                  normalize_path_cache; // cache for NormalizePath
 	static std::atomic<int>                    scan_serial;
 	VectorMap<String, Index<String> >          depends; // externally forced dependecies
+	FileMapping                                cache; // persistent PPFile records of all files
+	VectorMap<String, CacheItem>               cache_index; // path -> record in cache
+	bool                                       cache_loaded = false;
+	bool                                       cache_changed = false;
 
 	PPFile& File(const String& path);
+	bool    NeedsScan(const String& path, PPFile& f, Time& tm, int64& length);
+	void    LoadCache();
+	void    LoadDirs(const Index<String>& dirs);
+	void    CacheDirs(const String& inc, const String& filedir, Index<String>& dirs);
 
 public:
 	static void           RescanAll()                                           { scan_serial++; }
 
 	Event<const String&, const String&> WhenBlitzBlock;
-	Time                  GetFileTime(const String& path);
+	Time                  GetFileTime(const String& path, int64 *length = nullptr);
 	bool                  FileExists(const String& path)                        { return !IsNull(GetFileTime(path)); }
 	String                NormalizePath(const String& path, const String& curr_dir);
 	String                NormalizePath(const String& path)                     { return NormalizePath(path, current_dir); }
@@ -119,12 +136,19 @@ public:
 	const VectorMap<String, String>& GetFileFlags(const String& path)   { return File(NormalizePath(path)).flags; }
 
 	void                  Dirty();
+
+	void                  Prefetch(const Vector<String>& paths);
+	void                  SaveCache();
+	
+	~PPInfo();
 };
 
 void                  HdependSetIncludes(Vector<String>&& id);
 void                  HdependBaseIncludes();
 void                  HdependAddInclude(const String& inc);
 void                  HdependTimeDirty();
+void                  HdependPrefetch(const Vector<String>& paths);
+void                  HdependSaveCache();
 void                  HdependClearDependencies();
 void                  HdependAddDependency(const String& file, const String& depends);
 Time                  HdependGetFileTime(const String& path, VectorMap<String, Time> *ret_result = nullptr);
@@ -559,6 +583,7 @@ struct Builder {
 	bool             doall;
 	bool             main_conf;
 	bool             allow_pch;
+	bool             object_cache; // reuse objects from content addressed cache
 	FileTime         start_time;
 
 	Index<String>    pkg_config; // names of packages for pkg-config
@@ -573,6 +598,10 @@ struct Builder {
 	String                 CmdX(const char *s);
 	
 	Time                   HdependFileTime(const String& path);
+	String                 ObjectCachePath(const String& s);
+	String                 ObjectCacheKey(const String& cmdline);
+	bool                   ObjectFromCache(const String& key, const String& objfile);
+	void                   ObjectToCache(const String& key, const String& objfile);
 
 	virtual bool BuildPackage(const String& package, Vector<String>& linkfile, Vector<String>& immfile,
 	    String& linkoptions, const Vector<String>& all_uses, const Vector<String>& all_libraries, int optimize)
@@ -696,4 +725,4 @@ String CleanupPretty(const String& signature);
 
 Vector<ItemTextPart> ParsePretty(const String& name, const String& signature, int *fn_info = NULL);
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
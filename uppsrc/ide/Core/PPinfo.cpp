@@ -71,6 +71,7 @@ void PPInfo::PPFile::Parse(Stream& in)
 	LTIMING("PPInfo::Parse");
 
 	flags.Clear();
+	all_defines.Clear();
 	defines[0].Clear();
 	defines[1].Clear();
 	includes[0].Clear();
@@ -211,6 +212,7 @@ void PPInfo::PPFile::Parse(Stream& in)
 void PPInfo::PPFile::Serialize(Stream& s)
 {
 	s % time
+	  % length
 	  % flags
 	  % defines[0]
 	  % defines[1]
@@ -258,14 +260,46 @@ void PPInfo::Dir::Load(const String& dir)
 	#ifdef PLATFORM_WIN32
 		n = ToLower(n); // in Win32 case mismatch is possible
 	#endif
-		if(ff.IsFile())
+		if(ff.IsFile()) {
 			files.Add(n, ff.GetLastWriteTime());
+			length.Add(ff.GetLength());
+		}
 		if(ff.IsFolder())
 			subdirs.FindAdd(n);
 	}
 }
 
-Time PPInfo::GetFileTime(const String& path)
+void PPInfo::LoadDirs(const Index<String>& dirs)
+{ // loads missing directories in parallel, including parents needed for the sanity check
+	Index<String> load;
+	for(const String& dir : dirs)
+		if(dir_cache.Find(dir) < 0) {
+			load.FindAdd(dir);
+			String pdir = GetFileFolder(dir);
+			if(pdir.GetCount() > 3 && dir_cache.Find(pdir) < 0)
+				load.FindAdd(pdir);
+		}
+	if(load.GetCount() == 0)
+		return;
+	Array<Dir> d;
+	d.SetCount(load.GetCount());
+	CoFor(load.GetCount(), [&](int i) { d[i].Load(load[i]); });
+	Vector<bool> valid_dir;
+	for(int i = 0; i < load.GetCount(); i++) { // check that dir does make some sense...
+		bool valid = true;
+		String pdir = GetFileFolder(load[i]);
+		if(dirs.Find(load[i]) >= 0 && pdir.GetCount() > 3) {
+			int q = dir_cache.Find(pdir);
+			const Dir& pd = q >= 0 ? dir_cache[q] : d[load.Find(pdir)];
+			valid = pd.subdirs.Find(GetFileName(load[i])) >= 0;
+		}
+		valid_dir.Add(valid);
+	}
+	for(int i = 0; i < load.GetCount(); i++)
+		dir_cache.Add(load[i], valid_dir[i] ? pick(d[i]) : Dir());
+}
+
+Time PPInfo::GetFileTime(const String& path, int64 *length)
 {
 	String dir = GetFileFolder(path);
 	String name = GetFileName(path);
@@ -275,22 +309,16 @@ Time PPInfo::GetFileTime(const String& path)
 #endif
 	int q = dir_cache.Find(dir);
 	if(q < 0) {
-		String pdir = GetFileFolder(dir); // check that dir does make some sense...
-		bool valid_dir = true;
-		if(pdir.GetCount() > 3) {
-			int dq = dir_cache.Find(pdir);
-			if(dq < 0) {
-				dq = dir_cache.GetCount();
-				dir_cache.Add(pdir).Load(pdir);
-			}
-			valid_dir = dir_cache[dq].subdirs.Find(GetFileName(dir)) >= 0;
-		}
-		q = dir_cache.GetCount();
-		Dir& d = dir_cache.Add(dir);
-		if(valid_dir)
-			d.Load(dir);
+		Index<String> h;
+		h.Add(dir);
+		LoadDirs(h);
+		q = dir_cache.Find(dir);
 	}
-	return dir_cache[q].files.Get(name, Null);
+	const Dir& d = dir_cache[q];
+	int i = d.files.Find(name);
+	if(length)
+		*length = i >= 0 ? d.length[i] : -1;
+	return i >= 0 ? d.files[i] : Time(Null);
 }
 
 String PPInfo::NormalizePath(const String& path, const String& curr_dir)
@@ -305,35 +333,64 @@ String PPInfo::NormalizePath(const String& path, const String& curr_dir)
 	return normalize_path_cache[q];
 }
 
-String PPInfo::FindIncludeFile(const char *s, const String& filedir, const Vector<String>& incdirs)
+static bool sIncludeName(const char *s, String& name, int& type)
 {
 	while(*s == ' ' || *s == '\t')
 		s++;
-	int type = *s;
+	type = *s;
 	if(type == '<' || type == '\"' || type == '?') {
 		s++;
-		String name;
 		if(type == '<') type = '>';
-		while(*s != '\r' && *s != '\n') {
-			if(*s == type) {
-				if(type == '\"') {
-					String fn = NormalizePath(name, filedir);
-					if(FileExists(fn))
-						return fn;
-				}
-				for(int i = 0; i < incdirs.GetCount(); i++) {
-					String fn = NormalizePath(CatAnyPath(incdirs[i], name));
-					if(FileExists(fn))
-						return fn;
-				}
-				break;
-			}
+		while(*s && *s != '\r' && *s != '\n') {
+			if(*s == type)
+				return true;
 			name.Cat(*s++);
 		}
 	}
+	return false;
+}
+
+String PPInfo::FindIncludeFile(const char *s, const String& filedir, const Vector<String>& incdirs)
+{
+	String name;
+	int type;
+	if(sIncludeName(s, name, type)) {
+		if(type == '\"') {
+			String fn = NormalizePath(name, filedir);
+			if(FileExists(fn))
+				return fn;
+		}
+		for(int i = 0; i < incdirs.GetCount(); i++) {
+			String fn = NormalizePath(CatAnyPath(incdirs[i], name));
+			if(FileExists(fn))
+				return fn;
+		}
+	}
 	return String();
 }
 
+void PPInfo::CacheDirs(const String& inc, const String& filedir, Index<String>& dirs)
+{ // collects directories FindIncludeFile is going to look into
+	if(inc_cache.Find(filedir + "|" + inc) >= 0)
+		return;
+	String name;
+	int type;
+	if(sIncludeName(inc, name, type)) {
+		auto Add = [&](const String& fn) {
+			String dir = GetFileFolder(fn);
+		#ifdef PLATFORM_WIN32
+			dir = ToLower(dir);
+		#endif
+			if(dir_cache.Find(dir) < 0)
+				dirs.FindAdd(dir);
+		};
+		if(type == '\"')
+			Add(NormalizePath(name, filedir));
+		for(const String& incdir : includes)
+			Add(NormalizePath(CatAnyPath(incdir, name)));
+	}
+}
+
 String PPInfo::FindIncludeFile(const char *s, const String& filedir)
 {
 	String key = filedir + "|" + s;
@@ -360,34 +417,207 @@ void PPInfo::Dirty()
 
 std::atomic<int> PPInfo::scan_serial;
 
+void PPInfo::PPFile::ParseFile(const String& path)
+{
+	int retry = 0;
+again:
+	FileIn in(path);
+	if(!in && ++retry < 6) { // in case other thread is doing the same (e.g. Indexer)
+		Sleep(retry * 100);
+		goto again;
+	}
+	Parse(in);
+}
+
+void PPInfo::LoadCache()
+{
+	if(cache_loaded)
+		return;
+	cache_loaded = true;
+	cache_index.Clear();
+	if(!cache.Open(CacheFile("ppinfo.cache")) || cache.GetFileSize() < 4 || !cache.Map())
+		return;
+	const byte *b = cache.begin();
+	const byte *s = b;
+	const byte *e = cache.end();
+	if(memcmp(s, "PPI1", 4))
+		return;
+	s += 4;
+	while(e - s >= 4) {
+		int n = Peek32le(s);
+		s += 4;
+		if(n < 0 || e - s < (int64)n + 4)
+			break;
+		String path((const char *)s, n);
+		s += n;
+		int len = Peek32le(s);
+		s += 4;
+		if(len < 0 || e - s < len)
+			break;
+		CacheItem& m = cache_index.GetAdd(path);
+		m.pos = s - b;
+		m.len = len;
+		s += len;
+	}
+}
+
+bool PPInfo::NeedsScan(const String& path, PPFile& f, Time& tm, int64& length)
+{
+	if(!f.dirty)
+		return false;
+	f.dirty = false;
+	tm = GetFileTime(path, &length);
+	if(IsNull(tm)) // not a file
+		return false;
+	if(tm == f.time && length == f.length && scan_serial == f.scan_serial)
+		return false;
+	if(IsNull(f.time)) {
+		LoadCache();
+		int q = cache_index.Find(path);
+		if(q >= 0) {
+			MemReadStream in(cache.begin() + cache_index[q].pos, cache_index[q].len);
+			if(!Load(f, in))
+				f.time = Null;
+		}
+	}
+	return tm != f.time || length != f.length || scan_serial != f.scan_serial;
+}
+
 PPInfo::PPFile& PPInfo::File(const String& path)
 {
 	PPFile& f = files.GetAdd(path);
-	if(f.dirty) {
-		Time tm = GetFileTime(path);
-		f.dirty = false;
-		if(IsNull(tm)) // not a file
-			return f;
-		if(!IsNull(tm) || tm != f.time || scan_serial != f.scan_serial) {
-			String cache_path = CacheFile(GetFileTitle(path) + "$" + SHA1String(path) + ".ppi");
-			if(IsNull(f.time))
-				LoadFromFile(f, cache_path);
-			if(tm != f.time || scan_serial) {
-				int retry = 0;
-			again:
-				FileIn in(path);
-				if(!in && ++retry < 6) { // in case other thread is doing the same (e.g. Indexer)
-					Sleep(retry * 100);
-					goto again;
-				}
-				f.Parse(in);
-				f.time = tm;
-				f.scan_serial = scan_serial;
-				StoreToFile(f, cache_path);
+	Time tm;
+	int64 length;
+	if(NeedsScan(path, f, tm, length)) {
+		f.ParseFile(path);
+		f.time = tm;
+		f.length = length;
+		f.scan_serial = scan_serial;
+		cache_changed = true;
+	}
+	return f;
+}
+
+void PPInfo::Prefetch(const Vector<String>& paths)
+{ // walks include graph breadth first, listing directories and parsing changed files in parallel
+	Index<String> done;
+	Vector<String> level;
+	for(const String& p : paths) {
+		String path = NormalizePath(p);
+		if(done.Find(path) < 0) {
+			done.Add(path);
+			level.Add(path);
+		}
+	}
+	Index<String> dirs;
+	for(const String& path : level) {
+		String dir = GetFileFolder(path);
+	#ifdef PLATFORM_WIN32
+		dir = ToLower(dir);
+	#endif
+		dirs.FindAdd(dir);
+	}
+	while(level.GetCount()) {
+		LoadDirs(dirs);
+		dirs.Clear();
+
+		struct Scan : Moveable<Scan> {
+			PPFile *file;
+			String  path;
+			Time    tm;
+			int64   length;
+		};
+		Vector<Scan> scan;
+		for(const String& path : level) {
+			Scan& m = scan.Add();
+			m.file = &files.GetAdd(path);
+			m.path = path;
+			if(!NeedsScan(path, *m.file, m.tm, m.length))
+				scan.Drop();
+		}
+		CoFor(scan.GetCount(), [&](int i) { scan[i].file->ParseFile(scan[i].path); });
+		for(Scan& m : scan) {
+			m.file->time = m.tm;
+			m.file->length = m.length;
+			m.file->scan_serial = scan_serial;
+			cache_changed = true;
+		}
+
+		Vector<Tuple<String, String>> incs; // include, file directory
+		for(const String& path : level) {
+			const PPFile& f = files.Get(path);
+			String dir = GetFileFolder(path);
+			for(int i = 0; i < 2; i++) {
+				for(const String& inc : f.includes[i])
+					incs.Add({ inc, dir });
+				for(const String& def : f.defines[i])
+					if(findarg(*TrimLeft(def), '<', '\"') >= 0)
+						incs.Add({ def, dir });
+			}
+		}
+		for(const auto& inc : incs)
+			CacheDirs(inc.a, inc.b, dirs);
+		LoadDirs(dirs);
+		dirs.Clear();
+
+		level.Clear();
+		for(const auto& inc : incs) {
+			String ipath = FindIncludeFile(inc.a, inc.b);
+			if(ipath.GetCount() && done.Find(ipath) < 0) {
+				done.Add(ipath);
+				level.Add(ipath);
 			}
 		}
 	}
-	return f;
+}
+
+void PPInfo::SaveCache()
+{
+	if(!cache_changed)
+		return;
+	cache_changed = false;
+	LoadCache();
+	String path = CacheFile("ppinfo.cache");
+	if(!FileExists(path)) // remove .ppi files of the previous per-file format
+		for(FindFile ff(CacheFile("*.ppi")); ff; ff.Next())
+			DeleteFile(ff.GetPath());
+	String tmp = path + "." + AsString(Uuid::Create());
+	FileOut out(tmp);
+	out.Put("PPI1");
+	auto Put = [&](const String& key, const void *data, int len) {
+		out.Put32le(key.GetCount());
+		out.Put(key);
+		out.Put32le(len);
+		out.Put(data, len);
+	};
+	for(int i = 0; i < files.GetCount(); i++)
+		if(!IsNull(files[i].time)) {
+			String h = StoreAsString(files[i]);
+			Put(files.GetKey(i), h, h.GetCount());
+		}
+	for(int i = 0; i < cache_index.GetCount(); i++) { // keep records of files not used now, unless deleted
+		int q = files.Find(cache_index.GetKey(i));
+		if((q < 0 || IsNull(files[q].time)) && FileExists(cache_index.GetKey(i)))
+			Put(cache_index.GetKey(i), cache.begin() + cache_index[i].pos, cache_index[i].len);
+	}
+	out.Close();
+	cache.Close();
+	cache_index.Clear();
+	cache_loaded = false;
+	if(out.IsError()) {
+		DeleteFile(tmp);
+		return;
+	}
+#ifdef PLATFORM_WIN32
+	DeleteFile(path);
+#endif
+	if(!FileMove(tmp, path))
+		DeleteFile(tmp);
+}
+
+PPInfo::~PPInfo()
+{
+	SaveCache();
 }
 
 void PPInfo::AddDependency(const String& file, const String& dep)
@@ -532,9 +762,20 @@ void HdependAddInclude(const String& inc)
 
 void HdependTimeDirty()
 {
+	hdepend.SaveCache();
 	hdepend.Dirty();
 }
 
+void HdependPrefetch(const Vector<String>& paths)
+{
+	hdepend.Prefetch(paths);
+}
+
+void HdependSaveCache()
+{
+	hdepend.SaveCache();
+}
+
 void HdependClearDependencies()
 {
 	hdepend.ClearDependencies();
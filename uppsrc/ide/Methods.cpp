@@ -372,6 +372,7 @@ void DefaultBuilderSetup::InitSetupCtrlsMap(VectorMap<Id, Ctrl*>& map)
 	map.Add("DEBUGGER",                  &debugger);
 	map.Add("ALLOW_PRECOMPILED_HEADERS", &allow_pch);
 	map.Add("DISABLE_BLITZ",             &disable_blitz);
+	map.Add("OBJECT_CACHE",              &object_cache);
 	map.Add("PATH",                      &path);
 	map.Add("INCLUDE",                   &include);
 	map.Add("LIB",                       &lib);
@@ -10,6 +10,7 @@ void LZ4CompressStream::Open(Stream& out_)
 	xxh.Reset();
 	Alloc();
 	pos = 0;
+	index.Clear();
 	byte h[7];
 	Poke32le(h, LZ4F_MAGIC);
 	h[4] = LZ4F_VERSION | LZ4F_BLOCKINDEPENDENCE | LZ4F_CONTENTCHECKSUM;
@@ -74,11 +75,14 @@ void LZ4CompressStream::FlushOut()
 		if(clen >= origsize || clen == 0) {
 			out->Put32le(0x80000000 | origsize);
 			out->Put(s, origsize);
+			clen = origsize;
 		}
 		else {
 			out->Put32le(clen);
 			out->Put(t, clen);
 		}
+		if(seekable)
+			index << clen + 4 << origsize;
 		s += BLOCK_BYTES;
 		t += osz;
 	}
@@ -95,6 +99,16 @@ void LZ4CompressStream::Close()
 		FlushOut();
 		out->Put32le(0);
 		out->Put32le(xxh.Finish());
+		if(seekable) { // skippable frame with seek table, same layout as zstd seekable format
+			int n = index.GetCount() / 2;
+			out->Put32le(LZ4F_SKIPPABLE_MAGIC);
+			out->Put32le(8 * n + 9);
+			for(dword h : index)
+				out->Put32le(h);
+			out->Put32le(n);
+			out->Put(0);
+			out->Put32le(LZ4F_SEEKABLE_MAGIC);
+		}
 		out = NULL;
 	}
 }
@@ -137,6 +151,7 @@ LZ4CompressStream::LZ4CompressStream()
 {
 	style = STRM_WRITE;
 	concurrent = false;
+	seekable = false;
 	out = NULL;
 }
 
@@ -17,6 +17,13 @@ void LZ4DecompressStream::Init()
 	ptr = rdlim = buffer = &h;
 	xxh.Reset();
 	ClearError();
+	block_pos.Clear();
+	block_offset.Clear();
+	for(CachedBlock& b : cache)
+		b.block = -1;
+	cache_serial = 0;
+	block = -1;
+	style &= ~STRM_SEEK;
 }
 
 bool LZ4DecompressStream::Open(Stream& in_)
@@ -59,10 +66,117 @@ bool LZ4DecompressStream::Open(Stream& in_)
 		SetError();
 		return false;
 	}
+	
+	if(in->GetStyle() & STRM_SEEK) { // look for seek table at the end
+		int64 start = in->GetPos();
+		int64 size = in->GetSize();
+		if(size - start >= 25) {
+			in->Seek(size - 9);
+			int n = in->Get32le();
+			int descriptor = in->Get();
+			int64 table = size - 9 - 8 * (int64)n - 8;
+			if(in->Get32le() == (int)LZ4F_SEEKABLE_MAGIC && descriptor == 0 && n >= 0 && table >= start + 8) {
+				in->Seek(table);
+				if(in->Get32le() == LZ4F_SKIPPABLE_MAGIC && in->Get32le() == 8 * n + 9) {
+					int64 p = start;
+					int64 o = 0;
+					for(int i = 0; i < n; i++) {
+						block_pos.Add(p);
+						block_offset.Add(o);
+						p += (dword)in->Get32le();
+						o += (dword)in->Get32le();
+					}
+					block_pos.Add(p);
+					block_offset.Add(o);
+					if(p != table - 8 || in->IsError()) {
+						block_pos.Clear();
+						block_offset.Clear();
+					}
+				}
+			}
+		}
+		in->Seek(start);
+		if(block_pos.GetCount())
+			style |= STRM_SEEK;
+	}
 
 	return true;
 }
 
+bool LZ4DecompressStream::LoadBlock(int i)
+{
+	CachedBlock *b = NULL;
+	for(CachedBlock& m : cache)
+		if(m.block == i)
+			b = &m;
+	if(!b) {
+		b = &cache[0];
+		for(CachedBlock& m : cache)
+			if(m.serial < b->serial)
+				b = &m;
+		b->block = -1;
+		in->Seek(block_pos[i]);
+		int blksz = in->Get32le();
+		int clen = blksz & 0x7fffffff;
+		if(clen > maxblock || clen + 4 != block_pos[i + 1] - block_pos[i]) {
+			SetError();
+			return false;
+		}
+		if(!b->data)
+			b->data.Alloc(maxblock);
+		if(blksz & 0x80000000) {
+			b->len = clen;
+			if(!in->GetAll(~b->data, clen)) {
+				SetError();
+				return false;
+			}
+		}
+		else {
+			Buffer<char> c(clen);
+			if(!in->GetAll(~c, clen)) {
+				SetError();
+				return false;
+			}
+			b->len = LZ4_decompress_safe(~c, ~b->data, clen, maxblock);
+		}
+		if(b->len != block_offset[i + 1] - block_offset[i]) {
+			SetError();
+			return false;
+		}
+		b->block = i;
+	}
+	b->serial = ++cache_serial;
+	block = i;
+	ii = count = 0;
+	eof = i + 2 >= block_pos.GetCount();
+	ptr = Stream::buffer = (byte *)~b->data;
+	rdlim = ptr + b->len;
+	pos = block_offset[i];
+	return true;
+}
+
+void LZ4DecompressStream::Seek(int64 offset)
+{
+	ASSERT(IsSeekable());
+	int n = block_offset.GetCount() - 1;
+	offset = clamp(offset, (int64)0, block_offset.Top());
+	if(n == 0) {
+		block = 0;
+		ii = count = 0;
+		eof = true;
+		ptr = rdlim;
+		return;
+	}
+	int i = min(FindUpperBound(block_offset, offset) - 1, n - 1);
+	if(LoadBlock(i))
+		ptr += offset - block_offset[i];
+}
+
+int64 LZ4DecompressStream::GetSize() const
+{
+	return block_offset.GetCount() ? block_offset.Top() : 0;
+}
+
 bool LZ4DecompressStream::Next()
 {
 	pos += ptr - buffer;
@@ -80,6 +194,11 @@ bool LZ4DecompressStream::Next()
 
 void LZ4DecompressStream::Fetch()
 {
+	if(block >= 0) { // reading by seek table
+		if(block + 2 < block_pos.GetCount())
+			LoadBlock(block + 1);
+		return;
+	}
 	if(Next())
 		return;
 	if(eof)
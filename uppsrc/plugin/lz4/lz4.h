@@ -24,6 +24,9 @@ enum {
     LZ4F_MAXSIZE_256KB    = 0x50,
     LZ4F_MAXSIZE_1024KB   = 0x60,
     LZ4F_MAXSIZE_4096KB   = 0x70,
+    
+    LZ4F_SKIPPABLE_MAGIC  = 0x184D2A5E, // seek table frame
+    LZ4F_SEEKABLE_MAGIC   = 0x8F92EAB1,
 };
 
 class LZ4CompressStream : public Stream  {
@@ -46,6 +49,8 @@ protected:
 	xxHashStream xxh;
 
 	bool          concurrent;
+	bool          seekable;
+	Vector<dword> index; // compressed and decompressed size of blocks, for seek table
     
     void          Alloc();
 	void          Init();
@@ -53,6 +58,7 @@ protected:
 
 public:
 	void Co(bool b = true);
+	void Seekable(bool b = true)                            { seekable = b; }
 	void Open(Stream& out_);
 
 	LZ4CompressStream();
@@ -63,6 +69,8 @@ public:
 class LZ4DecompressStream : public Stream {
 public:
 	virtual   bool  IsOpen() const;
+	virtual   void  Seek(int64 pos);
+	virtual   int64 GetSize() const;
 
 protected:
 	virtual   int   _Term();
@@ -91,16 +99,30 @@ private:
 	bool         eof;
 	
 	bool         concurrent;
+	
+	Vector<int64> block_pos; // seekable: positions of blocks in input, last is the end
+	Vector<int64> block_offset; // seekable: positions of blocks in output, last is total size
+	struct CachedBlock {
+		int          block = -1;
+		Buffer<char> data;
+		int          len = 0;
+		int64        serial = 0;
+	};
+	CachedBlock  cache[4]; // recently decompressed blocks for random access
+	int64        cache_serial;
+	int          block; // current block if reading by seek table, -1 otherwise
 
     void          TryHeader();
 
 	void          Init();
 	bool          Next();
 	void          Fetch();
+	bool          LoadBlock(int i);
 	bool          Ended() const { return IsError() || in->IsError() || ptr == rdlim && ii == count && eof; }
 
 public:
 	bool Open(Stream& in);
+	bool IsSeekable() const                                 { return block_pos.GetCount(); }
 
 	void Co(bool b = true)                                  { concurrent = b; }
 
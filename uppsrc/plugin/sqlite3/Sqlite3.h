@@ -28,6 +28,9 @@ public:
 	virtual Vector<String> EnumViews(String database);
 	virtual Vector<SqlColumnInfo> EnumColumns(String database, String table);
 	virtual int            GetTransactionLevel() const;
+	virtual bool           BulkInsert(const String& table, const Vector<String>& column,
+	                                  const Vector< Vector<Value> >& data);
+	virtual int            GetBulkInsertRows(int columns) const;
 
 	// Some opaque structures used by the sqlite3 library
 	typedef struct sqlite3 sqlite3;
@@ -48,7 +51,13 @@ private:
 
 	int busy_timeout;
 
+	VectorMap<String, sqlite3_stmt *> stmt_cache; // statements not in use, least recently used first
+
+	sqlite3_stmt *GetCachedStatement(const String& statement);
+	bool          CacheStatement(const String& statement, sqlite3_stmt *stmt);
+
 	int SqlExecRetry(const char *sql);
+	int StepRetry(sqlite3_stmt *stmt);
 
 	void Reset();
 	void Cancel();
@@ -68,6 +77,7 @@ public:
 	virtual void   Begin();
 	virtual void   Commit();
 	virtual void   Rollback();
+	virtual void   ClearStatementCache();
 
 	void SetBusyTimeout(int ms)                         { busy_timeout = ms; } //infinite if less than 0
 
@@ -29,8 +29,10 @@ private:
 
 	sqlite3_stmt*    current_stmt;
 	String           current_stmt_string;
+	Vector<String>   bound; // texts of parameters bound without copying
 	bool             got_first_row;
 	bool             got_row_data;
+	bool             stmt_error;
 
 	friend class Sqlite3Session;
 	void             BindParam(int i, const Value& r);
@@ -42,7 +44,8 @@ public:
 };
 
 Sqlite3Connection::Sqlite3Connection(Sqlite3Session& the_session, sqlite3 *the_db)
-:	session(the_session), db(the_db), current_stmt(NULL), got_first_row(false), got_row_data(false)
+:	session(the_session), db(the_db), current_stmt(NULL), got_first_row(false), got_row_data(false),
+	stmt_error(false)
 {
 	LinkBefore(&session.clink);
 }
@@ -61,9 +64,11 @@ void Sqlite3Connection::Cancel()
 //		if (sqlite3_finalize(current_stmt) != SQLITE_OK)
 //			session.SetError(sqlite3_errmsg(db), "Finalizing statement: "+ current_stmt_string, sqlite3_errcode(db));
 		//this seems to be the correct way how to do error recovery...
-		sqlite3_finalize(current_stmt);
+		if(stmt_error || !session.CacheStatement(current_stmt_string, current_stmt))
+			sqlite3_finalize(current_stmt);
 		current_stmt = NULL;
 		current_stmt_string.Clear();
+		bound.Clear();
 		parse = true;
 	}
 }
@@ -80,42 +85,43 @@ void Sqlite3Connection::SetParam(int i, const Value& r)
 	param.At(i) = r;
 }
 
-void Sqlite3Connection::BindParam(int i, const Value& r) {
+static void sBind(Sqlite3Session::sqlite3_stmt *stmt, int i, const Value& r, String& p)
+{ // p has to stay unchanged until the parameter is bound again or statement is finalized
 	if (IsNull(r))
-		sqlite3_bind_null(current_stmt,i);
+		sqlite3_bind_null(stmt,i);
 	else switch (r.GetType()) {
 		case SQLRAW_V: {
-			SqlRaw p = r;
-			sqlite3_bind_blob(current_stmt, i, p, p.GetLength(), SQLITE_TRANSIENT);
+			p = SqlRaw(r);
+			sqlite3_bind_blob(stmt, i, p, p.GetLength(), SQLITE_STATIC);
 			break;
 		}
 		case STRING_V:
 		case WSTRING_V: {
-			String p = r;
-			sqlite3_bind_text(current_stmt, i, p, p.GetLength(), SQLITE_TRANSIENT);
+			p = r;
+			sqlite3_bind_text(stmt, i, p, p.GetLength(), SQLITE_STATIC);
 			break;
 		}
 		case BOOL_V:
 		case INT_V:
-			sqlite3_bind_int(current_stmt, i, int(r));
+			sqlite3_bind_int(stmt, i, int(r));
 			break;
 		case INT64_V:
-			sqlite3_bind_int64(current_stmt, i, int64(r));
+			sqlite3_bind_int64(stmt, i, int64(r));
 			break;
 		case DOUBLE_V:
-			sqlite3_bind_double(current_stmt, i, double(r));
+			sqlite3_bind_double(stmt, i, double(r));
 			break;
 		case DATE_V: {
 				Date d = r;
-				String p = Format("%04d-%02d-%02d", d.year, d.month, d.day);
-				sqlite3_bind_text(current_stmt,i,p,p.GetLength(),SQLITE_TRANSIENT);
+				p = Format("%04d-%02d-%02d", d.year, d.month, d.day);
+				sqlite3_bind_text(stmt,i,p,p.GetLength(),SQLITE_STATIC);
 			}
 			break;
 		case TIME_V: {
 				Time t = r;
-				String p = Format("%04d-%02d-%02d %02d:%02d:%02d",
-						          t.year, t.month, t.day, t.hour, t.minute, t.second);
-				sqlite3_bind_text(current_stmt,i,p,p.GetLength(),SQLITE_TRANSIENT);
+				p = Format("%04d-%02d-%02d %02d:%02d:%02d",
+				           t.year, t.month, t.day, t.hour, t.minute, t.second);
+				sqlite3_bind_text(stmt,i,p,p.GetLength(),SQLITE_STATIC);
 			}
 			break;
 		default:
@@ -123,6 +129,11 @@ void Sqlite3Connection::BindParam(int i, const Value& r) {
 	}
 }
 
+void Sqlite3Connection::BindParam(int i, const Value& r)
+{
+	sBind(current_stmt, i, r, bound[i - 1]);
+}
+
 int ParseForArgs(const char* sqlcmd)
 {
    int numargs = 0;
@@ -151,35 +162,29 @@ bool Sqlite3Connection::Execute() {
 		session.SetError("Empty statement", String("Preparing: ") + statement);
 		return false;
 	}
-	String utf8_stmt = ToCharset(CHARSET_UTF8, statement, CHARSET_DEFAULT);
-	if (SQLITE_OK != sqlite3_prepare(db,utf8_stmt,utf8_stmt.GetLength(),&current_stmt,NULL)) {
-		LLOG("Sqlite3Connection::Compile(" << statement << ") -> error");
-		session.SetError(sqlite3_errmsg(db), String("Preparing: ") + statement, sqlite3_errcode(db));
-		return false;
+	current_stmt = session.GetCachedStatement(statement);
+	if(!current_stmt) {
+		String utf8_stmt = ToCharset(CHARSET_UTF8, statement, CHARSET_DEFAULT);
+		if (SQLITE_OK != sqlite3_prepare_v2(db,utf8_stmt,utf8_stmt.GetLength(),&current_stmt,NULL)) {
+			LLOG("Sqlite3Connection::Compile(" << statement << ") -> error");
+			session.SetError(sqlite3_errmsg(db), String("Preparing: ") + statement, sqlite3_errcode(db));
+			return false;
+		}
 	}
 	current_stmt_string = statement;
-	int nparams = ParseForArgs(current_stmt_string);
-	ASSERT(nparams == param.GetCount());
+	stmt_error = false;
+	int nparams = param.GetCount();
+	ASSERT(nparams == ParseForArgs(current_stmt_string));
+	bound.SetCount(nparams);
 	for (int i = 0; i < nparams; ++i)
 		BindParam(i+1,param[i]);
 	param.Clear();
 	// Make sure that compiling the statement never fails.
 	ASSERT(NULL != current_stmt);
-	int retcode;
-	dword ticks_start = msecs();
-	int sleep_ms = 1;
-	do{
-		retcode = sqlite3_step(current_stmt);
-		if(retcode!=SQLITE_BUSY && retcode!=SQLITE_LOCKED) break;
-		if(session.busy_timeout == 0) break;
-		if(session.busy_timeout > 0 && (int)(msecs() - ticks_start) > session.busy_timeout)
-			break;
-		if(retcode==SQLITE_LOCKED) sqlite3_reset(current_stmt);
-		Sleep(sleep_ms);
-		if(sleep_ms<128) sleep_ms += sleep_ms;
-	}while(1);
+	int retcode = session.StepRetry(current_stmt);
 	if ((retcode != SQLITE_DONE) && (retcode != SQLITE_ROW)) {
 		session.SetError(sqlite3_errmsg(db), current_stmt_string, sqlite3_errcode(db));
+		stmt_error = true;
 		return false;
 	}
 	got_first_row = got_row_data = (retcode==SQLITE_ROW);
@@ -260,8 +265,10 @@ bool Sqlite3Connection::Fetch() {
 	}
 	ASSERT(got_row_data);
 	int retcode = sqlite3_step(current_stmt);
-	if ((retcode != SQLITE_DONE) && (retcode != SQLITE_ROW))
+	if ((retcode != SQLITE_DONE) && (retcode != SQLITE_ROW)) {
 		session.SetError(sqlite3_errmsg(db), String("Fetching prepared statement: ")+current_stmt_string, sqlite3_errcode(db));
+		stmt_error = true;
+	}
 	got_row_data = (retcode==SQLITE_ROW);
 	return got_row_data;
 }
@@ -433,6 +440,7 @@ void Sqlite3Session::Close() {
 	sql.Clear();
 	if (NULL != db) {
 		SessionClose();
+		ClearStatementCache();
 	#ifdef _DEBUG
 		int retval = sqlite3_close(db);
 		// If this function fails, that means that some of the
@@ -450,6 +458,42 @@ SqlConnection *Sqlite3Session::CreateConnection() {
 	return new Sqlite3Connection(*this, db);
 }
 
+Sqlite3Session::sqlite3_stmt *Sqlite3Session::GetCachedStatement(const String& statement)
+{
+	if(statement_cache <= 0)
+		return NULL;
+	int q = stmt_cache.Find(statement);
+	if(q < 0) {
+		statement_cache_misses++;
+		return NULL;
+	}
+	statement_cache_hits++;
+	sqlite3_stmt *stmt = stmt_cache[q];
+	stmt_cache.Remove(q); // statement is now owned by connection
+	return stmt;
+}
+
+bool Sqlite3Session::CacheStatement(const String& statement, sqlite3_stmt *stmt)
+{ // returns false if statement was not stored and has to be finalized
+	if(statement_cache <= 0 || !db || stmt_cache.Find(statement) >= 0)
+		return false;
+	sqlite3_reset(stmt);
+	sqlite3_clear_bindings(stmt); // bound parameters are not copied
+	stmt_cache.Add(statement, stmt);
+	while(stmt_cache.GetCount() > statement_cache) {
+		sqlite3_finalize(stmt_cache[0]);
+		stmt_cache.Remove(0);
+	}
+	return true;
+}
+
+void Sqlite3Session::ClearStatementCache()
+{
+	for(sqlite3_stmt *stmt : stmt_cache)
+		sqlite3_finalize(stmt);
+	stmt_cache.Clear();
+}
+
 int Sqlite3Session::SqlExecRetry(const char *sql)
 {
 	ASSERT(NULL != sql);
@@ -470,6 +514,71 @@ int Sqlite3Session::SqlExecRetry(const char *sql)
 	return retcode;
 }
 
+int Sqlite3Session::StepRetry(sqlite3_stmt *stmt)
+{
+	int retcode;
+	dword ticks_start = msecs();
+	int sleep_ms = 1;
+	do{
+		retcode = sqlite3_step(stmt);
+		if(retcode!=SQLITE_BUSY && retcode!=SQLITE_LOCKED) break;
+		if(busy_timeout == 0) break;
+		if(busy_timeout > 0 && (int)(msecs() - ticks_start) > busy_timeout)
+			break;
+		if(retcode==SQLITE_LOCKED) sqlite3_reset(stmt);
+		Sleep(sleep_ms);
+		if(sleep_ms<128) sleep_ms += sleep_ms;
+	}while(1);
+	return retcode;
+}
+
+int Sqlite3Session::GetBulkInsertRows(int columns) const
+{
+	return max(1000000 / max(columns, 1), 1);
+}
+
+bool Sqlite3Session::BulkInsert(const String& table, const Vector<String>& column,
+                                const Vector< Vector<Value> >& data)
+{ // one prepared statement, rebound for each row, all rows in single transaction
+	if(data.GetCount() == 0 || data[0].GetCount() == 0)
+		return true;
+	String stmt;
+	stmt << "insert into " << table << '(' << Join(column, ", ") << ") values (";
+	for(int i = 0; i < column.GetCount(); i++)
+		stmt << (i ? ", ?" : "?");
+	stmt << ')';
+	if(trace)
+		*trace << stmt << " -- " << data[0].GetCount() << " rows\n";
+	bool own = sqlite3_get_autocommit(db); // not in transaction, do not commit each row
+	if(own && SqlExecRetry("BEGIN;") != SQLITE_OK) {
+		SetError(sqlite3_errmsg(db), "BEGIN;", sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+		return false;
+	}
+	sqlite3_stmt *s = NULL;
+	String utf8_stmt = ToCharset(CHARSET_UTF8, stmt, CHARSET_DEFAULT);
+	bool ok = sqlite3_prepare_v2(db, utf8_stmt, utf8_stmt.GetLength(), &s, NULL) == SQLITE_OK;
+	Vector<String> bound;
+	bound.SetCount(column.GetCount());
+	for(int r = 0; ok && r < data[0].GetCount(); r++) {
+		for(int i = 0; i < column.GetCount(); i++)
+			sBind(s, i + 1, data[i][r], bound[i]);
+		ok = StepRetry(s) == SQLITE_DONE;
+		sqlite3_reset(s);
+	}
+	if(!ok)
+		SetError(sqlite3_errmsg(db), stmt, sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+	sqlite3_finalize(s);
+	if(own) {
+		if(ok && SqlExecRetry("COMMIT;") != SQLITE_OK) {
+			SetError(sqlite3_errmsg(db), "COMMIT;", sqlite3_errcode(db), sqlite3_errstr(sqlite3_errcode(db)));
+			ok = false;
+		}
+		if(!ok)
+			SqlExecRetry("ROLLBACK;");
+	}
+	return ok;
+}
+
 void Sqlite3Session::Reset()
 {
 	for(Link<> *s = clink.GetNext(); s != &clink; s = s->GetNext())
@@ -489,6 +598,7 @@ Sqlite3Session::Sqlite3Session()
 	busy_timeout = 0;
 	see = true;
 	encrypted = false;
+	StatementCache(32);
 }
 
 Sqlite3Session::~Sqlite3Session()
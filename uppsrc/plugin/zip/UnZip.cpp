@@ -7,6 +7,7 @@ void UnZip::ReadDir()
 	error = true;
 	
 	file.Clear();
+	index.Clear();
 	current = 0;
 
 	int64 entries = -1;
@@ -95,6 +96,7 @@ void UnZip::ReadDir()
 		zip->Seek(skipto);
 		if(zip->IsEof() || zip->IsError())
 			return;
+		index.Add(f.path);
 	}
 	
 	error = false;
@@ -115,54 +117,77 @@ Time UnZip::GetZipTime(dword dt)
 int64 zPress(Stream& out, Stream& in, int64 size, Gate<int64, int64> progress, bool gzip,
              bool compress, dword *crc, bool hdr);
 
-bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
+bool UnZip::ReadEntry(Stream& in, const File& f, Stream& out, Gate<int, int> progress) const
 {
-	if(error)
+	in.Seek(f.offset);
+	if(in.Get32le() != 0x04034b50)
 		return false;
-	if(IsFolder()) {
-		current++;
-		return true;
-	}
-	error = true;
-	if(current >= file.GetCount())
-		return false;
-	const File& f = file[current];
-	zip->Seek(f.offset);
-	if(zip->Get32le() != 0x04034b50)
-		return false;
-	zip->Get16le();
-	zip->Get16le(); // Skip header, use info from centrall dir
-	zip->Get16le();
-	zip->Get32le();
-	zip->Get32le();
-	zip->Get32le();
-	zip->Get32le();
-	dword filelen = zip->Get16le();
-	dword extralen = zip->Get16le();
-	zip->SeekCur(filelen + extralen);
+	in.Get16le();
+	in.Get16le(); // Skip header, use info from centrall dir
+	in.Get16le();
+	in.Get32le();
+	in.Get32le();
+	in.Get32le();
+	in.Get32le();
+	dword filelen = in.Get16le();
+	dword extralen = in.Get16le();
+	in.SeekCur(filelen + extralen);
 	dword crc;
 	qword l;
 	if(f.method == 0) {
-		Buffer<byte> temp(65536);
-		int loaded;
-		int64 count = f.csize;
-		Crc32Stream crc32;
-		while(count > 0 && (loaded = zip->Get(temp, (int)min<int64>(count, 65536))) > 0) {
-			out.Put(temp, loaded);
-			crc32.Put(temp, loaded);
-			count -= loaded;
+		if(data) { // no need for intermediate buffer
+			int64 pos = in.GetPos();
+			if(pos < 0 || pos + (int64)f.csize > data_size)
+				return false;
+			const byte *s = data + pos;
+			Crc32Stream crc32;
+			for(int64 count = f.csize; count > 0;) {
+				int n = (int)min<int64>(count, 1024 * 1024);
+				out.Put(s, n);
+				crc32.Put(s, n);
+				s += n;
+				count -= n;
+			}
+			l = f.csize;
+			crc = crc32;
+		}
+		else {
+			Buffer<byte> temp(65536);
+			int loaded;
+			int64 count = f.csize;
+			Crc32Stream crc32;
+			while(count > 0 && (loaded = in.Get(temp, (int)min<int64>(count, 65536))) > 0) {
+				out.Put(temp, loaded);
+				crc32.Put(temp, loaded);
+				count -= loaded;
+			}
+			if(count > 0)
+				return false;
+			l = f.csize;
+			crc = crc32;
 		}
-		if(count > 0)
-			return false;
-		l = f.csize;
-		crc = crc32;
 	}
 	else
 	if(f.method == 8)
-		l = zPress(out, *zip, f.csize, AsGate64(progress), false, false, &crc, false);
+		l = zPress(out, in, f.csize, AsGate64(progress), false, false, &crc, false);
 	else
 		return false;
-	if(crc != f.crc || l != f.usize)
+	return crc == f.crc && l == f.usize;
+}
+
+bool UnZip::ReadFile(Stream& out, Gate<int, int> progress)
+{
+	if(error)
+		return false;
+	if(IsFolder()) {
+		current++;
+		return true;
+	}
+	error = true;
+	if(current >= file.GetCount())
+		return false;
+	Mutex::Lock __(mutex);
+	if(!ReadEntry(*zip, file[current], out, progress))
 		return false;
 	current++;
 	error = false;
@@ -177,18 +202,88 @@ String UnZip::ReadFile(Gate<int, int> progress)
 
 String UnZip::ReadFile(const char *path, Gate<int, int> progress)
 {
-    for(int i = 0; i < file.GetCount(); i++)
-        if(file[i].path == path) {
-            Seek(i);
-            return ReadFile(progress);
-        }
+	int i = Find(path);
+	if(i < 0)
+		return String::GetVoid();
+	Seek(i);
+	return ReadFile(progress);
+}
+
+bool UnZip::Extract(int i, Stream& out)
+{ // random access, can be called concurrently
+	ASSERT(i >= 0 && i < file.GetCount());
+	if(IsFolder(i))
+		return true;
+	if(data) {
+		MemReadStream in(data, data_size);
+		return ReadEntry(in, file[i], out, Null);
+	}
+	Mutex::Lock __(mutex);
+	return ReadEntry(*zip, file[i], out, Null);
+}
+
+String UnZip::Extract(int i)
+{
+	StringStream ss;
+	return Extract(i, ss) ? ss.GetResult() : String::GetVoid();
+}
 
-    return String::GetVoid();
+const byte *UnZip::GetStored(int i) const
+{ // direct pointer to data of uncompressed (method 0) entry of in-memory archive, CRC is not checked
+	ASSERT(i >= 0 && i < file.GetCount());
+	const File& f = file[i];
+	if(!data || f.method != 0 || f.offset < 0 || f.offset + 30 > data_size)
+		return NULL;
+	const byte *s = data + f.offset;
+	if(Peek32le(s) != 0x04034b50)
+		return NULL;
+	int64 pos = f.offset + 30 + Peek16le(s + 26) + Peek16le(s + 28);
+	if(pos + (int64)f.csize > data_size)
+		return NULL;
+	return data + pos;
+}
+
+bool UnZip::ExtractAll(const char *dir)
+{
+	for(const File& f : file) {
+		String path = UnixPath(f.path);
+		if(*path == '/' || path.Find(':') >= 0 || path.StartsWith("../") || path.Find("/../") >= 0)
+			return false; // refuse to write outside dir
+	}
+	Index<String> folder;
+	for(int i = 0; i < file.GetCount(); i++)
+		folder.FindAdd(GetFileFolder(AppendFileName(dir, IsFolder(i) ? file[i].path + "." : file[i].path)));
+	for(const String& f : folder)
+		if(!RealizeDirectory(f))
+			return false;
+	std::atomic<bool> ok(true);
+	CoFor(file.GetCount(), [&](int i) {
+		if(!ok || IsFolder(i))
+			return;
+		FileOut out(AppendFileName(dir, file[i].path));
+		if(!out || !Extract(i, out))
+			ok = false;
+		out.Close();
+		if(out.IsError())
+			ok = false;
+	});
+	return ok;
 }
 
 void UnZip::Create(Stream& _zip)
 {
 	zip = &_zip;
+	data = NULL;
+	data_size = 0;
+	ReadDir();
+}
+
+void UnZip::Create(const void *ptr, int64 size)
+{
+	mem.Create(ptr, size);
+	zip = &mem;
+	data = (const byte *)ptr;
+	data_size = size;
 	ReadDir();
 }
 
@@ -201,6 +296,8 @@ UnZip::UnZip()
 {
 	error = true;
 	zip = NULL;
+	data = NULL;
+	data_size = 0;
 }
 
 UnZip::~UnZip() {}
@@ -10,16 +10,18 @@ bool FileUnZip::Create(const char *name)
 	return true;
 }
 
-void MemUnZip::Create(const void *ptr, int count)
+bool MappedUnZip::Create(const char *name)
 {
-	zip.Create(ptr, count);
-	UnZip::Create(zip);
+	if(!map.Open(name) || (int64)(size_t)map.GetFileSize() != map.GetFileSize())
+		return false;
+	UnZip::Create(map.GetFileSize() ? map.Map() : NULL, map.GetFileSize());
+	return !IsError();
 }
 
 void StringUnZip::Create(const String& s)
 {
-	zip.Open(s);
-	UnZip::Create(zip);
+	zip = s;
+	UnZip::Create(~zip, zip.GetCount());
 }
 
 }
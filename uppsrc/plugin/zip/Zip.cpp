@@ -50,9 +50,26 @@ static bool IsPlainASCII(const String &s){
 	return true;
 }
 
+Zip::File& Zip::AddFile(const char *path, Time tm, bool deflate, bool zip64)
+{
+	if(done>=0xffffffffULL) zip64 = true; // must switch to Zip64 due to large archive size
+	
+	File& f = file.Add();
+	f.version = zip64 ? 45 : 20;
+	f.gpflag = IsPlainASCII(path) ? 0x8 : 0x8 | 1<<11; // Added UTF-8 marker, i.e.: " | 1<<11"; only for files with non-ASCII characters
+	f.method = deflate ? 8 : 0;
+	f.zip64 = zip64;
+	f.crc = 0;
+	f.csize = 0;
+	f.usize = 0;
+	FileHeader(path, tm);
+	return f;
+}
+
 void Zip::BeginFile(const char *path, Time tm, bool deflate, bool zip64)
 {
 	ASSERT(!IsFileOpened());
+	FlushPending();
 	if(deflate) {
 		pipeZLib.Create();
 		pipeZLib->WhenOut = THISBACK(PutCompressed);
@@ -63,17 +80,7 @@ void Zip::BeginFile(const char *path, Time tm, bool deflate, bool zip64)
 		uncompressed = true;
 	}
 	
-	if(done>=0xffffffffULL) zip64 = true; // must switch to Zip64 due to large archive size
-	
-	File& f = file.Add();
-	f.version = zip64 ? 45 : 20;
-	f.gpflag = IsPlainASCII(path) ? 0x8 : 0x8 | 1<<11; // Added UTF-8 marker, i.e.: " | 1<<11"; only for files with non-ASCII characters
-	f.method = deflate ? 8 : 0;
-	f.zip64 = zip64;
-	f.crc = 0;
-	f.csize = 0;
-	f.usize = 0;
-	FileHeader(path, tm);
+	AddFile(path, tm, deflate, zip64);
 	if (zip->IsError()) WhenError();
 }
 
@@ -117,22 +124,12 @@ void Zip::Put64(const void *ptr, int64 size)
 	f.usize += size;
 }
 
-void Zip::EndFile()
+void Zip::DataDescriptor(File& f)
 {
-	if(!IsFileOpened())
-		return;
-	File& f = file.Top();
 	ASSERT(f.gpflag & 0x8);
 	
-	if(f.method == 0){
-		zip->Put32le(f.crc = crc32);
-		done += 4;
-	}
-	else {
-		pipeZLib->End();
-		zip->Put32le(f.crc = pipeZLib->GetCRC());
-		done += 4;
-	}
+	zip->Put32le(f.crc);
+	done += 4;
 
 	if(f.zip64){
 		zip->Put64le(f.csize);
@@ -144,6 +141,21 @@ void Zip::EndFile()
 		zip->Put32le((dword)f.usize);
 		done += 8;
 	}
+}
+
+void Zip::EndFile()
+{
+	if(!IsFileOpened())
+		return;
+	File& f = file.Top();
+	
+	if(f.method == 0)
+		f.crc = crc32;
+	else {
+		pipeZLib->End();
+		f.crc = pipeZLib->GetCRC();
+	}
+	DataDescriptor(f);
 	
 	pipeZLib.Clear();
 	uncompressed = false;
@@ -185,6 +197,54 @@ void Zip::WriteFile(const String& s, const char *path, Gate<int, int> progress,
 	WriteFile(~s, s.GetCount(), path, progress, tm, deflate);
 }
 
+void Zip::CoWriteFile(const String& s, const char *path, Time tm, bool deflate)
+{ // compresses in parallel, entries are written in the order of calls
+	ASSERT(!IsFileOpened());
+	Pending& p = pending.Add();
+	p.path = path;
+	p.tm = tm;
+	p.deflate = deflate;
+	p.data = s;
+	co & [&p] {
+		if(p.deflate) {
+			Zlib z;
+			z.GZip(false).CRC().NoHeader().Compress();
+			z.Put(p.data);
+			z.End();
+			p.compressed = z.Get();
+			p.crc = z.GetCRC();
+		}
+		else {
+			Crc32Stream crc32;
+			crc32.Put(p.data);
+			p.crc = crc32;
+		}
+	};
+	pending_size += s.GetCount();
+	if(pending_size > 64 * 1024 * 1024)
+		FlushPending();
+}
+
+void Zip::FlushPending()
+{
+	if(pending.GetCount() == 0)
+		return;
+	co.Finish();
+	for(Pending& p : pending) {
+		File& f = AddFile(p.path, p.tm, p.deflate, false);
+		const String& data = p.deflate ? p.compressed : p.data;
+		zip->Put(data);
+		done += data.GetCount();
+		f.crc = p.crc;
+		f.csize = data.GetCount();
+		f.usize = p.data.GetCount();
+		DataDescriptor(f);
+		if(zip->IsError()) WhenError();
+	}
+	pending.Clear();
+	pending_size = 0;
+}
+
 void Zip::Create(Stream& out)
 {
 	Finish();
@@ -196,6 +256,7 @@ void Zip::Finish()
 {
 	if(!zip)
 		return;
+	FlushPending();
 	qword off = done;
 	qword rof = 0;
 	
@@ -274,6 +335,7 @@ Zip::Zip()
 	done = 0;
 	zip = NULL;
 	uncompressed = false;
+	pending_size = 0;
 }
 
 Zip::Zip(Stream& out)
@@ -281,6 +343,7 @@ Zip::Zip(Stream& out)
 	done = 0;
 	zip = NULL;
 	uncompressed = false;
+	pending_size = 0;
 	Create(out);
 }
 
@@ -17,12 +17,18 @@ class UnZip {
 		int64  offset;
 	};
 	
-	Stream      *zip;
-	bool         error;
-	Vector<File> file;
-	int          current;
+	Stream       *zip;
+	const byte   *data; // whole archive in memory, allows concurrent Extract
+	int64         data_size;
+	MemReadStream mem;
+	bool          error;
+	Vector<File>  file;
+	Index<String> index; // path -> file
+	int           current;
+	Mutex         mutex; // serializes Extract when reading through zip Stream
 
 	void   ReadDir();
+	bool   ReadEntry(Stream& in, const File& f, Stream& out, Gate<int, int> progress) const;
 
 	static Time   GetZipTime(dword time);
 
@@ -55,7 +61,15 @@ public:
 
 	String ReadFile(const char *path, Gate<int, int> progress = Null);
 
+	int    Find(const char *path) const { return index.Find(path); }
+
+	bool   Extract(int i, Stream& out);
+	String Extract(int i);
+	const byte *GetStored(int i) const;
+	bool   ExtractAll(const char *dir);
+
 	void   Create(Stream& in);
+	void   Create(const void *data, int64 size);
 	void   Close()                { file.Clear(); zip->Close(); }
 
 	UnZip(Stream& in);
@@ -74,17 +88,25 @@ public:
 };
 
 class MemUnZip : public UnZip {
-	MemReadStream zip;
-
 public:
-	void Create(const void *ptr, int count);
+	void Create(const void *ptr, int count)    { UnZip::Create(ptr, count); }
 
 	MemUnZip(const void *ptr, int count)       { Create(ptr, count); }
 	MemUnZip();
 };
 
+class MappedUnZip : public UnZip {
+	FileMapping map;
+
+public:
+	bool Create(const char *name);
+
+	MappedUnZip(const char *name)               { Create(name); }
+	MappedUnZip()                               {}
+};
+
 class StringUnZip : public UnZip {
-	StringStream zip;
+	String zip;
 
 public:
 	void Create(const String& s);
@@ -112,6 +134,19 @@ class Zip {
 
 	qword   done;
 
+	struct Pending {
+		String path;
+		Time   tm;
+		bool   deflate;
+		String data;
+		String compressed;
+		dword  crc;
+	};
+	
+	Array<Pending> pending; // entries being compressed by CoWriteFile
+	int64          pending_size;
+	CoWork         co;
+
 	One<Zlib> pipeZLib;
 	Crc32Stream crc32; // for uncompressed files
 	bool        uncompressed;
@@ -119,6 +154,9 @@ class Zip {
 	void WriteFile0(const void *ptr, int size, const char *path, Gate<int, int> progress, Time tm, int method);
 
 	void FileHeader(const char *path, Time tm);
+	File& AddFile(const char *path, Time tm, bool deflate, bool zip64);
+	void DataDescriptor(File& f);
+	void FlushPending();
 
 	void PutCompressed(const void *data, int size);
 	
@@ -137,6 +175,7 @@ public:
 	void WriteFolder(const char *path, Time tm = GetSysTime());
 	void WriteFile(const void *ptr, int size, const char *path, Gate<int, int> progress = Null, Time tm = GetSysTime(), bool deflate = true);
 	void WriteFile(const String& s, const char *path, Gate<int, int> progress = Null, Time tm = GetSysTime(), bool deflate = true);
+	void CoWriteFile(const String& s, const char *path, Time tm = GetSysTime(), bool deflate = true);
 
 	void Create(Stream& out);
 	void Finish();
@@ -11,6 +11,7 @@ void ZstdCompressStream::Open(Stream& out_, int level_)
 	level = level_;
 	ClearError();
 	pos = 0;
+	index.Clear();
 	Alloc();
 }
 
@@ -66,6 +67,8 @@ void ZstdCompressStream::FlushOut()
 			return;
 		}
 		out->Put(t, clen);
+		if(seekable)
+			index << clen << min((int)BLOCK_BYTES, int(ptr - ~buffer) - i * BLOCK_BYTES);
 		t += osz;
 	}
 	
@@ -78,6 +81,16 @@ void ZstdCompressStream::Close()
 {
 	if(out) {
 		FlushOut();
+		if(seekable) { // zstd seekable format seek table, without checksums
+			int n = index.GetCount() / 2;
+			out->Put32le(ZSTD_SKIPPABLE_SEEK_MAGIC);
+			out->Put32le(8 * n + 9);
+			for(dword h : index)
+				out->Put32le(h);
+			out->Put32le(n);
+			out->Put(0);
+			out->Put32le(ZSTD_SEEKABLE_MAGIC);
+		}
 		out = NULL;
 	}
 }
@@ -120,6 +133,7 @@ ZstdCompressStream::ZstdCompressStream()
 {
 	style = STRM_WRITE;
 	concurrent = false;
+	seekable = false;
 	out = NULL;
 }
 
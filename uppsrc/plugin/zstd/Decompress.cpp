@@ -18,15 +18,122 @@ void ZstdDecompressStream::Init()
 	compressed_data.Clear();
 	compressed_at = 0;
 	ClearError();
+	block_pos.Clear();
+	block_offset.Clear();
+	for(CachedBlock& b : cache)
+		b.block = -1;
+	cache_serial = 0;
+	block = -1;
+	style &= ~STRM_SEEK;
 }
 
 bool ZstdDecompressStream::Open(Stream& in_)
 {
 	Init();
 	in = &in_;
+	if(in->GetStyle() & STRM_SEEK) { // look for seek table at the end
+		int64 start = in->GetPos();
+		int64 size = in->GetSize();
+		if(size - start >= 17) {
+			in->Seek(size - 9);
+			int n = in->Get32le();
+			int descriptor = in->Get();
+			int64 table = size - 9 - 8 * (int64)n - 8;
+			if(in->Get32le() == (int)ZSTD_SEEKABLE_MAGIC && descriptor == 0 && n >= 0 && table >= start) {
+				in->Seek(table);
+				if(in->Get32le() == ZSTD_SKIPPABLE_SEEK_MAGIC && in->Get32le() == 8 * n + 9) {
+					int64 p = start;
+					int64 o = 0;
+					for(int i = 0; i < n; i++) {
+						block_pos.Add(p);
+						block_offset.Add(o);
+						p += (dword)in->Get32le();
+						o += (dword)in->Get32le();
+					}
+					block_pos.Add(p);
+					block_offset.Add(o);
+					if(p != table || in->IsError()) {
+						block_pos.Clear();
+						block_offset.Clear();
+					}
+				}
+			}
+		}
+		in->Seek(start);
+		if(block_pos.GetCount())
+			style |= STRM_SEEK;
+	}
+	return true;
+}
+
+bool ZstdDecompressStream::LoadBlock(int i)
+{
+	CachedBlock *b = NULL;
+	for(CachedBlock& m : cache)
+		if(m.block == i)
+			b = &m;
+	if(!b) {
+		b = &cache[0];
+		for(CachedBlock& m : cache)
+			if(m.serial < b->serial)
+				b = &m;
+		b->block = -1;
+		int64 clen = block_pos[i + 1] - block_pos[i];
+		int64 len = block_offset[i + 1] - block_offset[i];
+		if(clen > 1024*1024*1024 || len > 1024*1024*1024) {
+			SetError();
+			return false;
+		}
+		in->Seek(block_pos[i]);
+		Buffer<char> c((int)clen);
+		if(!in->GetAll(~c, (int)clen)) {
+			SetError();
+			return false;
+		}
+		if(len > b->alloc || !b->data) {
+			b->alloc = max((int)len, (int)BLOCK_BYTES);
+			b->data.Alloc(b->alloc);
+		}
+		size_t sz = ZSTD_decompress(~b->data, (size_t)len, ~c, (size_t)clen);
+		if(ZSTD_isError(sz) || (int64)sz != len) {
+			SetError();
+			return false;
+		}
+		b->len = (int)len;
+		b->block = i;
+	}
+	b->serial = ++cache_serial;
+	block = i;
+	ii = count = 0;
+	eof = i + 2 >= block_pos.GetCount();
+	ptr = Stream::buffer = (byte *)~b->data;
+	rdlim = ptr + b->len;
+	pos = block_offset[i];
 	return true;
 }
 
+void ZstdDecompressStream::Seek(int64 offset)
+{
+	ASSERT(IsSeekable());
+	int n = block_offset.GetCount() - 1;
+	offset = clamp(offset, (int64)0, block_offset.Top());
+	if(n == 0) {
+		block = 0;
+		ii = count = 0;
+		eof = true;
+		ptr = rdlim;
+		return;
+	}
+	int i = min(FindUpperBound(block_offset, offset) - 1, n - 1);
+	if(LoadBlock(i))
+		ptr += offset - block_offset[i];
+}
+
+int64 ZstdDecompressStream::GetSize() const
+{
+	return block_offset.GetCount() ? block_offset.Top() : 0;
+}
+
 bool ZstdDecompressStream::Next()
 {
 	pos += ptr - buffer;
@@ -43,6 +150,11 @@ bool ZstdDecompressStream::Next()
 
 void ZstdDecompressStream::Fetch()
 {
+	if(block >= 0) { // reading by seek table
+		if(block + 2 < block_pos.GetCount())
+			LoadBlock(block + 1);
+		return;
+	}
 	if(Next())
 		return;
 	if(eof)
@@ -8,6 +8,11 @@
 
 namespace Upp {
 
+enum {
+	ZSTD_SKIPPABLE_SEEK_MAGIC = 0x184D2A5E, // seekable format seek table frame
+	ZSTD_SEEKABLE_MAGIC       = 0x8F92EAB1,
+};
+
 class ZstdCompressStream : public Stream  {
 public:
 	virtual   void  Close();
@@ -28,6 +33,8 @@ protected:
 	int           level;
 	
 	bool          concurrent;
+	bool          seekable;
+	Vector<dword> index; // compressed and decompressed size of frames, for seek table
     
     void          Alloc();
 	void          Init();
@@ -35,6 +42,7 @@ protected:
 
 public:
 	void Co(bool b = true);
+	void Seekable(bool b = true)                                          { seekable = b; }
 	void Open(Stream& out, int level = 1);
 
 	ZstdCompressStream();
@@ -45,6 +53,8 @@ public:
 class ZstdDecompressStream : public Stream {
 public:
 	virtual   bool  IsOpen() const;
+	virtual   void  Seek(int64 pos);
+	virtual   int64 GetSize() const;
 
 protected:
 	virtual   int   _Term();
@@ -80,16 +90,31 @@ private:
 	bool         eof;
 	
 	bool         concurrent;
+	
+	Vector<int64> block_pos; // seekable: positions of frames in input, last is the end
+	Vector<int64> block_offset; // seekable: positions of frames in output, last is total size
+	struct CachedBlock {
+		int          block = -1;
+		Buffer<char> data;
+		int          alloc = 0;
+		int          len = 0;
+		int64        serial = 0;
+	};
+	CachedBlock  cache[4]; // recently decompressed frames for random access
+	int64        cache_serial;
+	int          block; // current frame if reading by seek table, -1 otherwise
 
     void          TryHeader();
 
 	void          Init();
 	bool          Next();
 	void          Fetch();
+	bool          LoadBlock(int i);
 	bool          Ended() const { return IsError() || in->IsError() || ptr == rdlim && ii == count && eof; }
 
 public:	
 	bool Open(Stream& in);
+	bool IsSeekable() const                                   { return block_pos.GetCount(); }
 	void Co(bool b = true)                                    { concurrent = b; }
 
 	ZstdDecompressStream();
@@ -38,6 +38,7 @@ void Ide::EndBuilding(bool ok)
 {
 	console.EndGroup();
 	console.Wait();
+	HdependSaveCache();
 	Vector<String> errors = console.PickErrors();
 	for(String p: errors)
 		DeleteFile(p);